@@ -0,0 +1,95 @@
+#include <biscuit/assembler.hpp>
+#include <biscuit/icache.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace biscuit;
+
+namespace {
+constexpr int num_iterations = 10000;
+constexpr int num_jumps = 64;
+
+const char* GetMethodName(ICacheSyncMethod method) {
+    switch (method) {
+    case ICacheSyncMethod::ClearCache:
+        return "__builtin___clear_cache";
+    case ICacheSyncMethod::FlushICacheSyscall:
+        return "riscv_flush_icache";
+    case ICacheSyncMethod::Membarrier:
+        return "membarrier(PRIVATE_EXPEDITED_SYNC_CORE)";
+    }
+    return "unknown";
+}
+
+// Measures the average time of a single publish in nanoseconds.
+template <typename Func>
+double Measure(Func&& func) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_iterations; i++) {
+        func(i);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / num_iterations;
+}
+
+void RunBenchmarks(const std::vector<PatchableJump>& jumps, uint64_t a, uint64_t b) {
+    const auto unbatched = Measure([&](int i) {
+        for (const auto& jump : jumps) {
+            jump.Retarget((i & 1) != 0 ? a : b);
+        }
+    });
+
+    const auto batched = Measure([&](int i) {
+        CodePublisher publisher;
+        for (const auto& jump : jumps) {
+            jump.Retarget((i & 1) != 0 ? a : b, publisher);
+        }
+        publisher.Publish();
+    });
+
+    std::cout << "  " << num_jumps << " jumps, one publish each:  " << unbatched << " ns\n";
+    std::cout << "  " << num_jumps << " jumps, one batched publish: " << batched << " ns\n";
+    std::cout << "  per jump: " << unbatched / num_jumps << " ns vs. " << batched / num_jumps << " ns\n";
+}
+} // Anonymous namespace
+
+int main() {
+    Assembler as;
+    const auto a = as.GetCodeBuffer().GetCursorAddress();
+    const auto b = a + 0x1000;
+
+    std::vector<PatchableJump> jumps;
+    for (int i = 0; i < num_jumps; i++) {
+        jumps.push_back(as.EmitPatchableJump(a));
+    }
+
+    std::cout << "Publishing with " << GetMethodName(CodePublisher::GetMethod()) << "\n";
+
+    std::cout << "Single thread:\n";
+    RunBenchmarks(jumps, a, b);
+
+    // Broadcasts get more expensive with every other hart running a thread of the process.
+    const auto num_spinners = std::max(1U, std::thread::hardware_concurrency()) - 1;
+    std::atomic_bool done{false};
+    std::vector<std::thread> spinners;
+    for (unsigned i = 0; i < num_spinners; i++) {
+        spinners.emplace_back([&] {
+            while (!done.load(std::memory_order_relaxed)) {
+            }
+        });
+    }
+
+    std::cout << "With " << num_spinners << " other running threads:\n";
+    RunBenchmarks(jumps, a, b);
+
+    done = true;
+    for (auto& spinner : spinners) {
+        spinner.join();
+    }
+}
@@ -0,0 +1,93 @@
+#include <biscuit/assembler.hpp>
+#include <biscuit/scheduler.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+
+using namespace biscuit;
+
+namespace {
+struct Block {
+    std::string_view name;
+    std::function<void(Assembler&)> emit;
+};
+
+// Blocks in the shape that template-based code generators typically emit them,
+// i.e. each operation loads its inputs right before it needs them.
+const std::array blocks{
+    Block{"Interpreter ADD handler", [](Assembler& as) {
+              // Guest registers live in memory pointed to by s0.
+              as.LD(t0, 8, s0);
+              as.LD(t1, 16, s0);
+              as.ADD(t0, t0, t1);
+              as.SD(t0, 24, s0);
+              as.LD(t2, 0, s1);
+              as.ADDI(t2, t2, 4);
+              as.SD(t2, 0, s1);
+              as.LBU(t3, 0, t2);
+              as.SLLI(t3, t3, 3);
+              as.ADD(t3, t3, s2);
+              as.LD(t3, 0, t3);
+          }},
+    Block{"Array indexing", [](Assembler& as) {
+              as.SLLI(t0, a1, 3);
+              as.ADD(t0, a0, t0);
+              as.LD(t1, 0, t0);
+              as.MUL(t1, t1, a2);
+              as.ADD(a3, a3, t1);
+              as.SLLI(t2, a4, 3);
+              as.ADD(t2, a0, t2);
+              as.LD(t3, 0, t2);
+              as.MUL(t3, t3, a2);
+              as.ADD(a5, a5, t3);
+          }},
+    Block{"Floating-point dot product", [](Assembler& as) {
+              as.FLD(ft0, 0, a0);
+              as.FLD(ft1, 0, a1);
+              as.FMADD_D(fa0, ft0, ft1, fa0);
+              as.FLD(ft2, 8, a0);
+              as.FLD(ft3, 8, a1);
+              as.FMADD_D(fa1, ft2, ft3, fa1);
+              as.FLD(ft4, 16, a0);
+              as.FLD(ft5, 16, a1);
+              as.FMADD_D(fa2, ft4, ft5, fa2);
+              as.ADDI(a0, a0, 24);
+              as.ADDI(a1, a1, 24);
+          }},
+};
+
+void RunBenchmarks(const MachineModel& model) {
+    std::cout << model.name << ":\n";
+
+    uint64_t total_before = 0;
+    uint64_t total_after = 0;
+    for (const auto& block : blocks) {
+        Assembler as;
+        as.BeginRecording();
+        block.emit(as);
+        auto stream = as.EndRecording();
+
+        const auto before = EstimateCycles(stream, model);
+        static_cast<void>(Scheduler{model}.Run(stream));
+        const auto after = EstimateCycles(stream, model);
+
+        total_before += before;
+        total_after += after;
+
+        std::cout << "  " << std::left << std::setw(28) << block.name << std::right << std::setw(4) << before
+                  << " -> " << std::setw(4) << after << " cycles\n";
+    }
+
+    std::cout << "  " << std::left << std::setw(28) << "Total" << std::right << std::setw(4) << total_before
+              << " -> " << std::setw(4) << total_after << " cycles\n";
+}
+} // Anonymous namespace
+
+int main() {
+    RunBenchmarks(MachineModel::SiFiveU74());
+    RunBenchmarks(MachineModel::TheadC906());
+}
@@ -1,15 +1,24 @@
 #pragma once
 
 #include <biscuit/code_buffer.hpp>
+#include <biscuit/code_listener.hpp>
 #include <biscuit/csr.hpp>
 #include <biscuit/enum_utils.hpp>
+#include <biscuit/external_symbol.hpp>
+#include <biscuit/fusion.hpp>
 #include <biscuit/isa.hpp>
 #include <biscuit/label.hpp>
 #include <biscuit/literal.hpp>
+#include <biscuit/patchable.hpp>
 #include <biscuit/registers.hpp>
+#include <biscuit/relocation.hpp>
 #include <biscuit/vector.hpp>
 #include <cstddef>
 #include <cstdint>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <vector>
 
 namespace biscuit {
 
@@ -45,6 +54,18 @@ enum class Optimization : uint32_t {
      * as long as rd and rs are not the zero register.
      */
     AutoCompress = 1,
+
+    /**
+     * Skips emitting VSETVLI and VSETIVLI instructions with a destination of the zero
+     * register if the configuration they request is known to be in effect already.
+     *
+     * The configuration is known from the previous configuring instruction within
+     * the same straight-line region of code. It's forgotten at labels, jumps, calls,
+     * and instructions that modify vl (e.g. fault-only-first loads), and whenever
+     * the cursor is moved. See Assembler::SetVectorConfig and
+     * Assembler::InvalidateVectorConfig for details.
+     */
+    ElideVectorConfig = 2,
 };
 BISCUIT_DEFINE_ENUM_FLAG_OPERATORS(Optimization);
 
@@ -64,6 +85,20 @@ enum class ArchFeature : uint32_t {
     RV128, //< 128-bit RISC-V
 };
 
+/// What padding emitted by Assembler::Align consists of.
+enum class FillPolicy : uint32_t {
+    /// NOPs, for padding that may be executed, e.g. in front of a loop.
+    Nop,
+
+    /// Zero bytes, for padding that must not be executed, e.g. in front of data.
+    /// Executing them raises an illegal instruction exception.
+    Zero,
+};
+
+class IRPassPipeline;
+class IRStream;
+struct Instruction;
+
 /**
  * Code generator for RISC-V code.
  *
@@ -122,6 +157,11 @@ public:
         m_features = features;
     }
 
+    /// Gets the features that the assembler is taking into account.
+    [[nodiscard]] ArchFeature GetArchFeatures() const noexcept {
+        return m_features;
+    }
+
     /// Gets the underlying code buffer being managed by this assembler.
     CodeBuffer& GetCodeBuffer();
 
@@ -147,6 +187,7 @@ public:
      */
     void RewindBuffer(ptrdiff_t offset = 0) {
         m_buffer.RewindCursor(offset);
+        InvalidateVectorConfig();
     }
 
     /**
@@ -159,6 +200,7 @@ public:
      */
     void AdvanceBuffer(ptrdiff_t offset) {
         m_buffer.AdvanceCursor(offset);
+        InvalidateVectorConfig();
     }
 
     /// Retrieves the cursor pointer for the underlying code buffer.
@@ -174,6 +216,7 @@ public:
     /// Sets the cursor pointer for the underlying code buffer.
     void SetCursorPointer(uint8_t* ptr) noexcept {
         m_buffer.SetCursorPointer(ptr);
+        InvalidateVectorConfig();
     }
 
     /// Retrieves the pointer to an arbitrary location within the underlying code buffer.
@@ -215,6 +258,63 @@ public:
         m_optimizations &= ~opt;
     }
 
+    /**
+     * Tells the assembler which pairs of adjacent instructions the targeted core fuses.
+     *
+     * Multi-instruction helpers (e.g. LI, CALL, LILiteral, or LoadIndexed) always emit
+     * their pairs in fusible form. Pairs within the profile are additionally kept in
+     * their 32-bit form when AutoCompress is enabled, since that's the form a
+     * fusing core recognizes them in.
+     *
+     * @param profile The pairs the core fuses.
+     *
+     * @note No pairs are assumed to be fused unless a profile is set.
+     */
+    void SetFusionProfile(FusionProfile profile) noexcept {
+        m_fusion_profile = profile;
+    }
+
+    /// Gets the pairs of instructions that the assembler assumes to be fused.
+    [[nodiscard]] FusionProfile GetFusionProfile() const noexcept {
+        return m_fusion_profile;
+    }
+
+    /**
+     * Configures the vector unit for a number of elements of the given type,
+     * using the cheapest form that results in that configuration.
+     *
+     * Nothing is emitted if the configuration is known to be in effect already.
+     * If only the element type changes, while the number of elements and the
+     * ratio of SEW to LMUL stay the same, `VSETVLI zero, zero, ...` is emitted,
+     * which keeps vl. Otherwise `VSETIVLI zero, avl, ...` is emitted.
+     *
+     * This always takes the tracked configuration into account, regardless of
+     * whether Optimization::ElideVectorConfig is enabled.
+     *
+     * @param avl  The application vector length, i.e. the requested number of elements.
+     * @param sew  The element width.
+     * @param lmul The register group multiplier.
+     * @param vta  The tail policy.
+     * @param vma  The mask policy.
+     *
+     * @pre avl must fit in 5 bits.
+     */
+    void SetVectorConfig(uint32_t avl, SEW sew, LMUL lmul = LMUL::M1, VTA vta = VTA::No, VMA vma = VMA::No) noexcept;
+
+    /**
+     * Forgets the tracked vector configuration, so that the next configuring
+     * instruction is always emitted.
+     *
+     * The assembler does this by itself at labels, jumps, calls, and whenever the
+     * cursor is moved through the assembler. This has to be called manually at
+     * any other location that may be reached with a different configuration,
+     * e.g. targets of branches with raw offsets, or after code is emitted
+     * directly into the code buffer.
+     */
+    void InvalidateVectorConfig() noexcept {
+        m_vector_config.reset();
+    }
+
     /**
      * Binds a label to the current offset within the code buffer
      *
@@ -232,6 +332,376 @@ public:
         PlaceAtOffset(literal, m_buffer.GetCursorOffset());
     }
 
+    /**
+     * Pads the code buffer until the cursor address is a multiple of `bytes`.
+     *
+     * NOP padding is made of as few instructions as possible, i.e. 4-byte NOPs,
+     * preceded by a single C.NOP if the cursor is only 2-byte aligned. That can only
+     * be the case after compressed instructions, so the C.NOP is emitted regardless
+     * of whether AutoCompress is enabled.
+     *
+     * Padding is only ever appended, so labels and literals that are linked but
+     * not yet bound or placed are patched correctly once they are. Padding in front
+     * of a literal should use FillPolicy::Zero, e.g.
+     *
+     * @code{.cpp}
+     * as.Align(sizeof(uint64_t), FillPolicy::Zero);
+     * as.Place(&literal);
+     * @endcode
+     *
+     * @param bytes The alignment in bytes.
+     * @param fill  What the padding consists of.
+     *
+     * @pre bytes must be a power of two that's at least 2.
+     * @pre The assembler must not be recording, since the padding
+     *      wouldn't survive the stream being optimized.
+     *
+     * @note Alignment is relative to the address of the code buffer, so it's
+     *       lost if the code is copied to a less aligned address afterwards.
+     */
+    void Align(size_t bytes, FillPolicy fill = FillPolicy::Nop);
+
+    /**
+     * Aligns the head of a loop to the start of a fetch block, so that the
+     * first iteration and every branch back to the head fetches as many
+     * instructions of the loop as possible.
+     *
+     * Since the NOP padding is executed once before entering the loop, alignment
+     * is skipped if it needs more than `max_padding` bytes. In that case, the
+     * head is still aligned to 4 bytes if that fits, so that its first instruction
+     * doesn't straddle a fetch block.
+     *
+     * The label of the loop head should be bound after calling this, e.g.
+     *
+     * @code{.cpp}
+     * as.AlignLoopHead(MachineModel::SiFiveU74().fetch_block_size, 8);
+     * as.Bind(&loop);
+     * // ... loop body ...
+     * as.BNEZ(a0, &loop);
+     * @endcode
+     *
+     * @param fetch_block_size The size of an aligned fetch block of the targeted core in bytes.
+     * @param max_padding      The maximum number of padding bytes to emit.
+     *
+     * @returns Whether or not the cursor is aligned to a fetch block afterwards.
+     *
+     * @pre fetch_block_size must be a power of two that's at least 4.
+     * @pre The assembler must not be recording.
+     */
+    bool AlignLoopHead(size_t fetch_block_size, size_t max_padding);
+
+    /**
+     * Starts recording emitted instructions into an IRStream instead of only
+     * encoding them, so that passes can optimize across instructions.
+     *
+     * Every emitter can be used while recording. Instructions are still encoded
+     * into the code buffer as usual, and EndRecording decodes them back into
+     * an IRStream and removes them from the buffer again. Branches and jumps
+     * refer to labels within the stream, so passes may freely insert, remove,
+     * or reorder instructions. The stream is encoded again with EmitIR.
+     *
+     * The AutoCompress optimization is suspended while recording, so that
+     * passes see uncompressed instructions. It applies again once the stream
+     * is emitted.
+     *
+     * @par
+     * An example of running passes over a block of code:
+     *
+     * @code{.cpp}
+     * IRPassPipeline passes;
+     * passes.Add(MyPass);
+     *
+     * as.BeginRecording();
+     * // ... emit code as usual ...
+     * as.EndRecording(passes);
+     * @endcode
+     *
+     * @pre The assembler must not be recording already.
+     *
+     * @note Labels that are bound while recording are unbound again by EndRecording,
+     *       and only bound for good once the stream is emitted. Labels that are linked
+     *       or bound while recording must therefore outlive the call to EndRecording.
+     *
+     * @note PC-relative address computations other than LILabel (e.g. literal
+     *       loads or AUIPC+JALR calls), relocations, and patchable sequences
+     *       can't be recorded, since their offsets are only known once encoded.
+     *
+     * @note Zcmp and Zcmt instructions can't be recorded along with C.FSDSP,
+     *       since they reuse its encodings.
+     */
+    void BeginRecording();
+
+    /// Determines whether or not the assembler is currently recording.
+    [[nodiscard]] bool IsRecording() const noexcept {
+        return m_recording_start.has_value();
+    }
+
+    /**
+     * Stops recording, and removes the recorded instructions from the code buffer.
+     *
+     * @returns The recorded instructions.
+     *
+     * @pre The assembler must be recording.
+     */
+    [[nodiscard]] IRStream EndRecording();
+
+    /**
+     * Stops recording, runs passes over the recorded instructions,
+     * and emits the result in place of the recorded instructions.
+     *
+     * @param passes The passes to run.
+     *
+     * @pre The assembler must be recording.
+     */
+    void EndRecording(const IRPassPipeline& passes);
+
+    /**
+     * Encodes an instruction stream at the current offset within the code buffer,
+     * through the same emitters that normally encode its instructions.
+     *
+     * @param stream The stream to emit.
+     *
+     * @pre The assembler must not be recording.
+     */
+    void EmitIR(const IRStream& stream);
+
+    /**
+     * Attaches a listener that is notified about code emitted by this assembler.
+     *
+     * @param listener A non-null listener that isn't already attached.
+     *
+     * @note The listener must outlive the assembler, or be removed
+     *       with RemoveCodeListener before it's destroyed.
+     */
+    void AddCodeListener(CodeListener* listener);
+
+    /**
+     * Detaches a listener previously attached with AddCodeListener.
+     *
+     * @param listener The listener to detach.
+     */
+    void RemoveCodeListener(CodeListener* listener);
+
+    /**
+     * Marks the code from `start_offset` up to the current cursor as a complete
+     * function, and notifies all attached code listeners about it.
+     *
+     * @param name         The name of the function.
+     * @param start_offset The offset into the code buffer that the function starts at.
+     *
+     * @pre `start_offset` must be within the range [0, current cursor offset].
+     *
+     * @par
+     * An example of finalizing a function:
+     *
+     * @code{.cpp}
+     * const auto start = as.GetCodeBuffer().GetCursorOffset();
+     * as.ADD(a0, a0, a1);
+     * as.RET();
+     * as.FinalizeFunction("add", start);
+     * @endcode
+     */
+    void FinalizeFunction(std::string_view name, ptrdiff_t start_offset);
+
+    /**
+     * Records a reference to a symbol at the current offset within the code buffer.
+     *
+     * The referencing instruction should be emitted right after this, with
+     * an offset of zero, e.g.
+     *
+     * @code{.cpp}
+     * as.AddRelocation(RelocationType::Call, "helper");
+     * as.AUIPC(ra, 0);
+     * as.JALR(ra, 0, ra);
+     * @endcode
+     *
+     * @param type   The kind of reference.
+     * @param symbol The name of the referenced symbol.
+     * @param addend Constant to add to the address of the symbol.
+     *
+     * @note PCRelLo12I and PCRelLo12S relocations refer to their paired PCRelHi20
+     *       relocation rather than to a symbol, so they must be added with the
+     *       overload taking a Relocation.
+     */
+    void AddRelocation(RelocationType type, std::string_view symbol, int64_t addend = 0);
+
+    /**
+     * Records a reference to a symbol.
+     *
+     * @param relocation The reference to record.
+     *
+     * @pre The relocated bytes must lie within the emitted code.
+     */
+    void AddRelocation(Relocation relocation);
+
+    /// Retrieves all references to symbols recorded with AddRelocation.
+    [[nodiscard]] const std::vector<Relocation>& GetRelocations() const noexcept {
+        return m_relocations;
+    }
+
+    /**
+     * Makes the location of a label visible to other code under a given name.
+     *
+     * @param name  The name of the symbol.
+     * @param label The label to export.
+     * @param size  The size of the entity that the label refers to, or zero if unknown.
+     * @param type  What the label refers to.
+     *
+     * @pre The label must be bound.
+     */
+    void ExportLabel(std::string_view name, const Label* label, size_t size = 0,
+                     SymbolType type = SymbolType::Function);
+
+    /// Retrieves all symbols exported with ExportLabel.
+    [[nodiscard]] const std::vector<ExportedSymbol>& GetExportedSymbols() const noexcept {
+        return m_exported_symbols;
+    }
+
+    /**
+     * Emits a call to an external symbol, in the form of an AUIPC+JALR pair
+     * that links the return address into RA.
+     *
+     * If the symbol is bound and within range, it's called directly. Otherwise
+     * the call goes through the symbol's veneer, or is patched once the symbol
+     * is bound or a veneer is placed for it.
+     *
+     * @param symbol A non-null symbol to call.
+     *
+     * @note Calls through veneers clobber T1, like calls through PLT stubs do.
+     */
+    void CallExternal(ExternalSymbol* symbol);
+
+    /**
+     * Binds an external symbol to an address, and patches every call site
+     * emitted for it so far.
+     *
+     * Sites that are out of range of the address call it through the symbol's
+     * veneer. If the symbol doesn't have a veneer yet, those sites stay pending
+     * until the next call to PlaceExternalVeneers.
+     *
+     * @param symbol  A non-null symbol to bind.
+     * @param address The address to bind the symbol to.
+     *
+     * @pre The symbol must not already be bound.
+     */
+    void BindExternal(ExternalSymbol* symbol, uint64_t address);
+
+    /**
+     * Places veneers for all called external symbols that may need one
+     * at the current offset within the code buffer.
+     *
+     * A veneer is placed for every symbol that is either unbound, or bound with
+     * call sites that are out of range of it. Each symbol receives at most one veneer.
+     *
+     * @note Execution must not fall through into veneers, so they should be
+     *       placed after an unconditional jump or return.
+     */
+    void PlaceExternalVeneers();
+
+    /**
+     * Emits a jump whose destination can be atomically changed later, even
+     * while other harts are executing it. See PatchableJump for details.
+     *
+     * The jump is preceded by as many NOPs as needed to naturally align it.
+     *
+     * @param target The initial destination of the jump, which is also
+     *               the destination that PatchableJump::Unlink returns it to.
+     *
+     * @returns A handle for patching the jump.
+     *
+     * @note The code buffer must not move while the handle is in use,
+     *       as the handle refers to the jump by its address.
+     */
+    [[nodiscard]] PatchableJump EmitPatchableJump(uint64_t target);
+
+    /**
+     * Emits a load of a 64-bit constant whose value can be atomically changed
+     * later with Repatch. See PatchableConstant for details.
+     *
+     * Unlike LI, the emitted sequence has the same shape regardless of the value.
+     * It's preceded by as many NOPs as needed to naturally align its literal.
+     *
+     * @param rd    The register to load the constant into.
+     * @param value The initial value of the constant.
+     *
+     * @returns A handle for repatching the constant.
+     *
+     * @pre rd must not be the zero register.
+     * @pre On RV32, the value must fit in 32 bits.
+     *
+     * @note The code buffer must not move while the handle is in use,
+     *       as the handle refers to the constant by its address.
+     */
+    [[nodiscard]] PatchableConstant EmitPatchableLI(GPR rd, uint64_t value);
+
+    /**
+     * Emits a call whose destination can be atomically changed later with Repatch.
+     * See PatchableCall for details.
+     *
+     * The call is preceded by as many NOPs as needed to naturally align its literal.
+     *
+     * @param target The initial destination of the call.
+     *
+     * @returns A handle for repatching the call.
+     *
+     * @pre On RV32, the destination must fit in 32 bits.
+     *
+     * @note The code buffer must not move while the handle is in use,
+     *       as the handle refers to the call by its address.
+     */
+    [[nodiscard]] PatchableCall EmitPatchableCall(uint64_t target);
+
+    /// Discards all recorded relocations and exported symbols, and stops tracking external symbols.
+    void ClearSymbols() noexcept {
+        m_relocations.clear();
+        m_exported_symbols.clear();
+        m_external_symbols.clear();
+    }
+
+    /**
+     * Loads an address into a register with a single fusible pair where possible.
+     *
+     * Addresses that fit in 32 bits are materialized with LUI+ADDI(W), while
+     * other addresses within +/-2GiB of the current offset are materialized with
+     * AUIPC+ADDI. Any other address falls back to LI.
+     *
+     * @param rd      The register to load the address into.
+     * @param address The address to load.
+     *
+     * @pre rd must not be the zero register.
+     *
+     * @note PC-relative sequences depend on the address of the code buffer,
+     *       so the code buffer must not move afterwards.
+     */
+    void LoadAddress(GPR rd, uint64_t address) noexcept;
+
+    /**
+     * Loads from a register-indexed address as a fusible ADD+load pair,
+     * i.e. `ADD rd, base, index` + a load of `rd, 0(rd)`.
+     *
+     * @param rd    The register to load into.
+     * @param base  The base address.
+     * @param index The byte offset to add to the base address.
+     * @param width The width and signedness of the load.
+     *
+     * @pre rd must not be the zero register.
+     */
+    void LoadIndexed(GPR rd, GPR base, GPR index, LoadWidth width = LoadWidth::Doubleword) noexcept;
+
+    /**
+     * Zero-extends the lower bits of a register.
+     *
+     * Masks that fit in an immediate are applied with ANDI. Wider values are
+     * zero-extended with a fusible `SLLI rd, rs, n` + `SRLI rd, rd, n` pair.
+     *
+     * @param rd   The register to write the result to.
+     * @param rs   The register to zero-extend.
+     * @param bits The number of lower bits to keep.
+     *
+     * @pre bits must be within the range [1, XLEN - 1].
+     */
+    void ZeroExtend(GPR rd, GPR rs, uint32_t bits) noexcept;
+
     // RV32I Instructions
 
     void ADD(GPR rd, GPR lhs, GPR rhs) noexcept;
@@ -308,8 +778,10 @@ public:
         const auto offset = LinkAndGetOffset(literal);
         const auto hi20 = static_cast<int32_t>((static_cast<uint32_t>(offset) + 0x800) >> 12 & 0xFFFFF);
         const auto lo12 = static_cast<int32_t>(offset << 20) >> 20;
-        AUIPC(rd, hi20);
-        ADDI(rd, rd, lo12);
+        EmitPair(FusionProfile::AuipcAddi, [&] {
+            AUIPC(rd, hi20);
+            ADDI(rd, rd, lo12);
+        });
     }
     void LUI(GPR rd, uint32_t imm) noexcept;
     void LW(GPR rd, int32_t imm, GPR rs) noexcept;
@@ -369,8 +841,10 @@ public:
         const auto offset = LinkAndGetOffset(literal);
         const auto hi20 = static_cast<int32_t>((static_cast<uint32_t>(offset) + 0x800) >> 12 & 0xFFFFF);
         const auto lo12 = static_cast<int32_t>(offset << 20) >> 20;
-        AUIPC(rd, hi20);
-        LD(rd, lo12, rd);
+        EmitPair(FusionProfile::AuipcLoad, [&] {
+            AUIPC(rd, hi20);
+            LD(rd, lo12, rd);
+        });
     }
     void LWU(GPR rd, int32_t imm, GPR rs) noexcept;
 
@@ -1704,9 +2178,70 @@ private:
     // offsets into the load instructions that require them.
     void ResolveLiteralOffsetsRaw(ptrdiff_t location, const std::set<ptrdiff_t>& offsets);
 
+    // Points a call site at its symbol, or at the symbol's veneer if the
+    // symbol is out of range. Sites that can't be resolved yet become pending.
+    void ResolveExternalCallSite(ExternalSymbol* symbol, ptrdiff_t offset);
+
+    // A label bound while recording, along with the links to it
+    // from outside of the recording that binding it resolved.
+    struct RecordedBind {
+        ptrdiff_t offset;
+        Label* label;
+        std::vector<ptrdiff_t> external_links;
+    };
+
+    // Emits a PC-relative instruction with its offset resolved against a label.
+    void EmitWithLabel(const Instruction& instruction, Label* label);
+
+    // Determines whether or not a vector configuration is known to be in effect.
+    [[nodiscard]] bool IsVectorConfigInEffect(uint32_t vtype, uint32_t avl) const noexcept {
+        return m_vector_config.has_value() && m_vector_config->vtype == vtype && m_vector_config->avl == avl;
+    }
+
+    // A vector configuration known to be in effect.
+    struct VectorConfig {
+        // The encoded vtype.
+        uint32_t vtype;
+
+        // The AVL that vl was computed from, if known. AVL=VLMAX is represented as vlmax_avl.
+        std::optional<uint32_t> avl;
+    };
+    static constexpr uint32_t vlmax_avl = UINT32_MAX;
+
+    // Emits a pair of instructions. Pairs within the fusion profile are emitted
+    // uncompressed, so that they're in the form the core recognizes them in.
+    template <typename Emitter>
+    void EmitPair(FusionProfile pair, Emitter&& emit) {
+        const auto optimizations = m_optimizations;
+        if ((m_fusion_profile & pair) == pair) {
+            DisableOptimization(Optimization::AutoCompress);
+        }
+        emit();
+        m_optimizations = optimizations;
+    }
+
     CodeBuffer m_buffer;
     ArchFeature m_features = ArchFeature::RV64;
     Optimization m_optimizations = Optimization::None;
+    FusionProfile m_fusion_profile = FusionProfile::None;
+    std::optional<VectorConfig> m_vector_config;
+    std::vector<CodeListener*> m_code_listeners;
+    std::vector<Relocation> m_relocations;
+    std::vector<ExportedSymbol> m_exported_symbols;
+    std::vector<ExternalSymbol*> m_external_symbols;
+
+    // Recording state, see BeginRecording.
+    std::optional<ptrdiff_t> m_recording_start;
+    Optimization m_recording_optimizations = Optimization::None;
+    size_t m_recording_num_relocations = 0;
+    std::map<ptrdiff_t, Label*> m_recorded_links;
+    std::vector<RecordedBind> m_recorded_binds;
+
+    // Whether instructions sharing the C.FSDSP encoding space were recorded,
+    // so that EndRecording decodes them as what they were emitted as.
+    bool m_recorded_zcmp = false;
+    bool m_recorded_zcmt = false;
+    bool m_recorded_fsdsp = false;
 };
 
 } // namespace biscuit
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <biscuit/relocation.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace biscuit {
+
+class Assembler;
+class Profile;
+
+/// The version of the code cache format. Caches written with other versions are rejected.
+constexpr uint32_t code_cache_version = 1;
+
+/// The outcomes of loading a code cache.
+enum class CodeCacheStatus : uint32_t {
+    /// The cache was loaded and relocated.
+    Ok,
+
+    /// The cache couldn't be read, or memory for the code couldn't be allocated.
+    IOError,
+
+    /// The data isn't a code cache, or its contents are malformed.
+    InvalidFormat,
+
+    /// The cache was written with a different version of the format.
+    VersionMismatch,
+
+    /// The contents of the cache don't match its checksum.
+    ChecksumMismatch,
+
+    /// The cache was generated for a different target profile.
+    ProfileMismatch,
+
+    /// A symbol referenced by the code couldn't be resolved.
+    UnresolvedSymbol,
+
+    /// A resolved symbol is out of range of the instruction referencing it.
+    OutOfRange,
+};
+
+/**
+ * Resolves the address of a symbol referenced by cached code, or returns
+ * an empty optional if the symbol is unknown.
+ */
+using SymbolResolver = std::function<std::optional<uint64_t>(std::string_view name)>;
+
+/**
+ * Serializes finalized code into the code cache format.
+ *
+ * The cache contains the code of the assembler, the symbols it exported
+ * (see Assembler::ExportLabel), the references to symbols it recorded
+ * (see Assembler::AddRelocation), and the target profile the code was
+ * generated for.
+ *
+ * References to symbols exported by the code itself are resolved relative to
+ * wherever the code is loaded, so absolute addresses of locations within the
+ * code (e.g. jump tables) can be described by exporting the location and
+ * adding an Absolute64 relocation against it.
+ *
+ * @param assembler The assembler to take the code from.
+ * @param target    The profile the code was generated for.
+ *
+ * @note Branches to labels and literal loads are PC-relative, so code using
+ *       them doesn't need any relocations to be moved.
+ */
+[[nodiscard]] std::vector<uint8_t> SerializeCode(Assembler& assembler, const Profile& target);
+
+/**
+ * Serializes raw code into the code cache format.
+ *
+ * @param code        The code to serialize.
+ * @param symbols     Symbols defined within the code.
+ * @param relocations References to symbols within the code.
+ * @param target      The profile the code was generated for.
+ *
+ * @pre All symbols and relocations must lie within the code.
+ * @pre Every PCRelLo12I and PCRelLo12S relocation must be paired with a PCRelHi20 one.
+ */
+[[nodiscard]] std::vector<uint8_t> SerializeCode(std::span<const uint8_t> code,
+                                                 std::span<const ExportedSymbol> symbols,
+                                                 std::span<const Relocation> relocations,
+                                                 const Profile& target);
+
+/**
+ * Serializes the code of an assembler and writes it to a file.
+ *
+ * The file is written under a temporary name and then renamed over the
+ * destination, so that concurrent loaders never observe a partial cache.
+ *
+ * @param path      The path of the file to write.
+ * @param assembler The assembler to take the code from.
+ * @param target    The profile the code was generated for.
+ *
+ * @returns Whether or not the file was written.
+ */
+[[nodiscard]] bool WriteCodeCache(const std::string& path, Assembler& assembler, const Profile& target);
+
+/**
+ * Executable code loaded from a code cache.
+ *
+ * Loading validates the cache, resolves every symbol referenced by the code,
+ * patches the references in a single pass over the relocations, and then
+ * makes the code executable.
+ *
+ * @par
+ * An example of reusing code across runs:
+ *
+ * @code{.cpp}
+ * const auto target = Profile::FromCPU(CPUInfo{});
+ * const auto resolver = [](std::string_view name) -> std::optional<uint64_t> {
+ *     if (name == "helper") {
+ *         return reinterpret_cast<uintptr_t>(&helper);
+ *     }
+ *     return std::nullopt;
+ * };
+ *
+ * auto cached = CachedCode::Load("kernels.bcc", target, resolver);
+ * if (!cached) {
+ *     Assembler as;
+ *     // ... emit code, export "kernel" ...
+ *     (void)WriteCodeCache("kernels.bcc", as, target);
+ *     cached = CachedCode::Load("kernels.bcc", target, resolver);
+ * }
+ *
+ * auto* kernel = reinterpret_cast<void (*)()>(cached->GetSymbolAddress("kernel"));
+ * @endcode
+ *
+ * @note On Linux, files are mapped into memory directly and the relocated pages
+ *       become private copies. On other platforms the code is copied into
+ *       non-executable memory, much like a CodeBuffer without
+ *       BISCUIT_CODE_BUFFER_MMAP.
+ */
+class CachedCode {
+public:
+    /**
+     * Loads code from a cache file.
+     *
+     * @param path     The path of the file to load.
+     * @param target   The profile that the code must have been generated for.
+     * @param resolver Resolves symbols referenced by the code that it doesn't export itself.
+     * @param status   If not null, receives the reason loading failed, or
+     *                 CodeCacheStatus::Ok if it didn't.
+     *
+     * @returns The loaded code, or an empty optional if the cache was rejected.
+     */
+    [[nodiscard]] static std::optional<CachedCode> Load(const std::string& path, const Profile& target,
+                                                        const SymbolResolver& resolver,
+                                                        CodeCacheStatus* status = nullptr);
+
+    /**
+     * Loads code from a cache held in memory.
+     *
+     * @param data     The contents of the cache.
+     * @param target   The profile that the code must have been generated for.
+     * @param resolver Resolves symbols referenced by the code that it doesn't export itself.
+     * @param status   If not null, receives the reason loading failed, or
+     *                 CodeCacheStatus::Ok if it didn't.
+     *
+     * @returns The loaded code, or an empty optional if the cache was rejected.
+     */
+    [[nodiscard]] static std::optional<CachedCode> Load(std::span<const uint8_t> data, const Profile& target,
+                                                        const SymbolResolver& resolver,
+                                                        CodeCacheStatus* status = nullptr);
+
+    CachedCode(const CachedCode&) = delete;
+    CachedCode& operator=(const CachedCode&) = delete;
+
+    CachedCode(CachedCode&& other) noexcept;
+    CachedCode& operator=(CachedCode&& other) noexcept;
+
+    ~CachedCode() noexcept;
+
+    /// Retrieves a pointer to the start of the loaded code.
+    [[nodiscard]] const uint8_t* GetCode() const noexcept {
+        return m_memory + m_code_offset;
+    }
+
+    /// Retrieves the size of the loaded code in bytes.
+    [[nodiscard]] size_t GetSizeInBytes() const noexcept {
+        return m_code_size;
+    }
+
+    /// Retrieves all symbols exported by the loaded code.
+    [[nodiscard]] const std::vector<ExportedSymbol>& GetSymbols() const noexcept {
+        return m_symbols;
+    }
+
+    /**
+     * Retrieves the address of a symbol exported by the loaded code.
+     *
+     * @param name The name of the symbol.
+     *
+     * @returns The address of the symbol, or nullptr if the code doesn't export it.
+     */
+    [[nodiscard]] const void* GetSymbolAddress(std::string_view name) const noexcept;
+
+private:
+    CachedCode() = default;
+
+    uint8_t* m_memory = nullptr;
+    size_t m_memory_size = 0;
+    size_t m_code_offset = 0;
+    size_t m_code_size = 0;
+    std::vector<ExportedSymbol> m_symbols;
+};
+
+} // namespace biscuit
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace biscuit {
+
+/// Describes a function that an assembler has finished emitting.
+struct FinalizedFunction {
+    /// The name of the function.
+    std::string_view name;
+
+    /// Pointer to the first byte of the function's code.
+    const uint8_t* code = nullptr;
+
+    /// The size of the function's code in bytes.
+    size_t size = 0;
+};
+
+/**
+ * Interface for receiving notifications about code emitted by an Assembler.
+ *
+ * Listeners are attached to an assembler with Assembler::AddCodeListener and
+ * are notified whenever Assembler::FinalizeFunction is called. This allows
+ * tools such as profilers and debuggers to be informed about generated code.
+ *
+ * @par
+ * An example of a listener:
+ *
+ * @code{.cpp}
+ * class Logger final : public CodeListener {
+ * public:
+ *     void OnFunctionFinalized(const FinalizedFunction& function) override {
+ *         std::printf("%.*s: %zu bytes\n", int(function.name.size()),
+ *                     function.name.data(), function.size);
+ *     }
+ * };
+ * @endcode
+ *
+ * @note A listener may be attached to multiple assemblers, so implementations must
+ *       be safe to call from multiple threads if those assemblers are used concurrently.
+ */
+class CodeListener {
+public:
+    virtual ~CodeListener() = default;
+
+    /**
+     * Called after a function has been fully emitted.
+     *
+     * @param function Describes the finalized function. The name is only
+     *                 guaranteed to be valid for the duration of the call.
+     */
+    virtual void OnFunctionFinalized(const FinalizedFunction& function) = 0;
+};
+
+} // namespace biscuit
@@ -8,8 +8,10 @@
 
 #include <biscuit/assembler.hpp>
 #include <biscuit/registers.hpp>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <initializer_list>
 
 namespace biscuit {
 
@@ -75,7 +77,90 @@ enum class RISCVExtension : uint64_t {
     Zvfbfwma,
     Zicbom,
     Zaamo,
-    Zalrsc
+    Zalrsc,
+    Zcmp
+};
+
+/**
+ * A set of RISC-V extensions.
+ *
+ * Used for describing the capabilities that a piece of generated code
+ * requires or that a particular CPU provides.
+ */
+class ExtensionSet {
+public:
+    constexpr ExtensionSet() noexcept = default;
+
+    constexpr ExtensionSet(std::initializer_list<RISCVExtension> extensions) noexcept {
+        for (const auto extension : extensions) {
+            Add(extension);
+        }
+    }
+
+    /// Adds an extension to the set.
+    constexpr void Add(RISCVExtension extension) noexcept {
+        m_bits |= ToBit(extension);
+    }
+
+    /// Removes an extension from the set.
+    constexpr void Remove(RISCVExtension extension) noexcept {
+        m_bits &= ~ToBit(extension);
+    }
+
+    /// Whether or not the given extension is within the set.
+    [[nodiscard]] constexpr bool Has(RISCVExtension extension) const noexcept {
+        return (m_bits & ToBit(extension)) != 0;
+    }
+
+    /// Whether or not every extension in this set is also within `other`.
+    [[nodiscard]] constexpr bool IsSubsetOf(const ExtensionSet& other) const noexcept {
+        return (m_bits & ~other.m_bits) == 0;
+    }
+
+    /// Whether or not the set contains no extensions.
+    [[nodiscard]] constexpr bool IsEmpty() const noexcept {
+        return m_bits == 0;
+    }
+
+    /// Retrieves the number of extensions within the set.
+    [[nodiscard]] constexpr uint32_t Count() const noexcept {
+        return static_cast<uint32_t>(std::popcount(m_bits));
+    }
+
+    /// Retrieves the raw bit representation of the set.
+    [[nodiscard]] constexpr uint64_t GetBits() const noexcept {
+        return m_bits;
+    }
+
+    constexpr ExtensionSet& operator|=(const ExtensionSet& other) noexcept {
+        m_bits |= other.m_bits;
+        return *this;
+    }
+    constexpr ExtensionSet& operator&=(const ExtensionSet& other) noexcept {
+        m_bits &= other.m_bits;
+        return *this;
+    }
+
+    [[nodiscard]] friend constexpr ExtensionSet operator|(ExtensionSet lhs, const ExtensionSet& rhs) noexcept {
+        lhs |= rhs;
+        return lhs;
+    }
+    [[nodiscard]] friend constexpr ExtensionSet operator&(ExtensionSet lhs, const ExtensionSet& rhs) noexcept {
+        lhs &= rhs;
+        return lhs;
+    }
+
+    friend constexpr bool operator==(const ExtensionSet&, const ExtensionSet&) = default;
+
+private:
+    [[nodiscard]] static constexpr uint64_t ToBit(RISCVExtension extension) noexcept {
+        return uint64_t{1} << static_cast<uint64_t>(extension);
+    }
+
+    // Every RISCVExtension value must be representable as a single bit.
+    static_assert(static_cast<uint64_t>(RISCVExtension::Zcmp) < 64);
+
+    uint64_t m_bits = 0;
 };
 
 template <CSR csr>
@@ -115,6 +200,16 @@ public:
      */
     bool Has(RISCVExtension extension) const;
 
+    /**
+     * Checks if every extension within a set is available.
+     *
+     * @param extensions The extensions to check.
+     *
+     * @note Detection stops at the first missing extension, so the
+     *       remaining extensions in the set are never probed.
+     */
+    bool HasAll(const ExtensionSet& extensions) const;
+
     /// Returns the vector register length in bytes.
     uint32_t GetVlenb() const;
 };
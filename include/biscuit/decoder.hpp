@@ -0,0 +1,382 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/enum_utils.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace biscuit {
+
+/**
+ * Identifies a decoded instruction.
+ *
+ * There is one opcode for every instruction biscuit can emit. Instructions
+ * that have multiple operand forms (e.g. VADD, which has vector, scalar
+ * and immediate forms) have one opcode per form, distinguished by a suffix.
+ *
+ * Pseudo-instructions (e.g. MV, LI, RET) are not given opcodes, since they
+ * decode to the underlying instruction that they're implemented with.
+ */
+enum class Opcode : uint16_t {
+    // RV32I Instructions
+    ADD, ADDI, AND, ANDI, AUIPC, BEQ, BGE, BGEU, BLT, BLTU, BNE, EBREAK, ECALL, FENCE, FENCEI,
+    FENCETSO, JAL, JALR, LB, LBU, LH, LHU, LUI, LW, OR, ORI, PAUSE, SB, SH, SW, SLL, SLLI, SLT,
+    SLTI, SLTIU, SLTU, SRA, SRAI, SRL, SRLI, SUB, XOR, XORI,
+
+    // RV64I Base Instruction Set
+    ADDIW, ADDW, LD, LWU, SD, SLLIW, SRAIW, SRLIW, SLLW, SRAW, SRLW, SUBW,
+
+    // Zawrs Extension Instructions
+    WRS_NTO, WRS_STO,
+
+    // Zacas Extension Instructions
+    AMOCAS_D, AMOCAS_Q, AMOCAS_W,
+
+    // Zabha Extension Instructions
+    AMOADD_B, AMOAND_B, AMOMAX_B, AMOMAXU_B, AMOMIN_B, AMOMINU_B, AMOOR_B, AMOSWAP_B, AMOXOR_B,
+    AMOCAS_B, AMOADD_H, AMOAND_H, AMOMAX_H, AMOMAXU_H, AMOMIN_H, AMOMINU_H, AMOOR_H, AMOSWAP_H,
+    AMOXOR_H, AMOCAS_H,
+
+    // Zicond Extension Instructions
+    CZERO_EQZ, CZERO_NEZ,
+
+    // Zalasr Extension Instructions
+    LB_AQ, LH_AQ, LW_AQ, LD_AQ, SB_RL, SH_RL, SW_RL, SD_RL,
+
+    // XTheadCondMov Extension Instructions
+    TH_MVEQZ, TH_MVNEZ,
+
+    // XTheadBa Extension Instructions
+    TH_ADDSL,
+
+    // Zicsr Extension Instructions
+    CSRRC, CSRRCI, CSRRS, CSRRSI, CSRRW, CSRRWI,
+
+    // Zihintntl Extension Instructions
+    C_NTL_ALL, C_NTL_S1, C_NTL_P1, C_NTL_PALL, NTL_ALL, NTL_S1, NTL_P1, NTL_PALL,
+
+    // RV32M Extension Instructions
+    DIV, DIVU, MUL, MULH, MULHSU, MULHU, REM, REMU,
+
+    // RV64M Extension Instructions
+    DIVW, DIVUW, MULW, REMW, REMUW,
+
+    // RV32A Extension Instructions
+    AMOADD_W, AMOAND_W, AMOMAX_W, AMOMAXU_W, AMOMIN_W, AMOMINU_W, AMOOR_W, AMOSWAP_W, AMOXOR_W,
+    LR_W, SC_W,
+
+    // RV64A Extension Instructions
+    AMOADD_D, AMOAND_D, AMOMAX_D, AMOMAXU_D, AMOMIN_D, AMOMINU_D, AMOOR_D, AMOSWAP_D, AMOXOR_D,
+    LR_D, SC_D,
+
+    // RV32F Extension Instructions
+    FADD_S, FCLASS_S, FCVT_S_W, FCVT_S_WU, FCVT_W_S, FCVT_WU_S, FDIV_S, FEQ_S, FLE_S, FLT_S, FLW,
+    FMADD_S, FMAX_S, FMIN_S, FMSUB_S, FMUL_S, FMV_W_X, FMV_X_W, FNMADD_S, FNMSUB_S, FSGNJ_S,
+    FSGNJN_S, FSGNJX_S, FSQRT_S, FSUB_S, FSW,
+
+    // RV64F Extension Instructions
+    FCVT_L_S, FCVT_LU_S, FCVT_S_L, FCVT_S_LU,
+
+    // RV32D Extension Instructions
+    FADD_D, FCLASS_D, FCVT_D_W, FCVT_D_WU, FCVT_W_D, FCVT_WU_D, FCVT_D_S, FCVT_S_D, FDIV_D, FEQ_D,
+    FLE_D, FLT_D, FLD, FMADD_D, FMAX_D, FMIN_D, FMSUB_D, FMUL_D, FNMADD_D, FNMSUB_D, FSGNJ_D,
+    FSGNJN_D, FSGNJX_D, FSQRT_D, FSUB_D, FSD,
+
+    // RV64D Extension Instructions
+    FCVT_L_D, FCVT_LU_D, FCVT_D_L, FCVT_D_LU, FMV_D_X, FMV_X_D,
+
+    // RV32Q Extension Instructions
+    FADD_Q, FCLASS_Q, FCVT_Q_W, FCVT_Q_WU, FCVT_W_Q, FCVT_WU_Q, FCVT_Q_D, FCVT_D_Q, FCVT_Q_S,
+    FCVT_S_Q, FDIV_Q, FEQ_Q, FLE_Q, FLT_Q, FLQ, FMADD_Q, FMAX_Q, FMIN_Q, FMSUB_Q, FMUL_Q, FNMADD_Q,
+    FNMSUB_Q, FSGNJ_Q, FSGNJN_Q, FSGNJX_Q, FSQRT_Q, FSUB_Q, FSQ,
+
+    // RV64Q Extension Instructions
+    FCVT_L_Q, FCVT_LU_Q, FCVT_Q_L, FCVT_Q_LU,
+
+    // RV32Zfh Extension Instructions
+    FADD_H, FCLASS_H, FCVT_D_H, FCVT_H_D, FCVT_H_Q, FCVT_H_S, FCVT_H_W, FCVT_H_WU, FCVT_Q_H,
+    FCVT_S_H, FCVT_W_H, FCVT_WU_H, FDIV_H, FEQ_H, FLE_H, FLH, FLT_H, FMADD_H, FMAX_H, FMIN_H,
+    FMSUB_H, FMUL_H, FMV_H_X, FMV_X_H, FNMADD_H, FNMSUB_H, FSGNJ_H, FSGNJN_H, FSGNJX_H, FSH,
+    FSQRT_H, FSUB_H,
+
+    // RV64Zfh Extension Instructions
+    FCVT_L_H, FCVT_LU_H, FCVT_H_L, FCVT_H_LU,
+
+    // Zfa Extension Instructions
+    FLI_D, FLI_H, FLI_S, FMINM_D, FMINM_H, FMINM_Q, FMINM_S, FMAXM_D, FMAXM_H, FMAXM_Q, FMAXM_S,
+    FROUND_D, FROUND_H, FROUND_Q, FROUND_S, FROUNDNX_D, FROUNDNX_H, FROUNDNX_Q, FROUNDNX_S,
+    FCVTMOD_W_D, FMVH_X_D, FMVH_X_Q, FMVP_D_X, FMVP_Q_X, FLEQ_D, FLTQ_D, FLEQ_H, FLTQ_H, FLEQ_Q,
+    FLTQ_Q, FLEQ_S, FLTQ_S,
+
+    // Zfbfmin Extension Instructions
+    FCVT_BF16_S, FCVT_S_BF16,
+
+    // B Extension Instructions
+    ADDUW, ANDN, BCLR, BCLRI, BEXT, BEXTI, BINV, BINVI, BREV8, BSET, BSETI, CLMUL, CLMULH, CLMULR,
+    CLZ, CLZW, CPOP, CPOPW, CTZ, CTZW, MAX, MAXU, MIN, MINU, ORCB, ORN, PACK, PACKH, PACKW, REV8,
+    ROL, ROLW, ROR, RORI, RORIW, RORW, SEXTB, SEXTH, SH1ADD, SH1ADDUW, SH2ADD, SH2ADDUW, SH3ADD,
+    SH3ADDUW, SLLIUW, UNZIP, XNOR, XPERM4, XPERM8, ZEXTH, ZIP,
+
+    // Scalar Cryptography (RVK) instructions
+    AES32DSI, AES32DSMI, AES32ESI, AES32ESMI, AES64DS, AES64DSM, AES64ES, AES64ESM, AES64IM,
+    AES64KS1I, AES64KS2, SHA256SIG0, SHA256SIG1, SHA256SUM0, SHA256SUM1, SHA512SIG0, SHA512SIG0H,
+    SHA512SIG0L, SHA512SIG1, SHA512SIG1H, SHA512SIG1L, SHA512SUM0, SHA512SUM0R, SHA512SUM1,
+    SHA512SUM1R, SM3P0, SM3P1, SM4ED, SM4KS,
+
+    // RVC Extension Instructions
+    C_ADD, C_ADDI, C_ADDIW, C_ADDI4SPN, C_ADDI16SP, C_ADDW, C_AND, C_ANDI, C_BEQZ, C_BNEZ, C_EBREAK,
+    C_FLD, C_FLDSP, C_FLW, C_FLWSP, C_FSD, C_FSDSP, C_FSW, C_FSWSP, C_J, C_JAL, C_JALR, C_JR, C_LD,
+    C_LDSP, C_LI, C_LQ, C_LQSP, C_LUI, C_LW, C_LWSP, C_MV, C_NOP, C_OR, C_SD, C_SDSP, C_SLLI, C_SQ,
+    C_SQSP, C_SRAI, C_SRLI, C_SUB, C_SUBW, C_SW, C_SWSP, C_UNDEF, C_XOR,
+
+    // Zc Extension Instructions
+    C_LBU, C_LH, C_LHU, C_SB, C_SH, C_SEXT_B, C_SEXT_H, C_ZEXT_B, C_ZEXT_H, C_ZEXT_W, C_MUL, C_NOT,
+    CM_MVA01S, CM_MVSA01, CM_POP, CM_POPRET, CM_POPRETZ, CM_PUSH, CM_JALT, CM_JT,
+
+    // Cache Management Operation Extension Instructions
+    CBO_CLEAN, CBO_FLUSH, CBO_INVAL, CBO_ZERO, PREFETCH_I, PREFETCH_R, PREFETCH_W, SSAMOSWAP_D,
+    SSAMOSWAP_W, SSRDP, SSPOPCHK, SSPUSH, C_SSPOPCHK, C_SSPUSH, LPAD,
+
+    // Privileged Instructions
+    HFENCE_GVMA, HFENCE_VVMA, HINVAL_GVMA, HINVAL_VVMA, HLV_B, HLV_BU, HLV_D, HLV_H, HLV_HU, HLV_W,
+    HLV_WU, HLVX_HU, HLVX_WU, HSV_B, HSV_D, HSV_H, HSV_W, MRET, SCTRCLR, SFENCE_INVAL_IR,
+    SFENCE_VMA, SFENCE_W_INVAL, SINVAL_VMA, SRET, URET, WFI,
+
+    // Vector Integer Instructions
+    VAADD_VV, VAADD_VX, VAADDU_VV, VAADDU_VX, VADC_VVM, VADC_VXM, VADC_VIM, VADD_VV, VADD_VX,
+    VADD_VI, VAND_VV, VAND_VX, VAND_VI, VASUB_VV, VASUB_VX, VASUBU_VV, VASUBU_VX, VCOMPRESS,
+    VDIV_VV, VDIV_VX, VDIVU_VV, VDIVU_VX, VFIRST, VID, VIOTA, VMACC_VV, VMACC_VX, VMADC_VV,
+    VMADC_VX, VMADC_VI, VMADD_VV, VMADD_VX, VMAND, VMANDNOT, VMNAND, VMNOR, VMOR, VMORNOT, VMXNOR,
+    VMXOR, VMAX_VV, VMAX_VX, VMAXU_VV, VMAXU_VX, VMERGE_VVM, VMERGE_VXM, VMERGE_VIM, VMIN_VV,
+    VMIN_VX, VMINU_VV, VMINU_VX, VMSBC_VV, VMSBC_VX, VMSBF, VMSIF, VMSOF, VMSEQ_VV, VMSEQ_VX,
+    VMSEQ_VI, VMSGT_VX, VMSGT_VI, VMSGTU_VX, VMSGTU_VI, VMSLE_VV, VMSLE_VX, VMSLE_VI, VMSLEU_VV,
+    VMSLEU_VX, VMSLEU_VI, VMSLT_VV, VMSLT_VX, VMSLTU_VV, VMSLTU_VX, VMSNE_VV, VMSNE_VX, VMSNE_VI,
+    VMUL_VV, VMUL_VX, VMULH_VV, VMULH_VX, VMULHSU_VV, VMULHSU_VX, VMULHU_VV, VMULHU_VX, VMV_VV,
+    VMV_VX, VMV_VI, VMV1R, VMV2R, VMV4R, VMV8R, VMV_SX, VMV_XS, VNCLIP_VV, VNCLIP_VX, VNCLIP_VI,
+    VNCLIPU_VV, VNCLIPU_VX, VNCLIPU_VI, VNMSAC_VV, VNMSAC_VX, VNMSUB_VV, VNMSUB_VX, VNSRA_VV,
+    VNSRA_VX, VNSRA_VI, VNSRL_VV, VNSRL_VX, VNSRL_VI, VOR_VV, VOR_VX, VOR_VI, VPOPC, VREDAND,
+    VREDMAX, VREDMAXU, VREDMIN, VREDMINU, VREDOR, VREDSUM, VREDXOR, VREM_VV, VREM_VX, VREMU_VV,
+    VREMU_VX, VRGATHER_VV, VRGATHER_VX, VRGATHER_VI, VRGATHEREI16, VRSUB_VX, VRSUB_VI, VSADD_VV,
+    VSADD_VX, VSADD_VI, VSADDU_VV, VSADDU_VX, VSADDU_VI, VSBC_VVM, VSBC_VXM, VSEXTVF2, VSEXTVF4,
+    VSEXTVF8, VSLIDE1DOWN, VSLIDEDOWN_VX, VSLIDEDOWN_VI, VSLIDE1UP, VSLIDEUP_VX, VSLIDEUP_VI,
+    VSLL_VV, VSLL_VX, VSLL_VI, VSMUL_VV, VSMUL_VX, VSRA_VV, VSRA_VX, VSRA_VI, VSRL_VV, VSRL_VX,
+    VSRL_VI, VSSRA_VV, VSSRA_VX, VSSRA_VI, VSSRL_VV, VSSRL_VX, VSSRL_VI, VSSUB_VV, VSSUB_VX,
+    VSSUBU_VV, VSSUBU_VX, VSUB_VV, VSUB_VX, VWADD_VV, VWADD_VX, VWADDW_VV, VWADDW_VX, VWADDU_VV,
+    VWADDU_VX, VWADDUW_VV, VWADDUW_VX, VWMACC_VV, VWMACC_VX, VWMACCSU_VV, VWMACCSU_VX, VWMACCU_VV,
+    VWMACCU_VX, VWMACCUS, VWMUL_VV, VWMUL_VX, VWMULSU_VV, VWMULSU_VX, VWMULU_VV, VWMULU_VX,
+    VWREDSUM, VWREDSUMU, VWSUB_VV, VWSUB_VX, VWSUBW_VV, VWSUBW_VX, VWSUBU_VV, VWSUBU_VX, VWSUBUW_VV,
+    VWSUBUW_VX, VXOR_VV, VXOR_VX, VXOR_VI, VZEXTVF2, VZEXTVF4, VZEXTVF8,
+
+    // Vector Floating-Point Instructions
+    VFADD_VV, VFADD_VF, VFCLASS, VFCVT_F_X, VFCVT_F_XU, VFCVT_RTZ_X_F, VFCVT_RTZ_XU_F, VFCVT_X_F,
+    VFCVT_XU_F, VFNCVT_F_F, VFNCVT_F_X, VFNCVT_F_XU, VFNCVT_ROD_F_F, VFNCVT_RTZ_X_F,
+    VFNCVT_RTZ_XU_F, VFNCVT_X_F, VFNCVT_XU_F, VFWCVT_F_F, VFWCVT_F_X, VFWCVT_F_XU, VFWCVT_RTZ_X_F,
+    VFWCVT_RTZ_XU_F, VFWCVT_X_F, VFWCVT_XU_F, VFDIV_VV, VFDIV_VF, VFRDIV, VFREDMAX, VFREDMIN,
+    VFREDSUM, VFREDOSUM, VFMACC_VV, VFMACC_VF, VFMADD_VV, VFMADD_VF, VFMAX_VV, VFMAX_VF, VFMERGE,
+    VFMIN_VV, VFMIN_VF, VFMSAC_VV, VFMSAC_VF, VFMSUB_VV, VFMSUB_VF, VFMUL_VV, VFMUL_VF, VFMV,
+    VFMV_FS, VFMV_SF, VFNMACC_VV, VFNMACC_VF, VFNMADD_VV, VFNMADD_VF, VFNMSAC_VV, VFNMSAC_VF,
+    VFNMSUB_VV, VFNMSUB_VF, VFREC7, VFSGNJ_VV, VFSGNJ_VF, VFSGNJN_VV, VFSGNJN_VF, VFSGNJX_VV,
+    VFSGNJX_VF, VFSQRT, VFRSQRT7, VFSLIDE1DOWN, VFSLIDE1UP, VFSUB_VV, VFSUB_VF, VFRSUB, VFWADD_VV,
+    VFWADD_VF, VFWADDW_VV, VFWADDW_VF, VFWMACC_VV, VFWMACC_VF, VFWMUL_VV, VFWMUL_VF, VFWNMACC_VV,
+    VFWNMACC_VF, VFWNMSAC_VV, VFWNMSAC_VF, VFWREDSUM, VFWREDOSUM, VFWMSAC_VV, VFWMSAC_VF, VFWSUB_VV,
+    VFWSUB_VF, VFWSUBW_VV, VFWSUBW_VF, VMFEQ_VV, VMFEQ_VF, VMFGE, VMFGT, VMFLE_VV, VMFLE_VF,
+    VMFLT_VV, VMFLT_VF, VMFNE_VV, VMFNE_VF,
+
+    // Vector Load/Store Instructions
+    VLE8, VLE16, VLE32, VLE64, VLM, VLSE8, VLSE16, VLSE32, VLSE64, VLOXEI8, VLOXEI16, VLOXEI32,
+    VLOXEI64, VLUXEI8, VLUXEI16, VLUXEI32, VLUXEI64, VLE8FF, VLE16FF, VLE32FF, VLE64FF, VLSEGE8,
+    VLSEGE16, VLSEGE32, VLSEGE64, VLSSEGE8, VLSSEGE16, VLSSEGE32, VLSSEGE64, VLOXSEGEI8,
+    VLOXSEGEI16, VLOXSEGEI32, VLOXSEGEI64, VLUXSEGEI8, VLUXSEGEI16, VLUXSEGEI32, VLUXSEGEI64,
+    VL1RE8, VL2RE8, VL4RE8, VL8RE8, VL1RE16, VL2RE16, VL4RE16, VL8RE16, VL1RE32, VL2RE32, VL4RE32,
+    VL8RE32, VL1RE64, VL2RE64, VL4RE64, VL8RE64, VSE8, VSE16, VSE32, VSE64, VSM, VSSE8, VSSE16,
+    VSSE32, VSSE64, VSOXEI8, VSOXEI16, VSOXEI32, VSOXEI64, VSUXEI8, VSUXEI16, VSUXEI32, VSUXEI64,
+    VSSEGE8, VSSEGE16, VSSEGE32, VSSEGE64, VSSSEGE8, VSSSEGE16, VSSSEGE32, VSSSEGE64, VSOXSEGEI8,
+    VSOXSEGEI16, VSOXSEGEI32, VSOXSEGEI64, VSUXSEGEI8, VSUXSEGEI16, VSUXSEGEI32, VSUXSEGEI64, VS1R,
+    VS2R, VS4R, VS8R,
+
+    // Vector Configuration Setting Instructions
+    VSETIVLI, VSETVL, VSETVLI,
+
+    // Vector Cryptography Instructions
+    VANDN_VV, VANDN_VX, VBREV, VBREV8, VREV8, VCLZ, VCTZ, VCPOP, VROL_VV, VROL_VX, VROR_VV, VROR_VX,
+    VROR_VI, VWSLL_VV, VWSLL_VX, VWSLL_VI, VCLMUL_VV, VCLMUL_VX, VCLMULH_VV, VCLMULH_VX, VGHSH,
+    VGMUL, VAESDF_VV, VAESDF_VS, VAESDM_VV, VAESDM_VS, VAESEF_VV, VAESEF_VS, VAESEM_VV, VAESEM_VS,
+    VAESKF1, VAESKF2, VAESZ, VSHA2MS, VSHA2CH, VSHA2CL, VSM4K, VSM4R_VV, VSM4R_VS, VSM3C, VSM3ME,
+
+    // Zvfbfmin, Zvfbfwma Extension Instructions
+    VFNCVTBF16_F_F_W, VFWCVTBF16_F_F_V, VFWMACCBF16_VF, VFWMACCBF16_VV,
+
+    // Unknown or unsupported encoding.
+    Invalid,
+};
+
+/// Describes how the value of an instruction operand should be interpreted.
+enum class OperandType : uint8_t {
+    None,         //< Unused operand slot.
+    GPR,          //< General-purpose register index.
+    FPR,          //< Floating-point register index.
+    Vec,          //< Vector register index.
+    Imm,          //< Immediate value.
+    PCOffset,     //< Immediate offset relative to the address of the instruction.
+    CSR,          //< CSR number.
+    RMode,        //< Floating-point rounding mode.
+    Ordering,     //< Atomic memory ordering.
+    FenceOrder,   //< Fence predecessor or successor set.
+    VecMask,      //< Vector mask (see VecMask).
+    VType,        //< Vector type immediate as encoded in VSETVLI and VSETIVLI.
+    RegList,      //< Zcmp register list (rlist) encoding.
+    FloatConstant //< Index into the constant table used by FLI instructions.
+};
+
+/// A single decoded instruction operand.
+struct Operand {
+    OperandType type = OperandType::None;
+    int32_t value = 0;
+
+    friend bool operator==(const Operand&, const Operand&) = default;
+};
+
+/// Options that alter how instructions are decoded.
+enum class DecodeOptions : uint32_t {
+    None = 0,
+
+    /**
+     * Decodes the Zcmp instructions (CM.PUSH, CM.POP, CM.MVA01S, etc).
+     *
+     * These reuse the encoding space of C.FSDSP, so both can't be
+     * decoded at the same time.
+     */
+    Zcmp = 1U << 0,
+
+    /**
+     * Decodes the Zcmt instructions (CM.JT and CM.JALT).
+     *
+     * These reuse the encoding space of C.FSDSP, so both can't be
+     * decoded at the same time.
+     */
+    Zcmt = 1U << 1,
+};
+BISCUIT_DEFINE_ENUM_FLAG_OPERATORS(DecodeOptions);
+
+/**
+ * A decoded instruction.
+ *
+ * Operands are stored in the same order as the parameters of the Assembler
+ * function that emits the instruction. For example, a decoded SW instruction
+ * has the operands (rs2, imm, rs1), since it's emitted with SW(rs2, imm, rs1).
+ */
+struct Instruction {
+    /// Maximum number of operands any instruction can have.
+    static constexpr size_t max_operands = 5;
+
+    /// The decoded opcode. Opcode::Invalid if the encoding wasn't recognized.
+    Opcode opcode = Opcode::Invalid;
+
+    /// Size of the instruction in bytes.
+    uint8_t size = 0;
+
+    /// Number of valid entries within `operands`.
+    uint8_t num_operands = 0;
+
+    /// The raw encoding of the instruction. Only the lower 16 bits
+    /// are used for compressed instructions.
+    uint32_t encoding = 0;
+
+    /// The decoded operands.
+    std::array<Operand, max_operands> operands{};
+
+    /// Whether or not the instruction was successfully decoded.
+    [[nodiscard]] bool IsValid() const noexcept {
+        return opcode != Opcode::Invalid;
+    }
+
+    /// Whether or not this is a compressed (16-bit) instruction.
+    [[nodiscard]] bool IsCompressed() const noexcept {
+        return size == 2;
+    }
+
+    /// Retrieves a view of all valid operands.
+    [[nodiscard]] std::span<const Operand> GetOperands() const noexcept {
+        return {operands.data(), num_operands};
+    }
+
+    /// Retrieves the operand at the given index as a general-purpose register.
+    [[nodiscard]] GPR GetGPR(size_t index) const noexcept {
+        BISCUIT_ASSERT(index < num_operands && operands[index].type == OperandType::GPR);
+        return GPR{static_cast<uint32_t>(operands[index].value)};
+    }
+
+    /// Retrieves the operand at the given index as a floating-point register.
+    [[nodiscard]] FPR GetFPR(size_t index) const noexcept {
+        BISCUIT_ASSERT(index < num_operands && operands[index].type == OperandType::FPR);
+        return FPR{static_cast<uint32_t>(operands[index].value)};
+    }
+
+    /// Retrieves the operand at the given index as a vector register.
+    [[nodiscard]] Vec GetVec(size_t index) const noexcept {
+        BISCUIT_ASSERT(index < num_operands && operands[index].type == OperandType::Vec);
+        return Vec{static_cast<uint32_t>(operands[index].value)};
+    }
+
+    /// Retrieves the raw value of the operand at the given index.
+    [[nodiscard]] int32_t GetValue(size_t index) const noexcept {
+        BISCUIT_ASSERT(index < num_operands);
+        return operands[index].value;
+    }
+};
+
+/**
+ * Decodes a single instruction.
+ *
+ * Decoding is table-driven. The tables are derived from the Assembler's own
+ * emitters the first time any instruction is decoded, so every instruction
+ * biscuit can emit is also recognized by the decoder. Lookups only inspect
+ * a few fixed bit fields of the instruction to narrow down the candidates,
+ * which makes this suitable for scanning large amounts of generated code.
+ *
+ * @param code     Pointer to the instruction to decode. Only the bytes that belong
+ *                 to the instruction are read (i.e. 2 bytes for compressed instructions).
+ * @param features The architecture to decode for. This affects encodings that differ
+ *                 between RV32 and RV64 (e.g. C.JAL vs C.ADDIW or REV8).
+ * @param options  Options that alter decoding behavior.
+ *
+ * @returns The decoded instruction. If the encoding isn't recognized, the opcode is
+ *          Opcode::Invalid and the size still indicates the instruction length,
+ *          so that scanning can continue past it.
+ *
+ * @note Encodings that only differ from a recognized instruction in reserved
+ *       or hint operands (e.g. C.ADDI with rd = x0) are treated as invalid.
+ */
+[[nodiscard]] Instruction Decode(const uint8_t* code, ArchFeature features = ArchFeature::RV64,
+                                 DecodeOptions options = DecodeOptions::None) noexcept;
+
+/**
+ * Emits a decoded instruction through the given assembler.
+ *
+ * The instruction is emitted with the same Assembler function that normally
+ * emits it, so the output is identical to the originally decoded bytes as
+ * long as the assembler's features match the features that were decoded with.
+ *
+ * @param as          The assembler to emit the instruction with.
+ * @param instruction The instruction to emit.
+ *
+ * @pre `instruction` must be valid.
+ *
+ * @note If the assembler has the AutoCompress optimization enabled, then
+ *       uncompressed instructions may be emitted in their compressed form.
+ */
+void Encode(Assembler& as, const Instruction& instruction);
+
+/**
+ * Retrieves the lowercase assembly mnemonic of an opcode (e.g. "c.addi" or "vadd.vv").
+ *
+ * Atomic memory ordering suffixes (e.g. ".aqrl") are not included, since they're
+ * specified through operands.
+ */
+[[nodiscard]] std::string_view GetMnemonic(Opcode opcode) noexcept;
+
+} // namespace biscuit
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/decoder.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace biscuit {
+
+/// Options that control the output of the disassembler.
+struct DisassemblerOptions {
+    /// The architecture to decode instructions for.
+    ArchFeature features = ArchFeature::RV64;
+
+    /// Options to decode instructions with (e.g. to decode Zcmp instructions).
+    DecodeOptions decode_options = DecodeOptions::None;
+
+    /// Whether or not to print the raw bytes of each instruction.
+    bool show_raw_bytes = true;
+
+    /// Whether or not to name the targets of branches and jumps that lie within
+    /// the disassembled buffer, and to print those names before the instructions
+    /// they refer to.
+    bool show_labels = true;
+
+    /**
+     * Whether or not to print pseudo-instructions and the uncompressed forms of
+     * compressed instructions where possible (e.g. `ret` instead of `c.jr ra`).
+     *
+     * This matches the behavior of objdump, while disabling this is
+     * equivalent to disassembling with objdump's `-M no-aliases` option.
+     */
+    bool use_aliases = true;
+};
+
+/**
+ * Disassembles a buffer of code into text.
+ *
+ * The output follows the format of GNU objdump's disassembly, with one instruction
+ * per line, in the form `address: [raw bytes] mnemonic operands`, e.g.
+ *
+ * @code
+ *    0:	00b50533          	add	a0,a0,a1
+ *    4:	00050363          	beqz	a0,a <.L0>
+ *    8:	4505                	li	a0,1
+ *
+ * 000000000000000a <.L0>:
+ *    a:	8082                	ret
+ * @endcode
+ *
+ * When labels are enabled, every branch or jump target within the buffer is given a
+ * name of the form `.LN`, where N increases with the address of the target.
+ * Encodings that aren't recognized are printed with the `.insn` directive.
+ *
+ * @param code         The code to disassemble.
+ * @param base_address The address of the first byte of the code. Addresses and
+ *                     branch targets in the output are relative to this.
+ * @param options      Options that control the output.
+ *
+ * @note This doesn't modify any global state, so it's safe to call from
+ *       multiple threads simultaneously.
+ */
+[[nodiscard]] std::string Disassemble(std::span<const uint8_t> code, uint64_t base_address = 0,
+                                      const DisassemblerOptions& options = {});
+
+/**
+ * Formats a single decoded instruction as text (e.g. `addi\tsp,sp,-16`).
+ *
+ * @param instruction The instruction to format.
+ * @param address     The address of the instruction, used to print branch targets.
+ * @param use_aliases Whether or not to print pseudo-instructions and uncompressed
+ *                    forms of compressed instructions (see DisassemblerOptions).
+ */
+[[nodiscard]] std::string FormatInstruction(const Instruction& instruction, uint64_t address = 0,
+                                            bool use_aliases = true);
+
+} // namespace biscuit
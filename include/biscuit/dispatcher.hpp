@@ -0,0 +1,193 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/cpuinfo.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace biscuit {
+
+/**
+ * Selects and generates the most suitable variant of a kernel at runtime.
+ *
+ * Variants are registered along with the set of extensions they require.
+ * On first use, the dispatcher picks the highest priority variant that the
+ * current CPU is able to execute, generates it exactly once, and publishes
+ * the resulting entry point into an indirect-call slot. Subsequent calls
+ * only perform a single atomic load of that slot.
+ *
+ * Until then, the slot holds a resolver stub, so generated code may call
+ * through the slot before the dispatcher is resolved from the host. The
+ * first such call resolves the dispatcher and continues into the variant.
+ *
+ * This is essentially the runtime code generation equivalent of an ifunc.
+ *
+ * @par
+ * An example of dispatching a kernel:
+ *
+ * @code{.cpp}
+ * Dispatcher dispatcher;
+ *
+ * dispatcher.AddVariant({}, [](Assembler& as) {
+ *     // Baseline implementation
+ * });
+ * dispatcher.AddVariant({RISCVExtension::V}, [](Assembler& as) {
+ *     // Vectorized implementation
+ * });
+ *
+ * auto* const fn = dispatcher.Get<uint64_t (*)(const void*, size_t)>();
+ * fn(data, size);
+ * @endcode
+ *
+ * @note All member functions, aside from AddVariant, are safe to call
+ *       from multiple threads simultaneously.
+ */
+class Dispatcher {
+public:
+    /// Function that emits a kernel variant into the given assembler.
+    using Generator = std::function<void(Assembler&)>;
+
+    /**
+     * Constructor
+     *
+     * @param capacity The capacity in bytes of the code buffer that
+     *                 the selected variant will be generated into.
+     */
+    explicit Dispatcher(size_t capacity = CodeBuffer::default_capacity);
+
+    // Copying and moving is disallowed, since generated code
+    // may hold on to the address of the call slot.
+    Dispatcher(const Dispatcher&) = delete;
+    Dispatcher& operator=(const Dispatcher&) = delete;
+    Dispatcher(Dispatcher&&) = delete;
+    Dispatcher& operator=(Dispatcher&&) = delete;
+
+    ~Dispatcher();
+
+    /**
+     * Registers a kernel variant.
+     *
+     * @param requirements The extensions the variant requires to execute.
+     * @param generator    The function that generates the variant.
+     * @param priority     Priority of the variant. Variants with a higher priority
+     *                     are preferred over those with a lower one. If not specified,
+     *                     the number of required extensions is used, which results
+     *                     in the most specialized variant being preferred.
+     *
+     * @pre The dispatcher must not have been resolved yet.
+     *
+     * @note When multiple variants have the same priority, the one that was
+     *       registered first is preferred.
+     */
+    void AddVariant(const ExtensionSet& requirements, Generator generator,
+                    std::optional<int32_t> priority = std::nullopt);
+
+    /**
+     * Resolves the dispatcher against the extensions available on the current CPU.
+     *
+     * @returns A pointer to the entry point of the generated variant.
+     *
+     * @pre At least one registered variant must be executable on the current CPU.
+     */
+    [[nodiscard]] const void* Resolve();
+
+    /**
+     * Resolves the dispatcher against a given set of available extensions.
+     *
+     * Useful for generating code for a different machine than the current one.
+     *
+     * @param available The set of extensions that are available.
+     *
+     * @returns A pointer to the entry point of the generated variant.
+     *
+     * @pre At least one registered variant must be satisfied by `available`.
+     *
+     * @note Only the first resolution generates code. Any resolution after
+     *       that simply returns the previously generated entry point.
+     */
+    [[nodiscard]] const void* Resolve(const ExtensionSet& available);
+
+    /**
+     * Resolves the dispatcher and retrieves the entry point as a given function type.
+     *
+     * @tparam Func The function pointer type to retrieve the entry point as.
+     */
+    template <typename Func>
+    [[nodiscard]] Func Get() {
+        static_assert(std::is_pointer_v<Func> && std::is_function_v<std::remove_pointer_t<Func>>,
+                      "Func must be a function pointer type.");
+        return reinterpret_cast<Func>(const_cast<void*>(Resolve()));
+    }
+
+    /// Whether or not a variant has been selected and generated.
+    [[nodiscard]] bool IsResolved() const noexcept {
+        return m_slot.load(std::memory_order_acquire) != m_stub_entry;
+    }
+
+    /**
+     * Retrieves the indirect-call slot of this dispatcher.
+     *
+     * The slot contains the address of the generated variant once the
+     * dispatcher has been resolved, and the address of a resolver stub prior
+     * to that. The stub resolves the dispatcher against the current CPU and
+     * then jumps to the variant with the original arguments, so generated code
+     * may always load from the slot and jump through it, e.g.
+     *
+     * @code{.cpp}
+     * as.LI(t0, reinterpret_cast<uintptr_t>(dispatcher.GetSlot()));
+     * as.LD(t0, 0, t0);
+     * as.JALR(t0);
+     * @endcode
+     *
+     * @note The stub preserves arguments passed in a0-a7 and fa0-fa7,
+     *       but not arguments passed in vector registers.
+     */
+    [[nodiscard]] const std::atomic<uintptr_t>* GetSlot() const noexcept {
+        return &m_slot;
+    }
+
+    /**
+     * Retrieves the index of the variant that was selected, in registration order.
+     *
+     * @note If the returned value is empty, then the dispatcher has not been resolved yet.
+     */
+    [[nodiscard]] std::optional<size_t> GetSelectedVariant() const;
+
+private:
+    struct Variant {
+        ExtensionSet requirements;
+        Generator generator;
+        int32_t priority;
+        size_t index;
+    };
+
+    template <typename Predicate>
+    const void* ResolveImpl(Predicate&& is_available);
+
+    // Emits the stub the slot points to until the dispatcher is resolved.
+    void EmitResolverStub();
+
+    // Called by the resolver stub.
+    static const void* ResolveFromStub(Dispatcher* dispatcher);
+
+    std::vector<Variant> m_variants;
+    Assembler m_assembler;
+
+    // The stub lives in its own buffer, so that it stays executable
+    // while the variant is generated from within a call through it.
+    Assembler m_stub_assembler;
+    uintptr_t m_stub_entry = 0;
+
+    std::optional<size_t> m_selected;
+    mutable std::mutex m_mutex;
+    std::atomic<uintptr_t> m_slot{0};
+};
+
+} // namespace biscuit
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace biscuit {
+
+/**
+ * An external symbol is a named function that lives outside of the code being
+ * emitted (e.g. a runtime helper), and which can be called with
+ * Assembler::CallExternal.
+ *
+ * Symbols can be bound to an address before or after calls to them are emitted.
+ * Once a symbol is bound, every call site emitted for it is patched to reach it.
+ * Call sites are always a fixed AUIPC+JALR pair. Sites within ±2GiB of the symbol
+ * call it directly, while sites that are out of range call it through a veneer,
+ * which loads the address of the symbol from an adjacent slot and jumps to it.
+ * Veneers are emitted with Assembler::PlaceExternalVeneers.
+ *
+ * Every call site is also recorded as a RelocationType::Call relocation against
+ * the name of the symbol, so code calling external symbols can be written to
+ * an object file or a code cache and resolved again elsewhere.
+ *
+ * @par
+ * An example of calling a helper whose address is only known later:
+ *
+ * @code{.cpp}
+ * ExternalSymbol helper{"helper"};
+ *
+ * as.CallExternal(&helper);
+ * as.RET();
+ * as.PlaceExternalVeneers();  // In case the helper ends up out of range
+ *
+ * // ...
+ *
+ * as.BindExternal(&helper, reinterpret_cast<uintptr_t>(&Helper));
+ * @endcode
+ *
+ * @note The assembler keeps a pointer to every symbol that is called, so a symbol
+ *       must outlive the assembler it's used with (or until ClearSymbols is called).
+ *       For the same reason, symbols can't be copied or moved.
+ *
+ * @note Sites are patched relative to the current location of the code buffer.
+ *       If the code is moved afterwards (e.g. by growing a managed buffer),
+ *       symbols need to be bound again through the recorded relocations.
+ */
+class ExternalSymbol {
+public:
+    /**
+     * Constructs an unbound symbol.
+     *
+     * @param name The name of the symbol.
+     */
+    explicit ExternalSymbol(std::string name) : m_name{std::move(name)} {}
+
+    /**
+     * Constructs a symbol that is already bound to an address.
+     *
+     * @param name    The name of the symbol.
+     * @param address The address of the symbol.
+     */
+    explicit ExternalSymbol(std::string name, uint64_t address)
+        : m_name{std::move(name)}, m_address{address} {}
+
+    ExternalSymbol(const ExternalSymbol&) = delete;
+    ExternalSymbol& operator=(const ExternalSymbol&) = delete;
+    ExternalSymbol(ExternalSymbol&&) = delete;
+    ExternalSymbol& operator=(ExternalSymbol&&) = delete;
+
+    /// Retrieves the name of this symbol.
+    [[nodiscard]] std::string_view GetName() const noexcept {
+        return m_name;
+    }
+
+    /// Determines whether or not this symbol has an address assigned to it.
+    [[nodiscard]] bool IsBound() const noexcept {
+        return m_address.has_value();
+    }
+
+    /**
+     * Retrieves the address of this symbol.
+     *
+     * @note If the returned address is empty, then this symbol has not been bound yet.
+     */
+    [[nodiscard]] std::optional<uint64_t> GetAddress() const noexcept {
+        return m_address;
+    }
+
+    /**
+     * Determines whether or not every call site of this symbol can reach it.
+     *
+     * A symbol is considered resolved once it's bound and none of its call sites
+     * are waiting for a veneer to be placed.
+     */
+    [[nodiscard]] bool IsResolved() const noexcept {
+        return IsBound() && m_pending_sites.empty();
+    }
+
+    /// Determines whether or not a veneer has been placed for this symbol.
+    [[nodiscard]] bool HasVeneer() const noexcept {
+        return m_veneer.has_value();
+    }
+
+private:
+    // Call sites are offsets into the code buffer of the assembler that emitted
+    // them, so symbols are tied to the assembler they're used with.
+    friend class Assembler;
+
+    std::string m_name;
+    std::optional<uint64_t> m_address;
+
+    // Offsets of all call sites.
+    std::set<ptrdiff_t> m_sites;
+
+    // Offsets of call sites that don't reach their target yet.
+    std::set<ptrdiff_t> m_pending_sites;
+
+    // Offsets of the veneer, and of the slot holding the address it jumps to.
+    std::optional<ptrdiff_t> m_veneer;
+    ptrdiff_t m_veneer_slot = 0;
+};
+
+} // namespace biscuit
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/cpuinfo.hpp>
+#include <biscuit/registers.hpp>
+
+#include <cstdint>
+#include <span>
+
+namespace biscuit {
+
+/// How a function epilogue leaves the function.
+enum class FrameExit : uint32_t {
+    /// Returns to the caller.
+    Return,
+
+    /// Sets a0 to zero and returns to the caller.
+    ReturnZero,
+
+    /// Only tears down the frame, e.g. ahead of a tail call.
+    Restore,
+};
+
+/**
+ * Emits function prologues and epilogues that follow the standard calling convention.
+ *
+ * Frames are laid out with the saved registers at the top and the locals at the bottom,
+ * and are always a multiple of 16 bytes in size:
+ *
+ * @code{.unparsed}
+ *   sp + size - XLEN/8    ra
+ *   sp + size - 2*XLEN/8  s0, followed by the other saved GPRs in ascending order
+ *   ...                   saved FPRs in ascending order, as 8-byte aligned 64-bit values
+ *   sp + locals size      padding
+ *   sp                    locals
+ * @endcode
+ *
+ * The shortest sequence available on the target is chosen:
+ *
+ * - With Zcmp, GPRs are saved and restored with a single CM.PUSH and CM.POPRET, CM.POPRETZ,
+ *   or CM.POP. These always save ra and every register from s0 up to the highest saved register.
+ *
+ * - With Zca (or C), C.ADDI16SP, C.SDSP/C.LDSP (C.SWSP/C.LWSP on RV32), and C.JR are used,
+ *   as well as C.FSDSP/C.FLDSP with Zcd. Anything else uses the uncompressed equivalents.
+ *
+ * Frames larger than 2032 bytes are allocated in two steps, so that the saved registers
+ * stay within reach of the 12-bit offsets of loads and stores.
+ *
+ * @par
+ * An example of a frame for code allocated with a VirtualCodeBuilder:
+ *
+ * @code{.cpp}
+ * FrameBuilder frame{as, {RISCVExtension::Zcmp}};
+ * frame.SaveRegister(ra);
+ * frame.SaveRegisters(builder.GetUsedCalleeSavedGPRs());
+ * frame.SaveRegisters(builder.GetUsedCalleeSavedFPRs());
+ * frame.SetLocalsSize(builder.GetSpillAreaSize());
+ *
+ * frame.EmitPrologue();
+ * builder.Emit(as);
+ * frame.EmitEpilogue();
+ * @endcode
+ *
+ * @note Frames with more than 2032 bytes below the saved registers clobber t0
+ *       while adjusting SP.
+ *
+ * @note Only RV32 and RV64 are supported. Zcmp can't be combined with Zcd,
+ *       since it reuses the encodings of Zcd.
+ */
+class FrameBuilder {
+public:
+    /**
+     * Constructor
+     *
+     * @param assembler  The assembler to emit prologues and epilogues with.
+     * @param extensions The extensions available to the emitted code.
+     */
+    explicit FrameBuilder(Assembler& assembler, const ExtensionSet& extensions = {}) noexcept;
+
+    /**
+     * Saves a register in the prologue and restores it in the epilogue.
+     *
+     * @pre reg must be ra or one of s0-s11.
+     */
+    void SaveRegister(GPR reg);
+
+    /**
+     * Saves a register in the prologue and restores it in the epilogue.
+     *
+     * @pre reg must be one of fs0-fs11.
+     */
+    void SaveRegister(FPR reg);
+
+    /// Saves every given register. See SaveRegister(GPR).
+    void SaveRegisters(std::span<const GPR> regs);
+
+    /// Saves every given register. See SaveRegister(FPR).
+    void SaveRegisters(std::span<const FPR> regs);
+
+    /**
+     * Sets the number of bytes of locals at the bottom of the frame, starting at SP.
+     *
+     * @param size The size of the locals in bytes.
+     */
+    void SetLocalsSize(uint32_t size) noexcept {
+        m_locals_size = size;
+    }
+
+    /// Retrieves the total size of the frame in bytes.
+    [[nodiscard]] uint32_t GetFrameSize() const noexcept;
+
+    /// Allocates the frame and saves registers.
+    void EmitPrologue();
+
+    /**
+     * Restores registers and deallocates the frame.
+     *
+     * @param exit How to leave the function afterwards.
+     */
+    void EmitEpilogue(FrameExit exit = FrameExit::Return);
+
+private:
+    [[nodiscard]] bool HasZca() const noexcept;
+    [[nodiscard]] bool HasZcd() const noexcept;
+    [[nodiscard]] bool UsesPushPop() const noexcept;
+    [[nodiscard]] uint32_t GetGPRSize() const noexcept;
+    [[nodiscard]] uint32_t GetGPRSaveAreaSize() const noexcept;
+    [[nodiscard]] uint32_t GetFPRSaveAreaSize() const noexcept;
+
+    // The part of the frame that is allocated before registers are saved.
+    [[nodiscard]] uint32_t GetFirstAdjustment() const noexcept;
+
+    [[nodiscard]] PushPopList GetPushPopList() const noexcept;
+    [[nodiscard]] uint32_t GetPushPopStackAdjustment() const noexcept;
+
+    // Allocates or deallocates part of the frame, with a negative amount allocating.
+    void AdjustStack(int32_t amount);
+
+    // Saves or restores every saved register, given the offset of the top of the frame from SP.
+    void TransferRegisters(uint32_t frame_top, bool is_save);
+    void SaveGPR(GPR reg, uint32_t offset);
+    void RestoreGPR(GPR reg, uint32_t offset);
+
+    Assembler& m_assembler;
+    ExtensionSet m_extensions;
+    uint32_t m_saved_gprs = 0;
+    uint32_t m_saved_fprs = 0;
+    uint32_t m_locals_size = 0;
+};
+
+} // namespace biscuit
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <biscuit/enum_utils.hpp>
+
+#include <cstdint>
+
+namespace biscuit {
+
+struct Instruction;
+
+/**
+ * Pairs of adjacent instructions that some cores fuse into a single operation,
+ * usable as a bitmask. A bitmask of these pairs describes which ones a particular
+ * core fuses, and is referred to as its fusion profile.
+ *
+ * Cores only fuse a pair if the second instruction consumes the result of the first
+ * and overwrites it, so that only one register is written. Every pair described here
+ * has that shape, e.g. `LUI rd, hi20` + `ADDI rd, rd, lo12`.
+ *
+ * @note Pairs are described in terms of their 32-bit encodings. The Assembler
+ *       emits pairs within its fusion profile uncompressed for this reason.
+ */
+enum class FusionProfile : uint32_t {
+    None = 0,
+
+    /// `LUI rd, hi20` + `ADDI rd, rd, lo12` or `ADDIW rd, rd, lo12`, materializing a constant.
+    LuiAddi = 1U << 0,
+
+    /// `AUIPC rd, hi20` + `ADDI rd, rd, lo12`, materializing a PC-relative address.
+    AuipcAddi = 1U << 1,
+
+    /// `AUIPC rd, hi20` + `JALR rd, lo12(rd)`, a call or jump to a PC-relative address.
+    AuipcJalr = 1U << 2,
+
+    /// `AUIPC rd, hi20` + an integer load `rd, lo12(rd)`, loading from a PC-relative address.
+    AuipcLoad = 1U << 3,
+
+    /// `SLLI rd, rs, n` + `SRLI rd, rd, n`, zero-extending the lower bits of a register.
+    ZeroExtend = 1U << 4,
+
+    /// `ADD rd, rs1, rs2` + an integer load `rd, 0(rd)`, loading from a register-indexed address.
+    IndexedLoad = 1U << 5,
+
+    All = LuiAddi | AuipcAddi | AuipcJalr | AuipcLoad | ZeroExtend | IndexedLoad,
+};
+BISCUIT_DEFINE_ENUM_FLAG_OPERATORS(FusionProfile);
+
+/// The width and signedness of a load emitted by Assembler::LoadIndexed.
+enum class LoadWidth : uint32_t {
+    Byte,         //< LB
+    ByteUnsigned, //< LBU
+    Half,         //< LH
+    HalfUnsigned, //< LHU
+    Word,         //< LW
+    WordUnsigned, //< LWU (RV64 only)
+    Doubleword,   //< LD (RV64 only)
+};
+
+/**
+ * Determines which kind of fusible pair two adjacent instructions form, if any.
+ *
+ * @param first  The first instruction of the pair.
+ * @param second The instruction right after it.
+ *
+ * @returns The kind of pair, or FusionProfile::None if the instructions
+ *          don't form a fusible pair.
+ */
+[[nodiscard]] FusionProfile GetFusiblePair(const Instruction& first, const Instruction& second) noexcept;
+
+/**
+ * Determines whether or not a core with the given fusion profile fuses two adjacent instructions.
+ *
+ * @param profile The pairs the core fuses.
+ * @param first   The first instruction of the pair.
+ * @param second  The instruction right after it.
+ */
+[[nodiscard]] bool IsFusedPair(FusionProfile profile, const Instruction& first,
+                               const Instruction& second) noexcept;
+
+} // namespace biscuit
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <biscuit/code_listener.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace biscuit {
+
+/**
+ * Registers generated code with debuggers through the GDB JIT compilation interface.
+ *
+ * Every registered function is described by a small in-memory ELF image that
+ * contains a symbol for the function, and is made known to the debugger through
+ * `__jit_debug_descriptor` and `__jit_debug_register_code`. This allows GDB
+ * (and LLDB) to name generated functions in backtraces and disassembly.
+ *
+ * A registry can be attached to any number of assemblers as a code listener,
+ * after which every finalized function gets registered. Code that isn't emitted
+ * with an assembler can be registered with RegisterFunction.
+ *
+ * @par
+ * An example of making generated code visible to a debugger:
+ *
+ * @code{.cpp}
+ * GdbJitRegistry registry;
+ * as.AddCodeListener(&registry);
+ *
+ * const auto start = as.GetCodeBuffer().GetCursorOffset();
+ * // ... emit code ...
+ * as.FinalizeFunction("my_function", start);
+ * @endcode
+ *
+ * Registering a function only builds its image and links it into a list, so
+ * the cost is small enough to leave enabled in production. When no debugger is
+ * attached, notifying the debugger is just a call to an empty function.
+ *
+ * @note The images only describe code, so they don't include any information
+ *       about source lines or variables.
+ *
+ * @note All member functions are safe to call from multiple threads simultaneously.
+ */
+class GdbJitRegistry final : public CodeListener {
+public:
+    GdbJitRegistry();
+
+    // Copying and moving is disallowed, since assemblers may refer to the registry.
+    GdbJitRegistry(const GdbJitRegistry&) = delete;
+    GdbJitRegistry& operator=(const GdbJitRegistry&) = delete;
+    GdbJitRegistry(GdbJitRegistry&&) = delete;
+    GdbJitRegistry& operator=(GdbJitRegistry&&) = delete;
+
+    /// Destructor. Unregisters all functions that were registered through this registry.
+    ~GdbJitRegistry() override;
+
+    /**
+     * Registers a function with the debugger.
+     *
+     * @param name The name of the function.
+     * @param code Pointer to the function's code, as it will be executed.
+     * @param size The size of the function's code in bytes.
+     */
+    void RegisterFunction(std::string_view name, const void* code, size_t size);
+
+    /**
+     * Unregisters all functions whose code starts at the given address.
+     *
+     * This should be done before the memory containing the code is freed or reused.
+     *
+     * @param code Pointer to the code of the function(s) to unregister.
+     *
+     * @returns Whether or not any function was unregistered.
+     */
+    bool UnregisterFunction(const void* code);
+
+    /// Unregisters all functions that were registered through this registry.
+    void UnregisterAll();
+
+    /// Retrieves the number of functions currently registered through this registry.
+    [[nodiscard]] size_t GetNumRegistered() const;
+
+    void OnFunctionFinalized(const FinalizedFunction& function) override;
+
+private:
+    struct Entry;
+
+    std::vector<std::unique_ptr<Entry>> m_entries;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace biscuit
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace biscuit {
+
+/// The mechanism used to make modified code visible to instruction fetch on every hart.
+enum class ICacheSyncMethod : uint32_t {
+    /// Every modified range is synchronized with __builtin___clear_cache.
+    /// This doesn't notify other threads, so it's only sufficient on platforms
+    /// with coherent instruction caches, or single-threaded programs.
+    ClearCache,
+
+    /// The riscv_flush_icache syscall, which makes every hart
+    /// running a thread of the process execute a FENCE.I.
+    FlushICacheSyscall,
+
+    /// The local instruction cache is synchronized, and membarrier's
+    /// PRIVATE_EXPEDITED_SYNC_CORE command then makes every other
+    /// running thread of the process execute a core serializing instruction.
+    Membarrier,
+};
+
+/**
+ * Publishes modifications of executable code to every thread of the process,
+ * batching multiple modifications into a single broadcast.
+ *
+ * Harts may keep executing stale instructions after code is modified, until
+ * they synchronize their instruction fetch with prior stores (FENCE.I on RISC-V).
+ * Telling every other hart to do that is expensive, as it involves the kernel
+ * interrupting them, so modifications should be collected and published together
+ * whenever possible.
+ *
+ * @par
+ * An example of linking many translated blocks at once:
+ *
+ * @code{.cpp}
+ * CodePublisher publisher;
+ *
+ * for (const auto& exit : exits_to_link) {
+ *     exit.jump.Retarget(exit.target, publisher);
+ * }
+ *
+ * // Every hart observes the new destinations after this returns.
+ * publisher.Publish();
+ * @endcode
+ *
+ * @note Ranges are merged into a single covering range, which only matters on
+ *       platforms that synchronize by address (see ICacheSyncMethod::ClearCache).
+ *       Batching modifications that are far apart is still correct there, just slower.
+ *
+ * @note Any modification that is added, but *not* published will result in an
+ *       assertion being invoked when the publisher's destructor is executed.
+ */
+class CodePublisher {
+public:
+    /// Constructor
+    CodePublisher() noexcept = default;
+
+    /// Destructor
+    ~CodePublisher() noexcept;
+
+    // Pending modifications are only ever published once.
+    CodePublisher(const CodePublisher&) = delete;
+    CodePublisher& operator=(const CodePublisher&) = delete;
+    CodePublisher(CodePublisher&&) = delete;
+    CodePublisher& operator=(CodePublisher&&) = delete;
+
+    /**
+     * Records a range of modified code to publish with the next call to Publish.
+     *
+     * @param begin The beginning of the modified range.
+     * @param size  The size of the modified range in bytes.
+     */
+    void Add(const void* begin, size_t size) noexcept;
+
+    /**
+     * Makes all modifications recorded with Add visible to every thread of the
+     * process, with a single broadcast. Does nothing if there are no modifications.
+     */
+    void Publish() noexcept;
+
+    /// Determines whether or not any modifications are waiting to be published.
+    [[nodiscard]] bool HasPending() const noexcept {
+        return m_begin < m_end;
+    }
+
+    /**
+     * Retrieves the mechanism used for publishing modifications in this process.
+     *
+     * @note The mechanism is detected on first use. On Linux, this registers the
+     *       process for membarrier's PRIVATE_EXPEDITED_SYNC_CORE command if the
+     *       kernel supports it for the running architecture.
+     */
+    [[nodiscard]] static ICacheSyncMethod GetMethod() noexcept;
+
+private:
+    uintptr_t m_begin = UINTPTR_MAX;
+    uintptr_t m_end = 0;
+};
+
+/**
+ * Makes a single modified range of code visible to every thread of the process.
+ * Equivalent to adding the range to a CodePublisher and publishing it immediately.
+ *
+ * @param begin The beginning of the modified range.
+ * @param size  The size of the modified range in bytes.
+ */
+void PublishCode(const void* begin, size_t size) noexcept;
+
+} // namespace biscuit
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/decoder.hpp>
+#include <biscuit/label.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace biscuit {
+
+/// Identifies a label within an IRStream.
+using IRLabel = uint32_t;
+
+/// Marks IR nodes that don't refer to a label.
+constexpr IRLabel no_ir_label = UINT32_MAX;
+
+/// Describes what an IR node represents.
+enum class IRNodeKind : uint8_t {
+    /// An instruction. PC-relative instructions refer to the label they target.
+    Instruction,
+
+    /// Binds a label to the location of the node after it.
+    Bind,
+
+    /// Loads the address of a label into a register (see Assembler::LILabel).
+    /// The instruction is the AUIPC of the pair, and its destination is the register.
+    LabelAddress,
+
+    /// Bytes that don't decode to an instruction biscuit can emit, which are
+    /// emitted verbatim. The raw encoding and size are kept in the instruction.
+    Data,
+};
+
+/**
+ * Creates an instruction record by emitting the instruction and decoding it,
+ * e.g. for passes that replace instructions.
+ *
+ * @code{.cpp}
+ * const auto instruction = MakeInstruction(features, [](Assembler& as) {
+ *     as.ADDI(a0, a0, 1);
+ * });
+ * @endcode
+ *
+ * @param features The architecture to encode for.
+ * @param emit     A callable emitting exactly one instruction with the given assembler.
+ *
+ * @pre The emitted instruction must be one that can be decoded.
+ */
+template <typename Emitter>
+[[nodiscard]] Instruction MakeInstruction(ArchFeature features, Emitter&& emit) {
+    std::array<uint8_t, 8> storage{};
+    Assembler as{storage.data(), storage.size(), features};
+    emit(as);
+
+    const auto instruction = Decode(storage.data(), features);
+    BISCUIT_ASSERT(instruction.IsValid());
+    BISCUIT_ASSERT(instruction.size == as.GetCodeBuffer().GetSizeInBytes());
+    return instruction;
+}
+
+/**
+ * A single node of an IRStream.
+ *
+ * Nodes are fixed-size, and store instructions in their decoded form, with
+ * operands in the same order as the parameters of the Assembler function that
+ * emits them (see Instruction).
+ */
+struct IRNode {
+    /// The instruction, or the raw bytes of Data nodes.
+    Instruction instruction{};
+
+    /// What the node represents.
+    IRNodeKind kind = IRNodeKind::Instruction;
+
+    /// The label bound by Bind nodes, or targeted by other nodes.
+    IRLabel label = no_ir_label;
+
+    /// Determines whether or not the node is an instruction.
+    [[nodiscard]] bool IsInstruction() const noexcept {
+        return kind == IRNodeKind::Instruction;
+    }
+
+    /// Determines whether or not the node refers to a label.
+    [[nodiscard]] bool HasLabel() const noexcept {
+        return label != no_ir_label;
+    }
+
+    /**
+     * Creates an instruction node.
+     *
+     * @param instruction The instruction of the node.
+     *
+     * @pre The instruction must be valid and must not be PC-relative.
+     */
+    [[nodiscard]] static IRNode FromInstruction(const Instruction& instruction) noexcept {
+        BISCUIT_ASSERT(instruction.IsValid());
+        return IRNode{instruction, IRNodeKind::Instruction, no_ir_label};
+    }
+};
+
+/**
+ * A recorded sequence of instructions, along with the labels they refer to.
+ *
+ * Streams are created with Assembler::BeginRecording and Assembler::EndRecording,
+ * transformed with passes (see IRPassPipeline), and encoded with Assembler::EmitIR.
+ */
+class IRStream {
+public:
+    /**
+     * Constructor
+     *
+     * @param features The architecture the instructions are encoded for.
+     */
+    explicit IRStream(ArchFeature features) noexcept : m_features{features} {}
+
+    /// Retrieves the nodes of the stream.
+    [[nodiscard]] std::vector<IRNode>& GetNodes() noexcept {
+        return m_nodes;
+    }
+
+    /// Retrieves the nodes of the stream.
+    [[nodiscard]] const std::vector<IRNode>& GetNodes() const noexcept {
+        return m_nodes;
+    }
+
+    /// Retrieves the architecture the instructions are encoded for.
+    [[nodiscard]] ArchFeature GetArchFeatures() const noexcept {
+        return m_features;
+    }
+
+    /**
+     * Adds a label to the stream.
+     *
+     * @param label The label to refer to, or nullptr to create a label
+     *              that only exists within the stream, e.g. for branches
+     *              inserted by a pass.
+     *
+     * @returns The identifier of the label within the stream.
+     */
+    IRLabel AddLabel(Label* label = nullptr) {
+        m_labels.push_back({label, std::nullopt});
+        return static_cast<IRLabel>(m_labels.size() - 1);
+    }
+
+    /**
+     * Retrieves the label that an identifier refers to.
+     *
+     * @returns The label, or nullptr if the label only exists within the stream.
+     */
+    [[nodiscard]] Label* GetLabel(IRLabel label) const noexcept {
+        BISCUIT_ASSERT(label < m_labels.size());
+        return m_labels[label].label;
+    }
+
+    /// Retrieves the number of labels within the stream.
+    [[nodiscard]] size_t GetNumLabels() const noexcept {
+        return m_labels.size();
+    }
+
+private:
+    friend class Assembler;
+
+    struct LabelInfo {
+        // The label outside of the stream, if any.
+        Label* label;
+
+        // For labels only existing within the stream that
+        // target code preceding it, the offset of that code.
+        std::optional<ptrdiff_t> fixed_offset;
+    };
+
+    std::vector<IRNode> m_nodes;
+    std::vector<LabelInfo> m_labels;
+    ArchFeature m_features;
+};
+
+/// A transformation of an instruction stream.
+using IRPass = std::function<void(IRStream&)>;
+
+/**
+ * An ordered sequence of passes to run over instruction streams.
+ */
+class IRPassPipeline {
+public:
+    /**
+     * Appends a pass to the pipeline.
+     *
+     * @param pass The pass to append.
+     */
+    void Add(IRPass pass) {
+        BISCUIT_ASSERT(pass);
+        m_passes.push_back(std::move(pass));
+    }
+
+    /**
+     * Runs every pass over a stream, in the order they were added.
+     *
+     * @param stream The stream to transform.
+     */
+    void Run(IRStream& stream) const {
+        for (const auto& pass : m_passes) {
+            pass(stream);
+        }
+    }
+
+    /// Retrieves the number of passes within the pipeline.
+    [[nodiscard]] size_t GetNumPasses() const noexcept {
+        return m_passes.size();
+    }
+
+private:
+    std::vector<IRPass> m_passes;
+};
+
+} // namespace biscuit
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace biscuit {
+
+/**
+ * Emits calls and jumps to absolute addresses that may lie anywhere in the
+ * address space, through islands of shared veneers.
+ *
+ * Destinations within range of a JAL (±1MiB) are reached with a single JAL.
+ * Destinations that are further away are reached by a JAL to a veneer, which
+ * loads the destination from an adjacent literal and jumps to it
+ * (AUIPC+LD+JR). Veneers are emitted in islands, which are placed at explicit
+ * pool points (see Place and PlaceInline), and each veneer is shared by every
+ * call site that targets the same destination and is within range of it.
+ *
+ * @par
+ * An example of placing islands at the boundaries of blocks in a code cache:
+ *
+ * @code{.cpp}
+ * IslandManager islands{as};
+ *
+ * for (const auto& block : blocks) {
+ *     // Make sure pending sites stay within range of the next island.
+ *     if (islands.NeedsIsland(max_block_size)) {
+ *         islands.Place();
+ *     }
+ *
+ *     // ... emit block ...
+ *     islands.Call(runtime_helper_address);
+ *     // ...
+ *     islands.Jump(next_block_address);
+ * }
+ * islands.Place();
+ * @endcode
+ *
+ * @note Veneers clobber T1, like calls through PLT stubs do.
+ *
+ * @note Destinations are reached relative to the current location of the code
+ *       buffer, so the buffer must not move while it contains far calls or jumps.
+ *
+ * @note Any call or jump that is emitted, but whose veneer is *not* placed
+ *       will result in an assertion being invoked when the manager's
+ *       destructor is executed.
+ */
+class IslandManager {
+public:
+    /// The furthest distance that a JAL can reach in either direction.
+    static constexpr ptrdiff_t jal_range = ptrdiff_t{1} << 20;
+
+    /// The largest size of a single veneer, including padding for its literal.
+    static constexpr ptrdiff_t max_veneer_size = 28;
+
+    /**
+     * Constructor
+     *
+     * @param assembler The assembler to emit calls, jumps, and islands with.
+     */
+    explicit IslandManager(Assembler& assembler);
+
+    /// Destructor
+    ~IslandManager() noexcept;
+
+    // The manager tracks offsets within the code of a particular
+    // assembler, so copying or moving it isn't sensible.
+    IslandManager(const IslandManager&) = delete;
+    IslandManager& operator=(const IslandManager&) = delete;
+    IslandManager(IslandManager&&) = delete;
+    IslandManager& operator=(IslandManager&&) = delete;
+
+    /**
+     * Emits a call to an address, linking the return address into RA.
+     *
+     * @param address The address to call.
+     */
+    void Call(uint64_t address);
+
+    /**
+     * Emits a jump to an address.
+     *
+     * @param address The address to jump to.
+     */
+    void Jump(uint64_t address);
+
+    /**
+     * Places an island at the current offset within the code buffer, containing
+     * a veneer for every destination that pending calls and jumps target.
+     *
+     * @pre Every pending call and jump must be within range of the island.
+     *
+     * @note Execution must not fall through into islands, so they should be
+     *       placed after an unconditional jump or return. Use PlaceInline
+     *       if that isn't possible.
+     */
+    void Place();
+
+    /**
+     * Places an island along with a jump over it, so that it can be placed
+     * within code that execution falls through.
+     *
+     * @pre Every pending call and jump must be within range of the island.
+     */
+    void PlaceInline();
+
+    /**
+     * Determines whether or not an island needs to be placed before emitting
+     * `distance` more bytes of code, in order for all pending calls and jumps
+     * to stay within range of their veneers.
+     *
+     * @param distance The number of bytes intended to be emitted before placing an island.
+     */
+    [[nodiscard]] bool NeedsIsland(ptrdiff_t distance = 0) const noexcept;
+
+    /// Determines whether or not any calls or jumps are waiting for an island to be placed.
+    [[nodiscard]] bool HasPendingSites() const noexcept {
+        return !m_pending.empty();
+    }
+
+    /// Retrieves the number of veneers placed so far.
+    [[nodiscard]] size_t GetNumVeneers() const noexcept {
+        return m_num_veneers;
+    }
+
+private:
+    // Emits a JAL that reaches the address, either directly or through a veneer.
+    void EmitJump(GPR rd, uint64_t address);
+
+    // Patches the JAL at the given offset to jump to another offset.
+    void PatchJump(ptrdiff_t offset, ptrdiff_t target);
+
+    Assembler& m_assembler;
+
+    // The most recently placed veneer for every destination. Since code is
+    // only ever appended, it's always the closest one to new call sites.
+    std::unordered_map<uint64_t, ptrdiff_t> m_veneers;
+
+    // Offsets of JALs waiting for a veneer, keyed by destination.
+    std::map<uint64_t, std::vector<ptrdiff_t>> m_pending;
+
+    // Offset of the earliest pending JAL, which limits where the next island can go.
+    ptrdiff_t m_earliest_pending = 0;
+
+    size_t m_num_veneers = 0;
+};
+
+} // namespace biscuit
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace biscuit {
+
+/**
+ * Manages the jump table of the Zcmt extension, turning calls and jumps to
+ * frequently used destinations into 2-byte CM.JALT and CM.JT instructions.
+ *
+ * Destinations are assigned table indices either explicitly (see AddCall and
+ * AddJump), or by ranking the number of times they're counted (see CountCall,
+ * CountJump, and AssignByFrequency). Calls and jumps to destinations without
+ * an index fall back to regular AUIPC+JALR pairs.
+ *
+ * The table itself is placed into the code buffer at an explicit pool point
+ * (see Place), and the JVT CSR is pointed at it by code emitted with EmitSetup.
+ *
+ * @par
+ * An example of frequency-ranking the runtime helpers called by generated code:
+ *
+ * @code{.cpp}
+ * JumpTable table{as};
+ *
+ * // Count how often every helper is called...
+ * for (const auto& call : planned_calls) {
+ *     table.CountCall(call.helper_address);
+ * }
+ * table.AssignByFrequency();
+ *
+ * // ...then emit code calling them.
+ * table.EmitSetup(t0);
+ * for (const auto& call : planned_calls) {
+ *     table.Call(call.helper_address);
+ * }
+ * as.RET();
+ *
+ * table.Place();
+ * @endcode
+ *
+ * @note Each table entry costs XLEN bits, while each CM.JALT saves 6 bytes
+ *       over an AUIPC+JALR pair, so only destinations reached more than once
+ *       are worth an entry.
+ *
+ * @note Destinations are absolute, so the code buffer must not move while it
+ *       contains calls or jumps emitted by the manager.
+ *
+ * @note Any table entry that is used, or any setup code that is emitted, but whose
+ *       table is *not* placed will result in an assertion being invoked when the
+ *       manager's destructor is executed.
+ */
+class JumpTable {
+public:
+    /// The number of table entries that CM.JT can index (0-31).
+    static constexpr uint32_t num_jump_entries = 32;
+
+    /// The first table entry that CM.JALT can index.
+    static constexpr uint32_t first_call_index = 32;
+
+    /// The total number of entries a table can have.
+    static constexpr uint32_t max_entries = 256;
+
+    /// The alignment required of the table base by the JVT CSR.
+    static constexpr size_t alignment = 64;
+
+    /**
+     * Constructor
+     *
+     * @param assembler The assembler to emit calls, jumps, and the table with.
+     */
+    explicit JumpTable(Assembler& assembler);
+
+    /// Destructor
+    ~JumpTable() noexcept;
+
+    // Setup code is patched once the table is placed, which a copy
+    // would either do a second time or never do at all.
+    JumpTable(const JumpTable&) = delete;
+    JumpTable& operator=(const JumpTable&) = delete;
+    JumpTable(JumpTable&&) = delete;
+    JumpTable& operator=(JumpTable&&) = delete;
+
+    /**
+     * Assigns a CM.JALT table index to a call destination.
+     *
+     * @param target The destination to assign an index to.
+     *
+     * @returns The index of the destination, or std::nullopt if every
+     *          call index is taken or the table has already been placed.
+     */
+    std::optional<uint32_t> AddCall(uint64_t target);
+
+    /**
+     * Assigns a CM.JT table index to a jump destination.
+     *
+     * @param target The destination to assign an index to.
+     *
+     * @returns The index of the destination, or std::nullopt if every
+     *          jump index is taken or the table has already been placed.
+     */
+    std::optional<uint32_t> AddJump(uint64_t target);
+
+    /**
+     * Counts calls to a destination, for ranking with AssignByFrequency.
+     *
+     * @param target The destination being called.
+     * @param count  The number of calls to count.
+     */
+    void CountCall(uint64_t target, uint64_t count = 1);
+
+    /**
+     * Counts jumps to a destination, for ranking with AssignByFrequency.
+     *
+     * @param target The destination being jumped to.
+     * @param count  The number of jumps to count.
+     */
+    void CountJump(uint64_t target, uint64_t count = 1);
+
+    /**
+     * Assigns table indices to the most frequently counted destinations,
+     * until either the table is full, or there are no more destinations
+     * counted at least `min_count` times. Counts are reset afterwards.
+     *
+     * @param min_count The number of times a destination has to be counted
+     *                  to be worth a table entry.
+     */
+    void AssignByFrequency(uint64_t min_count = 2);
+
+    /**
+     * Emits a call to a destination, linking the return address into RA.
+     *
+     * This is a CM.JALT if the destination has been assigned an index,
+     * and a call through T1 otherwise.
+     *
+     * @param target The destination to call.
+     */
+    void Call(uint64_t target);
+
+    /**
+     * Emits a jump to a destination.
+     *
+     * This is a CM.JT if the destination has been assigned an index,
+     * and a jump through T1 otherwise.
+     *
+     * @param target The destination to jump to.
+     */
+    void Jump(uint64_t target);
+
+    /**
+     * Emits code that points the JVT CSR at the table.
+     *
+     * The table doesn't have to be placed yet, the code is patched once it is.
+     *
+     * @param scratch The register to compute the table address in.
+     *
+     * @pre scratch must not be the zero register.
+     */
+    void EmitSetup(GPR scratch);
+
+    /**
+     * Places the table at the current location within the code buffer, after
+     * padding to the required alignment, and patches any emitted setup code.
+     *
+     * Only the range of entries that are in use is emitted. In particular, if no jumps
+     * are assigned, the table base is placed before the table so that the first call
+     * entry is the first entry emitted, since CM.JT entries are never accessed then.
+     *
+     * @note Execution must not fall through into the table, so it should be
+     *       placed after an unconditional jump or return.
+     *
+     * @note The table can only be placed once, and no indices can be assigned after.
+     */
+    void Place();
+
+    /// Retrieves the index assigned to a call destination, if any.
+    [[nodiscard]] std::optional<uint32_t> GetCallIndex(uint64_t target) const;
+
+    /// Retrieves the index assigned to a jump destination, if any.
+    [[nodiscard]] std::optional<uint32_t> GetJumpIndex(uint64_t target) const;
+
+    /// Retrieves the address the JVT CSR is set to, if the table has been placed.
+    [[nodiscard]] std::optional<uint64_t> GetTableAddress() const noexcept {
+        return m_table_address;
+    }
+
+    /// Determines whether or not the table has been placed.
+    [[nodiscard]] bool IsPlaced() const noexcept {
+        return m_table_address.has_value();
+    }
+
+    /// Retrieves the number of call destinations with an index.
+    [[nodiscard]] size_t GetNumCalls() const noexcept {
+        return m_calls.size();
+    }
+
+    /// Retrieves the number of jump destinations with an index.
+    [[nodiscard]] size_t GetNumJumps() const noexcept {
+        return m_jumps.size();
+    }
+
+private:
+    // Emits a call or jump through T1 for destinations without an index.
+    void EmitFallback(GPR rd, uint64_t target);
+
+    // Assigns indices to counted destinations in order of frequency.
+    void AssignCounted(std::unordered_map<uint64_t, uint64_t>& counts, uint64_t min_count, bool is_call);
+
+    Assembler& m_assembler;
+
+    // Destinations in the order of their indices, starting at 0 for jumps and 32 for calls.
+    std::vector<uint64_t> m_jumps;
+    std::vector<uint64_t> m_calls;
+
+    std::unordered_map<uint64_t, uint32_t> m_jump_indices;
+    std::unordered_map<uint64_t, uint32_t> m_call_indices;
+
+    std::unordered_map<uint64_t, uint64_t> m_jump_counts;
+    std::unordered_map<uint64_t, uint64_t> m_call_counts;
+
+    // Offsets of setup code waiting for the table to be placed.
+    std::vector<ptrdiff_t> m_pending_setups;
+
+    std::optional<uint64_t> m_table_address;
+    bool m_has_table_sites = false;
+};
+
+} // namespace biscuit
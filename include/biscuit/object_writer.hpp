@@ -0,0 +1,131 @@
+#pragma once
+
+#include <biscuit/relocation.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace biscuit {
+
+class Assembler;
+
+/// The kinds of sections that an ObjectWriter can emit.
+enum class SectionKind : uint32_t {
+    Code,         //< Executable code (e.g. .text)
+    ReadOnlyData, //< Read-only data (e.g. .rodata)
+    Data,         //< Writable data (e.g. .data)
+};
+
+/// The floating-point calling conventions that an object may be marked as using.
+enum class FloatABI : uint32_t {
+    Soft,   //< lp64
+    Single, //< lp64f
+    Double, //< lp64d
+    Quad,   //< lp64q
+};
+
+/**
+ * Writes code into an ELF64 relocatable object file, which can then be linked
+ * with a regular linker or loaded by an ELF loader.
+ *
+ * Each section of the object is taken from the code of an assembler, along with
+ * the labels it exported (see Assembler::ExportLabel) and the references to
+ * symbols it recorded (see Assembler::AddRelocation). References to symbols
+ * that aren't exported by any section are emitted as undefined symbols, which
+ * are then resolved when linking.
+ *
+ * @par
+ * An example of compiling a function ahead of time:
+ *
+ * @code{.cpp}
+ * Assembler as;
+ * Label entry;
+ * as.Bind(&entry);
+ * as.AddRelocation(RelocationType::Call, "helper");
+ * as.AUIPC(ra, 0);
+ * as.JALR(ra, 0, ra);
+ * // ...
+ * as.ExportLabel("kernel", &entry, as.GetCodeBuffer().GetSizeInBytes());
+ *
+ * ObjectWriter writer;
+ * writer.AddSection(".text", as);
+ * const std::vector<uint8_t> object = writer.Write();
+ * @endcode
+ *
+ * @note Branches and jumps to labels within the same assembler are already
+ *       resolved when emitted, so they don't need relocations.
+ */
+class ObjectWriter {
+public:
+    /**
+     * Constructor
+     *
+     * @param float_abi The floating-point calling convention to mark the object
+     *                  with. Linkers refuse to link objects with differing ones.
+     */
+    explicit ObjectWriter(FloatABI float_abi = FloatABI::Double);
+
+    /**
+     * Adds the code of an assembler as a section, along with its exported
+     * symbols and relocations.
+     *
+     * @param name      The name of the section (e.g. ".text").
+     * @param assembler The assembler to take the code from.
+     * @param kind      The kind of section.
+     * @param alignment The alignment of the section in bytes.
+     *
+     * @returns The index of the section within the object.
+     *
+     * @pre The name must not be empty or the same as a previously added section.
+     * @pre The alignment must be a power of two.
+     */
+    uint32_t AddSection(std::string_view name, Assembler& assembler,
+                        SectionKind kind = SectionKind::Code, size_t alignment = 4);
+
+    /**
+     * Adds a section from raw data.
+     *
+     * @param name        The name of the section (e.g. ".text").
+     * @param data        The contents of the section.
+     * @param symbols     Symbols defined within the section.
+     * @param relocations References to symbols within the section.
+     * @param kind        The kind of section.
+     * @param alignment   The alignment of the section in bytes.
+     *
+     * @returns The index of the section within the object.
+     *
+     * @pre The name must not be empty or the same as a previously added section.
+     * @pre The alignment must be a power of two.
+     * @pre All symbols and relocations must lie within the data.
+     */
+    uint32_t AddSection(std::string_view name, std::span<const uint8_t> data,
+                        std::span<const ExportedSymbol> symbols,
+                        std::span<const Relocation> relocations,
+                        SectionKind kind = SectionKind::Code, size_t alignment = 4);
+
+    /**
+     * Builds the object file.
+     *
+     * @pre No two sections may export a symbol with the same name.
+     */
+    [[nodiscard]] std::vector<uint8_t> Write() const;
+
+private:
+    struct Section {
+        std::string name;
+        SectionKind kind;
+        size_t alignment;
+        std::vector<uint8_t> data;
+        std::vector<ExportedSymbol> symbols;
+        std::vector<Relocation> relocations;
+    };
+
+    std::vector<Section> m_sections;
+    FloatABI m_float_abi;
+};
+
+} // namespace biscuit
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <biscuit/icache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace biscuit {
+
+/**
+ * A jump within executable code whose destination can be changed while other
+ * harts may be executing it, e.g. for chaining translated blocks together.
+ *
+ * Patchable jumps are emitted with Assembler::EmitPatchableJump as a naturally
+ * aligned slot with the following fixed shape:
+ *
+ * @code
+ * +0:  J      destination     // or J +4 for destinations out of range
+ * +4:  AUIPC  t1, 0
+ * +8:  L{W,D} t1, 12(t1)
+ * +12: JR     t1
+ * +16: .{word,dword} destination
+ * @endcode
+ *
+ * Destinations within ±1MiB of the slot are reached with the leading J alone.
+ * Other destinations are stored into the literal, and the leading J is pointed
+ * at the indirect jump after it. Either way, executing harts only ever observe
+ * a single naturally aligned 32-bit instruction store and a single naturally
+ * aligned XLEN-sized data store, so every hart always jumps to either the old
+ * or the new destination, and never to anything in between.
+ *
+ * @par
+ * An example of chaining blocks:
+ *
+ * @code{.cpp}
+ * // While translating a block, exit to the dispatcher until the next block exists.
+ * const auto exit = as.EmitPatchableJump(dispatcher_address);
+ *
+ * // Once the next block is translated, jump to it directly.
+ * exit.Retarget(next_block_address);
+ *
+ * // When the next block is invalidated, go back to the dispatcher.
+ * exit.Unlink();
+ * @endcode
+ *
+ * @note The far path clobbers T1.
+ *
+ * @note The memory containing the jump must be writable while it's being patched.
+ *
+ * @note Patching synchronizes the instruction caches of all harts before
+ *       returning, so other harts observe the new destination after that.
+ *       Use the overloads taking a CodePublisher to batch that synchronization.
+ */
+class PatchableJump {
+public:
+    /// The size of a patchable jump slot in bytes.
+    static constexpr size_t size = 24;
+
+    /// The alignment of a patchable jump slot in bytes.
+    static constexpr size_t alignment = 8;
+
+    /**
+     * Constructor
+     *
+     * @param address         The address of the slot.
+     * @param unlinked_target The destination that Unlink points the jump back to.
+     * @param is_rv32         Whether the literal of the slot is 32-bit or 64-bit.
+     *
+     * @note This doesn't emit anything. Use Assembler::EmitPatchableJump
+     *       to emit a slot.
+     */
+    explicit PatchableJump(uintptr_t address, uint64_t unlinked_target, bool is_rv32) noexcept
+        : m_address{address}, m_unlinked_target{unlinked_target}, m_is_rv32{is_rv32} {}
+
+    /**
+     * Atomically changes the destination of the jump.
+     *
+     * @param target The new destination.
+     *
+     * @pre On RV32, the destination must fit in 32 bits.
+     */
+    void Retarget(uint64_t target) const;
+
+    /**
+     * Atomically changes the destination of the jump, leaving publishing
+     * the modification to other harts up to the given publisher.
+     *
+     * This allows many jumps to be retargeted with a single broadcast.
+     * Until the publisher publishes, other harts may still jump to the
+     * old destination.
+     *
+     * @param target    The new destination.
+     * @param publisher The publisher to record the modification with.
+     *
+     * @pre On RV32, the destination must fit in 32 bits.
+     */
+    void Retarget(uint64_t target, CodePublisher& publisher) const;
+
+    /// Atomically points the jump back at the destination it was emitted with.
+    void Unlink() const {
+        Retarget(m_unlinked_target);
+    }
+
+    /// Atomically points the jump back at the destination it was emitted with,
+    /// leaving publishing the modification up to the given publisher.
+    void Unlink(CodePublisher& publisher) const {
+        Retarget(m_unlinked_target, publisher);
+    }
+
+    /// Retrieves the current destination of the jump.
+    [[nodiscard]] uint64_t GetTarget() const noexcept;
+
+    /// Determines whether or not the jump has been retargeted away from its original destination.
+    [[nodiscard]] bool IsLinked() const noexcept {
+        return GetTarget() != m_unlinked_target;
+    }
+
+    /// Retrieves the address of the slot.
+    [[nodiscard]] uintptr_t GetAddress() const noexcept {
+        return m_address;
+    }
+
+    /// Retrieves the destination that Unlink points the jump back to.
+    [[nodiscard]] uint64_t GetUnlinkedTarget() const noexcept {
+        return m_unlinked_target;
+    }
+
+private:
+    uintptr_t m_address = 0;
+    uint64_t m_unlinked_target = 0;
+    bool m_is_rv32 = false;
+};
+
+/**
+ * A 64-bit constant load whose value can be changed after it's emitted,
+ * e.g. for the expected type of an inline cache.
+ *
+ * Patchable constants are emitted with Assembler::EmitPatchableLI, which loads
+ * the value from a naturally aligned literal right after the load:
+ *
+ * @code
+ * +0:  AUIPC  rd, 0
+ * +4:  L{W,D} rd, 12(rd)
+ * +8:  J      +12
+ * +12: .{word,dword} value
+ * @endcode
+ *
+ * Since the value is data rather than part of an instruction, repatching it
+ * is a single aligned XLEN-sized atomic store, and doesn't require any
+ * instruction cache synchronization. Harts executing the load concurrently
+ * observe either the old or the new value.
+ *
+ * @note Immediates can be compared against a patchable constant by loading it
+ *       into a register and comparing against that, e.g. with BEQ.
+ */
+class PatchableConstant {
+public:
+    /**
+     * Constructor
+     *
+     * @param address The address of the sequence.
+     * @param is_rv32 Whether the literal is 32-bit or 64-bit.
+     *
+     * @note This doesn't emit anything. Use Assembler::EmitPatchableLI
+     *       to emit a constant load.
+     */
+    explicit PatchableConstant(uintptr_t address, bool is_rv32) noexcept
+        : m_address{address}, m_is_rv32{is_rv32} {}
+
+    /// Retrieves the current value of the constant.
+    [[nodiscard]] uint64_t GetValue() const noexcept;
+
+    /// Retrieves the address of the sequence.
+    [[nodiscard]] uintptr_t GetAddress() const noexcept {
+        return m_address;
+    }
+
+    /// Retrieves the address of the literal holding the value.
+    [[nodiscard]] uintptr_t GetLiteralAddress() const noexcept {
+        return m_address + 12;
+    }
+
+    /// Retrieves whether or not the literal is 32-bit.
+    [[nodiscard]] bool IsRV32() const noexcept {
+        return m_is_rv32;
+    }
+
+private:
+    uintptr_t m_address = 0;
+    bool m_is_rv32 = false;
+};
+
+/**
+ * A call whose destination can be changed after it's emitted, e.g. for the
+ * target of a monomorphic inline cache.
+ *
+ * Patchable calls are emitted with Assembler::EmitPatchableCall, which loads
+ * the destination from a naturally aligned literal after the call:
+ *
+ * @code
+ * +0:  AUIPC  t1, 0
+ * +4:  L{W,D} t1, 16(t1)
+ * +8:  JALR   ra, 0(t1)
+ * +12: J      +{8,12}
+ * +16: .{word,dword} destination
+ * @endcode
+ *
+ * Like with PatchableConstant, repatching is a single aligned XLEN-sized atomic
+ * store that doesn't require any instruction cache synchronization.
+ *
+ * @note The call clobbers T1.
+ */
+class PatchableCall {
+public:
+    /**
+     * Constructor
+     *
+     * @param address The address of the sequence.
+     * @param is_rv32 Whether the literal is 32-bit or 64-bit.
+     *
+     * @note This doesn't emit anything. Use Assembler::EmitPatchableCall
+     *       to emit a call.
+     */
+    explicit PatchableCall(uintptr_t address, bool is_rv32) noexcept
+        : m_address{address}, m_is_rv32{is_rv32} {}
+
+    /// Retrieves the current destination of the call.
+    [[nodiscard]] uint64_t GetTarget() const noexcept;
+
+    /// Retrieves the address of the sequence.
+    [[nodiscard]] uintptr_t GetAddress() const noexcept {
+        return m_address;
+    }
+
+    /// Retrieves the address of the literal holding the destination.
+    [[nodiscard]] uintptr_t GetLiteralAddress() const noexcept {
+        return m_address + 16;
+    }
+
+    /// Retrieves whether or not the literal is 32-bit.
+    [[nodiscard]] bool IsRV32() const noexcept {
+        return m_is_rv32;
+    }
+
+private:
+    uintptr_t m_address = 0;
+    bool m_is_rv32 = false;
+};
+
+/**
+ * Atomically changes the value loaded by a patchable constant.
+ *
+ * @param constant The constant to repatch.
+ * @param value    The new value.
+ *
+ * @pre On RV32, the value must fit in 32 bits.
+ */
+void Repatch(const PatchableConstant& constant, uint64_t value);
+
+/**
+ * Atomically changes the destination of a patchable call.
+ *
+ * @param call   The call to repatch.
+ * @param target The new destination.
+ *
+ * @pre On RV32, the destination must fit in 32 bits.
+ */
+void Repatch(const PatchableCall& call, uint64_t target);
+
+/**
+ * Atomically changes the destination of a patchable jump.
+ * Equivalent to PatchableJump::Retarget.
+ *
+ * @param jump   The jump to repatch.
+ * @param target The new destination.
+ */
+inline void Repatch(const PatchableJump& jump, uint64_t target) {
+    jump.Retarget(target);
+}
+
+} // namespace biscuit
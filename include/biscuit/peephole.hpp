@@ -0,0 +1,111 @@
+#pragma once
+
+#include <biscuit/cpuinfo.hpp>
+#include <biscuit/enum_utils.hpp>
+#include <biscuit/ir.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace biscuit {
+
+/// The rewrites a Peephole pass may apply, usable as a bitmask.
+enum class PeepholeRule : uint32_t {
+    None = 0,
+
+    /**
+     * Removes instructions that leave their destination unchanged, such as
+     * `MV rd, rd`, `ADDI rd, rd, 0`, or `ADD rd, rd, zero`. NOPs writing the
+     * zero register are kept, since they may be intentional padding.
+     */
+    RedundantMove = 1U << 0,
+
+    /**
+     * Folds a small constant that's loaded into a register and then added
+     * into the addition, e.g. `LI t0, 8` + `ADD a0, a1, t0` into `ADDI a0, a1, 8`.
+     */
+    FoldImmediate = 1U << 1,
+
+    /**
+     * Turns a shift by 1, 2 or 3 followed by an addition into SH1ADD, SH2ADD or SH3ADD.
+     * Requires Zba.
+     */
+    ShiftAdd = 1U << 2,
+
+    /**
+     * Turns `SLLI rd, rs, 32` + `SRLI rd, rd, 32` into `ZEXT.W rd, rs`.
+     * Requires Zba and RV64.
+     */
+    ZeroExtend = 1U << 3,
+
+    /**
+     * Turns a branch over a move of zero into CZERO.EQZ or CZERO.NEZ,
+     * e.g. `BNEZ a1, skip` + `LI a0, 0` + `skip:` into `CZERO.EQZ a0, a0, a1`.
+     * Requires Zicond.
+     */
+    ConditionalZero = 1U << 4,
+
+    All = RedundantMove | FoldImmediate | ShiftAdd | ZeroExtend | ConditionalZero,
+};
+BISCUIT_DEFINE_ENUM_FLAG_OPERATORS(PeepholeRule);
+
+/**
+ * A pass that rewrites short windows of instructions within a recorded
+ * instruction stream into fewer or cheaper instructions.
+ *
+ * Rules that fold an instruction into the one after it only apply if the
+ * register it writes is provably overwritten before it's read again within
+ * the same basic block. Since nothing is known about code following the stream,
+ * registers are assumed to be live at the end of it, and at any branch or label.
+ *
+ * @par
+ * An example of cleaning up code emitted from templates:
+ *
+ * @code{.cpp}
+ * IRPassPipeline passes;
+ * passes.Add(Peephole{{RISCVExtension::Zba, RISCVExtension::Zicond}});
+ *
+ * as.BeginRecording();
+ * // ... emit code ...
+ * as.EndRecording(passes);
+ * @endcode
+ *
+ * @note Rules are applied repeatedly until none of them match anymore,
+ *       so the result of one rewrite can feed into another.
+ */
+class Peephole {
+public:
+    /**
+     * Constructor
+     *
+     * @param extensions The extensions that rewritten instructions may use.
+     *                   Rules requiring an extension that isn't available
+     *                   are skipped.
+     * @param rules      The rules to apply.
+     */
+    explicit Peephole(const ExtensionSet& extensions = {}, PeepholeRule rules = PeepholeRule::All) noexcept
+        : m_extensions{extensions}, m_rules{rules} {}
+
+    /**
+     * Rewrites the instructions of a stream.
+     *
+     * @param stream The stream to rewrite.
+     *
+     * @returns The number of rewrites that were applied.
+     */
+    size_t Run(IRStream& stream) const;
+
+    /// Rewrites the instructions of a stream, so that the pass can be added to an IRPassPipeline.
+    void operator()(IRStream& stream) const {
+        static_cast<void>(Run(stream));
+    }
+
+    /// Determines whether or not a rule is enabled and has the extensions it requires.
+    [[nodiscard]] bool IsRuleEnabled(PeepholeRule rule, ArchFeature features) const noexcept;
+
+private:
+    ExtensionSet m_extensions;
+    PeepholeRule m_rules;
+};
+
+} // namespace biscuit
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <biscuit/code_listener.hpp>
+#include <biscuit/enum_utils.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace biscuit {
+
+/// The kinds of files that a PerfSink can emit for the Linux `perf` tool.
+enum class PerfFormat : uint32_t {
+    None = 0,
+
+    /**
+     * A perf map (`perf-<pid>.map`), containing one `start size name` line per
+     * function. This is enough for `perf report` to symbolize samples.
+     */
+    PerfMap = 1U << 0,
+
+    /**
+     * A jitdump file (`jit-<pid>.dump`), which additionally contains a copy of the
+     * code of every function. This allows `perf inject --jit` to create
+     * ELF images of the code, so that it can also be annotated.
+     */
+    JitDump = 1U << 1,
+};
+BISCUIT_DEFINE_ENUM_FLAG_OPERATORS(PerfFormat);
+
+/**
+ * Informs the Linux `perf` tool about generated code.
+ *
+ * Without this, `perf` can't symbolize generated code and samples within it
+ * only show up as raw addresses. A sink can be attached to any number of
+ * assemblers as a code listener, after which every finalized function gets
+ * recorded. Code that isn't emitted with an assembler can be recorded with
+ * RecordFunction.
+ *
+ * @par
+ * An example of profiling generated code:
+ *
+ * @code{.cpp}
+ * PerfSink sink{PerfFormat::PerfMap | PerfFormat::JitDump};
+ * as.AddCodeListener(&sink);
+ *
+ * const auto start = as.GetCodeBuffer().GetCursorOffset();
+ * // ... emit code ...
+ * as.FinalizeFunction("my_function", start);
+ * @endcode
+ *
+ * A perf map is picked up automatically by `perf report`. For jitdump files, the
+ * program needs to be recorded with a monotonic clock, and the recording needs to
+ * be injected with the dump before reporting:
+ *
+ * @code{.sh}
+ * perf record -k 1 ./program
+ * perf inject --jit -i perf.data -o perf.jit.data
+ * perf report -i perf.jit.data
+ * @endcode
+ *
+ * @note Only supported on Linux. On other platforms, no files are emitted.
+ *
+ * @note All member functions are safe to call from multiple threads simultaneously.
+ */
+class PerfSink final : public CodeListener {
+public:
+    /// The directory that perf looks for perf maps in.
+    static constexpr std::string_view default_directory = "/tmp";
+
+    /**
+     * Constructor
+     *
+     * Creates the files for the requested formats. Failing to create a file
+     * isn't fatal, in which case the corresponding format is just disabled.
+     *
+     * @param formats   The formats to emit.
+     * @param directory The directory to create the files in. perf only looks for
+     *                  perf maps in the default directory, however a jitdump file
+     *                  may be placed anywhere.
+     */
+    explicit PerfSink(PerfFormat formats = PerfFormat::PerfMap,
+                      std::string_view directory = default_directory);
+
+    // Copying and moving is disallowed, since assemblers may refer to the sink.
+    PerfSink(const PerfSink&) = delete;
+    PerfSink& operator=(const PerfSink&) = delete;
+    PerfSink(PerfSink&&) = delete;
+    PerfSink& operator=(PerfSink&&) = delete;
+
+    /// Destructor. Closes all files that were created.
+    ~PerfSink() override;
+
+    /**
+     * Checks whether the files for all of the given formats are being written.
+     *
+     * @param formats The formats to check.
+     */
+    [[nodiscard]] bool IsEnabled(PerfFormat formats) const noexcept {
+        return formats != PerfFormat::None && (m_enabled & formats) == formats;
+    }
+
+    /// Retrieves the path of the perf map, regardless of whether it's being written.
+    [[nodiscard]] const std::string& GetPerfMapPath() const noexcept {
+        return m_perf_map_path;
+    }
+
+    /// Retrieves the path of the jitdump file, regardless of whether it's being written.
+    [[nodiscard]] const std::string& GetJitDumpPath() const noexcept {
+        return m_jitdump_path;
+    }
+
+    /**
+     * Records a function.
+     *
+     * @param name The name of the function.
+     * @param code Pointer to the function's code, as it will be executed.
+     * @param size The size of the function's code in bytes.
+     */
+    void RecordFunction(std::string_view name, const void* code, size_t size);
+
+    void OnFunctionFinalized(const FinalizedFunction& function) override;
+
+private:
+    void OpenPerfMap();
+    void OpenJitDump();
+    void CloseJitDump();
+
+    void WritePerfMapEntry(std::string_view name, uintptr_t address, size_t size);
+    void WriteJitDumpEntry(std::string_view name, uintptr_t address, size_t size);
+
+    std::string m_perf_map_path;
+    std::string m_jitdump_path;
+    PerfFormat m_enabled = PerfFormat::None;
+
+    int m_perf_map_fd = -1;
+    int m_jitdump_fd = -1;
+    void* m_jitdump_marker = nullptr;
+    size_t m_jitdump_marker_size = 0;
+    uint64_t m_code_index = 0;
+
+    std::mutex m_mutex;
+};
+
+} // namespace biscuit
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/cpuinfo.hpp>
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace biscuit {
+
+/**
+ * Describes a RISC-V target: its base integer width and the set of extensions it provides.
+ *
+ * Profiles can be constructed from standard ISA strings (e.g. "rv64imafdcv_zba_zbb")
+ * or from one of the built-in profile presets (e.g. RVA22U64).
+ *
+ * The extension set of a profile is always kept closed under implication, meaning
+ * that extensions implied by others are automatically added to it (e.g. D implies F,
+ * V implies Zve64d, C implies Zca, etc). This makes comparisons between profiles
+ * well-defined regardless of how the profile was originally spelled, and also makes
+ * the canonical string representation (see ToString()) unique for every distinct profile.
+ *
+ * @par
+ * An example of checking whether the current CPU can run code targeting a profile:
+ *
+ * @code{.cpp}
+ * const auto target = Profile::Parse("rv64gcv_zba_zbb").value();
+ *
+ * if (target.IsSupportedBy(CPUInfo{})) {
+ *     Assembler as;
+ *     as.SetArchFeatures(target.GetArchFeature());
+ *     // ...
+ * }
+ * @endcode
+ *
+ * @note Only extensions representable by RISCVExtension are tracked. Other
+ *       standard extensions are recognized by the parser (so that ISA strings
+ *       containing them are still accepted), but are not retained. This includes
+ *       extensions that are always present in environments biscuit supports
+ *       (e.g. Zicsr and Zifencei), those that only describe memory or cache
+ *       properties (e.g. Ziccif, Za64rs), and hint-only extensions (e.g. Zicbop).
+ */
+class Profile {
+public:
+    /**
+     * Constructor
+     *
+     * @param xlen       The base integer width of the profile.
+     * @param extensions The extensions provided by the profile.
+     */
+    explicit Profile(ArchFeature xlen, const ExtensionSet& extensions);
+
+    /**
+     * Parses an ISA string or a profile name.
+     *
+     * Accepts ISA strings in the form described by the ISA manual's naming conventions
+     * chapter (e.g. "rv64imafdc_zicsr_zba" or "RV64GC"). Version numbers are accepted and
+     * ignored (e.g. "rv64i2p1_m2p0"), as are non-standard X extensions (e.g. "xtheadba").
+     * Parsing is case-insensitive.
+     *
+     * Also accepts the names of the built-in profile presets (e.g. "rva22u64").
+     *
+     * @param isa The string to parse.
+     *
+     * @returns The parsed profile, or an empty optional if the string was malformed
+     *          or contained unrecognized extensions.
+     */
+    [[nodiscard]] static std::optional<Profile> Parse(std::string_view isa);
+
+    /**
+     * Creates a profile describing the CPU being executed on.
+     *
+     * @param cpu_info The CPU information to build the profile from.
+     * @param xlen     The base integer width of the profile.
+     */
+    [[nodiscard]] static Profile FromCPU(const CPUInfo& cpu_info, ArchFeature xlen = ArchFeature::RV64);
+
+    /// RVA20U64 profile preset.
+    [[nodiscard]] static Profile RVA20U64();
+
+    /// RVA22U64 profile preset.
+    [[nodiscard]] static Profile RVA22U64();
+
+    /// RVA23U64 profile preset.
+    [[nodiscard]] static Profile RVA23U64();
+
+    /// Gets the base integer width of this profile.
+    [[nodiscard]] ArchFeature GetArchFeature() const noexcept {
+        return m_xlen;
+    }
+
+    /// Gets the set of extensions within this profile.
+    [[nodiscard]] const ExtensionSet& GetExtensions() const noexcept {
+        return m_extensions;
+    }
+
+    /// Whether or not the given extension is part of this profile.
+    [[nodiscard]] bool Has(RISCVExtension extension) const noexcept {
+        return m_extensions.Has(extension);
+    }
+
+    /**
+     * Determines whether code targeting this profile can execute on the given target.
+     *
+     * This is the case when both profiles have the same base integer width
+     * and every extension within this profile is also present in `target`.
+     */
+    [[nodiscard]] bool IsSupportedBy(const Profile& target) const noexcept {
+        return m_xlen == target.m_xlen && m_extensions.IsSubsetOf(target.m_extensions);
+    }
+
+    /// Determines whether code targeting this profile can execute on the given CPU.
+    [[nodiscard]] bool IsSupportedBy(const CPUInfo& cpu_info) const;
+
+    /**
+     * Retrieves the canonical ISA string for this profile.
+     *
+     * Single-letter extensions come first, in the canonical order specified by the
+     * ISA manual, followed by multi-letter extensions separated with underscores.
+     * Multi-letter extensions are ordered by category and then alphabetically.
+     * No version numbers are included.
+     *
+     * Two profiles compare equal if and only if their canonical strings are equal,
+     * which makes the string suitable as a key for caching generated code.
+     */
+    [[nodiscard]] std::string ToString() const;
+
+    friend bool operator==(const Profile&, const Profile&) = default;
+
+private:
+    ArchFeature m_xlen;
+    ExtensionSet m_extensions;
+};
+
+} // namespace biscuit
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace biscuit {
+
+/// The kinds of references to symbols that code may contain.
+enum class RelocationType : uint32_t {
+    /// A 64-bit absolute address of a symbol (R_RISCV_64).
+    Absolute64,
+
+    /// A 32-bit absolute address of a symbol (R_RISCV_32).
+    Absolute32,
+
+    /// A conditional branch to a symbol (R_RISCV_BRANCH).
+    Branch,
+
+    /// A JAL to a symbol (R_RISCV_JAL).
+    Jal,
+
+    /// An AUIPC and JALR pair that calls a symbol (R_RISCV_CALL_PLT).
+    Call,
+
+    /// An AUIPC that computes the upper bits of the address of a symbol (R_RISCV_PCREL_HI20).
+    PCRelHi20,
+
+    /// An I-type instruction that adds the lower bits of a PCRelHi20 reference (R_RISCV_PCREL_LO12_I).
+    PCRelLo12I,
+
+    /// An S-type instruction that adds the lower bits of a PCRelHi20 reference (R_RISCV_PCREL_LO12_S).
+    PCRelLo12S,
+};
+
+/**
+ * Describes a reference from code to a symbol whose address isn't known
+ * at the time the code is emitted.
+ *
+ * The instruction (or data) at the relocated offset is emitted with an offset
+ * or address of zero, which is then filled in once the symbol's address is known.
+ */
+struct Relocation {
+    /// Offset into the code buffer of the instruction or data to relocate.
+    ptrdiff_t offset = 0;
+
+    /// The kind of reference.
+    RelocationType type = RelocationType::Absolute64;
+
+    /// The name of the referenced symbol. Unused by PCRelLo12I and PCRelLo12S.
+    std::string symbol;
+
+    /// Constant added to the address of the symbol.
+    int64_t addend = 0;
+
+    /**
+     * For PCRelLo12I and PCRelLo12S, the offset of the AUIPC instruction
+     * that the lower bits are paired with. Unused otherwise.
+     */
+    ptrdiff_t hi20_offset = 0;
+};
+
+/// The kinds of symbols that can be defined within code.
+enum class SymbolType : uint32_t {
+    /// The symbol refers to a function.
+    Function,
+
+    /// The symbol refers to data.
+    Object,
+};
+
+/// Describes a symbol defined within an assembler's code that is visible to other code.
+struct ExportedSymbol {
+    /// The name of the symbol.
+    std::string name;
+
+    /// Offset into the code buffer that the symbol refers to.
+    ptrdiff_t offset = 0;
+
+    /// The size of the entity the symbol refers to in bytes, or zero if unknown.
+    size_t size = 0;
+
+    /// What the symbol refers to.
+    SymbolType type = SymbolType::Function;
+};
+
+/// Retrieves the number of bytes that a relocation of the given type spans.
+[[nodiscard]] constexpr size_t GetRelocationSize(RelocationType type) noexcept {
+    switch (type) {
+    case RelocationType::Absolute64:
+    case RelocationType::Call:
+        return 8;
+    case RelocationType::Absolute32:
+    case RelocationType::Branch:
+    case RelocationType::Jal:
+    case RelocationType::PCRelHi20:
+    case RelocationType::PCRelLo12I:
+    case RelocationType::PCRelLo12S:
+        return 4;
+    }
+    return 0;
+}
+
+} // namespace biscuit
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <biscuit/decoder.hpp>
+#include <biscuit/fusion.hpp>
+#include <biscuit/ir.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace biscuit {
+
+/// Groups of instructions that share their timing on a core.
+enum class InstructionClass : uint8_t {
+    IntAlu, //< Integer arithmetic, logic, shifts and bit manipulation.
+    IntMul, //< Integer multiplication, including carry-less multiplication.
+    IntDiv, //< Integer division and remainder.
+    Load,   //< Integer and floating-point loads.
+    Store,  //< Integer and floating-point stores.
+    FpAlu,  //< Floating-point addition, comparisons, conversions and moves.
+    FpMul,  //< Floating-point multiplication and fused multiply-add.
+    FpDiv,  //< Floating-point division and square root.
+    Branch, //< Conditional branches and direct jumps.
+
+    /// Anything else (e.g. CSR accesses, fences, atomics, or vector instructions).
+    /// These are never moved by the scheduler, and nothing is moved across them.
+    Other,
+};
+
+/// The number of instruction classes.
+constexpr size_t num_instruction_classes = static_cast<size_t>(InstructionClass::Other) + 1;
+
+/**
+ * Retrieves the class of an instruction.
+ *
+ * @param instruction The instruction to classify.
+ */
+[[nodiscard]] InstructionClass GetInstructionClass(const Instruction& instruction) noexcept;
+
+/// The timing of an instruction class on a core.
+struct ClassTiming {
+    /// The number of cycles until the result can be used by a dependent instruction.
+    uint8_t latency;
+
+    /// The number of cycles a port is occupied for, which is 1 for pipelined units.
+    uint8_t occupancy;
+
+    /// A bitmask of the ports that can execute instructions of this class.
+    uint8_t ports;
+};
+
+/**
+ * A model of an in-order core, used for scheduling and cycle estimates.
+ *
+ * Models are plain data, so models of other cores can be created the same way the
+ * provided ones are, e.g. by copying one of them and adjusting the timings.
+ *
+ * @note Models are approximations. Latencies that vary with their operands
+ *       (e.g. divisions) are represented by a typical value.
+ */
+struct MachineModel {
+    /// The maximum number of ports a model can have.
+    static constexpr size_t max_ports = 8;
+
+    /// A human-readable name of the core.
+    std::string_view name;
+
+    /// The maximum number of instructions issued per cycle.
+    uint32_t issue_width;
+
+    /// The number of ports, each of which accepts one instruction per cycle.
+    uint32_t num_ports;
+
+    /// The size of the aligned blocks that instructions are fetched in, in bytes.
+    /// Useful for aligning loop heads, see Assembler::AlignLoopHead.
+    uint32_t fetch_block_size;
+
+    /// The timing of each instruction class, indexed by InstructionClass.
+    std::array<ClassTiming, num_instruction_classes> timings;
+
+    /// The pairs of adjacent instructions the core fuses, if any.
+    FusionProfile fusion;
+
+    /// Retrieves the timing of an instruction class.
+    [[nodiscard]] const ClassTiming& GetTiming(InstructionClass instruction_class) const noexcept {
+        return timings[static_cast<size_t>(instruction_class)];
+    }
+
+    /**
+     * SiFive U74: dual-issue in-order, with two ALU pipes, one memory pipe,
+     * a shared multiply/divide unit and a floating-point unit.
+     * Timings approximate those given in the U74 core complex manual.
+     */
+    [[nodiscard]] static MachineModel SiFiveU74() noexcept;
+
+    /**
+     * T-Head C906: single-issue in-order, 5-stage pipeline.
+     * Timings approximate those given in the C906 user manual.
+     */
+    [[nodiscard]] static MachineModel TheadC906() noexcept;
+};
+
+/**
+ * Estimates the number of cycles a stream takes to issue on a core, assuming
+ * that every instruction is executed once in order and that caches always hit.
+ *
+ * @param stream The stream to estimate.
+ * @param model  The core to estimate for.
+ */
+[[nodiscard]] uint64_t EstimateCycles(const IRStream& stream, const MachineModel& model);
+
+/**
+ * A pass that reorders the instructions of each basic block within a
+ * recorded stream to reduce stalls on an in-order core.
+ *
+ * Blocks are list scheduled by the length of the dependency chain each
+ * instruction heads, while modelling the issue width and ports of the core.
+ * Register dependencies are tracked exactly. Memory is treated as a single
+ * location, so stores are never reordered with any other memory access, while
+ * loads may be reordered with each other. Branches, labels, and instructions
+ * of InstructionClass::Other delimit blocks and are never moved.
+ *
+ * A block is only reordered if that reduces its estimated number of cycles.
+ *
+ * @par
+ * An example of scheduling code for a particular core:
+ *
+ * @code{.cpp}
+ * IRPassPipeline passes;
+ * passes.Add(Scheduler{MachineModel::SiFiveU74()});
+ *
+ * as.BeginRecording();
+ * // ... emit code ...
+ * as.EndRecording(passes);
+ * @endcode
+ *
+ * @note Pairs of adjacent instructions that the core fuses (see MachineModel::fusion)
+ *       are scheduled as a unit, so that they stay adjacent.
+ */
+class Scheduler {
+public:
+    /**
+     * Constructor
+     *
+     * @param model The core to schedule for.
+     */
+    explicit Scheduler(const MachineModel& model) noexcept : m_model{model} {}
+
+    /**
+     * Schedules the instructions of a stream.
+     *
+     * @param stream The stream to schedule.
+     *
+     * @returns The number of blocks that were reordered.
+     */
+    size_t Run(IRStream& stream) const;
+
+    /// Schedules the instructions of a stream, so that the pass can be added to an IRPassPipeline.
+    void operator()(IRStream& stream) const {
+        static_cast<void>(Run(stream));
+    }
+
+    /// Retrieves the core being scheduled for.
+    [[nodiscard]] const MachineModel& GetModel() const noexcept {
+        return m_model;
+    }
+
+private:
+    MachineModel m_model;
+};
+
+} // namespace biscuit
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/cpuinfo.hpp>
+#include <biscuit/registers.hpp>
+#include <biscuit/vector.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace biscuit {
+
+/// A single strip of a strip-mined loop, as seen by the loop body.
+struct StripMineStrip {
+    /// The register holding the number of elements processed by this strip.
+    GPR vl;
+
+    /// Which of the unrolled copies of the body this is, starting at zero.
+    uint32_t unroll_index;
+
+    /// The register groups reserved for each copy of the body.
+    uint32_t groups_per_body;
+
+    /// The first register of the first group reserved for the loop.
+    Vec first_group;
+
+    /// The number of registers in each group.
+    uint32_t group_size;
+
+    /**
+     * Retrieves one of the register groups reserved for this copy of the body.
+     * Every copy receives distinct groups, so that copies don't have to wait
+     * for each other to finish reading their registers.
+     *
+     * @param index The index of the group within this copy.
+     *
+     * @pre index must be less than `groups_per_body`.
+     */
+    [[nodiscard]] Vec GetGroup(uint32_t index) const noexcept;
+};
+
+/**
+ * Emits vector-length agnostic loops over arrays, in the canonical
+ * strip-mined shape given by the vector extension specification.
+ *
+ * Each strip configures the vector unit for the remaining number of elements,
+ * runs the body, decrements the count by the number of processed elements,
+ * and advances every registered pointer past them:
+ *
+ * @code{.unparsed}
+ *     beqz   count, done
+ * loop:
+ *     vsetvli vl, count, e32, m4, ta, ma
+ *     <body>
+ *     sub    count, count, vl
+ *     sh2add ptr, vl, ptr           (slli + add without Zba)
+ *     bnez   count, loop
+ * done:
+ * @endcode
+ *
+ * With an unroll factor, each iteration of the loop consists of several
+ * strips, each with its own copy of the body and its own register groups.
+ * Strips other than the last exit the loop once the count reaches zero.
+ *
+ * @par
+ * An example of adding two arrays of 32-bit integers, i.e. `a[i] += b[i]`:
+ *
+ * @code{.cpp}
+ * StripMineLoop loop{as, SEW::E32, LMUL::M4};
+ * loop.AddPointer(a0);
+ * loop.AddPointer(a1);
+ * loop.Emit(a2, t0, t1, [](Assembler& as, const StripMineStrip& strip) {
+ *     const auto lhs = strip.GetGroup(0);
+ *     const auto rhs = strip.GetGroup(1);
+ *     as.VLE32(lhs, a0);
+ *     as.VLE32(rhs, a1);
+ *     as.VADD(lhs, lhs, rhs);
+ *     as.VSE32(lhs, a0);
+ * });
+ * @endcode
+ *
+ * @note Branches across the loop are conditional branches, so the
+ *       unrolled loop must be smaller than 4KiB.
+ */
+class StripMineLoop {
+public:
+    /// Emits the body of a strip.
+    using Body = std::function<void(Assembler&, const StripMineStrip&)>;
+
+    /**
+     * Constructor
+     *
+     * @param assembler  The assembler to emit the loop with.
+     * @param sew        The element width the loop is configured for.
+     * @param lmul       The register group multiplier the loop is configured for.
+     * @param extensions The extensions available to the loop.
+     *                   With Zba, pointers are advanced with SH1ADD, SH2ADD, or SH3ADD.
+     */
+    explicit StripMineLoop(Assembler& assembler, SEW sew, LMUL lmul = LMUL::M1,
+                           const ExtensionSet& extensions = {}) noexcept;
+
+    /**
+     * Sets the tail and mask policies of the loop. Both are agnostic unless set,
+     * which is the cheapest choice for bodies that don't rely on inactive elements.
+     *
+     * @param vta The tail policy.
+     * @param vma The mask policy.
+     */
+    void SetPolicy(VTA vta, VMA vma) noexcept {
+        m_vta = vta;
+        m_vma = vma;
+    }
+
+    /**
+     * Sets how many strips are processed by each iteration of the loop,
+     * and how many register groups each copy of the body needs.
+     *
+     * Groups are handed out from the first LMUL-aligned group after v0,
+     * which is left alone so that it can be used as a mask. Unless set,
+     * there is a single copy of the body, which receives every group.
+     *
+     * @param factor          The number of strips per iteration.
+     * @param groups_per_body The number of register groups each copy of the body needs.
+     *
+     * @pre factor and groups_per_body must be at least 1.
+     * @pre The groups of all copies must fit in the vector registers after v0.
+     */
+    void SetUnroll(uint32_t factor, uint32_t groups_per_body);
+
+    /**
+     * Registers a pointer that the loop advances past each strip.
+     *
+     * @param pointer      The register holding the pointer.
+     * @param element_size The size in bytes of each element the pointer points to,
+     *                     or zero for the element width of the loop.
+     *
+     * @pre element_size must be zero or a power of two.
+     */
+    void AddPointer(GPR pointer, uint32_t element_size = 0);
+
+    /**
+     * Emits the loop.
+     *
+     * @param count   The register holding the number of elements to process, which
+     *                is zero after the loop.
+     * @param vl      A register that receives the number of elements of each strip.
+     * @param scratch A register that may be clobbered while advancing pointers.
+     * @param body    Emits the body of each strip.
+     *
+     * @pre The registers must be distinct, none of them may be the zero register,
+     *      and none of them may be a registered pointer.
+     */
+    void Emit(GPR count, GPR vl, GPR scratch, const Body& body);
+
+private:
+    struct Pointer {
+        GPR reg;
+        uint32_t shift;
+    };
+
+    // Advances every registered pointer by vl elements.
+    void EmitPointerIncrements(GPR vl, GPR scratch);
+
+    Assembler& m_assembler;
+    ExtensionSet m_extensions;
+    SEW m_sew;
+    LMUL m_lmul;
+    VTA m_vta = VTA::Yes;
+    VMA m_vma = VMA::Yes;
+    uint32_t m_unroll_factor = 1;
+    uint32_t m_groups_per_body = 0; // Zero hands every group to a single copy.
+    std::vector<Pointer> m_pointers;
+};
+
+} // namespace biscuit
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/cpuinfo.hpp>
+#include <biscuit/label.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace biscuit {
+
+/// How a cluster of switch cases is lowered.
+enum class SwitchClusterKind : uint32_t {
+    /// A compare against a single case value.
+    Compare,
+
+    /// A bit test of a mask per destination, for few destinations within a small range.
+    BitTest,
+
+    /// A PC-relative jump table, for densely populated ranges.
+    JumpTable,
+};
+
+/// A contiguous range of case values that is lowered as a unit.
+struct SwitchCluster {
+    SwitchClusterKind kind;
+    int64_t low;
+    int64_t high;
+};
+
+/**
+ * Lowers multi-way dispatch on a register into branches, bit tests, and jump tables.
+ *
+ * Cases are sorted by value and partitioned into clusters. Densely populated ranges
+ * become PC-relative jump tables, small ranges with few destinations become bit tests,
+ * and every other case is compared individually. The clusters are then dispatched to
+ * with a balanced binary search tree of compares.
+ *
+ * Jump table entries are 32-bit offsets from the table, which is emitted inline after
+ * the indirect jump that uses it. Entries for destinations that aren't bound yet are
+ * filled in by Resolve.
+ *
+ * @par
+ * An example of an interpreter's opcode dispatch:
+ *
+ * @code{.cpp}
+ * std::array<Label, num_handlers> handlers;
+ * Label invalid_opcode;
+ *
+ * Switch dispatch{as};
+ * for (const auto& [opcode, handler] : opcode_handlers) {
+ *     dispatch.AddCase(opcode, &handlers[handler]);
+ * }
+ * dispatch.Emit(a0, &invalid_opcode, t0, t1);
+ *
+ * // ... bind every handler and invalid_opcode ...
+ *
+ * dispatch.Resolve();
+ * @endcode
+ *
+ * @note Case values are compared as signed XLEN-bit integers.
+ *
+ * @note Any jump table entry whose destination is *not* resolved will result in
+ *       an assertion being invoked when the switch's destructor is executed.
+ */
+class Switch {
+public:
+    /// The smallest number of cases worth a jump table.
+    static constexpr size_t min_jump_table_cases = 4;
+
+    /// The smallest percentage of a jump table's entries that must be cases.
+    static constexpr uint64_t min_jump_table_density = 40;
+
+    /// The largest number of entries a jump table can have.
+    static constexpr uint64_t max_jump_table_entries = 4096;
+
+    /// The smallest number of cases worth a bit test.
+    static constexpr size_t min_bit_test_cases = 3;
+
+    /// The largest number of destinations a bit test can have.
+    static constexpr size_t max_bit_test_destinations = 3;
+
+    /**
+     * Constructor
+     *
+     * @param assembler  The assembler to emit the dispatch with.
+     * @param extensions The extensions available to the dispatch.
+     *                   With Zba, jump table indices are scaled with SH2ADD.
+     */
+    explicit Switch(Assembler& assembler, const ExtensionSet& extensions = {});
+
+    /// Destructor
+    ~Switch() noexcept;
+
+    // Jump table entries that Resolve still has to fill in would be
+    // written twice by a copy, or trip the destructor of the original.
+    Switch(const Switch&) = delete;
+    Switch& operator=(const Switch&) = delete;
+    Switch(Switch&&) = delete;
+    Switch& operator=(Switch&&) = delete;
+
+    /**
+     * Adds a case to the switch.
+     *
+     * @param value  The value of the case.
+     * @param target The label to jump to if the dispatched value equals the case value.
+     *
+     * @pre Every case must have a distinct value.
+     * @pre On RV32, the value must fit in 32 bits.
+     */
+    void AddCase(int64_t value, Label* target);
+
+    /**
+     * Emits the dispatch on a register.
+     *
+     * @param value          The register containing the value to dispatch on.
+     * @param default_target The label to jump to if no case matches.
+     * @param scratch1       A register that may be clobbered.
+     * @param scratch2       Another register that may be clobbered.
+     *
+     * @pre The registers must be distinct, and none of them may be the zero register.
+     * @pre The switch can only be emitted once.
+     */
+    void Emit(GPR value, Label* default_target, GPR scratch1, GPR scratch2);
+
+    /**
+     * Fills in the jump table entries of destinations that have been bound since the
+     * switch was emitted. Entries of destinations that are already bound are
+     * filled in when they're emitted.
+     *
+     * @pre Every destination of a jump table must be bound.
+     */
+    void Resolve();
+
+    /// Determines whether or not any jump table entries are waiting for their destination.
+    [[nodiscard]] bool HasPendingEntries() const noexcept {
+        return !m_pending_entries.empty();
+    }
+
+    /// Retrieves the clusters that the cases were partitioned into when emitted.
+    [[nodiscard]] const std::vector<SwitchCluster>& GetClusters() const noexcept {
+        return m_clusters;
+    }
+
+private:
+    struct Case {
+        int64_t value;
+        Label* target;
+    };
+
+    struct TableEntry {
+        ptrdiff_t offset;
+        ptrdiff_t table;
+        Label* target;
+    };
+
+    // Partitions the sorted cases into clusters.
+    void BuildClusters();
+
+    // Emits a binary search over the clusters in [first, last).
+    void EmitTree(size_t first, size_t last);
+
+    void EmitCompare(const SwitchCluster& cluster);
+    void EmitBitTest(const SwitchCluster& cluster);
+    void EmitJumpTable(const SwitchCluster& cluster);
+
+    // Sets scratch1 to the dispatched value minus `low`, and jumps to
+    // the default destination if that's larger than `high - low`.
+    void EmitRangeCheck(int64_t low, int64_t high);
+
+    // Emits a jump to an external destination if `rs` is (not) zero. Destinations
+    // may be out of range of a branch, so this branches over a jump to them.
+    void EmitJumpIfZero(GPR rs, Label* target);
+    void EmitJumpIfNotZero(GPR rs, Label* target);
+
+    // Writes the offset of a bound destination into a jump table entry.
+    void WriteEntry(const TableEntry& entry);
+
+    // Retrieves the cases within [low, high].
+    [[nodiscard]] std::vector<Case> GetCases(int64_t low, int64_t high) const;
+
+    Assembler& m_assembler;
+    ExtensionSet m_extensions;
+
+    std::vector<Case> m_cases;
+    std::vector<SwitchCluster> m_clusters;
+    std::vector<TableEntry> m_pending_entries;
+
+    GPR m_value;
+    GPR m_scratch1;
+    GPR m_scratch2;
+    Label* m_default = nullptr;
+    bool m_is_emitted = false;
+};
+
+} // namespace biscuit
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <biscuit/registers.hpp>
+#include <biscuit/vector.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace biscuit {
+
+/**
+ * How the register groups of a vector instruction relate to LMUL.
+ *
+ * Operands are named after the instruction encoding, i.e. `vd`, `vs2`, and `vs1`.
+ */
+enum class VectorShape : uint32_t {
+    /// Every operand is a group of LMUL registers, e.g. VADD.
+    SingleWidth,
+
+    /// `vd` is a group of 2*LMUL registers, the sources are groups of LMUL registers, e.g. VWADD.
+    Widening,
+
+    /// `vd` and `vs2` are groups of 2*LMUL registers, `vs1` is a group of LMUL registers, e.g. VWADDW.
+    WideningWide,
+
+    /// `vs2` is a group of 2*LMUL registers, `vd` and `vs1` are groups of LMUL registers, e.g. VNSRL.
+    Narrowing,
+
+    /// `vs2` is a group of LMUL registers, `vd` and `vs1` are single registers, e.g. VREDSUM.
+    Reduction,
+
+    /// Like Reduction, but `vd` and `vs1` have twice the element width of `vs2`, e.g. VWREDSUM.
+    WideningReduction,
+};
+
+/**
+ * Determines whether or not the operands of a vector instruction are legal for the given LMUL.
+ *
+ * Register groups must be aligned to their size, and sources of a different element width
+ * than the destination may only overlap it where the vector extension specification allows:
+ *
+ * - Widening destinations may only overlap a source in their highest-numbered half,
+ *   and only if LMUL is at least 1. e.g. `VWADD.VV v2, v3, v4` with LMUL=1.
+ *
+ * - Narrowing destinations may only overlap the lowest-numbered half of the source.
+ *   e.g. `VNSRL.WI v2, v2, 3` with LMUL=1, but not `VNSRL.WI v3, v2, 3`.
+ *
+ * - Sources of different element widths may not overlap each other.
+ *
+ * - Masked instructions may not use v0 as any other operand, except
+ *   as the destination of a reduction, which is a single element.
+ *
+ * @param shape The shape of the instruction.
+ * @param lmul  The register group multiplier the instruction executes with.
+ * @param vd    The destination register group.
+ * @param vs2   The first source register group.
+ * @param vs1   The second source register group, if the second source is a vector.
+ * @param mask  Whether or not the instruction is masked.
+ */
+[[nodiscard]] bool AreVectorOperandsLegal(VectorShape shape, LMUL lmul, Vec vd, Vec vs2,
+                                          std::optional<Vec> vs1 = std::nullopt,
+                                          VecMask mask = VecMask::No) noexcept;
+
+/**
+ * Hands out vector register groups that are aligned for a given LMUL.
+ *
+ * v0 is reserved for masks, so it's only handed out by AllocateMask and
+ * never as part of a group. Groups of eight registers are therefore
+ * limited to v8, v16, and v24.
+ *
+ * Groups stay live until they're freed, or until the Scope they were allocated
+ * within ends, whichever comes first.
+ *
+ * @par
+ * An example of allocating the operands of a widening multiply-add:
+ *
+ * @code{.cpp}
+ * VectorRegisterAllocator allocator;
+ * {
+ *     VectorRegisterAllocator::Scope scope{allocator};
+ *     const auto acc = allocator.Allocate(LMUL::M8);
+ *     const auto lhs = allocator.Allocate(LMUL::M4);
+ *     const auto rhs = allocator.Allocate(LMUL::M4);
+ *     BISCUIT_ASSERT(AreVectorOperandsLegal(VectorShape::Widening, LMUL::M4, acc, rhs, lhs));
+ *     as.VWMACC(acc, lhs, rhs);
+ * } // acc, lhs, and rhs are free again.
+ * @endcode
+ */
+class VectorRegisterAllocator {
+public:
+    /// Frees every group allocated within its lifetime once it ends.
+    class Scope {
+    public:
+        explicit Scope(VectorRegisterAllocator& allocator) noexcept;
+        ~Scope() noexcept;
+
+        // Scopes free everything allocated past the depth they were opened
+        // at, so they must end exactly once and in reverse order.
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(Scope&&) = delete;
+
+    private:
+        VectorRegisterAllocator& m_allocator;
+        uint32_t m_depth;
+    };
+
+    VectorRegisterAllocator() noexcept = default;
+
+    // Open scopes hold a reference to the allocator and free groups through it.
+    VectorRegisterAllocator(const VectorRegisterAllocator&) = delete;
+    VectorRegisterAllocator& operator=(const VectorRegisterAllocator&) = delete;
+    VectorRegisterAllocator(VectorRegisterAllocator&&) = delete;
+    VectorRegisterAllocator& operator=(VectorRegisterAllocator&&) = delete;
+
+    /**
+     * Allocates the lowest free register group that is aligned for the given LMUL.
+     * Fractional LMULs allocate a single register.
+     *
+     * @param lmul The register group multiplier the group is used with.
+     *
+     * @returns The first register of the group, or std::nullopt
+     *          if no suitably aligned group is free.
+     */
+    [[nodiscard]] std::optional<Vec> TryAllocate(LMUL lmul) noexcept;
+
+    /**
+     * Allocates the lowest free register group that is aligned for the given LMUL.
+     *
+     * @param lmul The register group multiplier the group is used with.
+     *
+     * @pre A suitably aligned group must be free.
+     */
+    [[nodiscard]] Vec Allocate(LMUL lmul) noexcept;
+
+    /**
+     * Allocates v0 for use as a mask.
+     *
+     * @pre v0 must not already be allocated.
+     */
+    [[nodiscard]] Vec AllocateMask() noexcept;
+
+    /**
+     * Frees a group that was previously allocated.
+     *
+     * @param group The first register of the group.
+     *
+     * @pre group must be the first register of a live group.
+     */
+    void Free(Vec group) noexcept;
+
+    /// Whether or not a register is part of a live group.
+    [[nodiscard]] bool IsLive(Vec reg) const noexcept {
+        return (m_live & (1U << reg.Index())) != 0;
+    }
+
+    /// Retrieves the number of registers that aren't part of a live group, including v0.
+    [[nodiscard]] uint32_t GetFreeCount() const noexcept;
+
+private:
+    struct Group {
+        uint8_t size;
+        uint8_t depth;
+    };
+
+    void MarkLive(uint32_t index, uint32_t size) noexcept;
+
+    // Indexed by the first register of each live group.
+    std::array<Group, 32> m_groups{};
+    uint32_t m_live = 0;
+    uint32_t m_depth = 0;
+};
+
+} // namespace biscuit
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/label.hpp>
+#include <biscuit/registers.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace biscuit {
+
+class VirtualCodeBuilder;
+
+/// A general purpose register that is assigned a physical register by a VirtualCodeBuilder.
+struct VirtualGPR {
+    uint32_t id;
+
+    friend constexpr bool operator==(VirtualGPR, VirtualGPR) = default;
+};
+
+/// A floating-point register that is assigned a physical register by a VirtualCodeBuilder.
+struct VirtualFPR {
+    uint32_t id;
+
+    friend constexpr bool operator==(VirtualFPR, VirtualFPR) = default;
+};
+
+/// Identifies a label within a VirtualCodeBuilder.
+using VirtualLabel = uint32_t;
+
+/**
+ * Resolves virtual registers and labels to the physical registers
+ * and labels they're emitted with, within the emitter of a single node.
+ *
+ * Uses and definitions are distinguished so that the builder knows which values
+ * each node reads and writes, e.g. `as.ADD(map.Def(sum), map.Use(lhs), map.Use(rhs))`.
+ */
+class RegisterMap {
+public:
+    /// Retrieves the physical register to read a virtual register from.
+    [[nodiscard]] GPR Use(VirtualGPR reg);
+
+    /// Retrieves the physical register to read a virtual register from.
+    [[nodiscard]] FPR Use(VirtualFPR reg);
+
+    /// Retrieves the physical register to write a virtual register to.
+    [[nodiscard]] GPR Def(VirtualGPR reg);
+
+    /// Retrieves the physical register to write a virtual register to.
+    [[nodiscard]] FPR Def(VirtualFPR reg);
+
+    /// Retrieves the label to branch or jump to.
+    [[nodiscard]] Label* GetLabel(VirtualLabel label);
+
+private:
+    friend class VirtualCodeBuilder;
+
+    explicit RegisterMap(VirtualCodeBuilder& builder, size_t node) noexcept
+        : m_builder{builder}, m_node{node} {}
+
+    [[nodiscard]] uint32_t Resolve(uint32_t reg, bool is_def);
+
+    VirtualCodeBuilder& m_builder;
+    size_t m_node;
+
+    // Labels handed out while a node is being analyzed, and the labels they stand in for.
+    std::deque<Label> m_analysis_labels;
+    std::vector<VirtualLabel> m_analysis_label_ids;
+
+    // Registers resolved while a node is being analyzed, in the order they were first resolved.
+    std::vector<uint32_t> m_analysis_registers;
+};
+
+/**
+ * Records code written in terms of virtual registers, assigns physical registers
+ * to them with linear-scan allocation, and emits the code with those registers.
+ *
+ * Code is recorded as a sequence of nodes, each of which is an emitter that
+ * resolves its registers through a RegisterMap. Every emitter is invoked once
+ * when it's added, to find out which virtual registers and labels it refers to,
+ * and once more when the code is emitted.
+ *
+ * Allocation follows the standard calling convention:
+ *
+ * - Values that are live across nodes added with AddCall are only kept in the
+ *   callee-saved registers s0-s11 and fs0-fs11, all other values prefer the
+ *   caller-saved t and a registers, so that they don't need to be preserved.
+ *
+ * - Values that are referenced by many nodes prefer x8-x15 and f8-f15,
+ *   which are the registers compressed instructions can encode.
+ *
+ * - Values that don't fit into registers are spilled to 8-byte stack slots,
+ *   and are loaded into t5/t6 or ft9-ft11 around each node referring to them.
+ *   Since those are the only scratch registers, each node reads at most two spilled GPRs
+ *   and three spilled FPRs, and writes at most as many. Other values are spilled instead,
+ *   and allocation fails if there are none left to spill.
+ *
+ * @par
+ * An example of summing an array of 64-bit integers:
+ *
+ * @code{.cpp}
+ * VirtualCodeBuilder builder;
+ * const auto sum = builder.NewGPR();
+ * const auto value = builder.NewGPR();
+ * const auto loop = builder.NewLabel();
+ *
+ * builder.Reserve(a0);
+ * builder.Reserve(a1);
+ * builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(sum), 0); });
+ * builder.Bind(loop);
+ * builder.Add([=](Assembler& as, RegisterMap& map) { as.LD(map.Def(value), 0, a0); });
+ * builder.Add([=](Assembler& as, RegisterMap& map) { as.ADD(map.Def(sum), map.Use(sum), map.Use(value)); });
+ * builder.Add([](Assembler& as, RegisterMap&) { as.ADDI(a0, a0, 8); });
+ * builder.Add([=](Assembler& as, RegisterMap& map) { as.BNE(a0, a1, map.GetLabel(loop)); });
+ * builder.Add([=](Assembler& as, RegisterMap& map) { as.MV(a0, map.Use(sum)); });
+ *
+ * builder.Allocate();
+ * // ... reserve builder.GetSpillAreaSize() bytes of stack and
+ * //     save builder.GetUsedCalleeSavedGPRs() ...
+ * builder.Emit(as);
+ * @endcode
+ *
+ * @note Each node is treated as a single instruction, i.e. the registers it reads
+ *       may be reused for the registers it writes. Emitters of several instructions
+ *       must read every virtual register they use before writing any they define.
+ *
+ * @note Physical registers that emitters refer to directly must be reserved,
+ *       and emitters must only refer to labels through the RegisterMap.
+ */
+class VirtualCodeBuilder {
+public:
+    /// Emits a node.
+    using Emitter = std::function<void(Assembler&, RegisterMap&)>;
+
+    /**
+     * Constructor
+     *
+     * @param features The architecture the code is emitted for.
+     */
+    explicit VirtualCodeBuilder(ArchFeature features = ArchFeature::RV64) noexcept;
+
+    VirtualCodeBuilder(const VirtualCodeBuilder&) = delete;
+    VirtualCodeBuilder& operator=(const VirtualCodeBuilder&) = delete;
+    VirtualCodeBuilder(VirtualCodeBuilder&&) = delete;
+    VirtualCodeBuilder& operator=(VirtualCodeBuilder&&) = delete;
+
+    /// Creates a new virtual general purpose register.
+    [[nodiscard]] VirtualGPR NewGPR();
+
+    /// Creates a new virtual floating-point register.
+    [[nodiscard]] VirtualFPR NewFPR();
+
+    /**
+     * Creates a new label.
+     *
+     * @param external The label outside of the builder to refer to, or nullptr to
+     *                 create a label that is bound within the builder with Bind.
+     */
+    [[nodiscard]] VirtualLabel NewLabel(Label* external = nullptr);
+
+    /**
+     * Excludes a physical register from allocation, so that emitters can refer to it directly.
+     *
+     * @pre Code must not have been allocated yet.
+     */
+    void Reserve(GPR reg);
+
+    /// @copydoc Reserve(GPR)
+    void Reserve(FPR reg);
+
+    /**
+     * Sets where spilled values are stored. Stack slots are laid
+     * out consecutively from `offset` bytes past the base register.
+     *
+     * @param base   The register holding the base of the spill area, SP by default.
+     * @param offset The offset of the spill area from the base register.
+     *
+     * @pre base must be reserved, unless it's SP.
+     */
+    void SetSpillArea(GPR base, int32_t offset) noexcept {
+        m_spill_base = base;
+        m_spill_offset = offset;
+    }
+
+    /**
+     * Adds a node to the code.
+     *
+     * @param emitter Emits the node, resolving registers and labels through the register map.
+     *
+     * @pre Code must not have been allocated yet.
+     */
+    void Add(Emitter emitter);
+
+    /**
+     * Adds a node that calls a function following the standard calling convention,
+     * which clobbers every caller-saved register.
+     *
+     * @param emitter Emits the node, resolving registers and labels through the register map.
+     *
+     * @pre Code must not have been allocated yet.
+     */
+    void AddCall(Emitter emitter);
+
+    /**
+     * Binds a label to the location of the node following it.
+     *
+     * @pre The label must have been created without an external label,
+     *      and must not be bound already.
+     */
+    void Bind(VirtualLabel label);
+
+    /**
+     * Assigns physical registers or stack slots to every virtual register.
+     *
+     * @pre Code must not have been allocated yet.
+     */
+    void Allocate();
+
+    /**
+     * Emits the code, allocating it first if it hasn't been allocated yet.
+     *
+     * @param as The assembler to emit the code with.
+     *
+     * @pre Every label created without an external label must be bound.
+     */
+    void Emit(Assembler& as);
+
+    /**
+     * Retrieves the physical register assigned to a virtual register.
+     *
+     * @returns The physical register, or std::nullopt if the virtual register was spilled.
+     *
+     * @pre Code must have been allocated.
+     */
+    [[nodiscard]] std::optional<GPR> GetAssignment(VirtualGPR reg) const noexcept;
+
+    /// @copydoc GetAssignment(VirtualGPR) const
+    [[nodiscard]] std::optional<FPR> GetAssignment(VirtualFPR reg) const noexcept;
+
+    /// Retrieves the number of bytes of stack that spilled values need.
+    [[nodiscard]] uint32_t GetSpillAreaSize() const noexcept {
+        return m_num_spill_slots * spill_slot_size;
+    }
+
+    /// Retrieves the callee-saved general purpose registers that were assigned to values.
+    [[nodiscard]] std::vector<GPR> GetUsedCalleeSavedGPRs() const;
+
+    /// Retrieves the callee-saved floating-point registers that were assigned to values.
+    [[nodiscard]] std::vector<FPR> GetUsedCalleeSavedFPRs() const;
+
+private:
+    friend class RegisterMap;
+
+    static constexpr uint32_t spill_slot_size = 8;
+    static constexpr uint32_t num_scratch_gprs = 2;
+    static constexpr uint32_t num_scratch_fprs = 3;
+
+    // Where a virtual register lives once allocated.
+    struct Assignment {
+        bool is_fpr = false;
+        bool is_spilled = false;
+
+        // The physical register, or the stack slot of spilled registers.
+        uint32_t index = 0;
+
+        // The number of nodes referring to the register.
+        uint32_t num_references = 0;
+    };
+
+    struct Node {
+        Emitter emitter;
+        std::vector<uint32_t> uses;
+        std::vector<uint32_t> defs;
+        std::vector<VirtualLabel> targets;
+        VirtualLabel bound_label;
+        bool is_call;
+    };
+
+    struct LabelInfo {
+        Label* external;
+        std::optional<size_t> node;
+    };
+
+    void AddNode(Emitter emitter, bool is_call);
+    void EmitSpillCode(Assembler& as, uint32_t reg, uint32_t scratch, bool is_load) const;
+
+    ArchFeature m_features;
+    std::vector<Node> m_nodes;
+    std::vector<Assignment> m_registers;
+    std::vector<LabelInfo> m_labels;
+    uint32_t m_reserved_gprs = 0;
+    uint32_t m_reserved_fprs = 0;
+    GPR m_spill_base = sp;
+    int32_t m_spill_offset = 0;
+    uint32_t m_num_spill_slots = 0;
+    bool m_allocated = false;
+
+    // State of the node that a RegisterMap is currently resolving for.
+    bool m_analyzing = false;
+    std::vector<std::pair<uint32_t, uint32_t>> m_scratch_uses;
+    std::vector<std::pair<uint32_t, uint32_t>> m_scratch_defs;
+    std::vector<Label>* m_emit_labels = nullptr;
+};
+
+} // namespace biscuit
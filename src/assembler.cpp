@@ -1,9 +1,11 @@
 #include <biscuit/assert.hpp>
 #include <biscuit/assembler.hpp>
 
+#include <algorithm>
 #include <array>
 #include <bit>
 #include <cstring>
+#include <iterator>
 #include <utility>
 
 #include "assembler_util.hpp"
@@ -23,6 +25,7 @@ CodeBuffer& Assembler::GetCodeBuffer() {
 }
 
 CodeBuffer Assembler::SwapCodeBuffer(CodeBuffer&& buffer) noexcept {
+    InvalidateVectorConfig();
     return std::exchange(m_buffer, std::move(buffer));
 }
 
@@ -30,6 +33,183 @@ void Assembler::Bind(Label* label) {
     BindToOffset(label, m_buffer.GetCursorOffset());
 }
 
+void Assembler::Align(size_t bytes, FillPolicy fill) {
+    BISCUIT_ASSERT(bytes >= 2 && std::has_single_bit(bytes));
+    BISCUIT_ASSERT(!IsRecording());
+
+    const auto alignment = static_cast<uintptr_t>(bytes);
+
+    if (fill == FillPolicy::Zero) {
+        // Data may leave the cursor at any address.
+        while (m_buffer.GetCursorAddress() % alignment != 0) {
+            m_buffer.Emit(uint8_t{0});
+        }
+        return;
+    }
+
+    // Instructions are always at least 2-byte aligned.
+    BISCUIT_ASSERT(m_buffer.GetCursorAddress() % 2 == 0);
+
+    if (m_buffer.GetCursorAddress() % alignment != 0 && m_buffer.GetCursorAddress() % 4 != 0) {
+        m_buffer.Emit16(0x0001); // C.NOP
+    }
+    while (m_buffer.GetCursorAddress() % alignment != 0) {
+        m_buffer.Emit32(0x00000013); // NOP
+    }
+}
+
+bool Assembler::AlignLoopHead(size_t fetch_block_size, size_t max_padding) {
+    BISCUIT_ASSERT(fetch_block_size >= 4 && std::has_single_bit(fetch_block_size));
+    BISCUIT_ASSERT(!IsRecording());
+
+    const auto address = m_buffer.GetCursorAddress();
+    const auto padding = (fetch_block_size - address % fetch_block_size) % fetch_block_size;
+
+    if (padding <= max_padding) {
+        Align(fetch_block_size);
+        return true;
+    }
+
+    if (address % 4 != 0 && max_padding >= 2) {
+        Align(4);
+    }
+    return false;
+}
+
+void Assembler::AddCodeListener(CodeListener* listener) {
+    BISCUIT_ASSERT(listener != nullptr);
+    BISCUIT_ASSERT(std::find(m_code_listeners.begin(), m_code_listeners.end(), listener) ==
+                   m_code_listeners.end());
+
+    m_code_listeners.push_back(listener);
+}
+
+void Assembler::RemoveCodeListener(CodeListener* listener) {
+    std::erase(m_code_listeners, listener);
+}
+
+void Assembler::FinalizeFunction(std::string_view name, ptrdiff_t start_offset) {
+    const auto cursor_offset = m_buffer.GetCursorOffset();
+    BISCUIT_ASSERT(start_offset >= 0 && start_offset <= cursor_offset);
+
+    const FinalizedFunction function{
+        .name = name,
+        .code = m_buffer.GetOffsetPointer(start_offset),
+        .size = static_cast<size_t>(cursor_offset - start_offset),
+    };
+
+    for (auto* listener : m_code_listeners) {
+        listener->OnFunctionFinalized(function);
+    }
+}
+
+void Assembler::AddRelocation(RelocationType type, std::string_view symbol, int64_t addend) {
+    BISCUIT_ASSERT(type != RelocationType::PCRelLo12I && type != RelocationType::PCRelLo12S);
+
+    // The referencing instruction is emitted after this, so the usual bounds check doesn't apply.
+    m_relocations.push_back({
+        .offset = m_buffer.GetCursorOffset(),
+        .type = type,
+        .symbol = std::string{symbol},
+        .addend = addend,
+        .hi20_offset = 0,
+    });
+}
+
+void Assembler::AddRelocation(Relocation relocation) {
+    const auto size = static_cast<ptrdiff_t>(GetRelocationSize(relocation.type));
+    BISCUIT_ASSERT(relocation.offset >= 0);
+    BISCUIT_ASSERT(relocation.offset + size <= m_buffer.GetCursorOffset());
+
+    if (relocation.type == RelocationType::PCRelLo12I || relocation.type == RelocationType::PCRelLo12S) {
+        const auto iter = std::find_if(m_relocations.begin(), m_relocations.end(),
+                                       [&relocation](const Relocation& other) {
+                                           return other.type == RelocationType::PCRelHi20 &&
+                                                  other.offset == relocation.hi20_offset;
+                                       });
+        BISCUIT_ASSERT(iter != m_relocations.end());
+    }
+
+    m_relocations.push_back(std::move(relocation));
+}
+
+void Assembler::ExportLabel(std::string_view name, const Label* label, size_t size, SymbolType type) {
+    BISCUIT_ASSERT(label != nullptr);
+    BISCUIT_ASSERT(label->IsBound());
+    BISCUIT_ASSERT(!name.empty());
+
+    m_exported_symbols.push_back({
+        .name = std::string{name},
+        .offset = *label->GetLocation(),
+        .size = size,
+        .type = type,
+    });
+}
+
+void Assembler::CallExternal(ExternalSymbol* symbol) {
+    BISCUIT_ASSERT(symbol != nullptr);
+
+    InvalidateVectorConfig();
+
+    if (std::find(m_external_symbols.begin(), m_external_symbols.end(), symbol) == m_external_symbols.end()) {
+        m_external_symbols.push_back(symbol);
+    }
+
+    // Call sites are patched in place, so they must never be compressed.
+    const auto offset = m_buffer.GetCursorOffset();
+    AddRelocation(RelocationType::Call, symbol->GetName());
+    EmitUType(m_buffer, 0, ra, 0b0010111);
+    EmitIType(m_buffer, 0, ra, 0b000, ra, 0b1100111);
+
+    symbol->m_sites.insert(offset);
+    ResolveExternalCallSite(symbol, offset);
+}
+
+void Assembler::BindExternal(ExternalSymbol* symbol, uint64_t address) {
+    BISCUIT_ASSERT(symbol != nullptr);
+    BISCUIT_ASSERT(!symbol->IsBound());
+
+    symbol->m_address = address;
+
+    if (symbol->HasVeneer()) {
+        std::memcpy(m_buffer.GetOffsetPointer(symbol->m_veneer_slot), &address,
+                    IsRV32(m_features) ? sizeof(uint32_t) : sizeof(uint64_t));
+    }
+    for (const auto offset : symbol->m_sites) {
+        ResolveExternalCallSite(symbol, offset);
+    }
+}
+
+void Assembler::PlaceExternalVeneers() {
+    const bool is_rv32 = IsRV32(m_features);
+
+    for (auto* const symbol : m_external_symbols) {
+        if (symbol->HasVeneer() || symbol->IsResolved()) {
+            continue;
+        }
+
+        const auto veneer = m_buffer.GetCursorOffset();
+        const auto slot = EmitVeneer(m_buffer, symbol->GetAddress().value_or(0), is_rv32);
+
+        AddRelocation({
+            .offset = slot,
+            .type = is_rv32 ? RelocationType::Absolute32 : RelocationType::Absolute64,
+            .symbol = std::string{symbol->GetName()},
+            .addend = 0,
+            .hi20_offset = 0,
+        });
+
+        symbol->m_veneer = veneer;
+        symbol->m_veneer_slot = slot;
+
+        // Copy, since resolving sites removes them from the pending set.
+        const auto pending_sites = symbol->m_pending_sites;
+        for (const auto offset : pending_sites) {
+            ResolveExternalCallSite(symbol, offset);
+        }
+    }
+}
+
 void Assembler::ADD(GPR rd, GPR lhs, GPR rhs) noexcept {
     if (IsOptimizationEnabled(Optimization::AutoCompress)) {
         if (IsValid3BitCompressedReg(rd) && IsValid3BitCompressedReg(lhs) && IsValid3BitCompressedReg(rhs)) {
@@ -288,8 +468,10 @@ void Assembler::CALL(int32_t offset) noexcept {
                                            : static_cast<int32_t>(lower);
     const auto new_upper = needs_increment ? upper + 1 : upper;
 
-    AUIPC(x1, new_upper);
-    JALR(x1, new_lower, x1);
+    EmitPair(FusionProfile::AuipcJalr, [&] {
+        AUIPC(x1, new_upper);
+        JALR(x1, new_lower, x1);
+    });
 }
 
 void Assembler::EBREAK() noexcept {
@@ -297,6 +479,9 @@ void Assembler::EBREAK() noexcept {
 }
 
 void Assembler::ECALL() noexcept {
+    // Vector state isn't preserved across system calls.
+    InvalidateVectorConfig();
+
     m_buffer.Emit32(0x00000073);
 }
 
@@ -347,6 +532,9 @@ void Assembler::JAL(int32_t imm) noexcept {
 void Assembler::JAL(GPR rd, int32_t imm) noexcept {
     BISCUIT_ASSERT(IsValidJTypeImm(imm));
 
+    // Code after jumps and calls may run with any vector configuration.
+    InvalidateVectorConfig();
+
     if (IsOptimizationEnabled(Optimization::AutoCompress)) {
         if (IsValidCJTypeImm(imm) && (imm & 0b1) == 0) {
             if (rd == x0) {
@@ -369,6 +557,8 @@ void Assembler::JALR(GPR rs) noexcept {
 void Assembler::JALR(GPR rd, int32_t imm, GPR rs1) noexcept {
     BISCUIT_ASSERT(IsValidSigned12BitImm(imm));
 
+    InvalidateVectorConfig();
+
     if (IsOptimizationEnabled(Optimization::AutoCompress)) {
         if (imm == 0 && rs1 != x0) {
             if (rd == x0) {
@@ -423,15 +613,16 @@ void Assembler::LI(GPR rd, uint64_t imm) noexcept {
         const auto uimm32 = static_cast<uint32_t>(imm);
         const auto hi20 = (uimm32 + 0x800) >> 12 & 0xFFFFF;
         const auto lo12 = static_cast<int32_t>(uimm32) & 0xFFF;
-        GPR rs1 = zero;
 
-        if (hi20 != 0) {
+        if (hi20 != 0 && lo12 != 0) {
+            EmitPair(FusionProfile::LuiAddi, [&] {
+                LUI(rd, hi20);
+                ADDI(rd, rd, lo12);
+            });
+        } else if (hi20 != 0) {
             LUI(rd, hi20);
-            rs1 = rd;
-        }
-
-        if (lo12 != 0 || hi20 == 0) {
-            ADDI(rd, rs1, lo12);
+        } else {
+            ADDI(rd, zero, lo12);
         }
     } else {
         // For 64-bit imm, a sequence of up to 8 instructions (i.e. LUI+ADDIW+SLLI+
@@ -451,15 +642,16 @@ void Assembler::LI(GPR rd, uint64_t imm) noexcept {
             // Add 0x800 to cancel out the signed extension of ADDIW.
             const auto hi20 = (static_cast<uint32_t>(imm) + 0x800) >> 12 & 0xFFFFF;
             const auto lo12 = static_cast<int32_t>(imm) & 0xFFF;
-            GPR rs1 = zero;
 
-            if (hi20 != 0) {
+            if (hi20 != 0 && lo12 != 0) {
+                EmitPair(FusionProfile::LuiAddi, [&] {
+                    LUI(rd, hi20);
+                    ADDIW(rd, rd, lo12);
+                });
+            } else if (hi20 != 0) {
                 LUI(rd, hi20);
-                rs1 = rd;
-            }
-
-            if (lo12 != 0 || hi20 == 0) {
-                ADDIW(rd, rs1, lo12);
+            } else {
+                ADDIW(rd, zero, lo12);
             }
             return;
         }
@@ -1755,14 +1947,39 @@ void Assembler::BindToOffset(Label* label, Label::LocationOffset offset) {
     BISCUIT_ASSERT(label != nullptr);
     BISCUIT_ASSERT(offset >= 0 && offset <= m_buffer.GetCursorOffset());
 
+    // Labels may be reached with any vector configuration.
+    InvalidateVectorConfig();
+
+    if (IsRecording() && offset >= *m_recording_start) {
+        std::vector<ptrdiff_t> external_links;
+        std::copy_if(label->m_offsets.begin(), label->m_offsets.end(), std::back_inserter(external_links),
+                     [this](ptrdiff_t link) { return link < *m_recording_start; });
+        m_recorded_binds.push_back({offset, label, std::move(external_links)});
+    }
+
     label->Bind(offset);
     ResolveLabelOffsets(label);
     label->ClearOffsets();
 }
 
+void Assembler::ResolveExternalCallSite(ExternalSymbol* symbol, ptrdiff_t offset) {
+    const auto address = symbol->GetAddress();
+
+    if ((address && PatchAUIPCPair(m_buffer, offset, *address)) ||
+        (symbol->HasVeneer() && PatchAUIPCPair(m_buffer, offset, m_buffer.GetOffsetAddress(*symbol->m_veneer)))) {
+        symbol->m_pending_sites.erase(offset);
+    } else {
+        symbol->m_pending_sites.insert(offset);
+    }
+}
+
 ptrdiff_t Assembler::LinkAndGetOffset(Label* label) {
     BISCUIT_ASSERT(label != nullptr);
 
+    if (IsRecording()) {
+        m_recorded_links.emplace(m_buffer.GetCursorOffset(), label);
+    }
+
     // If we have a bound label, then it's straightforward to calculate
     // the offsets.
     if (label->IsBound()) {
@@ -150,15 +150,6 @@ void EmitCMPPType(CodeBuffer& buffer, uint32_t funct6, uint32_t funct2, PushPopL
                   int32_t stack_adj, uint32_t op, ArchFeature feature) {
     BISCUIT_ASSERT(stack_adj % 16 == 0);
 
-    static constexpr std::array stack_adj_bases_rv32{
-        0U, 0U, 0U, 0U, 16U, 16U, 16U, 16U,
-        32U, 32U, 32U, 32U, 48U, 48U, 48U, 64U,
-    };
-    static constexpr std::array stack_adj_bases_rv64{
-        0U, 0U, 0U, 0U, 16U, 16U, 32U, 32U,
-        48U, 48U, 64U, 64U, 80U, 80U, 96U, 112U
-    };
-
     const auto bitmask = reglist.GetBitmask();
     const auto stack_adj_base = IsRV64(feature) ? stack_adj_bases_rv64[bitmask]
                                                 : stack_adj_bases_rv32[bitmask];
@@ -324,6 +315,7 @@ void Assembler::C_FSDSP(FPR rs, uint32_t imm) noexcept {
     BISCUIT_ASSERT(IsRV32OrRV64(m_features));
     BISCUIT_ASSERT(imm <= 504);
     BISCUIT_ASSERT(imm % 8 == 0);
+    m_recorded_fsdsp |= IsRecording();
 
     // clang-format off
     const auto new_imm = ((imm & 0x038) << 7) |
@@ -339,6 +331,7 @@ void Assembler::C_J(Label* label) noexcept {
 }
 
 void Assembler::C_J(int32_t offset) noexcept {
+    InvalidateVectorConfig();
     EmitCompressedJump(m_buffer, 0b101, offset, 0b01);
 }
 
@@ -349,6 +342,7 @@ void Assembler::C_JAL(Label* label) noexcept {
 
 void Assembler::C_JAL(int32_t offset) noexcept {
     BISCUIT_ASSERT(IsRV32(m_features));
+    InvalidateVectorConfig();
     EmitCompressedJump(m_buffer, 0b001, offset, 0b01);
 }
 
@@ -377,11 +371,13 @@ void Assembler::C_FSWSP(FPR rs, uint32_t imm) noexcept {
 
 void Assembler::C_JALR(GPR rs) noexcept {
     BISCUIT_ASSERT(rs != x0);
+    InvalidateVectorConfig();
     m_buffer.Emit16(0x9002 | (rs.Index() << 7));
 }
 
 void Assembler::C_JR(GPR rs) noexcept {
     BISCUIT_ASSERT(rs != x0);
+    InvalidateVectorConfig();
     m_buffer.Emit16(0x8002 | (rs.Index() << 7));
 }
 
@@ -659,34 +655,46 @@ void Assembler::C_NOT(GPR rd) noexcept {
 
 void Assembler::CM_JALT(uint32_t index) noexcept {
     BISCUIT_ASSERT(index >= 32 && index <= 255);
+    m_recorded_zcmt |= IsRecording();
+    InvalidateVectorConfig();
     EmitCMJTType(m_buffer, 0b101000, index, 0b10);
 }
 void Assembler::CM_JT(uint32_t index) noexcept {
     BISCUIT_ASSERT(index <= 31);
+    m_recorded_zcmt |= IsRecording();
+    InvalidateVectorConfig();
     EmitCMJTType(m_buffer, 0b101000, index, 0b10);
 }
 
 void Assembler::CM_MVA01S(GPR r1s, GPR r2s) noexcept {
+    m_recorded_zcmp |= IsRecording();
     EmitCMMVType(m_buffer, 0b101011, r1s, 0b11, r2s, 0b10);
 }
 void Assembler::CM_MVSA01(GPR r1s, GPR r2s) noexcept {
+    m_recorded_zcmp |= IsRecording();
     EmitCMMVType(m_buffer, 0b101011, r1s, 0b01, r2s, 0b10);
 }
 
 void Assembler::CM_POP(PushPopList reg_list, int32_t stack_adj) noexcept {
     BISCUIT_ASSERT(stack_adj > 0);
+    m_recorded_zcmp |= IsRecording();
     EmitCMPPType(m_buffer, 0b101110, 0b10, reg_list, stack_adj, 0b10, m_features);
 }
 void Assembler::CM_POPRET(PushPopList reg_list, int32_t stack_adj) noexcept {
     BISCUIT_ASSERT(stack_adj > 0);
+    m_recorded_zcmp |= IsRecording();
+    InvalidateVectorConfig();
     EmitCMPPType(m_buffer, 0b101111, 0b10, reg_list, stack_adj, 0b10, m_features);
 }
 void Assembler::CM_POPRETZ(PushPopList reg_list, int32_t stack_adj) noexcept {
     BISCUIT_ASSERT(stack_adj > 0);
+    m_recorded_zcmp |= IsRecording();
+    InvalidateVectorConfig();
     EmitCMPPType(m_buffer, 0b101111, 0b00, reg_list, stack_adj, 0b10, m_features);
 }
 void Assembler::CM_PUSH(PushPopList reg_list, int32_t stack_adj) noexcept {
     BISCUIT_ASSERT(stack_adj < 0);
+    m_recorded_zcmp |= IsRecording();
     EmitCMPPType(m_buffer, 0b101110, 0b00, reg_list, stack_adj, 0b10, m_features);
 }
 
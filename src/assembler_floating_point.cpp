@@ -525,41 +525,6 @@ void Assembler::FCVT_H_LU(FPR rd, GPR rs1, RMode rmode) noexcept {
 // Zfa Extension Instructions
 
 static void FLIImpl(CodeBuffer& buffer, uint32_t funct7, FPR rd, double value) noexcept {
-    static constexpr std::array fli_table{
-        0xBFF0000000000000ULL, // -1.0
-        0x0010000000000000ULL, // Minimum positive normal
-        0x3EF0000000000000ULL, // 1.0 * 2^-16
-        0x3F00000000000000ULL, // 1.0 * 2^-15
-        0x3F70000000000000ULL, // 1.0 * 2^-8
-        0x3F80000000000000ULL, // 1.0 * 2^-7
-        0x3FB0000000000000ULL, // 1.0 * 2^-4
-        0x3FC0000000000000ULL, // 1.0 * 2^-3
-        0x3FD0000000000000ULL, // 0.25
-        0x3FD4000000000000ULL, // 0.3125
-        0x3FD8000000000000ULL, // 0.375
-        0x3FDC000000000000ULL, // 0.4375
-        0x3FE0000000000000ULL, // 0.5
-        0x3FE4000000000000ULL, // 0.625
-        0x3FE8000000000000ULL, // 0.75
-        0x3FEC000000000000ULL, // 0.875
-        0x3FF0000000000000ULL, // 1.0
-        0x3FF4000000000000ULL, // 1.25
-        0x3FF8000000000000ULL, // 1.5
-        0x3FFC000000000000ULL, // 1.75
-        0x4000000000000000ULL, // 2.0
-        0x4004000000000000ULL, // 2.5
-        0x4008000000000000ULL, // 3
-        0x4010000000000000ULL, // 4
-        0x4020000000000000ULL, // 8
-        0x4030000000000000ULL, // 16
-        0x4060000000000000ULL, // 2^7
-        0x4070000000000000ULL, // 2^8
-        0x40E0000000000000ULL, // 2^15
-        0x40F0000000000000ULL, // 2^16
-        0x7FF0000000000000ULL, // +inf
-        0x7FF8000000000000ULL, // Canonical NaN
-    };
-
     uint64_t ivalue{};
     std::memcpy(&ivalue, &value, sizeof(uint64_t));
 
@@ -4,8 +4,10 @@
 #include <biscuit/code_buffer.hpp>
 #include <biscuit/registers.hpp>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 // Generic internal utility header for various helper functions related
 // to encoding instructions.
@@ -183,6 +185,64 @@ inline void EmitUType(CodeBuffer& buffer, uint32_t imm, GPR rd, uint32_t opcode)
     buffer.Emit32((imm & 0x000FFFFF) << 12 | rd.Index() << 7 | (opcode & 0x7F));
 }
 
+// Emits a veneer that jumps to the address held in the slot right after it.
+// The veneer clobbers T1 and has the following shape:
+//
+//   AUIPC  t1, 0
+//   L{W,D} t1, (slot - veneer)(t1)
+//   JR     t1
+//   [padding to slot alignment]
+//   slot: .{word,dword} address
+//
+// Returns the offset of the slot.
+inline ptrdiff_t EmitVeneer(CodeBuffer& buffer, uint64_t address, bool is_rv32) {
+    const ptrdiff_t slot_size = is_rv32 ? 4 : 8;
+    const auto veneer = buffer.GetCursorOffset();
+    const auto slot = (veneer + 12 + slot_size - 1) & ~(slot_size - 1);
+
+    EmitUType(buffer, 0, t1, 0b0010111);
+    EmitIType(buffer, static_cast<uint32_t>(slot - veneer), t1, is_rv32 ? 0b010 : 0b011, t1, 0b0000011);
+    EmitIType(buffer, 0, t1, 0b000, zero, 0b1100111);
+
+    while (buffer.GetCursorOffset() < slot) {
+        buffer.Emit16(0);
+    }
+
+    if (is_rv32) {
+        buffer.Emit32(static_cast<uint32_t>(address));
+    } else {
+        buffer.Emit(address);
+    }
+
+    return slot;
+}
+
+// Patches an AUIPC and the I-type instruction after it to compute an address.
+// Returns false if the address is out of range of the pair.
+inline bool PatchAUIPCPair(CodeBuffer& buffer, ptrdiff_t offset, uint64_t address) {
+    const auto pc = static_cast<uint64_t>(buffer.GetOffsetAddress(offset));
+    const auto distance = static_cast<int64_t>(address - pc);
+
+    // The sign-extended lower 12 bits are compensated for by rounding the upper 20 bits.
+    const auto rounded = distance + 0x800;
+    if (rounded < INT32_MIN || rounded > INT32_MAX) {
+        return false;
+    }
+
+    const auto hi20 = static_cast<uint32_t>(rounded) & 0xFFFFF000;
+    const auto lo12 = static_cast<uint32_t>(distance) & 0xFFF;
+
+    auto* const ptr = buffer.GetOffsetPointer(offset);
+    std::array<uint32_t, 2> instructions{};
+    std::memcpy(instructions.data(), ptr, sizeof(instructions));
+
+    instructions[0] = (instructions[0] & 0x00000FFF) | hi20;
+    instructions[1] = (instructions[1] & 0x000FFFFF) | (lo12 << 20);
+
+    std::memcpy(ptr, instructions.data(), sizeof(instructions));
+    return true;
+}
+
 // Emits an atomic instruction.
 inline void EmitAtomic(CodeBuffer& buffer, uint32_t funct5, Ordering ordering, GPR rs2, GPR rs1,
                        uint32_t funct3, GPR rd, uint32_t opcode) noexcept {
@@ -224,6 +284,53 @@ inline void EmitCMOP(CodeBuffer& buffer, uint32_t op) {
     buffer.Emit16(base | encoded_op);
 }
 
+// Bit patterns of the double-precision constants that can be loaded with the
+// Zfa FLI instructions, indexed by the value of the rs1 field.
+inline constexpr std::array<uint64_t, 32> fli_table{
+    0xBFF0000000000000ULL, // -1.0
+    0x0010000000000000ULL, // Minimum positive normal
+    0x3EF0000000000000ULL, // 1.0 * 2^-16
+    0x3F00000000000000ULL, // 1.0 * 2^-15
+    0x3F70000000000000ULL, // 1.0 * 2^-8
+    0x3F80000000000000ULL, // 1.0 * 2^-7
+    0x3FB0000000000000ULL, // 1.0 * 2^-4
+    0x3FC0000000000000ULL, // 1.0 * 2^-3
+    0x3FD0000000000000ULL, // 0.25
+    0x3FD4000000000000ULL, // 0.3125
+    0x3FD8000000000000ULL, // 0.375
+    0x3FDC000000000000ULL, // 0.4375
+    0x3FE0000000000000ULL, // 0.5
+    0x3FE4000000000000ULL, // 0.625
+    0x3FE8000000000000ULL, // 0.75
+    0x3FEC000000000000ULL, // 0.875
+    0x3FF0000000000000ULL, // 1.0
+    0x3FF4000000000000ULL, // 1.25
+    0x3FF8000000000000ULL, // 1.5
+    0x3FFC000000000000ULL, // 1.75
+    0x4000000000000000ULL, // 2.0
+    0x4004000000000000ULL, // 2.5
+    0x4008000000000000ULL, // 3
+    0x4010000000000000ULL, // 4
+    0x4020000000000000ULL, // 8
+    0x4030000000000000ULL, // 16
+    0x4060000000000000ULL, // 2^7
+    0x4070000000000000ULL, // 2^8
+    0x40E0000000000000ULL, // 2^15
+    0x40F0000000000000ULL, // 2^16
+    0x7FF0000000000000ULL, // +inf
+    0x7FF8000000000000ULL, // Canonical NaN
+};
+
+// Base stack adjustments of the Zcmp CM.PUSH/CM.POP instructions, indexed by rlist.
+inline constexpr std::array<uint32_t, 16> stack_adj_bases_rv32{
+    0U, 0U, 0U, 0U, 16U, 16U, 16U, 16U,
+    32U, 32U, 32U, 32U, 48U, 48U, 48U, 64U,
+};
+inline constexpr std::array<uint32_t, 16> stack_adj_bases_rv64{
+    0U, 0U, 0U, 0U, 16U, 16U, 32U, 32U,
+    48U, 48U, 64U, 64U, 80U, 80U, 96U, 112U
+};
+
 // Internal helpers for siloing away particular comparisons for behavior.
 constexpr bool IsRV32(ArchFeature feature) {
     return feature == ArchFeature::RV32;
@@ -37,6 +37,25 @@ enum class WidthEncoding : uint32_t {
     // clang-format on
 };
 
+uint32_t EncodeVType(SEW sew, LMUL lmul, VTA vta, VMA vma) noexcept {
+    // clang-format off
+    return static_cast<uint32_t>(lmul) |
+           (static_cast<uint32_t>(sew) << 3) |
+           (static_cast<uint32_t>(vta) << 6) |
+           (static_cast<uint32_t>(vma) << 7);
+    // clang-format on
+}
+
+// Retrieves log2(SEW / LMUL) of an encoded vtype. Configurations with
+// the same ratio have the same VLMAX on any implementation.
+int32_t GetVLMAXRatio(uint32_t vtype) noexcept {
+    const auto sew = static_cast<int32_t>((vtype >> 3) & 0b111) + 3;
+    const auto lmul = static_cast<int32_t>(vtype & 0b111);
+
+    // Fractional LMULs are encoded as negative 3-bit values.
+    return sew - (lmul >= 4 ? lmul - 8 : lmul);
+}
+
 void EmitVectorLoadImpl(CodeBuffer& buffer, uint32_t nf, bool mew, AddressingMode mop,
                         VecMask vm, uint32_t lumop, GPR rs, WidthEncoding width, Vec vd) noexcept {
     BISCUIT_ASSERT(nf <= 8);
@@ -1679,21 +1698,29 @@ void Assembler::VLUXEI64(Vec vd, GPR rs, Vec vs, VecMask mask) noexcept {
 }
 
 void Assembler::VLE8FF(Vec vd, GPR rs, VecMask mask) noexcept {
+    // Fault-only-first loads may reduce vl.
+    InvalidateVectorConfig();
     EmitVectorLoad(m_buffer, 0b000, false, AddressingMode::UnitStride, mask,
                    UnitStrideLoadAddressingMode::LoadFaultOnlyFirst, rs, WidthEncoding::E8, vd);
 }
 
 void Assembler::VLE16FF(Vec vd, GPR rs, VecMask mask) noexcept {
+    // Fault-only-first loads may reduce vl.
+    InvalidateVectorConfig();
     EmitVectorLoad(m_buffer, 0b000, false, AddressingMode::UnitStride, mask,
                    UnitStrideLoadAddressingMode::LoadFaultOnlyFirst, rs, WidthEncoding::E16, vd);
 }
 
 void Assembler::VLE32FF(Vec vd, GPR rs, VecMask mask) noexcept {
+    // Fault-only-first loads may reduce vl.
+    InvalidateVectorConfig();
     EmitVectorLoad(m_buffer, 0b000, false, AddressingMode::UnitStride, mask,
                    UnitStrideLoadAddressingMode::LoadFaultOnlyFirst, rs, WidthEncoding::E32, vd);
 }
 
 void Assembler::VLE64FF(Vec vd, GPR rs, VecMask mask) noexcept {
+    // Fault-only-first loads may reduce vl.
+    InvalidateVectorConfig();
     EmitVectorLoad(m_buffer, 0b000, false, AddressingMode::UnitStride, mask,
                    UnitStrideLoadAddressingMode::LoadFaultOnlyFirst, rs, WidthEncoding::E64, vd);
 }
@@ -2034,31 +2061,63 @@ void Assembler::VS8R(Vec vs, GPR rs) noexcept {
     VSR(8, vs, rs);
 }
 
+void Assembler::SetVectorConfig(uint32_t avl, SEW sew, LMUL lmul, VTA vta, VMA vma) noexcept {
+    BISCUIT_ASSERT(avl <= 31);
+
+    const auto vtype = EncodeVType(sew, lmul, vta, vma);
+    if (IsVectorConfigInEffect(vtype, avl)) {
+        return;
+    }
+
+    if (m_vector_config.has_value() && m_vector_config->avl == avl &&
+        GetVLMAXRatio(m_vector_config->vtype) == GetVLMAXRatio(vtype)) {
+        VSETVLI(x0, x0, sew, lmul, vta, vma);
+    } else {
+        VSETIVLI(x0, avl, sew, lmul, vta, vma);
+    }
+}
+
 void Assembler::VSETIVLI(GPR rd, uint32_t imm, SEW sew, LMUL lmul, VTA vta, VMA vma) noexcept {
     // Immediate must be able to fit in 5 bits.
     BISCUIT_ASSERT(imm <= 31);
 
-    // clang-format off
-    const auto zimm = static_cast<uint32_t>(lmul) |
-                      (static_cast<uint32_t>(sew) << 3) |
-                      (static_cast<uint32_t>(vta) << 6) |
-                      (static_cast<uint32_t>(vma) << 7);
-    // clang-format on
+    const auto zimm = EncodeVType(sew, lmul, vta, vma);
+    if (rd == x0 && IsOptimizationEnabled(Optimization::ElideVectorConfig) &&
+        IsVectorConfigInEffect(zimm, imm)) {
+        return;
+    }
+    m_vector_config = VectorConfig{zimm, imm};
 
     m_buffer.Emit32(0xC0007057U | (zimm << 20) | (imm << 15) | (rd.Index() << 7));
 }
 
 void Assembler::VSETVL(GPR rd, GPR rs1, GPR rs2) noexcept {
+    // The configuration comes from a register, so nothing is known about it.
+    InvalidateVectorConfig();
+
     m_buffer.Emit32(0x80007057U | (rs2.Index() << 20) | (rs1.Index() << 15) | (rd.Index() << 7));
 }
 
 void Assembler::VSETVLI(GPR rd, GPR rs, SEW sew, LMUL lmul, VTA vta, VMA vma) noexcept {
-    // clang-format off
-    const auto zimm = static_cast<uint32_t>(lmul) |
-                      (static_cast<uint32_t>(sew) << 3) |
-                      (static_cast<uint32_t>(vta) << 6) |
-                      (static_cast<uint32_t>(vma) << 7);
-    // clang-format on
+    const auto zimm = EncodeVType(sew, lmul, vta, vma);
+
+    if (rd == x0 && rs == x0) {
+        // Keeps vl, which is only valid if VLMAX doesn't change.
+        if (IsOptimizationEnabled(Optimization::ElideVectorConfig) && m_vector_config.has_value() &&
+            m_vector_config->vtype == zimm) {
+            return;
+        }
+        if (m_vector_config.has_value() && GetVLMAXRatio(m_vector_config->vtype) == GetVLMAXRatio(zimm)) {
+            m_vector_config->vtype = zimm;
+        } else {
+            InvalidateVectorConfig();
+        }
+    } else if (rs == x0) {
+        m_vector_config = VectorConfig{zimm, vlmax_avl};
+    } else {
+        // The AVL comes from a register, which may change at any time.
+        m_vector_config = VectorConfig{zimm, std::nullopt};
+    }
 
     m_buffer.Emit32(0x00007057U | (zimm << 20) | (rs.Index() << 15) | (rd.Index() << 7));
 }
@@ -0,0 +1,680 @@
+#include <biscuit/assembler.hpp>
+#include <biscuit/assert.hpp>
+#include <biscuit/code_cache.hpp>
+#include <biscuit/profile.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace biscuit {
+namespace {
+// Layout of a cache file:
+//
+//   [FileHeader]
+//   [profile string]            (padded to 8 bytes)
+//   [RelocationRecord...]
+//   [SymbolRecord...]
+//   [string table]              (padded to code_alignment)
+//   [code]
+//
+// The code is page-aligned within the file so that it can be relocated
+// and made executable in place after mapping the file.
+constexpr uint32_t code_cache_magic = 0x48434342; // "BCCH"
+constexpr size_t code_alignment = 4096;
+constexpr uint32_t no_pair = std::numeric_limits<uint32_t>::max();
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t file_size;
+    uint64_t code_offset;
+    uint64_t code_size;
+    uint32_t profile_size;
+    uint32_t num_relocations;
+    uint32_t num_symbols;
+    uint32_t strings_size;
+
+    // FNV-1a hash of everything within the file except this field.
+    uint64_t checksum;
+};
+static_assert(sizeof(FileHeader) == 56);
+static_assert(offsetof(FileHeader, checksum) + sizeof(uint64_t) == sizeof(FileHeader));
+
+struct RelocationRecord {
+    uint64_t offset;
+    int64_t addend;
+    uint32_t type;
+    uint32_t name_offset;
+    uint32_t name_size;
+
+    // For PCRelLo12I and PCRelLo12S, the index of the paired PCRelHi20 record.
+    uint32_t pair;
+};
+static_assert(sizeof(RelocationRecord) == 32);
+
+struct SymbolRecord {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t name_offset;
+    uint32_t name_size;
+    uint32_t type;
+    uint32_t reserved;
+};
+static_assert(sizeof(SymbolRecord) == 32);
+
+// Offsets of the metadata tables within a validated cache.
+struct CacheLayout {
+    FileHeader header;
+    size_t relocations_offset;
+    size_t symbols_offset;
+    size_t strings_offset;
+};
+
+[[nodiscard]] constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment) noexcept {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+[[nodiscard]] uint64_t HashBytes(uint64_t hash, std::span<const uint8_t> data) noexcept {
+    for (const uint8_t byte : data) {
+        hash ^= byte;
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+[[nodiscard]] uint64_t ComputeChecksum(std::span<const uint8_t> file) noexcept {
+    uint64_t hash = 0xCBF29CE484222325;
+    hash = HashBytes(hash, file.first(offsetof(FileHeader, checksum)));
+    hash = HashBytes(hash, file.subspan(sizeof(FileHeader)));
+    return hash;
+}
+
+template <typename T>
+[[nodiscard]] T ReadAt(std::span<const uint8_t> data, size_t offset) noexcept {
+    T value{};
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void WriteAt(std::vector<uint8_t>& data, size_t offset, const T& value) noexcept {
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+[[nodiscard]] bool IsPCRelLo12(RelocationType type) noexcept {
+    return type == RelocationType::PCRelLo12I || type == RelocationType::PCRelLo12S;
+}
+
+[[nodiscard]] bool IsSignedInRange(int64_t value, uint32_t bits) noexcept {
+    const auto limit = int64_t{1} << (bits - 1);
+    return value >= -limit && value < limit;
+}
+
+[[nodiscard]] uint32_t ReadInstruction(const uint8_t* ptr) noexcept {
+    uint32_t instruction = 0;
+    std::memcpy(&instruction, ptr, sizeof(instruction));
+    return instruction;
+}
+
+void WriteInstruction(uint8_t* ptr, uint32_t instruction) noexcept {
+    std::memcpy(ptr, &instruction, sizeof(instruction));
+}
+
+// Instructions are emitted with a zero offset, but the immediate fields are cleared
+// anyway so that relocating code that was already relocated once still works.
+void PatchBType(uint8_t* ptr, int64_t offset) noexcept {
+    const auto imm = static_cast<uint32_t>(offset);
+    const auto encoded = ((imm & 0x1000) << 19) | ((imm & 0x7E0) << 20) |
+                         ((imm & 0x1E) << 7) | ((imm & 0x800) >> 4);
+    WriteInstruction(ptr, (ReadInstruction(ptr) & 0x01FFF07F) | encoded);
+}
+
+void PatchJType(uint8_t* ptr, int64_t offset) noexcept {
+    const auto imm = static_cast<uint32_t>(offset);
+    const auto encoded = ((imm & 0x100000) << 11) | ((imm & 0x7FE) << 20) |
+                         ((imm & 0x800) << 9) | (imm & 0xFF000);
+    WriteInstruction(ptr, (ReadInstruction(ptr) & 0x00000FFF) | encoded);
+}
+
+void PatchUType(uint8_t* ptr, int64_t hi20) noexcept {
+    const auto encoded = static_cast<uint32_t>(hi20) << 12;
+    WriteInstruction(ptr, (ReadInstruction(ptr) & 0x00000FFF) | encoded);
+}
+
+void PatchIType(uint8_t* ptr, int64_t lo12) noexcept {
+    const auto encoded = (static_cast<uint32_t>(lo12) & 0xFFF) << 20;
+    WriteInstruction(ptr, (ReadInstruction(ptr) & 0x000FFFFF) | encoded);
+}
+
+void PatchSType(uint8_t* ptr, int64_t lo12) noexcept {
+    const auto imm = static_cast<uint32_t>(lo12);
+    const auto encoded = ((imm & 0xFE0) << 20) | ((imm & 0x1F) << 7);
+    WriteInstruction(ptr, (ReadInstruction(ptr) & 0x01FFF07F) | encoded);
+}
+
+// Splits a PC-relative offset into the parts added by an AUIPC and the instruction after it.
+[[nodiscard]] bool SplitOffset(int64_t offset, int64_t& hi20, int64_t& lo12) noexcept {
+    if (!IsSignedInRange(offset + 0x800, 32)) {
+        return false;
+    }
+
+    hi20 = (offset + 0x800) >> 12;
+    lo12 = offset - (hi20 << 12);
+    return true;
+}
+
+void SetStatus(CodeCacheStatus* status, CodeCacheStatus value) noexcept {
+    if (status != nullptr) {
+        *status = value;
+    }
+}
+
+[[nodiscard]] CodeCacheStatus ValidateCache(std::span<const uint8_t> data, const Profile& target,
+                                            CacheLayout& layout) {
+    if (data.size() < sizeof(FileHeader)) {
+        return CodeCacheStatus::InvalidFormat;
+    }
+
+    const auto header = ReadAt<FileHeader>(data, 0);
+    if (header.magic != code_cache_magic) {
+        return CodeCacheStatus::InvalidFormat;
+    }
+    if (header.version != code_cache_version) {
+        return CodeCacheStatus::VersionMismatch;
+    }
+    if (header.file_size != data.size() || header.checksum != ComputeChecksum(data)) {
+        return CodeCacheStatus::ChecksumMismatch;
+    }
+
+    // All counts are 32-bit, so none of this can overflow.
+    const auto relocations_offset = AlignUp(sizeof(FileHeader) + uint64_t{header.profile_size}, 8);
+    const auto symbols_offset = relocations_offset + uint64_t{header.num_relocations} * sizeof(RelocationRecord);
+    const auto strings_offset = symbols_offset + uint64_t{header.num_symbols} * sizeof(SymbolRecord);
+    const auto strings_end = strings_offset + header.strings_size;
+    if (strings_end > header.code_offset || header.code_offset > header.file_size ||
+        header.code_size != header.file_size - header.code_offset) {
+        return CodeCacheStatus::InvalidFormat;
+    }
+
+    const auto* profile = reinterpret_cast<const char*>(data.data() + sizeof(FileHeader));
+    if (std::string_view{profile, header.profile_size} != target.ToString()) {
+        return CodeCacheStatus::ProfileMismatch;
+    }
+
+    layout = {
+        .header = header,
+        .relocations_offset = static_cast<size_t>(relocations_offset),
+        .symbols_offset = static_cast<size_t>(symbols_offset),
+        .strings_offset = static_cast<size_t>(strings_offset),
+    };
+    return CodeCacheStatus::Ok;
+}
+
+// Reads the symbol table and relocates the code, which has already been placed at its final location.
+[[nodiscard]] CodeCacheStatus RelocateCode(std::span<const uint8_t> data, const CacheLayout& layout,
+                                           uint8_t* code, const SymbolResolver& resolver,
+                                           std::vector<ExportedSymbol>& symbols) {
+    const auto& header = layout.header;
+    const auto code_address = reinterpret_cast<uintptr_t>(code);
+
+    const auto get_name = [&](uint32_t offset, uint32_t size) -> std::optional<std::string_view> {
+        if (uint64_t{offset} + size > header.strings_size) {
+            return std::nullopt;
+        }
+        const auto* name = reinterpret_cast<const char*>(data.data() + layout.strings_offset + offset);
+        return std::string_view{name, size};
+    };
+
+    symbols.reserve(header.num_symbols);
+    for (uint32_t i = 0; i < header.num_symbols; i++) {
+        const auto record = ReadAt<SymbolRecord>(data, layout.symbols_offset + i * sizeof(SymbolRecord));
+        const auto name = get_name(record.name_offset, record.name_size);
+        if (!name || record.offset > header.code_size || record.type > static_cast<uint32_t>(SymbolType::Object)) {
+            return CodeCacheStatus::InvalidFormat;
+        }
+
+        symbols.push_back({
+            .name = std::string{*name},
+            .offset = static_cast<ptrdiff_t>(record.offset),
+            .size = static_cast<size_t>(record.size),
+            .type = static_cast<SymbolType>(record.type),
+        });
+    }
+
+    // Symbols exported by the code itself take precedence over the resolver.
+    const auto resolve = [&](const RelocationRecord& record) -> std::optional<uint64_t> {
+        const auto name = get_name(record.name_offset, record.name_size);
+        if (!name) {
+            return std::nullopt;
+        }
+
+        const auto iter = std::find_if(symbols.begin(), symbols.end(), [&name](const ExportedSymbol& symbol) {
+            return symbol.name == *name;
+        });
+        if (iter != symbols.end()) {
+            return code_address + static_cast<uint64_t>(iter->offset) + static_cast<uint64_t>(record.addend);
+        }
+
+        const auto address = resolver ? resolver(*name) : std::nullopt;
+        if (!address) {
+            return std::nullopt;
+        }
+        return *address + static_cast<uint64_t>(record.addend);
+    };
+
+    const auto read_relocation = [&](uint32_t index) {
+        return ReadAt<RelocationRecord>(data, layout.relocations_offset + index * sizeof(RelocationRecord));
+    };
+
+    for (uint32_t i = 0; i < header.num_relocations; i++) {
+        const auto record = read_relocation(i);
+        if (record.type > static_cast<uint32_t>(RelocationType::PCRelLo12S)) {
+            return CodeCacheStatus::InvalidFormat;
+        }
+
+        const auto type = static_cast<RelocationType>(record.type);
+        if (record.offset > header.code_size || header.code_size - record.offset < GetRelocationSize(type)) {
+            return CodeCacheStatus::InvalidFormat;
+        }
+
+        // The lower bits of a PC-relative address are relative to the paired AUIPC.
+        auto reference = record;
+        if (IsPCRelLo12(type)) {
+            if (record.pair >= header.num_relocations) {
+                return CodeCacheStatus::InvalidFormat;
+            }
+            reference = read_relocation(record.pair);
+            if (reference.type != static_cast<uint32_t>(RelocationType::PCRelHi20) ||
+                reference.offset > header.code_size - sizeof(uint32_t)) {
+                return CodeCacheStatus::InvalidFormat;
+            }
+        }
+
+        const auto target = resolve(reference);
+        if (!target) {
+            return CodeCacheStatus::UnresolvedSymbol;
+        }
+
+        auto* const ptr = code + record.offset;
+        const auto pc = code_address + reference.offset;
+        const auto offset = static_cast<int64_t>(*target - pc);
+
+        int64_t hi20 = 0;
+        int64_t lo12 = 0;
+        switch (type) {
+        case RelocationType::Absolute64:
+            std::memcpy(ptr, &*target, sizeof(uint64_t));
+            break;
+        case RelocationType::Absolute32: {
+            const auto value = static_cast<int64_t>(*target);
+            if ((*target >> 32) != 0 && !IsSignedInRange(value, 32)) {
+                return CodeCacheStatus::OutOfRange;
+            }
+            const auto truncated = static_cast<uint32_t>(*target);
+            std::memcpy(ptr, &truncated, sizeof(uint32_t));
+            break;
+        }
+        case RelocationType::Branch:
+            if (!IsSignedInRange(offset, 13) || (offset & 1) != 0) {
+                return CodeCacheStatus::OutOfRange;
+            }
+            PatchBType(ptr, offset);
+            break;
+        case RelocationType::Jal:
+            if (!IsSignedInRange(offset, 21) || (offset & 1) != 0) {
+                return CodeCacheStatus::OutOfRange;
+            }
+            PatchJType(ptr, offset);
+            break;
+        case RelocationType::Call:
+            if (!SplitOffset(offset, hi20, lo12)) {
+                return CodeCacheStatus::OutOfRange;
+            }
+            PatchUType(ptr, hi20);
+            PatchIType(ptr + 4, lo12);
+            break;
+        case RelocationType::PCRelHi20:
+            if (!SplitOffset(offset, hi20, lo12)) {
+                return CodeCacheStatus::OutOfRange;
+            }
+            PatchUType(ptr, hi20);
+            break;
+        case RelocationType::PCRelLo12I:
+        case RelocationType::PCRelLo12S:
+            if (!SplitOffset(offset, hi20, lo12)) {
+                return CodeCacheStatus::OutOfRange;
+            }
+            if (type == RelocationType::PCRelLo12I) {
+                PatchIType(ptr, lo12);
+            } else {
+                PatchSType(ptr, lo12);
+            }
+            break;
+        }
+    }
+
+    return CodeCacheStatus::Ok;
+}
+
+#if defined(__linux__)
+[[nodiscard]] size_t GetPageSize() noexcept {
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+[[nodiscard]] bool MakeExecutable(uint8_t* code, size_t size) noexcept {
+    if (size == 0) {
+        return true;
+    }
+
+    __builtin___clear_cache(reinterpret_cast<char*>(code), reinterpret_cast<char*>(code + size));
+    return mprotect(code, AlignUp(size, GetPageSize()), PROT_READ | PROT_EXEC) == 0;
+}
+#endif
+} // Anonymous namespace
+
+std::vector<uint8_t> SerializeCode(Assembler& assembler, const Profile& target) {
+    auto& buffer = assembler.GetCodeBuffer();
+    const std::span<const uint8_t> code{buffer.GetOffsetPointer(0), buffer.GetSizeInBytes()};
+
+    return SerializeCode(code, assembler.GetExportedSymbols(), assembler.GetRelocations(), target);
+}
+
+std::vector<uint8_t> SerializeCode(std::span<const uint8_t> code,
+                                   std::span<const ExportedSymbol> symbols,
+                                   std::span<const Relocation> relocations,
+                                   const Profile& target) {
+    const auto profile = target.ToString();
+    std::vector<uint8_t> strings;
+
+    const auto add_string = [&strings](std::string_view string) {
+        const auto offset = static_cast<uint32_t>(strings.size());
+        strings.insert(strings.end(), string.begin(), string.end());
+        return offset;
+    };
+
+    const auto code_size = static_cast<ptrdiff_t>(code.size());
+    std::vector<RelocationRecord> relocation_records;
+    relocation_records.reserve(relocations.size());
+    for (const auto& relocation : relocations) {
+        const auto end = relocation.offset + static_cast<ptrdiff_t>(GetRelocationSize(relocation.type));
+        BISCUIT_ASSERT(relocation.offset >= 0 && end <= code_size);
+
+        RelocationRecord record{
+            .offset = static_cast<uint64_t>(relocation.offset),
+            .addend = relocation.addend,
+            .type = static_cast<uint32_t>(relocation.type),
+            .name_offset = 0,
+            .name_size = 0,
+            .pair = no_pair,
+        };
+
+        if (IsPCRelLo12(relocation.type)) {
+            const auto iter = std::find_if(relocations.begin(), relocations.end(),
+                                           [&relocation](const Relocation& other) {
+                                               return other.type == RelocationType::PCRelHi20 &&
+                                                      other.offset == relocation.hi20_offset;
+                                           });
+            BISCUIT_ASSERT(iter != relocations.end());
+            record.pair = static_cast<uint32_t>(iter - relocations.begin());
+        } else {
+            record.name_offset = add_string(relocation.symbol);
+            record.name_size = static_cast<uint32_t>(relocation.symbol.size());
+        }
+
+        relocation_records.push_back(record);
+    }
+
+    std::vector<SymbolRecord> symbol_records;
+    symbol_records.reserve(symbols.size());
+    for (const auto& symbol : symbols) {
+        BISCUIT_ASSERT(symbol.offset >= 0 && symbol.offset <= code_size);
+
+        symbol_records.push_back({
+            .offset = static_cast<uint64_t>(symbol.offset),
+            .size = symbol.size,
+            .name_offset = add_string(symbol.name),
+            .name_size = static_cast<uint32_t>(symbol.name.size()),
+            .type = static_cast<uint32_t>(symbol.type),
+            .reserved = 0,
+        });
+    }
+
+    const auto relocations_offset = AlignUp(sizeof(FileHeader) + profile.size(), 8);
+    const auto symbols_offset = relocations_offset + relocation_records.size() * sizeof(RelocationRecord);
+    const auto strings_offset = symbols_offset + symbol_records.size() * sizeof(SymbolRecord);
+    const auto code_offset = AlignUp(strings_offset + strings.size(), code_alignment);
+    const auto file_size = code_offset + code.size();
+
+    std::vector<uint8_t> file(file_size);
+    std::memcpy(file.data() + sizeof(FileHeader), profile.data(), profile.size());
+    for (size_t i = 0; i < relocation_records.size(); i++) {
+        WriteAt(file, relocations_offset + i * sizeof(RelocationRecord), relocation_records[i]);
+    }
+    for (size_t i = 0; i < symbol_records.size(); i++) {
+        WriteAt(file, symbols_offset + i * sizeof(SymbolRecord), symbol_records[i]);
+    }
+    std::copy(strings.begin(), strings.end(), file.begin() + static_cast<ptrdiff_t>(strings_offset));
+    std::copy(code.begin(), code.end(), file.begin() + static_cast<ptrdiff_t>(code_offset));
+
+    FileHeader header{
+        .magic = code_cache_magic,
+        .version = code_cache_version,
+        .file_size = file_size,
+        .code_offset = code_offset,
+        .code_size = code.size(),
+        .profile_size = static_cast<uint32_t>(profile.size()),
+        .num_relocations = static_cast<uint32_t>(relocation_records.size()),
+        .num_symbols = static_cast<uint32_t>(symbol_records.size()),
+        .strings_size = static_cast<uint32_t>(strings.size()),
+        .checksum = 0,
+    };
+    WriteAt(file, 0, header);
+
+    header.checksum = ComputeChecksum(file);
+    WriteAt(file, 0, header);
+
+    return file;
+}
+
+bool WriteCodeCache(const std::string& path, Assembler& assembler, const Profile& target) {
+    const auto data = SerializeCode(assembler, target);
+    const auto temporary_path = path + ".tmp";
+
+    std::FILE* file = std::fopen(temporary_path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    const bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    const bool closed = std::fclose(file) == 0;
+    if (!written || !closed || std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+        std::remove(temporary_path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<CachedCode> CachedCode::Load(const std::string& path, const Profile& target,
+                                           const SymbolResolver& resolver, CodeCacheStatus* status) {
+#if defined(__linux__)
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        SetStatus(status, CodeCacheStatus::IOError);
+        return std::nullopt;
+    }
+
+    struct stat file_info {};
+    if (fstat(fd, &file_info) != 0 || file_info.st_size <= 0) {
+        close(fd);
+        SetStatus(status, file_info.st_size == 0 ? CodeCacheStatus::InvalidFormat : CodeCacheStatus::IOError);
+        return std::nullopt;
+    }
+
+    // Pages that get relocated become private copies, everything else stays shared with the page cache.
+    const auto file_size = static_cast<size_t>(file_info.st_size);
+    void* const mapping = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        SetStatus(status, CodeCacheStatus::IOError);
+        return std::nullopt;
+    }
+
+    CachedCode cached;
+    cached.m_memory = static_cast<uint8_t*>(mapping);
+    cached.m_memory_size = file_size;
+
+    const std::span<const uint8_t> data{cached.m_memory, file_size};
+    CacheLayout layout{};
+    if (const auto result = ValidateCache(data, target, layout); result != CodeCacheStatus::Ok) {
+        SetStatus(status, result);
+        return std::nullopt;
+    }
+
+    // The code can only be made executable in place if it starts on a page boundary,
+    // which isn't the case on hosts with pages larger than the alignment used by the format.
+    if (layout.header.code_offset % GetPageSize() != 0) {
+        return Load(data, target, resolver, status);
+    }
+
+    cached.m_code_offset = static_cast<size_t>(layout.header.code_offset);
+    cached.m_code_size = static_cast<size_t>(layout.header.code_size);
+
+    auto* const code = cached.m_memory + cached.m_code_offset;
+    if (const auto result = RelocateCode(data, layout, code, resolver, cached.m_symbols);
+        result != CodeCacheStatus::Ok) {
+        SetStatus(status, result);
+        return std::nullopt;
+    }
+
+    if (!MakeExecutable(code, cached.m_code_size)) {
+        SetStatus(status, CodeCacheStatus::IOError);
+        return std::nullopt;
+    }
+
+    SetStatus(status, CodeCacheStatus::Ok);
+    return cached;
+#else
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        SetStatus(status, CodeCacheStatus::IOError);
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> data;
+    std::array<uint8_t, 4096> chunk{};
+    size_t read = 0;
+    while ((read = std::fread(chunk.data(), 1, chunk.size(), file)) != 0) {
+        data.insert(data.end(), chunk.begin(), chunk.begin() + static_cast<ptrdiff_t>(read));
+    }
+
+    const bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+    if (failed) {
+        SetStatus(status, CodeCacheStatus::IOError);
+        return std::nullopt;
+    }
+
+    return Load(data, target, resolver, status);
+#endif
+}
+
+std::optional<CachedCode> CachedCode::Load(std::span<const uint8_t> data, const Profile& target,
+                                           const SymbolResolver& resolver, CodeCacheStatus* status) {
+    CacheLayout layout{};
+    if (const auto result = ValidateCache(data, target, layout); result != CodeCacheStatus::Ok) {
+        SetStatus(status, result);
+        return std::nullopt;
+    }
+
+    CachedCode cached;
+    cached.m_code_size = static_cast<size_t>(layout.header.code_size);
+
+#if defined(__linux__)
+    cached.m_memory_size = static_cast<size_t>(AlignUp(std::max<size_t>(cached.m_code_size, 1), GetPageSize()));
+    void* const memory = mmap(nullptr, cached.m_memory_size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        SetStatus(status, CodeCacheStatus::IOError);
+        return std::nullopt;
+    }
+    cached.m_memory = static_cast<uint8_t*>(memory);
+#else
+    cached.m_memory_size = std::max<size_t>(cached.m_code_size, 1);
+    cached.m_memory = new uint8_t[cached.m_memory_size]();
+#endif
+
+    std::memcpy(cached.m_memory, data.data() + layout.header.code_offset, cached.m_code_size);
+
+    if (const auto result = RelocateCode(data, layout, cached.m_memory, resolver, cached.m_symbols);
+        result != CodeCacheStatus::Ok) {
+        SetStatus(status, result);
+        return std::nullopt;
+    }
+
+#if defined(__linux__)
+    if (!MakeExecutable(cached.m_memory, cached.m_code_size)) {
+        SetStatus(status, CodeCacheStatus::IOError);
+        return std::nullopt;
+    }
+#endif
+
+    SetStatus(status, CodeCacheStatus::Ok);
+    return cached;
+}
+
+CachedCode::CachedCode(CachedCode&& other) noexcept
+    : m_memory{std::exchange(other.m_memory, nullptr)}
+    , m_memory_size{std::exchange(other.m_memory_size, size_t{0})}
+    , m_code_offset{std::exchange(other.m_code_offset, size_t{0})}
+    , m_code_size{std::exchange(other.m_code_size, size_t{0})}
+    , m_symbols{std::move(other.m_symbols)} {}
+
+CachedCode& CachedCode::operator=(CachedCode&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+
+    std::swap(m_memory, other.m_memory);
+    std::swap(m_memory_size, other.m_memory_size);
+    std::swap(m_code_offset, other.m_code_offset);
+    std::swap(m_code_size, other.m_code_size);
+    std::swap(m_symbols, other.m_symbols);
+    return *this;
+}
+
+CachedCode::~CachedCode() noexcept {
+    if (m_memory == nullptr) {
+        return;
+    }
+
+#if defined(__linux__)
+    munmap(m_memory, m_memory_size);
+#else
+    delete[] m_memory;
+#endif
+}
+
+const void* CachedCode::GetSymbolAddress(std::string_view name) const noexcept {
+    const auto iter = std::find_if(m_symbols.begin(), m_symbols.end(), [name](const ExportedSymbol& symbol) {
+        return symbol.name == name;
+    });
+    if (iter == m_symbols.end()) {
+        return nullptr;
+    }
+    return GetCode() + iter->offset;
+}
+
+} // namespace biscuit
@@ -7,6 +7,8 @@
 #include <biscuit/assert.hpp>
 #include <biscuit/cpuinfo.hpp>
 
+#include <bit>
+
 #if defined(__linux__) && defined(__riscv)
 #include <csignal>
 #include <utility>
@@ -773,6 +775,10 @@ bool CheckExtensionSyscall(biscuit::RISCVExtension extension) {
         return (features0 & RISCV_HWPROBE_EXT_ZAAMO) != 0;
     case RISCVExtension::Zalrsc:
         return (features0 & RISCV_HWPROBE_EXT_ZALRSC) != 0;
+    case RISCVExtension::Zcmp:
+        // Not reported by hwprobe, and its encodings overlap with Zcd,
+        // so it can't be probed for by executing an instruction either.
+        return false;
     }
 
     return false;
@@ -795,6 +801,16 @@ bool CPUInfo::Has([[maybe_unused]] RISCVExtension extension) const {
 #endif
 }
 
+bool CPUInfo::HasAll(const ExtensionSet& extensions) const {
+    for (uint64_t bits = extensions.GetBits(); bits != 0; bits &= bits - 1) {
+        const auto extension = static_cast<RISCVExtension>(std::countr_zero(bits));
+        if (!Has(extension)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 uint32_t CPUInfo::GetVlenb() const {
     if (Has(RISCVExtension::V)) {
         static CSRReader<CSR::VLenb> csrReader;
@@ -0,0 +1,1173 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/assembler.hpp>
+#include <biscuit/decoder.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <vector>
+
+#include "assembler_util.hpp"
+#include "decoder_table.hpp"
+
+// Table-driven instruction decoder.
+//
+// Rather than maintaining a second copy of every encoding, the decoding tables are
+// derived from the Assembler itself. Each instruction is emitted once with sample
+// operands, and every bit that doesn't belong to an operand field becomes part of
+// the (match, mask) pair that identifies the instruction.
+//
+// Candidates are then bucketed by the bits that identify most instructions
+// (the major opcode, funct3 and the upper six bits for 32-bit instructions, and
+// the quadrant, funct3 and bits [12:10] for compressed ones), so decoding an
+// instruction only has to test a handful of candidates.
+
+namespace biscuit {
+namespace {
+// An operand field within an instruction encoding.
+enum class Field : uint8_t {
+    // Regular instruction fields
+    Rd,             // [11:7]
+    RdNz,           // [11:7], must not be x0
+    Rs1,            // [19:15]
+    Rs2,            // [24:20]
+    Rs1Link,        // [19:15], must be x1 or x5
+    Rs2Link,        // [24:20], must be x1 or x5
+    Frd,            // [11:7]
+    Frs1,           // [19:15]
+    Frs2,           // [24:20]
+    Frs3,           // [31:27]
+    Vd,             // [11:7]
+    Vs1,            // [19:15]
+    Vs2,            // [24:20]
+    Vm,             // [25]
+    Imm12,          // [31:20], signed
+    Uimm12,         // [31:20]
+    StoreImm,       // [31:25|11:7], signed
+    BranchOffset,   // B-type immediate
+    UpperImm,       // [31:12]
+    JumpOffset,     // J-type immediate
+    Shamt6,         // [25:20]
+    Shamt5,         // [24:20]
+    AddslShift,     // [26:25]
+    ByteSelect,     // [31:30]
+    Rnum,           // [23:20]
+    FliIndex,       // [19:15]
+    Csr,            // [31:20]
+    Uimm5,          // [19:15]
+    Simm5,          // [19:15], signed
+    VUimm6,         // [26|19:15]
+    Pred,           // [27:24]
+    Succ,           // [23:20]
+    PrefetchOffset, // [31:25], signed, scaled by 32
+    AqRl,           // [26:25]
+    Rm,             // [14:12]
+    Nf,             // [31:29], number of segments minus one
+    VTypeImm,       // [27:20]
+
+    // Compressed instruction fields
+    CRd,            // [11:7]
+    CRdNz,          // [11:7], must not be x0
+    CRdLui,         // [11:7], must not be x0 or x2
+    CRs2,           // [6:2]
+    CRs2Nz,         // [6:2], must not be x0
+    CFrd,           // [11:7]
+    CFrs2,          // [6:2]
+    CRegHi,         // [9:7], x8-x15
+    CRegLo,         // [4:2], x8-x15
+    CFRegLo,        // [4:2], f8-f15
+    CSregHi,        // [9:7], s0-s7
+    CSregLo,        // [4:2], s0-s7, must differ from CSregHi
+    CImm6,          // [12|6:2], signed
+    CImm6Nz,        // [12|6:2], signed, must not be zero
+    CLuiImm,        // [12|6:2], must not be zero
+    CShamt,         // [12|6:2]
+    CAddi16spImm,   // [12|6:2], signed, scaled by 16
+    CAddi4spnImm,   // [12:5], scaled by 4
+    CLwspImm,       // [12|6:2], scaled by 4
+    CLdspImm,       // [12|6:2], scaled by 8
+    CLqspImm,       // [12|6:2], scaled by 16
+    CSwspImm,       // [12:7], scaled by 4
+    CSdspImm,       // [12:7], scaled by 8
+    CSqspImm,       // [12:7], scaled by 16
+    CLwImm,         // [12:10|6:5], scaled by 4
+    CLdImm,         // [12:10|6:5], scaled by 8
+    CLqImm,         // [12:10|6:5], scaled by 16
+    CLbImm,         // [6:5]
+    CLhImm,         // [5], scaled by 2
+    CBranchOffset,  // CB-type immediate
+    CJumpOffset,    // CJ-type immediate
+    CRlist,         // [7:4]
+    CPushAdj,       // [3:2], combined with the rlist base adjustment
+    CPopAdj,        // [3:2], combined with the rlist base adjustment
+    CJtIndex,       // [6:2]
+    CJaltIndex,     // [9:2], must be at least 32
+
+    Count,
+};
+
+struct FieldInfo {
+    uint32_t bits;
+    OperandType type;
+};
+
+constexpr std::array<FieldInfo, static_cast<size_t>(Field::Count)> field_infos{{
+    {0x00000F80, OperandType::GPR},           // Rd
+    {0x00000F80, OperandType::GPR},           // RdNz
+    {0x000F8000, OperandType::GPR},           // Rs1
+    {0x01F00000, OperandType::GPR},           // Rs2
+    {0x000F8000, OperandType::GPR},           // Rs1Link
+    {0x01F00000, OperandType::GPR},           // Rs2Link
+    {0x00000F80, OperandType::FPR},           // Frd
+    {0x000F8000, OperandType::FPR},           // Frs1
+    {0x01F00000, OperandType::FPR},           // Frs2
+    {0xF8000000, OperandType::FPR},           // Frs3
+    {0x00000F80, OperandType::Vec},           // Vd
+    {0x000F8000, OperandType::Vec},           // Vs1
+    {0x01F00000, OperandType::Vec},           // Vs2
+    {0x02000000, OperandType::VecMask},       // Vm
+    {0xFFF00000, OperandType::Imm},           // Imm12
+    {0xFFF00000, OperandType::Imm},           // Uimm12
+    {0xFE000F80, OperandType::Imm},           // StoreImm
+    {0xFE000F80, OperandType::PCOffset},      // BranchOffset
+    {0xFFFFF000, OperandType::Imm},           // UpperImm
+    {0xFFFFF000, OperandType::PCOffset},      // JumpOffset
+    {0x03F00000, OperandType::Imm},           // Shamt6
+    {0x01F00000, OperandType::Imm},           // Shamt5
+    {0x06000000, OperandType::Imm},           // AddslShift
+    {0xC0000000, OperandType::Imm},           // ByteSelect
+    {0x00F00000, OperandType::Imm},           // Rnum
+    {0x000F8000, OperandType::FloatConstant}, // FliIndex
+    {0xFFF00000, OperandType::CSR},           // Csr
+    {0x000F8000, OperandType::Imm},           // Uimm5
+    {0x000F8000, OperandType::Imm},           // Simm5
+    {0x040F8000, OperandType::Imm},           // VUimm6
+    {0x0F000000, OperandType::FenceOrder},    // Pred
+    {0x00F00000, OperandType::FenceOrder},    // Succ
+    {0xFE000000, OperandType::Imm},           // PrefetchOffset
+    {0x06000000, OperandType::Ordering},      // AqRl
+    {0x00007000, OperandType::RMode},         // Rm
+    {0xE0000000, OperandType::Imm},           // Nf
+    {0x0FF00000, OperandType::VType},         // VTypeImm
+
+    {0x0F80, OperandType::GPR},               // CRd
+    {0x0F80, OperandType::GPR},               // CRdNz
+    {0x0F80, OperandType::GPR},               // CRdLui
+    {0x007C, OperandType::GPR},               // CRs2
+    {0x007C, OperandType::GPR},               // CRs2Nz
+    {0x0F80, OperandType::FPR},               // CFrd
+    {0x007C, OperandType::FPR},               // CFrs2
+    {0x0380, OperandType::GPR},               // CRegHi
+    {0x001C, OperandType::GPR},               // CRegLo
+    {0x001C, OperandType::FPR},               // CFRegLo
+    {0x0380, OperandType::GPR},               // CSregHi
+    {0x001C, OperandType::GPR},               // CSregLo
+    {0x107C, OperandType::Imm},               // CImm6
+    {0x107C, OperandType::Imm},               // CImm6Nz
+    {0x107C, OperandType::Imm},               // CLuiImm
+    {0x107C, OperandType::Imm},               // CShamt
+    {0x107C, OperandType::Imm},               // CAddi16spImm
+    {0x1FE0, OperandType::Imm},               // CAddi4spnImm
+    {0x107C, OperandType::Imm},               // CLwspImm
+    {0x107C, OperandType::Imm},               // CLdspImm
+    {0x107C, OperandType::Imm},               // CLqspImm
+    {0x1F80, OperandType::Imm},               // CSwspImm
+    {0x1F80, OperandType::Imm},               // CSdspImm
+    {0x1F80, OperandType::Imm},               // CSqspImm
+    {0x1C60, OperandType::Imm},               // CLwImm
+    {0x1C60, OperandType::Imm},               // CLdImm
+    {0x1C60, OperandType::Imm},               // CLqImm
+    {0x0060, OperandType::Imm},               // CLbImm
+    {0x0020, OperandType::Imm},               // CLhImm
+    {0x1C7C, OperandType::PCOffset},          // CBranchOffset
+    {0x1FFC, OperandType::PCOffset},          // CJumpOffset
+    {0x00F0, OperandType::RegList},           // CRlist
+    {0x000C, OperandType::Imm},               // CPushAdj
+    {0x000C, OperandType::Imm},               // CPopAdj
+    {0x007C, OperandType::Imm},               // CJtIndex
+    {0x03FC, OperandType::Imm},               // CJaltIndex
+}};
+
+[[nodiscard]] constexpr const FieldInfo& GetFieldInfo(Field field) {
+    return field_infos[static_cast<size_t>(field)];
+}
+
+// The operand fields of an instruction format, in operand order.
+struct FormatLayout {
+    uint8_t num_fields = 0;
+    std::array<Field, Instruction::max_operands> fields{};
+
+    constexpr FormatLayout() = default;
+    constexpr FormatLayout(std::initializer_list<Field> list) : num_fields{static_cast<uint8_t>(list.size())} {
+        std::copy(list.begin(), list.end(), fields.begin());
+    }
+};
+
+[[nodiscard]] constexpr FormatLayout GetFormatLayout(Format format) {
+    using enum Field;
+
+    switch (format) {
+    case Format::None:
+    case Format::CNone:
+        return {};
+    case Format::R:
+        return {Rd, Rs1, Rs2};
+    case Format::RUnary:
+    case Format::HypervisorLoad:
+        return {Rd, Rs1};
+    case Format::RFence:
+        return {Rs1, Rs2};
+    case Format::RShiftAdd:
+        return {Rd, Rs1, Rs2, AddslShift};
+    case Format::RByteSelect:
+        return {Rd, Rs1, Rs2, ByteSelect};
+    case Format::RRoundNum:
+        return {Rd, Rs1, Rnum};
+    case Format::I:
+        return {Rd, Rs1, Imm12};
+    case Format::Shift:
+        return {Rd, Rs1, Shamt6};
+    case Format::ShiftW:
+        return {Rd, Rs1, Shamt5};
+    case Format::Load:
+        return {Rd, Imm12, Rs1};
+    case Format::Store:
+        return {Rs2, StoreImm, Rs1};
+    case Format::Branch:
+        return {Rs1, Rs2, BranchOffset};
+    case Format::U:
+        return {Rd, UpperImm};
+    case Format::Jal:
+        return {Rd, JumpOffset};
+    case Format::Lpad:
+        return {UpperImm};
+    case Format::Fence:
+        return {Pred, Succ};
+    case Format::FenceI:
+        return {Rd, Rs1, Uimm12};
+    case Format::Csr:
+        return {Rd, Csr, Rs1};
+    case Format::CsrImm:
+        return {Rd, Csr, Uimm5};
+    case Format::Prefetch:
+        return {Rs1, PrefetchOffset};
+    case Format::CacheBlock:
+        return {Rs1};
+    case Format::HypervisorStore:
+        return {Rs2, Rs1};
+    case Format::Amo:
+        return {AqRl, Rd, Rs2, Rs1};
+    case Format::LoadReserved:
+        return {AqRl, Rd, Rs1};
+    case Format::StoreRelease:
+        return {AqRl, Rs2, Rs1};
+    case Format::SSPush:
+        return {Rs2Link};
+    case Format::SSPopChk:
+        return {Rs1Link};
+    case Format::SSReadPointer:
+        return {RdNz};
+
+    case Format::FR:
+        return {Frd, Frs1, Frs2};
+    case Format::FRRm:
+        return {Frd, Frs1, Frs2, Rm};
+    case Format::FR4:
+        return {Frd, Frs1, Frs2, Frs3, Rm};
+    case Format::FUnaryRm:
+        return {Frd, Frs1, Rm};
+    case Format::FCompare:
+        return {Rd, Frs1, Frs2};
+    case Format::FToX:
+        return {Rd, Frs1};
+    case Format::FToXRm:
+        return {Rd, Frs1, Rm};
+    case Format::XToF:
+        return {Frd, Rs1};
+    case Format::XToFRm:
+        return {Frd, Rs1, Rm};
+    case Format::FMovePair:
+        return {Frd, Rs1, Rs2};
+    case Format::FLoad:
+        return {Frd, Imm12, Rs1};
+    case Format::FStore:
+        return {Frs2, StoreImm, Rs1};
+    case Format::FLoadImm:
+        return {Frd, FliIndex};
+
+    case Format::VV:
+        return {Vd, Vs2, Vs1, Vm};
+    case Format::VX:
+        return {Vd, Vs2, Rs1, Vm};
+    case Format::VF:
+        return {Vd, Vs2, Frs1, Vm};
+    case Format::VI:
+        return {Vd, Vs2, Simm5, Vm};
+    case Format::VUI:
+        return {Vd, Vs2, Uimm5, Vm};
+    case Format::VRotateImm:
+        return {Vd, Vs2, VUimm6, Vm};
+    case Format::VVMultiplyAdd:
+        return {Vd, Vs1, Vs2, Vm};
+    case Format::VXMultiplyAdd:
+        return {Vd, Rs1, Vs2, Vm};
+    case Format::VFMultiplyAdd:
+        return {Vd, Frs1, Vs2, Vm};
+    case Format::VVNoMask:
+        return {Vd, Vs2, Vs1};
+    case Format::VXNoMask:
+        return {Vd, Vs2, Rs1};
+    case Format::VINoMask:
+        return {Vd, Vs2, Simm5};
+    case Format::VFNoMask:
+        return {Vd, Vs2, Frs1};
+    case Format::VUINoMask:
+        return {Vd, Vs2, Uimm5};
+    case Format::VUnary:
+        return {Vd, Vs2, Vm};
+    case Format::VUnaryNoMask:
+        return {Vd, Vs2};
+    case Format::VMoveV:
+        return {Vd, Vs1};
+    case Format::VMoveX:
+        return {Vd, Rs1};
+    case Format::VMoveF:
+        return {Vd, Frs1};
+    case Format::VMoveI:
+        return {Vd, Simm5};
+    case Format::VMoveToX:
+        return {Rd, Vs2};
+    case Format::VMoveToF:
+        return {Frd, Vs2};
+    case Format::VMaskToX:
+        return {Rd, Vs2, Vm};
+    case Format::VIndex:
+        return {Vd, Vm};
+    case Format::VMemUnit:
+        return {Vd, Rs1, Vm};
+    case Format::VMemWhole:
+        return {Vd, Rs1};
+    case Format::VMemStrided:
+        return {Vd, Rs1, Rs2, Vm};
+    case Format::VMemIndexed:
+        return {Vd, Rs1, Vs2, Vm};
+    case Format::VMemSegUnit:
+        return {Nf, Vd, Rs1, Vm};
+    case Format::VMemSegStrided:
+        return {Nf, Vd, Rs1, Rs2, Vm};
+    case Format::VMemSegIndexed:
+        return {Nf, Vd, Rs1, Vs2, Vm};
+    case Format::VSetVLI:
+        return {Rd, Rs1, VTypeImm};
+    case Format::VSetIVLI:
+        return {Rd, Uimm5, VTypeImm};
+
+    case Format::CR:
+        return {CRd, CRs2Nz};
+    case Format::CMove:
+        return {CRdNz, CRs2Nz};
+    case Format::CJumpReg:
+        return {CRdNz};
+    case Format::CI:
+        return {CRdNz, CImm6};
+    case Format::CAddi:
+        return {CRdNz, CImm6Nz};
+    case Format::CLui:
+        return {CRdLui, CLuiImm};
+    case Format::CShift:
+        return {CRdNz, CShamt};
+    case Format::CShiftB:
+        return {CRegHi, CShamt};
+    case Format::CAndi:
+        return {CRegHi, CImm6};
+    case Format::CAddi16sp:
+        return {CAddi16spImm};
+    case Format::CAddi4spn:
+        return {CRegLo, CAddi4spnImm};
+    case Format::CLwsp:
+        return {CRdNz, CLwspImm};
+    case Format::CLdsp:
+        return {CRdNz, CLdspImm};
+    case Format::CLqsp:
+        return {CRdNz, CLqspImm};
+    case Format::CFlwsp:
+        return {CFrd, CLwspImm};
+    case Format::CFldsp:
+        return {CFrd, CLdspImm};
+    case Format::CSwsp:
+        return {CRs2, CSwspImm};
+    case Format::CSdsp:
+        return {CRs2, CSdspImm};
+    case Format::CSqsp:
+        return {CRs2, CSqspImm};
+    case Format::CFswsp:
+        return {CFrs2, CSwspImm};
+    case Format::CFsdsp:
+        return {CFrs2, CSdspImm};
+    case Format::CMemB:
+        return {CRegLo, CLbImm, CRegHi};
+    case Format::CMemH:
+        return {CRegLo, CLhImm, CRegHi};
+    case Format::CMemW:
+        return {CRegLo, CLwImm, CRegHi};
+    case Format::CMemD:
+        return {CRegLo, CLdImm, CRegHi};
+    case Format::CMemQ:
+        return {CRegLo, CLqImm, CRegHi};
+    case Format::CFMemW:
+        return {CFRegLo, CLwImm, CRegHi};
+    case Format::CFMemD:
+        return {CFRegLo, CLdImm, CRegHi};
+    case Format::CA:
+        return {CRegHi, CRegLo};
+    case Format::CUnary:
+        return {CRegHi};
+    case Format::CBranch:
+        return {CRegHi, CBranchOffset};
+    case Format::CJump:
+        return {CJumpOffset};
+    case Format::CMMove:
+        return {CSregHi, CSregLo};
+    case Format::CMPush:
+        return {CRlist, CPushAdj};
+    case Format::CMPop:
+        return {CRlist, CPopAdj};
+    case Format::CMJumpTable:
+        return {CJtIndex};
+    case Format::CMJumpTableLink:
+        return {CJaltIndex};
+
+    case Format::Count:
+        break;
+    }
+
+    return {};
+}
+
+constexpr auto format_layouts = [] {
+    std::array<FormatLayout, static_cast<size_t>(Format::Count)> layouts{};
+    for (size_t i = 0; i < layouts.size(); i++) {
+        layouts[i] = GetFormatLayout(static_cast<Format>(i));
+    }
+    return layouts;
+}();
+
+[[nodiscard]] constexpr bool IsCompressedFormat(Format format) {
+    return format >= Format::CNone;
+}
+
+// Extracts bits [hi:lo] of a value.
+[[nodiscard]] constexpr uint32_t Bits(uint32_t value, uint32_t hi, uint32_t lo) {
+    return (value >> lo) & ((1U << (hi - lo + 1)) - 1);
+}
+
+// Sign-extends the lower `bits` bits of a value.
+[[nodiscard]] constexpr int32_t SignExtend(uint32_t value, uint32_t bits) {
+    const auto shift = 32 - bits;
+    return static_cast<int32_t>(value << shift) >> shift;
+}
+
+// Decodes the 3-bit register encoding used by the Zcmp CM.MVA01S and CM.MVSA01 instructions.
+[[nodiscard]] constexpr int32_t DecodeSRegister(uint32_t value) {
+    return static_cast<int32_t>(value < 2 ? value + 8 : value + 16);
+}
+
+// Determines the stack adjustment of a CM.PUSH/CM.POP instruction.
+[[nodiscard]] constexpr int32_t DecodeStackAdjustment(uint32_t encoding, ArchFeature features) {
+    const auto rlist = Bits(encoding, 7, 4);
+    const auto base = IsRV64(features) ? stack_adj_bases_rv64[rlist]
+                                       : stack_adj_bases_rv32[rlist];
+    return static_cast<int32_t>(base + Bits(encoding, 3, 2) * 16);
+}
+
+// Extracts the value of an operand field from an instruction encoding.
+// Returns false if the field contains a reserved value.
+[[nodiscard]] bool ExtractField(Field field, uint32_t enc, ArchFeature features, int32_t& value) {
+    const auto to_signed = [](uint32_t v) { return static_cast<int32_t>(v); };
+
+    switch (field) {
+    case Field::Rd:
+    case Field::Frd:
+    case Field::Vd:
+    case Field::CRd:
+    case Field::CFrd:
+        value = to_signed(Bits(enc, 11, 7));
+        return true;
+    case Field::RdNz:
+    case Field::CRdNz:
+        value = to_signed(Bits(enc, 11, 7));
+        return value != 0;
+    case Field::CRdLui:
+        value = to_signed(Bits(enc, 11, 7));
+        return value != 0 && value != 2;
+    case Field::Rs1:
+    case Field::Frs1:
+    case Field::Vs1:
+    case Field::Uimm5:
+    case Field::FliIndex:
+        value = to_signed(Bits(enc, 19, 15));
+        return true;
+    case Field::Rs2:
+    case Field::Frs2:
+    case Field::Vs2:
+    case Field::Shamt5:
+        value = to_signed(Bits(enc, 24, 20));
+        return true;
+    case Field::Rs1Link:
+        value = to_signed(Bits(enc, 19, 15));
+        return value == 1 || value == 5;
+    case Field::Rs2Link:
+        value = to_signed(Bits(enc, 24, 20));
+        return value == 1 || value == 5;
+    case Field::Frs3:
+        value = to_signed(Bits(enc, 31, 27));
+        return true;
+    case Field::Vm:
+        value = to_signed(Bits(enc, 25, 25));
+        return true;
+    case Field::Imm12:
+        value = SignExtend(Bits(enc, 31, 20), 12);
+        return true;
+    case Field::Uimm12:
+    case Field::Csr:
+        value = to_signed(Bits(enc, 31, 20));
+        return true;
+    case Field::StoreImm:
+        value = SignExtend((Bits(enc, 31, 25) << 5) | Bits(enc, 11, 7), 12);
+        return true;
+    case Field::BranchOffset:
+        value = SignExtend((Bits(enc, 31, 31) << 12) | (Bits(enc, 7, 7) << 11) |
+                           (Bits(enc, 30, 25) << 5) | (Bits(enc, 11, 8) << 1), 13);
+        return true;
+    case Field::UpperImm:
+        value = to_signed(Bits(enc, 31, 12));
+        return true;
+    case Field::JumpOffset:
+        value = SignExtend((Bits(enc, 31, 31) << 20) | (Bits(enc, 19, 12) << 12) |
+                           (Bits(enc, 20, 20) << 11) | (Bits(enc, 30, 21) << 1), 21);
+        return true;
+    case Field::Shamt6:
+        value = to_signed(Bits(enc, 25, 20));
+        return !IsRV32(features) || value < 32;
+    case Field::AddslShift:
+    case Field::AqRl:
+        value = to_signed(Bits(enc, 26, 25));
+        return true;
+    case Field::ByteSelect:
+        value = to_signed(Bits(enc, 31, 30));
+        return true;
+    case Field::Rnum:
+    case Field::Succ:
+        value = to_signed(Bits(enc, 23, 20));
+        return true;
+    case Field::Simm5:
+        value = SignExtend(Bits(enc, 19, 15), 5);
+        return true;
+    case Field::VUimm6:
+        value = to_signed((Bits(enc, 26, 26) << 5) | Bits(enc, 19, 15));
+        return true;
+    case Field::Pred:
+        value = to_signed(Bits(enc, 27, 24));
+        return true;
+    case Field::PrefetchOffset:
+        value = SignExtend(Bits(enc, 31, 25), 7) * 32;
+        return true;
+    case Field::Rm:
+        // Rounding modes 0b101 and 0b110 are reserved.
+        value = to_signed(Bits(enc, 14, 12));
+        return value != 0b101 && value != 0b110;
+    case Field::Nf:
+        // A segment count of one is a regular unit-stride/strided/indexed access.
+        value = to_signed(Bits(enc, 31, 29) + 1);
+        return value != 1;
+    case Field::VTypeImm:
+        // An LMUL encoding of 0b100 is reserved.
+        value = to_signed(Bits(enc, 27, 20));
+        return Bits(enc, 22, 20) != 0b100;
+
+    case Field::CRs2:
+    case Field::CFrs2:
+        value = to_signed(Bits(enc, 6, 2));
+        return true;
+    case Field::CRs2Nz:
+        value = to_signed(Bits(enc, 6, 2));
+        return value != 0;
+    case Field::CRegHi:
+        value = to_signed(Bits(enc, 9, 7) + 8);
+        return true;
+    case Field::CRegLo:
+    case Field::CFRegLo:
+        value = to_signed(Bits(enc, 4, 2) + 8);
+        return true;
+    case Field::CSregHi:
+        value = DecodeSRegister(Bits(enc, 9, 7));
+        return true;
+    case Field::CSregLo:
+        // Both registers of CM.MVA01S and CM.MVSA01 must differ.
+        value = DecodeSRegister(Bits(enc, 4, 2));
+        return Bits(enc, 4, 2) != Bits(enc, 9, 7);
+    case Field::CImm6:
+        value = SignExtend((Bits(enc, 12, 12) << 5) | Bits(enc, 6, 2), 6);
+        return true;
+    case Field::CImm6Nz:
+        value = SignExtend((Bits(enc, 12, 12) << 5) | Bits(enc, 6, 2), 6);
+        return value != 0;
+    case Field::CLuiImm:
+        value = to_signed((Bits(enc, 12, 12) << 5) | Bits(enc, 6, 2));
+        return value != 0;
+    case Field::CShamt:
+        // RV32C requires shamt[5] to be zero, and RV128C encodes a shift of 64 as zero.
+        value = to_signed((Bits(enc, 12, 12) << 5) | Bits(enc, 6, 2));
+        if (value == 0) {
+            value = 64;
+            return IsRV128(features);
+        }
+        return !IsRV32(features) || value < 32;
+    case Field::CAddi16spImm:
+        value = SignExtend((Bits(enc, 12, 12) << 9) | (Bits(enc, 4, 3) << 7) | (Bits(enc, 5, 5) << 6) |
+                           (Bits(enc, 2, 2) << 5) | (Bits(enc, 6, 6) << 4), 10);
+        return value != 0;
+    case Field::CAddi4spnImm:
+        value = to_signed((Bits(enc, 10, 7) << 6) | (Bits(enc, 12, 11) << 4) |
+                          (Bits(enc, 5, 5) << 3) | (Bits(enc, 6, 6) << 2));
+        return value != 0;
+    case Field::CLwspImm:
+        value = to_signed((Bits(enc, 3, 2) << 6) | (Bits(enc, 12, 12) << 5) | (Bits(enc, 6, 4) << 2));
+        return true;
+    case Field::CLdspImm:
+        value = to_signed((Bits(enc, 4, 2) << 6) | (Bits(enc, 12, 12) << 5) | (Bits(enc, 6, 5) << 3));
+        return true;
+    case Field::CLqspImm:
+        value = to_signed((Bits(enc, 5, 2) << 6) | (Bits(enc, 12, 12) << 5) | (Bits(enc, 6, 6) << 4));
+        return true;
+    case Field::CSwspImm:
+        value = to_signed((Bits(enc, 8, 7) << 6) | (Bits(enc, 12, 9) << 2));
+        return true;
+    case Field::CSdspImm:
+        value = to_signed((Bits(enc, 9, 7) << 6) | (Bits(enc, 12, 10) << 3));
+        return true;
+    case Field::CSqspImm:
+        value = to_signed((Bits(enc, 10, 7) << 6) | (Bits(enc, 12, 11) << 4));
+        return true;
+    case Field::CLwImm:
+        value = to_signed((Bits(enc, 5, 5) << 6) | (Bits(enc, 12, 10) << 3) | (Bits(enc, 6, 6) << 2));
+        return true;
+    case Field::CLdImm:
+        value = to_signed((Bits(enc, 6, 5) << 6) | (Bits(enc, 12, 10) << 3));
+        return true;
+    case Field::CLqImm:
+        value = to_signed((Bits(enc, 10, 10) << 8) | (Bits(enc, 6, 5) << 6) | (Bits(enc, 12, 11) << 4));
+        return true;
+    case Field::CLbImm:
+        value = to_signed((Bits(enc, 5, 5) << 1) | Bits(enc, 6, 6));
+        return true;
+    case Field::CLhImm:
+        value = to_signed(Bits(enc, 5, 5) << 1);
+        return true;
+    case Field::CBranchOffset:
+        value = SignExtend((Bits(enc, 12, 12) << 8) | (Bits(enc, 6, 5) << 6) | (Bits(enc, 2, 2) << 5) |
+                           (Bits(enc, 11, 10) << 3) | (Bits(enc, 4, 3) << 1), 9);
+        return true;
+    case Field::CJumpOffset:
+        value = SignExtend((Bits(enc, 12, 12) << 11) | (Bits(enc, 8, 8) << 10) | (Bits(enc, 10, 9) << 8) |
+                           (Bits(enc, 6, 6) << 7) | (Bits(enc, 7, 7) << 6) | (Bits(enc, 2, 2) << 5) |
+                           (Bits(enc, 11, 11) << 4) | (Bits(enc, 5, 3) << 1), 12);
+        return true;
+    case Field::CRlist:
+        // rlist values below 4 are reserved.
+        value = to_signed(Bits(enc, 7, 4));
+        return value >= 4;
+    case Field::CPushAdj:
+        value = -DecodeStackAdjustment(enc, features);
+        return true;
+    case Field::CPopAdj:
+        value = DecodeStackAdjustment(enc, features);
+        return true;
+    case Field::CJtIndex:
+        value = to_signed(Bits(enc, 6, 2));
+        return true;
+    case Field::CJaltIndex:
+        // Indices below 32 are encoded as CM.JT.
+        value = to_signed(Bits(enc, 9, 2));
+        return value >= 32;
+
+    case Field::Count:
+        break;
+    }
+
+    return false;
+}
+
+// Retrieves a value for a field that every instruction using the field accepts.
+// These are used to emit each instruction once while building the decoding tables.
+[[nodiscard]] int32_t GetSampleValue(Field field, ArchFeature features) {
+    switch (field) {
+    case Field::Rd:
+    case Field::RdNz:
+    case Field::Frd:
+    case Field::CRd:
+    case Field::CRdNz:
+    case Field::CRdLui:
+    case Field::CFrd:
+    case Field::CRegLo:
+    case Field::CFRegLo:
+        return 10;
+    case Field::Rs1:
+    case Field::Frs1:
+    case Field::CRs2:
+    case Field::CRs2Nz:
+    case Field::CFrs2:
+        return 11;
+    case Field::Rs2:
+    case Field::Frs2:
+        return 12;
+    case Field::Frs3:
+        return 13;
+    case Field::Rs1Link:
+    case Field::Rs2Link:
+        return 1;
+    case Field::Vd:
+        return 8;
+    case Field::Vs2:
+        return 16;
+    case Field::Vs1:
+        return 24;
+    case Field::Vm:
+        return static_cast<int32_t>(VecMask::Yes);
+    case Field::Imm12:
+        return -1000;
+    case Field::Uimm12:
+        return 0x123;
+    case Field::StoreImm:
+        return -100;
+    case Field::BranchOffset:
+        return -1234;
+    case Field::UpperImm:
+        return 0xABCDE;
+    case Field::JumpOffset:
+        return -123456;
+    case Field::Shamt6:
+    case Field::CShamt:
+        return IsRV32(features) ? 21 : 37;
+    case Field::Shamt5:
+        return 21;
+    case Field::AddslShift:
+    case Field::ByteSelect:
+        return 2;
+    case Field::Rnum:
+    case Field::FliIndex:
+    case Field::Uimm5:
+    case Field::CJtIndex:
+        return 5;
+    case Field::Csr:
+        return 0x123;
+    case Field::Simm5:
+    case Field::CImm6:
+    case Field::CImm6Nz:
+        return -7;
+    case Field::VUimm6:
+        return 37;
+    case Field::Pred:
+        return static_cast<int32_t>(FenceOrder::R);
+    case Field::Succ:
+        return static_cast<int32_t>(FenceOrder::RW);
+    case Field::PrefetchOffset:
+    case Field::CAddi16spImm:
+        return -64;
+    case Field::AqRl:
+        return static_cast<int32_t>(Ordering::AQRL);
+    case Field::Rm:
+        return static_cast<int32_t>(RMode::RUP);
+    case Field::Nf:
+        return 3;
+    case Field::VTypeImm:
+        // e32, m2, ta, mu
+        return 0x51;
+    case Field::CRegHi:
+    case Field::CSregHi:
+        return 9;
+    case Field::CSregLo:
+        return 18;
+    case Field::CLuiImm:
+        return 0x21;
+    case Field::CAddi4spnImm:
+        return 932;
+    case Field::CLwspImm:
+    case Field::CSwspImm:
+        return 172;
+    case Field::CLdspImm:
+    case Field::CSdspImm:
+        return 344;
+    case Field::CLqspImm:
+    case Field::CSqspImm:
+        return 688;
+    case Field::CLwImm:
+        return 76;
+    case Field::CLdImm:
+        return 200;
+    case Field::CLqImm:
+        return 336;
+    case Field::CLbImm:
+        return 1;
+    case Field::CLhImm:
+        return 2;
+    case Field::CBranchOffset:
+        return -20;
+    case Field::CJumpOffset:
+        return 1234;
+    case Field::CRlist:
+        return 7;
+    case Field::CPushAdj:
+        return -DecodeStackAdjustment((7U << 4) | (2U << 2), features);
+    case Field::CPopAdj:
+        return DecodeStackAdjustment((7U << 4) | (2U << 2), features);
+    case Field::CJaltIndex:
+        return 40;
+
+    case Field::Count:
+        break;
+    }
+
+    return 0;
+}
+
+// Extension options required for a candidate to be considered.
+enum CandidateFlags : uint8_t {
+    RequiresZcmp = 1U << 0,
+    RequiresZcmt = 1U << 1,
+    // Encoding space shared with Zcmp and Zcmt.
+    ConflictsWithZcm = 1U << 2,
+};
+
+[[nodiscard]] constexpr uint8_t GetCandidateFlags(Format format) {
+    switch (format) {
+    case Format::CMMove:
+    case Format::CMPush:
+    case Format::CMPop:
+        return RequiresZcmp;
+    case Format::CMJumpTable:
+    case Format::CMJumpTableLink:
+        return RequiresZcmt;
+    case Format::CFsdsp:
+        return ConflictsWithZcm;
+    default:
+        return 0;
+    }
+}
+
+struct Candidate {
+    uint32_t match;
+    uint32_t mask;
+    Opcode opcode;
+    Format format;
+    uint8_t xlen;
+    uint8_t flags;
+};
+
+// Candidates grouped into buckets by a subset of their encoding bits.
+struct DecodeTable {
+    std::vector<Candidate> candidates;
+    std::vector<uint32_t> offsets;
+};
+
+// Bucket key for 32-bit instructions: opcode[6:2], funct3 and bits [31:26] (funct6/funct7).
+constexpr uint32_t key_bits_32 = 14;
+[[nodiscard]] constexpr uint32_t GetBucketKey32(uint32_t encoding) {
+    return (Bits(encoding, 6, 2) << 9) | (Bits(encoding, 14, 12) << 6) | Bits(encoding, 31, 26);
+}
+
+// Bucket key for 16-bit instructions: quadrant, funct3 and bits [12:10].
+constexpr uint32_t key_bits_16 = 8;
+[[nodiscard]] constexpr uint32_t GetBucketKey16(uint32_t encoding) {
+    return (Bits(encoding, 1, 0) << 6) | (Bits(encoding, 15, 13) << 3) | Bits(encoding, 12, 10);
+}
+
+class DecodeTableBuilder {
+public:
+    explicit DecodeTableBuilder(uint32_t key_bits) : m_buckets(size_t{1} << key_bits) {}
+
+    void Add(const Candidate& candidate, uint32_t key_match, uint32_t key_mask) {
+        // Candidates are added to every bucket whose key is consistent
+        // with the fixed bits of the candidate.
+        const auto free_bits = ~key_mask & static_cast<uint32_t>(m_buckets.size() - 1);
+        auto subset = free_bits;
+        while (true) {
+            m_buckets[(key_match & key_mask) | subset].push_back(candidate);
+            if (subset == 0) {
+                break;
+            }
+            subset = (subset - 1) & free_bits;
+        }
+    }
+
+    [[nodiscard]] DecodeTable Build() {
+        DecodeTable table;
+        table.offsets.reserve(m_buckets.size() + 1);
+
+        for (auto& bucket : m_buckets) {
+            // Prefer the most specific candidates, so that instructions which are special cases
+            // of others (e.g. C.NOP and C.ADDI) are matched before more general ones.
+            std::stable_sort(bucket.begin(), bucket.end(), [](const Candidate& lhs, const Candidate& rhs) {
+                return std::popcount(lhs.mask) > std::popcount(rhs.mask);
+            });
+
+            table.offsets.push_back(static_cast<uint32_t>(table.candidates.size()));
+            table.candidates.insert(table.candidates.end(), bucket.begin(), bucket.end());
+        }
+        table.offsets.push_back(static_cast<uint32_t>(table.candidates.size()));
+
+        return table;
+    }
+
+private:
+    std::vector<std::vector<Candidate>> m_buckets;
+};
+
+struct DecodeTables {
+    DecodeTable compressed;
+    DecodeTable uncompressed;
+};
+
+[[nodiscard]] bool IsCandidateEnabled(const Candidate& candidate, uint8_t xlen, DecodeOptions options) {
+    if ((candidate.xlen & xlen) == 0) {
+        return false;
+    }
+    if (candidate.flags == 0) {
+        return true;
+    }
+
+    const auto enabled = static_cast<uint32_t>(options);
+    if ((candidate.flags & ConflictsWithZcm) != 0) {
+        return (enabled & static_cast<uint32_t>(DecodeOptions::Zcmp | DecodeOptions::Zcmt)) == 0;
+    }
+    if ((candidate.flags & RequiresZcmp) != 0) {
+        return (enabled & static_cast<uint32_t>(DecodeOptions::Zcmp)) != 0;
+    }
+    return (enabled & static_cast<uint32_t>(DecodeOptions::Zcmt)) != 0;
+}
+
+void DecodeWithTable(const DecodeTable& table, uint32_t key, ArchFeature features,
+                     DecodeOptions options, Instruction& instruction) {
+    const auto xlen = XLen::FromArchFeature(features);
+    const auto encoding = instruction.encoding;
+
+    const auto begin = table.candidates.begin() + table.offsets[key];
+    const auto end = table.candidates.begin() + table.offsets[key + 1];
+
+    for (auto iter = begin; iter != end; ++iter) {
+        const auto& candidate = *iter;
+        if ((encoding & candidate.mask) != candidate.match) {
+            continue;
+        }
+        if (!IsCandidateEnabled(candidate, xlen, options)) {
+            continue;
+        }
+
+        const auto& layout = format_layouts[static_cast<size_t>(candidate.format)];
+
+        bool valid = true;
+        for (size_t i = 0; i < layout.num_fields && valid; i++) {
+            const auto field = layout.fields[i];
+            auto& operand = instruction.operands[i];
+
+            operand.type = GetFieldInfo(field).type;
+            valid = ExtractField(field, encoding, features, operand.value);
+        }
+        if (!valid) {
+            continue;
+        }
+
+        instruction.opcode = candidate.opcode;
+        instruction.num_operands = layout.num_fields;
+        return;
+    }
+
+    instruction.operands = {};
+}
+[[nodiscard]] Instruction MakeSampleInstruction(Opcode opcode, const FormatLayout& layout,
+                                                ArchFeature features) {
+    Instruction instruction;
+    instruction.opcode = opcode;
+    instruction.num_operands = layout.num_fields;
+    for (size_t i = 0; i < layout.num_fields; i++) {
+        const auto field = layout.fields[i];
+        instruction.operands[i] = {GetFieldInfo(field).type, GetSampleValue(field, features)};
+    }
+    return instruction;
+}
+
+[[nodiscard]] DecodeTables BuildDecodeTables() {
+    static constexpr std::array features_list{
+        ArchFeature::RV32,
+        ArchFeature::RV64,
+        ArchFeature::RV128,
+    };
+
+    DecodeTableBuilder compressed{key_bits_16};
+    DecodeTableBuilder uncompressed{key_bits_32};
+
+    std::array<uint8_t, 8> buffer{};
+
+    struct Sample {
+        uint32_t encoding;
+        ArchFeature features;
+        Opcode opcode;
+        uint8_t flags;
+    };
+    std::vector<Sample> samples;
+
+    for (const auto& info : GetOpcodeInfos()) {
+        const auto& layout = format_layouts[static_cast<size_t>(info.format)];
+        const bool is_compressed = IsCompressedFormat(info.format);
+
+        uint32_t field_bits = 0;
+        for (size_t i = 0; i < layout.num_fields; i++) {
+            field_bits |= GetFieldInfo(layout.fields[i]).bits;
+        }
+
+        // The same encoding may be shared by several base ISAs, in which case
+        // a single candidate covers all of them.
+        std::array<Candidate, features_list.size()> variants{};
+        size_t num_variants = 0;
+
+        for (const auto features : features_list) {
+            const auto xlen = XLen::FromArchFeature(features);
+            if ((info.xlen & xlen) == 0) {
+                continue;
+            }
+
+            const auto sample = MakeSampleInstruction(info.opcode, layout, features);
+
+            Assembler as{buffer.data(), buffer.size(), features};
+            info.emit(as, sample);
+
+            const auto size = static_cast<size_t>(as.GetCodeBuffer().GetCursorOffset());
+            BISCUIT_ASSERT(size == (is_compressed ? 2U : 4U));
+
+            uint32_t encoding = 0;
+            std::memcpy(&encoding, buffer.data(), size);
+
+            // Ensure the field descriptions agree with what the emitter produced.
+            for (size_t i = 0; i < layout.num_fields; i++) {
+                int32_t value = 0;
+                BISCUIT_ASSERT(ExtractField(layout.fields[i], encoding, features, value));
+                BISCUIT_ASSERT(value == sample.operands[i].value);
+            }
+
+            samples.push_back({encoding, features, info.opcode, GetCandidateFlags(info.format)});
+
+            const auto mask = ~field_bits & (is_compressed ? 0xFFFFU : 0xFFFFFFFFU);
+            const auto match = encoding & mask;
+
+            const auto iter = std::find_if(variants.begin(), variants.begin() + num_variants,
+                                           [&](const Candidate& candidate) {
+                return candidate.match == match && candidate.mask == mask;
+            });
+            if (iter != variants.begin() + num_variants) {
+                iter->xlen |= xlen;
+                continue;
+            }
+
+            variants[num_variants++] = {
+                .match = match,
+                .mask = mask,
+                .opcode = info.opcode,
+                .format = info.format,
+                .xlen = xlen,
+                .flags = GetCandidateFlags(info.format),
+            };
+        }
+
+        for (size_t i = 0; i < num_variants; i++) {
+            const auto& variant = variants[i];
+            if (is_compressed) {
+                compressed.Add(variant, GetBucketKey16(variant.match), GetBucketKey16(variant.mask));
+            } else {
+                uncompressed.Add(variant, GetBucketKey32(variant.match), GetBucketKey32(variant.mask));
+            }
+        }
+    }
+
+    DecodeTables tables{
+        .compressed = compressed.Build(),
+        .uncompressed = uncompressed.Build(),
+    };
+
+    // Ensure every sample decodes back to the instruction that produced it. This catches
+    // any ambiguities between instructions that the candidate ordering doesn't resolve.
+    for (const auto& sample : samples) {
+        auto options = DecodeOptions::None;
+        if ((sample.flags & RequiresZcmp) != 0) {
+            options = DecodeOptions::Zcmp;
+        } else if ((sample.flags & RequiresZcmt) != 0) {
+            options = DecodeOptions::Zcmt;
+        }
+
+        Instruction instruction;
+        instruction.encoding = sample.encoding;
+        if ((sample.encoding & 0b11) != 0b11) {
+            DecodeWithTable(tables.compressed, GetBucketKey16(sample.encoding),
+                            sample.features, options, instruction);
+        } else {
+            DecodeWithTable(tables.uncompressed, GetBucketKey32(sample.encoding),
+                            sample.features, options, instruction);
+        }
+        BISCUIT_ASSERT(instruction.opcode == sample.opcode);
+    }
+
+    return tables;
+}
+
+[[nodiscard]] const DecodeTables& GetDecodeTables() {
+    static const DecodeTables tables = BuildDecodeTables();
+    return tables;
+}
+
+} // Anonymous namespace
+
+Instruction Decode(const uint8_t* code, ArchFeature features, DecodeOptions options) noexcept {
+    const auto& tables = GetDecodeTables();
+
+    uint16_t low_half = 0;
+    std::memcpy(&low_half, code, sizeof(low_half));
+
+    Instruction instruction;
+
+    // Determine the instruction length from the low bits, as per the
+    // "Base Instruction-Length Encoding" section of the ISA manual.
+    if ((low_half & 0b11) != 0b11) {
+        instruction.size = 2;
+        instruction.encoding = low_half;
+        DecodeWithTable(tables.compressed, GetBucketKey16(low_half), features, options, instruction);
+    } else if ((low_half & 0b11100) != 0b11100) {
+        instruction.size = 4;
+        std::memcpy(&instruction.encoding, code, sizeof(instruction.encoding));
+        DecodeWithTable(tables.uncompressed, GetBucketKey32(instruction.encoding),
+                        features, options, instruction);
+    } else if ((low_half & 0b111111) == 0b011111) {
+        instruction.size = 6;
+    } else if ((low_half & 0b1111111) == 0b0111111) {
+        instruction.size = 8;
+    } else {
+        // Longer encodings aren't standardized yet. Treat them as an
+        // unrecognized 16-bit parcel so that scanning can resynchronize.
+        instruction.size = 2;
+    }
+
+    return instruction;
+}
+
+void Encode(Assembler& as, const Instruction& instruction) {
+    BISCUIT_ASSERT(instruction.IsValid());
+    GetOpcodeInfo(instruction.opcode).emit(as, instruction);
+}
+
+std::string_view GetMnemonic(Opcode opcode) noexcept {
+    if (opcode == Opcode::Invalid) {
+        return "unknown";
+    }
+    return GetOpcodeInfo(opcode).mnemonic;
+}
+
+} // namespace biscuit
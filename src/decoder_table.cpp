@@ -0,0 +1,1135 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/assembler.hpp>
+#include <biscuit/decoder.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "assembler_util.hpp"
+#include "decoder_table.hpp"
+
+// Table of every instruction known to the decoder, along with the
+// Assembler functions that are used to encode each of them.
+
+namespace biscuit {
+namespace {
+// Converts a decoded operand into the type an Assembler function expects.
+template <typename T>
+T OperandAs(const Operand& operand) noexcept {
+    if constexpr (std::is_same_v<T, int32_t>) {
+        return operand.value;
+    } else if constexpr (std::is_same_v<T, uint32_t>) {
+        return static_cast<uint32_t>(operand.value);
+    } else if constexpr (std::is_base_of_v<Register, T>) {
+        return T{static_cast<uint32_t>(operand.value)};
+    } else if constexpr (std::is_enum_v<T>) {
+        return static_cast<T>(operand.value);
+    } else if constexpr (std::is_same_v<T, double>) {
+        return std::bit_cast<double>(fli_table[static_cast<size_t>(operand.value)]);
+    } else if constexpr (std::is_same_v<T, PushPopList>) {
+        // rlist values 4 to 15 correspond to {ra}, {ra, s0}, {ra, s0-s1}, ..., {ra, s0-s11},
+        // with the exception of {ra, s0-s10}, which isn't encodable.
+        const auto rlist = static_cast<uint32_t>(operand.value);
+        if (rlist == 4) {
+            return PushPopList{ra};
+        }
+        if (rlist == 5) {
+            return PushPopList{ra, {s0}};
+        }
+        if (rlist == 15) {
+            return PushPopList{ra, {s0, s11}};
+        }
+        return PushPopList{ra, {s0, rlist == 6 ? s1 : GPR{rlist + 11}}};
+    } else {
+        static_assert(!sizeof(T), "Unhandled operand type");
+    }
+}
+
+template <typename Function>
+struct Emitter;
+
+template <typename... Args>
+struct Emitter<void (Assembler::*)(Args...) noexcept> {
+    template <auto Function>
+    static void Emit(Assembler& as, const Instruction& instruction) noexcept {
+        EmitImpl<Function>(as, instruction, std::index_sequence_for<Args...>{});
+    }
+
+private:
+    template <auto Function, size_t... Indices>
+    static void EmitImpl(Assembler& as, const Instruction& instruction,
+                         std::index_sequence<Indices...>) noexcept {
+        (as.*Function)(OperandAs<Args>(instruction.operands[Indices])...);
+    }
+};
+
+template <typename... Args>
+using AssemblerFunction = void (Assembler::*)(Args...) noexcept;
+
+// Splits the vtype immediate back into the parameters taken by VSETVLI and VSETIVLI.
+void EmitVSETVLI(Assembler& as, const Instruction& instruction) noexcept {
+    const auto vtype = static_cast<uint32_t>(instruction.operands[2].value);
+    as.VSETVLI(instruction.GetGPR(0), instruction.GetGPR(1),
+               static_cast<SEW>((vtype >> 3) & 0b111), static_cast<LMUL>(vtype & 0b111),
+               static_cast<VTA>((vtype >> 6) & 1), static_cast<VMA>((vtype >> 7) & 1));
+}
+void EmitVSETIVLI(Assembler& as, const Instruction& instruction) noexcept {
+    const auto vtype = static_cast<uint32_t>(instruction.operands[2].value);
+    as.VSETIVLI(instruction.GetGPR(0), static_cast<uint32_t>(instruction.operands[1].value),
+                static_cast<SEW>((vtype >> 3) & 0b111), static_cast<LMUL>(vtype & 0b111),
+                static_cast<VTA>((vtype >> 6) & 1), static_cast<VMA>((vtype >> 7) & 1));
+}
+
+// clang-format off
+#define BISCUIT_OPCODE(name, mnemonic, format, xlen)                               \
+    OpcodeInfo{Opcode::name, mnemonic, Format::format, XLen::xlen,                 \
+               &Emitter<decltype(&Assembler::name)>::Emit<&Assembler::name>}
+
+#define BISCUIT_OVERLOAD(name, function, mnemonic, format, xlen, ...)              \
+    OpcodeInfo{Opcode::name, mnemonic, Format::format, XLen::xlen,                 \
+               &Emitter<AssemblerFunction<__VA_ARGS__>>::Emit<                     \
+                   static_cast<AssemblerFunction<__VA_ARGS__>>(&Assembler::function)>}
+
+#define BISCUIT_CUSTOM(name, mnemonic, format, xlen, emitter)                      \
+    OpcodeInfo{Opcode::name, mnemonic, Format::format, XLen::xlen, &emitter}
+
+constexpr std::array opcode_infos{
+    // RV32I Instructions
+    BISCUIT_OPCODE(ADD, "add", R, All),
+    BISCUIT_OPCODE(ADDI, "addi", I, All),
+    BISCUIT_OPCODE(AND, "and", R, All),
+    BISCUIT_OPCODE(ANDI, "andi", I, All),
+    BISCUIT_OPCODE(AUIPC, "auipc", U, All),
+    BISCUIT_OVERLOAD(BEQ, BEQ, "beq", Branch, All, GPR, GPR, int32_t),
+    BISCUIT_OVERLOAD(BGE, BGE, "bge", Branch, All, GPR, GPR, int32_t),
+    BISCUIT_OVERLOAD(BGEU, BGEU, "bgeu", Branch, All, GPR, GPR, int32_t),
+    BISCUIT_OVERLOAD(BLT, BLT, "blt", Branch, All, GPR, GPR, int32_t),
+    BISCUIT_OVERLOAD(BLTU, BLTU, "bltu", Branch, All, GPR, GPR, int32_t),
+    BISCUIT_OVERLOAD(BNE, BNE, "bne", Branch, All, GPR, GPR, int32_t),
+    BISCUIT_OPCODE(EBREAK, "ebreak", None, All),
+    BISCUIT_OPCODE(ECALL, "ecall", None, All),
+    BISCUIT_OVERLOAD(FENCE, FENCE, "fence", Fence, All, FenceOrder, FenceOrder),
+    BISCUIT_OPCODE(FENCEI, "fence.i", FenceI, All),
+    BISCUIT_OPCODE(FENCETSO, "fence.tso", None, All),
+    BISCUIT_OVERLOAD(JAL, JAL, "jal", Jal, All, GPR, int32_t),
+    BISCUIT_OVERLOAD(JALR, JALR, "jalr", Load, All, GPR, int32_t, GPR),
+    BISCUIT_OVERLOAD(LB, LB, "lb", Load, All, GPR, int32_t, GPR),
+    BISCUIT_OPCODE(LBU, "lbu", Load, All),
+    BISCUIT_OVERLOAD(LH, LH, "lh", Load, All, GPR, int32_t, GPR),
+    BISCUIT_OPCODE(LHU, "lhu", Load, All),
+    BISCUIT_OPCODE(LUI, "lui", U, All),
+    BISCUIT_OVERLOAD(LW, LW, "lw", Load, All, GPR, int32_t, GPR),
+    BISCUIT_OPCODE(OR, "or", R, All),
+    BISCUIT_OPCODE(ORI, "ori", I, All),
+    BISCUIT_OPCODE(PAUSE, "pause", None, All),
+    BISCUIT_OVERLOAD(SB, SB, "sb", Store, All, GPR, int32_t, GPR),
+    BISCUIT_OVERLOAD(SH, SH, "sh", Store, All, GPR, int32_t, GPR),
+    BISCUIT_OVERLOAD(SW, SW, "sw", Store, All, GPR, int32_t, GPR),
+    BISCUIT_OPCODE(SLL, "sll", R, All),
+    BISCUIT_OPCODE(SLLI, "slli", Shift, All),
+    BISCUIT_OPCODE(SLT, "slt", R, All),
+    BISCUIT_OPCODE(SLTI, "slti", I, All),
+    BISCUIT_OPCODE(SLTIU, "sltiu", I, All),
+    BISCUIT_OPCODE(SLTU, "sltu", R, All),
+    BISCUIT_OPCODE(SRA, "sra", R, All),
+    BISCUIT_OPCODE(SRAI, "srai", Shift, All),
+    BISCUIT_OPCODE(SRL, "srl", R, All),
+    BISCUIT_OPCODE(SRLI, "srli", Shift, All),
+    BISCUIT_OPCODE(SUB, "sub", R, All),
+    BISCUIT_OPCODE(XOR, "xor", R, All),
+    BISCUIT_OPCODE(XORI, "xori", I, All),
+
+    // RV64I Base Instruction Set
+    BISCUIT_OPCODE(ADDIW, "addiw", I, RV64),
+    BISCUIT_OPCODE(ADDW, "addw", R, RV64),
+    BISCUIT_OVERLOAD(LD, LD, "ld", Load, RV64, GPR, int32_t, GPR),
+    BISCUIT_OPCODE(LWU, "lwu", Load, RV64),
+    BISCUIT_OVERLOAD(SD, SD, "sd", Store, RV64, GPR, int32_t, GPR),
+    BISCUIT_OPCODE(SLLIW, "slliw", ShiftW, RV64),
+    BISCUIT_OPCODE(SRAIW, "sraiw", ShiftW, RV64),
+    BISCUIT_OPCODE(SRLIW, "srliw", ShiftW, RV64),
+    BISCUIT_OPCODE(SLLW, "sllw", R, RV64),
+    BISCUIT_OPCODE(SRAW, "sraw", R, RV64),
+    BISCUIT_OPCODE(SRLW, "srlw", R, RV64),
+    BISCUIT_OPCODE(SUBW, "subw", R, RV64),
+
+    // Zawrs Extension Instructions
+    BISCUIT_OPCODE(WRS_NTO, "wrs.nto", None, All),
+    BISCUIT_OPCODE(WRS_STO, "wrs.sto", None, All),
+
+    // Zacas Extension Instructions
+    BISCUIT_OPCODE(AMOCAS_D, "amocas.d", Amo, All),
+    BISCUIT_OPCODE(AMOCAS_Q, "amocas.q", Amo, RV64),
+    BISCUIT_OPCODE(AMOCAS_W, "amocas.w", Amo, All),
+
+    // Zabha Extension Instructions
+    BISCUIT_OPCODE(AMOADD_B, "amoadd.b", Amo, All),
+    BISCUIT_OPCODE(AMOAND_B, "amoand.b", Amo, All),
+    BISCUIT_OPCODE(AMOMAX_B, "amomax.b", Amo, All),
+    BISCUIT_OPCODE(AMOMAXU_B, "amomaxu.b", Amo, All),
+    BISCUIT_OPCODE(AMOMIN_B, "amomin.b", Amo, All),
+    BISCUIT_OPCODE(AMOMINU_B, "amominu.b", Amo, All),
+    BISCUIT_OPCODE(AMOOR_B, "amoor.b", Amo, All),
+    BISCUIT_OPCODE(AMOSWAP_B, "amoswap.b", Amo, All),
+    BISCUIT_OPCODE(AMOXOR_B, "amoxor.b", Amo, All),
+    BISCUIT_OPCODE(AMOCAS_B, "amocas.b", Amo, All),
+    BISCUIT_OPCODE(AMOADD_H, "amoadd.h", Amo, All),
+    BISCUIT_OPCODE(AMOAND_H, "amoand.h", Amo, All),
+    BISCUIT_OPCODE(AMOMAX_H, "amomax.h", Amo, All),
+    BISCUIT_OPCODE(AMOMAXU_H, "amomaxu.h", Amo, All),
+    BISCUIT_OPCODE(AMOMIN_H, "amomin.h", Amo, All),
+    BISCUIT_OPCODE(AMOMINU_H, "amominu.h", Amo, All),
+    BISCUIT_OPCODE(AMOOR_H, "amoor.h", Amo, All),
+    BISCUIT_OPCODE(AMOSWAP_H, "amoswap.h", Amo, All),
+    BISCUIT_OPCODE(AMOXOR_H, "amoxor.h", Amo, All),
+    BISCUIT_OPCODE(AMOCAS_H, "amocas.h", Amo, All),
+
+    // Zicond Extension Instructions
+    BISCUIT_OPCODE(CZERO_EQZ, "czero.eqz", R, All),
+    BISCUIT_OPCODE(CZERO_NEZ, "czero.nez", R, All),
+
+    // Zalasr Extension Instructions
+    BISCUIT_OVERLOAD(LB_AQ, LB, "lb", LoadReserved, All, Ordering, GPR, GPR),
+    BISCUIT_OVERLOAD(LH_AQ, LH, "lh", LoadReserved, All, Ordering, GPR, GPR),
+    BISCUIT_OVERLOAD(LW_AQ, LW, "lw", LoadReserved, All, Ordering, GPR, GPR),
+    BISCUIT_OVERLOAD(LD_AQ, LD, "ld", LoadReserved, RV64, Ordering, GPR, GPR),
+    BISCUIT_OVERLOAD(SB_RL, SB, "sb", StoreRelease, All, Ordering, GPR, GPR),
+    BISCUIT_OVERLOAD(SH_RL, SH, "sh", StoreRelease, All, Ordering, GPR, GPR),
+    BISCUIT_OVERLOAD(SW_RL, SW, "sw", StoreRelease, All, Ordering, GPR, GPR),
+    BISCUIT_OVERLOAD(SD_RL, SD, "sd", StoreRelease, RV64, Ordering, GPR, GPR),
+
+    // XTheadCondMov Extension Instructions
+    BISCUIT_OPCODE(TH_MVEQZ, "th.mveqz", R, All),
+    BISCUIT_OPCODE(TH_MVNEZ, "th.mvnez", R, All),
+
+    // XTheadBa Extension Instructions
+    BISCUIT_OPCODE(TH_ADDSL, "th.addsl", RShiftAdd, All),
+
+    // Zicsr Extension Instructions
+    BISCUIT_OPCODE(CSRRC, "csrrc", Csr, All),
+    BISCUIT_OPCODE(CSRRCI, "csrrci", CsrImm, All),
+    BISCUIT_OPCODE(CSRRS, "csrrs", Csr, All),
+    BISCUIT_OPCODE(CSRRSI, "csrrsi", CsrImm, All),
+    BISCUIT_OPCODE(CSRRW, "csrrw", Csr, All),
+    BISCUIT_OPCODE(CSRRWI, "csrrwi", CsrImm, All),
+
+    // Zihintntl Extension Instructions
+    BISCUIT_OPCODE(C_NTL_ALL, "c.ntl.all", CNone, All),
+    BISCUIT_OPCODE(C_NTL_S1, "c.ntl.s1", CNone, All),
+    BISCUIT_OPCODE(C_NTL_P1, "c.ntl.p1", CNone, All),
+    BISCUIT_OPCODE(C_NTL_PALL, "c.ntl.pall", CNone, All),
+    BISCUIT_OPCODE(NTL_ALL, "ntl.all", None, All),
+    BISCUIT_OPCODE(NTL_S1, "ntl.s1", None, All),
+    BISCUIT_OPCODE(NTL_P1, "ntl.p1", None, All),
+    BISCUIT_OPCODE(NTL_PALL, "ntl.pall", None, All),
+
+    // RV32M Extension Instructions
+    BISCUIT_OPCODE(DIV, "div", R, All),
+    BISCUIT_OPCODE(DIVU, "divu", R, All),
+    BISCUIT_OPCODE(MUL, "mul", R, All),
+    BISCUIT_OPCODE(MULH, "mulh", R, All),
+    BISCUIT_OPCODE(MULHSU, "mulhsu", R, All),
+    BISCUIT_OPCODE(MULHU, "mulhu", R, All),
+    BISCUIT_OPCODE(REM, "rem", R, All),
+    BISCUIT_OPCODE(REMU, "remu", R, All),
+
+    // RV64M Extension Instructions
+    BISCUIT_OPCODE(DIVW, "divw", R, All),
+    BISCUIT_OPCODE(DIVUW, "divuw", R, All),
+    BISCUIT_OPCODE(MULW, "mulw", R, All),
+    BISCUIT_OPCODE(REMW, "remw", R, All),
+    BISCUIT_OPCODE(REMUW, "remuw", R, All),
+
+    // RV32A Extension Instructions
+    BISCUIT_OPCODE(AMOADD_W, "amoadd.w", Amo, All),
+    BISCUIT_OPCODE(AMOAND_W, "amoand.w", Amo, All),
+    BISCUIT_OPCODE(AMOMAX_W, "amomax.w", Amo, All),
+    BISCUIT_OPCODE(AMOMAXU_W, "amomaxu.w", Amo, All),
+    BISCUIT_OPCODE(AMOMIN_W, "amomin.w", Amo, All),
+    BISCUIT_OPCODE(AMOMINU_W, "amominu.w", Amo, All),
+    BISCUIT_OPCODE(AMOOR_W, "amoor.w", Amo, All),
+    BISCUIT_OPCODE(AMOSWAP_W, "amoswap.w", Amo, All),
+    BISCUIT_OPCODE(AMOXOR_W, "amoxor.w", Amo, All),
+    BISCUIT_OPCODE(LR_W, "lr.w", LoadReserved, All),
+    BISCUIT_OPCODE(SC_W, "sc.w", Amo, All),
+
+    // RV64A Extension Instructions
+    BISCUIT_OPCODE(AMOADD_D, "amoadd.d", Amo, RV64),
+    BISCUIT_OPCODE(AMOAND_D, "amoand.d", Amo, RV64),
+    BISCUIT_OPCODE(AMOMAX_D, "amomax.d", Amo, RV64),
+    BISCUIT_OPCODE(AMOMAXU_D, "amomaxu.d", Amo, RV64),
+    BISCUIT_OPCODE(AMOMIN_D, "amomin.d", Amo, RV64),
+    BISCUIT_OPCODE(AMOMINU_D, "amominu.d", Amo, RV64),
+    BISCUIT_OPCODE(AMOOR_D, "amoor.d", Amo, RV64),
+    BISCUIT_OPCODE(AMOSWAP_D, "amoswap.d", Amo, RV64),
+    BISCUIT_OPCODE(AMOXOR_D, "amoxor.d", Amo, RV64),
+    BISCUIT_OPCODE(LR_D, "lr.d", LoadReserved, RV64),
+    BISCUIT_OPCODE(SC_D, "sc.d", Amo, RV64),
+
+    // RV32F Extension Instructions
+    BISCUIT_OPCODE(FADD_S, "fadd.s", FRRm, All),
+    BISCUIT_OPCODE(FCLASS_S, "fclass.s", FToX, All),
+    BISCUIT_OPCODE(FCVT_S_W, "fcvt.s.w", XToFRm, All),
+    BISCUIT_OPCODE(FCVT_S_WU, "fcvt.s.wu", XToFRm, All),
+    BISCUIT_OPCODE(FCVT_W_S, "fcvt.w.s", FToXRm, All),
+    BISCUIT_OPCODE(FCVT_WU_S, "fcvt.wu.s", FToXRm, All),
+    BISCUIT_OPCODE(FDIV_S, "fdiv.s", FRRm, All),
+    BISCUIT_OPCODE(FEQ_S, "feq.s", FCompare, All),
+    BISCUIT_OPCODE(FLE_S, "fle.s", FCompare, All),
+    BISCUIT_OPCODE(FLT_S, "flt.s", FCompare, All),
+    BISCUIT_OPCODE(FLW, "flw", FLoad, All),
+    BISCUIT_OPCODE(FMADD_S, "fmadd.s", FR4, All),
+    BISCUIT_OPCODE(FMAX_S, "fmax.s", FR, All),
+    BISCUIT_OPCODE(FMIN_S, "fmin.s", FR, All),
+    BISCUIT_OPCODE(FMSUB_S, "fmsub.s", FR4, All),
+    BISCUIT_OPCODE(FMUL_S, "fmul.s", FRRm, All),
+    BISCUIT_OPCODE(FMV_W_X, "fmv.w.x", XToF, All),
+    BISCUIT_OPCODE(FMV_X_W, "fmv.x.w", FToX, All),
+    BISCUIT_OPCODE(FNMADD_S, "fnmadd.s", FR4, All),
+    BISCUIT_OPCODE(FNMSUB_S, "fnmsub.s", FR4, All),
+    BISCUIT_OPCODE(FSGNJ_S, "fsgnj.s", FR, All),
+    BISCUIT_OPCODE(FSGNJN_S, "fsgnjn.s", FR, All),
+    BISCUIT_OPCODE(FSGNJX_S, "fsgnjx.s", FR, All),
+    BISCUIT_OPCODE(FSQRT_S, "fsqrt.s", FUnaryRm, All),
+    BISCUIT_OPCODE(FSUB_S, "fsub.s", FRRm, All),
+    BISCUIT_OPCODE(FSW, "fsw", FStore, All),
+
+    // RV64F Extension Instructions
+    BISCUIT_OPCODE(FCVT_L_S, "fcvt.l.s", FToXRm, RV64),
+    BISCUIT_OPCODE(FCVT_LU_S, "fcvt.lu.s", FToXRm, RV64),
+    BISCUIT_OPCODE(FCVT_S_L, "fcvt.s.l", XToFRm, RV64),
+    BISCUIT_OPCODE(FCVT_S_LU, "fcvt.s.lu", XToFRm, RV64),
+
+    // RV32D Extension Instructions
+    BISCUIT_OPCODE(FADD_D, "fadd.d", FRRm, All),
+    BISCUIT_OPCODE(FCLASS_D, "fclass.d", FToX, All),
+    BISCUIT_OPCODE(FCVT_D_W, "fcvt.d.w", XToFRm, All),
+    BISCUIT_OPCODE(FCVT_D_WU, "fcvt.d.wu", XToFRm, All),
+    BISCUIT_OPCODE(FCVT_W_D, "fcvt.w.d", FToXRm, All),
+    BISCUIT_OPCODE(FCVT_WU_D, "fcvt.wu.d", FToXRm, All),
+    BISCUIT_OPCODE(FCVT_D_S, "fcvt.d.s", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVT_S_D, "fcvt.s.d", FUnaryRm, All),
+    BISCUIT_OPCODE(FDIV_D, "fdiv.d", FRRm, All),
+    BISCUIT_OPCODE(FEQ_D, "feq.d", FCompare, All),
+    BISCUIT_OPCODE(FLE_D, "fle.d", FCompare, All),
+    BISCUIT_OPCODE(FLT_D, "flt.d", FCompare, All),
+    BISCUIT_OPCODE(FLD, "fld", FLoad, All),
+    BISCUIT_OPCODE(FMADD_D, "fmadd.d", FR4, All),
+    BISCUIT_OPCODE(FMAX_D, "fmax.d", FR, All),
+    BISCUIT_OPCODE(FMIN_D, "fmin.d", FR, All),
+    BISCUIT_OPCODE(FMSUB_D, "fmsub.d", FR4, All),
+    BISCUIT_OPCODE(FMUL_D, "fmul.d", FRRm, All),
+    BISCUIT_OPCODE(FNMADD_D, "fnmadd.d", FR4, All),
+    BISCUIT_OPCODE(FNMSUB_D, "fnmsub.d", FR4, All),
+    BISCUIT_OPCODE(FSGNJ_D, "fsgnj.d", FR, All),
+    BISCUIT_OPCODE(FSGNJN_D, "fsgnjn.d", FR, All),
+    BISCUIT_OPCODE(FSGNJX_D, "fsgnjx.d", FR, All),
+    BISCUIT_OPCODE(FSQRT_D, "fsqrt.d", FUnaryRm, All),
+    BISCUIT_OPCODE(FSUB_D, "fsub.d", FRRm, All),
+    BISCUIT_OPCODE(FSD, "fsd", FStore, All),
+
+    // RV64D Extension Instructions
+    BISCUIT_OPCODE(FCVT_L_D, "fcvt.l.d", FToXRm, RV64),
+    BISCUIT_OPCODE(FCVT_LU_D, "fcvt.lu.d", FToXRm, RV64),
+    BISCUIT_OPCODE(FCVT_D_L, "fcvt.d.l", XToFRm, RV64),
+    BISCUIT_OPCODE(FCVT_D_LU, "fcvt.d.lu", XToFRm, RV64),
+    BISCUIT_OPCODE(FMV_D_X, "fmv.d.x", XToF, RV64_128),
+    BISCUIT_OPCODE(FMV_X_D, "fmv.x.d", FToX, RV64_128),
+
+    // RV32Q Extension Instructions
+    BISCUIT_OPCODE(FADD_Q, "fadd.q", FRRm, All),
+    BISCUIT_OPCODE(FCLASS_Q, "fclass.q", FToX, All),
+    BISCUIT_OPCODE(FCVT_Q_W, "fcvt.q.w", XToFRm, All),
+    BISCUIT_OPCODE(FCVT_Q_WU, "fcvt.q.wu", XToFRm, All),
+    BISCUIT_OPCODE(FCVT_W_Q, "fcvt.w.q", FToXRm, All),
+    BISCUIT_OPCODE(FCVT_WU_Q, "fcvt.wu.q", FToXRm, All),
+    BISCUIT_OPCODE(FCVT_Q_D, "fcvt.q.d", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVT_D_Q, "fcvt.d.q", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVT_Q_S, "fcvt.q.s", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVT_S_Q, "fcvt.s.q", FUnaryRm, All),
+    BISCUIT_OPCODE(FDIV_Q, "fdiv.q", FRRm, All),
+    BISCUIT_OPCODE(FEQ_Q, "feq.q", FCompare, All),
+    BISCUIT_OPCODE(FLE_Q, "fle.q", FCompare, All),
+    BISCUIT_OPCODE(FLT_Q, "flt.q", FCompare, All),
+    BISCUIT_OPCODE(FLQ, "flq", FLoad, All),
+    BISCUIT_OPCODE(FMADD_Q, "fmadd.q", FR4, All),
+    BISCUIT_OPCODE(FMAX_Q, "fmax.q", FR, All),
+    BISCUIT_OPCODE(FMIN_Q, "fmin.q", FR, All),
+    BISCUIT_OPCODE(FMSUB_Q, "fmsub.q", FR4, All),
+    BISCUIT_OPCODE(FMUL_Q, "fmul.q", FRRm, All),
+    BISCUIT_OPCODE(FNMADD_Q, "fnmadd.q", FR4, All),
+    BISCUIT_OPCODE(FNMSUB_Q, "fnmsub.q", FR4, All),
+    BISCUIT_OPCODE(FSGNJ_Q, "fsgnj.q", FR, All),
+    BISCUIT_OPCODE(FSGNJN_Q, "fsgnjn.q", FR, All),
+    BISCUIT_OPCODE(FSGNJX_Q, "fsgnjx.q", FR, All),
+    BISCUIT_OPCODE(FSQRT_Q, "fsqrt.q", FUnaryRm, All),
+    BISCUIT_OPCODE(FSUB_Q, "fsub.q", FRRm, All),
+    BISCUIT_OPCODE(FSQ, "fsq", FStore, All),
+
+    // RV64Q Extension Instructions
+    BISCUIT_OPCODE(FCVT_L_Q, "fcvt.l.q", FToXRm, RV64),
+    BISCUIT_OPCODE(FCVT_LU_Q, "fcvt.lu.q", FToXRm, RV64),
+    BISCUIT_OPCODE(FCVT_Q_L, "fcvt.q.l", XToFRm, RV64),
+    BISCUIT_OPCODE(FCVT_Q_LU, "fcvt.q.lu", XToFRm, RV64),
+
+    // RV32Zfh Extension Instructions
+    BISCUIT_OPCODE(FADD_H, "fadd.h", FRRm, All),
+    BISCUIT_OPCODE(FCLASS_H, "fclass.h", FToX, All),
+    BISCUIT_OPCODE(FCVT_D_H, "fcvt.d.h", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVT_H_D, "fcvt.h.d", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVT_H_Q, "fcvt.h.q", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVT_H_S, "fcvt.h.s", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVT_H_W, "fcvt.h.w", XToFRm, All),
+    BISCUIT_OPCODE(FCVT_H_WU, "fcvt.h.wu", XToFRm, All),
+    BISCUIT_OPCODE(FCVT_Q_H, "fcvt.q.h", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVT_S_H, "fcvt.s.h", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVT_W_H, "fcvt.w.h", FToXRm, All),
+    BISCUIT_OPCODE(FCVT_WU_H, "fcvt.wu.h", FToXRm, All),
+    BISCUIT_OPCODE(FDIV_H, "fdiv.h", FRRm, All),
+    BISCUIT_OPCODE(FEQ_H, "feq.h", FCompare, All),
+    BISCUIT_OPCODE(FLE_H, "fle.h", FCompare, All),
+    BISCUIT_OPCODE(FLH, "flh", FLoad, All),
+    BISCUIT_OPCODE(FLT_H, "flt.h", FCompare, All),
+    BISCUIT_OPCODE(FMADD_H, "fmadd.h", FR4, All),
+    BISCUIT_OPCODE(FMAX_H, "fmax.h", FR, All),
+    BISCUIT_OPCODE(FMIN_H, "fmin.h", FR, All),
+    BISCUIT_OPCODE(FMSUB_H, "fmsub.h", FR4, All),
+    BISCUIT_OPCODE(FMUL_H, "fmul.h", FRRm, All),
+    BISCUIT_OPCODE(FMV_H_X, "fmv.h.x", XToF, All),
+    BISCUIT_OPCODE(FMV_X_H, "fmv.x.h", FToX, All),
+    BISCUIT_OPCODE(FNMADD_H, "fnmadd.h", FR4, All),
+    BISCUIT_OPCODE(FNMSUB_H, "fnmsub.h", FR4, All),
+    BISCUIT_OPCODE(FSGNJ_H, "fsgnj.h", FR, All),
+    BISCUIT_OPCODE(FSGNJN_H, "fsgnjn.h", FR, All),
+    BISCUIT_OPCODE(FSGNJX_H, "fsgnjx.h", FR, All),
+    BISCUIT_OPCODE(FSH, "fsh", FStore, All),
+    BISCUIT_OPCODE(FSQRT_H, "fsqrt.h", FUnaryRm, All),
+    BISCUIT_OPCODE(FSUB_H, "fsub.h", FRRm, All),
+
+    // RV64Zfh Extension Instructions
+    BISCUIT_OPCODE(FCVT_L_H, "fcvt.l.h", FToXRm, All),
+    BISCUIT_OPCODE(FCVT_LU_H, "fcvt.lu.h", FToXRm, All),
+    BISCUIT_OPCODE(FCVT_H_L, "fcvt.h.l", XToFRm, All),
+    BISCUIT_OPCODE(FCVT_H_LU, "fcvt.h.lu", XToFRm, All),
+
+    // Zfa Extension Instructions
+    BISCUIT_OPCODE(FLI_D, "fli.d", FLoadImm, All),
+    BISCUIT_OPCODE(FLI_H, "fli.h", FLoadImm, All),
+    BISCUIT_OPCODE(FLI_S, "fli.s", FLoadImm, All),
+    BISCUIT_OPCODE(FMINM_D, "fminm.d", FR, All),
+    BISCUIT_OPCODE(FMINM_H, "fminm.h", FR, All),
+    BISCUIT_OPCODE(FMINM_Q, "fminm.q", FR, All),
+    BISCUIT_OPCODE(FMINM_S, "fminm.s", FR, All),
+    BISCUIT_OPCODE(FMAXM_D, "fmaxm.d", FR, All),
+    BISCUIT_OPCODE(FMAXM_H, "fmaxm.h", FR, All),
+    BISCUIT_OPCODE(FMAXM_Q, "fmaxm.q", FR, All),
+    BISCUIT_OPCODE(FMAXM_S, "fmaxm.s", FR, All),
+    BISCUIT_OPCODE(FROUND_D, "fround.d", FUnaryRm, All),
+    BISCUIT_OPCODE(FROUND_H, "fround.h", FUnaryRm, All),
+    BISCUIT_OPCODE(FROUND_Q, "fround.q", FUnaryRm, All),
+    BISCUIT_OPCODE(FROUND_S, "fround.s", FUnaryRm, All),
+    BISCUIT_OPCODE(FROUNDNX_D, "froundnx.d", FUnaryRm, All),
+    BISCUIT_OPCODE(FROUNDNX_H, "froundnx.h", FUnaryRm, All),
+    BISCUIT_OPCODE(FROUNDNX_Q, "froundnx.q", FUnaryRm, All),
+    BISCUIT_OPCODE(FROUNDNX_S, "froundnx.s", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVTMOD_W_D, "fcvtmod.w.d", FToX, All),
+    BISCUIT_OPCODE(FMVH_X_D, "fmvh.x.d", FToX, All),
+    BISCUIT_OPCODE(FMVH_X_Q, "fmvh.x.q", FToX, All),
+    BISCUIT_OPCODE(FMVP_D_X, "fmvp.d.x", FMovePair, All),
+    BISCUIT_OPCODE(FMVP_Q_X, "fmvp.q.x", FMovePair, All),
+    BISCUIT_OPCODE(FLEQ_D, "fleq.d", FCompare, All),
+    BISCUIT_OPCODE(FLTQ_D, "fltq.d", FCompare, All),
+    BISCUIT_OPCODE(FLEQ_H, "fleq.h", FCompare, All),
+    BISCUIT_OPCODE(FLTQ_H, "fltq.h", FCompare, All),
+    BISCUIT_OPCODE(FLEQ_Q, "fleq.q", FCompare, All),
+    BISCUIT_OPCODE(FLTQ_Q, "fltq.q", FCompare, All),
+    BISCUIT_OPCODE(FLEQ_S, "fleq.s", FCompare, All),
+    BISCUIT_OPCODE(FLTQ_S, "fltq.s", FCompare, All),
+
+    // Zfbfmin Extension Instructions
+    BISCUIT_OPCODE(FCVT_BF16_S, "fcvt.bf16.s", FUnaryRm, All),
+    BISCUIT_OPCODE(FCVT_S_BF16, "fcvt.s.bf16", FUnaryRm, All),
+    BISCUIT_OPCODE(ADDUW, "add.uw", R, RV64),
+    BISCUIT_OPCODE(ANDN, "andn", R, All),
+    BISCUIT_OPCODE(BCLR, "bclr", R, All),
+    BISCUIT_OPCODE(BCLRI, "bclri", Shift, All),
+    BISCUIT_OPCODE(BEXT, "bext", R, All),
+    BISCUIT_OPCODE(BEXTI, "bexti", Shift, All),
+    BISCUIT_OPCODE(BINV, "binv", R, All),
+    BISCUIT_OPCODE(BINVI, "binvi", Shift, All),
+    BISCUIT_OPCODE(BREV8, "brev8", RUnary, All),
+    BISCUIT_OPCODE(BSET, "bset", R, All),
+    BISCUIT_OPCODE(BSETI, "bseti", Shift, All),
+    BISCUIT_OPCODE(CLMUL, "clmul", R, All),
+    BISCUIT_OPCODE(CLMULH, "clmulh", R, All),
+    BISCUIT_OPCODE(CLMULR, "clmulr", R, All),
+    BISCUIT_OPCODE(CLZ, "clz", RUnary, All),
+    BISCUIT_OPCODE(CLZW, "clzw", RUnary, RV64),
+    BISCUIT_OPCODE(CPOP, "cpop", RUnary, All),
+    BISCUIT_OPCODE(CPOPW, "cpopw", RUnary, RV64),
+    BISCUIT_OPCODE(CTZ, "ctz", RUnary, All),
+    BISCUIT_OPCODE(CTZW, "ctzw", RUnary, RV64),
+    BISCUIT_OPCODE(MAX, "max", R, All),
+    BISCUIT_OPCODE(MAXU, "maxu", R, All),
+    BISCUIT_OPCODE(MIN, "min", R, All),
+    BISCUIT_OPCODE(MINU, "minu", R, All),
+    BISCUIT_OPCODE(ORCB, "orc.b", RUnary, All),
+    BISCUIT_OPCODE(ORN, "orn", R, All),
+    BISCUIT_OPCODE(PACK, "pack", R, All),
+    BISCUIT_OPCODE(PACKH, "packh", R, All),
+    BISCUIT_OPCODE(PACKW, "packw", R, RV64),
+    BISCUIT_OPCODE(REV8, "rev8", RUnary, All),
+    BISCUIT_OPCODE(ROL, "rol", R, All),
+    BISCUIT_OPCODE(ROLW, "rolw", R, RV64),
+    BISCUIT_OPCODE(ROR, "ror", R, All),
+    BISCUIT_OPCODE(RORI, "rori", Shift, All),
+    BISCUIT_OPCODE(RORIW, "roriw", ShiftW, RV64),
+    BISCUIT_OPCODE(RORW, "rorw", R, RV64),
+    BISCUIT_OPCODE(SEXTB, "sext.b", RUnary, All),
+    BISCUIT_OPCODE(SEXTH, "sext.h", RUnary, All),
+    BISCUIT_OPCODE(SH1ADD, "sh1add", R, All),
+    BISCUIT_OPCODE(SH1ADDUW, "sh1add.uw", R, RV64),
+    BISCUIT_OPCODE(SH2ADD, "sh2add", R, All),
+    BISCUIT_OPCODE(SH2ADDUW, "sh2add.uw", R, RV64),
+    BISCUIT_OPCODE(SH3ADD, "sh3add", R, All),
+    BISCUIT_OPCODE(SH3ADDUW, "sh3add.uw", R, RV64),
+    BISCUIT_OPCODE(SLLIUW, "slli.uw", Shift, RV64),
+    BISCUIT_OPCODE(UNZIP, "unzip", RUnary, RV32),
+    BISCUIT_OPCODE(XNOR, "xnor", R, All),
+    BISCUIT_OPCODE(XPERM4, "xperm4", R, All),
+    BISCUIT_OPCODE(XPERM8, "xperm8", R, All),
+    BISCUIT_OPCODE(ZEXTH, "zext.h", RUnary, All),
+    BISCUIT_OPCODE(ZIP, "zip", RUnary, RV32),
+
+    // Scalar Cryptography (RVK) instructions
+    BISCUIT_OPCODE(AES32DSI, "aes32dsi", RByteSelect, RV32),
+    BISCUIT_OPCODE(AES32DSMI, "aes32dsmi", RByteSelect, RV32),
+    BISCUIT_OPCODE(AES32ESI, "aes32esi", RByteSelect, RV32),
+    BISCUIT_OPCODE(AES32ESMI, "aes32esmi", RByteSelect, RV32),
+    BISCUIT_OPCODE(AES64DS, "aes64ds", R, RV64),
+    BISCUIT_OPCODE(AES64DSM, "aes64dsm", R, RV64),
+    BISCUIT_OPCODE(AES64ES, "aes64es", R, RV64),
+    BISCUIT_OPCODE(AES64ESM, "aes64esm", R, RV64),
+    BISCUIT_OPCODE(AES64IM, "aes64im", RUnary, RV64),
+    BISCUIT_OPCODE(AES64KS1I, "aes64ks1i", RRoundNum, RV64),
+    BISCUIT_OPCODE(AES64KS2, "aes64ks2", R, RV64),
+    BISCUIT_OPCODE(SHA256SIG0, "sha256sig0", RUnary, All),
+    BISCUIT_OPCODE(SHA256SIG1, "sha256sig1", RUnary, All),
+    BISCUIT_OPCODE(SHA256SUM0, "sha256sum0", RUnary, All),
+    BISCUIT_OPCODE(SHA256SUM1, "sha256sum1", RUnary, All),
+    BISCUIT_OPCODE(SHA512SIG0, "sha512sig0", RUnary, RV64),
+    BISCUIT_OPCODE(SHA512SIG0H, "sha512sig0h", R, RV32),
+    BISCUIT_OPCODE(SHA512SIG0L, "sha512sig0l", R, RV32),
+    BISCUIT_OPCODE(SHA512SIG1, "sha512sig1", RUnary, RV64),
+    BISCUIT_OPCODE(SHA512SIG1H, "sha512sig1h", R, RV32),
+    BISCUIT_OPCODE(SHA512SIG1L, "sha512sig1l", R, RV32),
+    BISCUIT_OPCODE(SHA512SUM0, "sha512sum0", RUnary, RV64),
+    BISCUIT_OPCODE(SHA512SUM0R, "sha512sum0r", R, RV32),
+    BISCUIT_OPCODE(SHA512SUM1, "sha512sum1", RUnary, RV64),
+    BISCUIT_OPCODE(SHA512SUM1R, "sha512sum1r", R, RV32),
+    BISCUIT_OPCODE(SM3P0, "sm3p0", RUnary, All),
+    BISCUIT_OPCODE(SM3P1, "sm3p1", RUnary, All),
+    BISCUIT_OPCODE(SM4ED, "sm4ed", RByteSelect, All),
+    BISCUIT_OPCODE(SM4KS, "sm4ks", RByteSelect, All),
+
+    // RVC Extension Instructions
+    BISCUIT_OPCODE(C_ADD, "c.add", CR, All),
+    BISCUIT_OPCODE(C_ADDI, "c.addi", CAddi, All),
+    BISCUIT_OPCODE(C_ADDIW, "c.addiw", CI, RV64_128),
+    BISCUIT_OPCODE(C_ADDI4SPN, "c.addi4spn", CAddi4spn, All),
+    BISCUIT_OPCODE(C_ADDI16SP, "c.addi16sp", CAddi16sp, All),
+    BISCUIT_OPCODE(C_ADDW, "c.addw", CA, RV64_128),
+    BISCUIT_OPCODE(C_AND, "c.and", CA, All),
+    BISCUIT_OPCODE(C_ANDI, "c.andi", CAndi, All),
+    BISCUIT_OVERLOAD(C_BEQZ, C_BEQZ, "c.beqz", CBranch, All, GPR, int32_t),
+    BISCUIT_OVERLOAD(C_BNEZ, C_BNEZ, "c.bnez", CBranch, All, GPR, int32_t),
+    BISCUIT_OPCODE(C_EBREAK, "c.ebreak", CNone, All),
+    BISCUIT_OPCODE(C_FLD, "c.fld", CFMemD, RV32_64),
+    BISCUIT_OPCODE(C_FLDSP, "c.fldsp", CFldsp, RV32_64),
+    BISCUIT_OPCODE(C_FLW, "c.flw", CFMemW, RV32),
+    BISCUIT_OPCODE(C_FLWSP, "c.flwsp", CFlwsp, RV32),
+    BISCUIT_OPCODE(C_FSD, "c.fsd", CFMemD, RV32_64),
+    BISCUIT_OPCODE(C_FSDSP, "c.fsdsp", CFsdsp, RV32_64),
+    BISCUIT_OPCODE(C_FSW, "c.fsw", CFMemW, RV32),
+    BISCUIT_OPCODE(C_FSWSP, "c.fswsp", CFswsp, RV32),
+    BISCUIT_OVERLOAD(C_J, C_J, "c.j", CJump, All, int32_t),
+    BISCUIT_OVERLOAD(C_JAL, C_JAL, "c.jal", CJump, RV32, int32_t),
+    BISCUIT_OPCODE(C_JALR, "c.jalr", CJumpReg, All),
+    BISCUIT_OPCODE(C_JR, "c.jr", CJumpReg, All),
+    BISCUIT_OPCODE(C_LD, "c.ld", CMemD, RV64_128),
+    BISCUIT_OPCODE(C_LDSP, "c.ldsp", CLdsp, RV64_128),
+    BISCUIT_OPCODE(C_LI, "c.li", CI, All),
+    BISCUIT_OPCODE(C_LQ, "c.lq", CMemQ, RV128),
+    BISCUIT_OPCODE(C_LQSP, "c.lqsp", CLqsp, RV128),
+    BISCUIT_OPCODE(C_LUI, "c.lui", CLui, All),
+    BISCUIT_OPCODE(C_LW, "c.lw", CMemW, All),
+    BISCUIT_OPCODE(C_LWSP, "c.lwsp", CLwsp, All),
+    BISCUIT_OPCODE(C_MV, "c.mv", CMove, All),
+    BISCUIT_OPCODE(C_NOP, "c.nop", CNone, All),
+    BISCUIT_OPCODE(C_OR, "c.or", CA, All),
+    BISCUIT_OPCODE(C_SD, "c.sd", CMemD, RV64_128),
+    BISCUIT_OPCODE(C_SDSP, "c.sdsp", CSdsp, RV64_128),
+    BISCUIT_OPCODE(C_SLLI, "c.slli", CShift, All),
+    BISCUIT_OPCODE(C_SQ, "c.sq", CMemQ, RV128),
+    BISCUIT_OPCODE(C_SQSP, "c.sqsp", CSqsp, RV128),
+    BISCUIT_OPCODE(C_SRAI, "c.srai", CShiftB, All),
+    BISCUIT_OPCODE(C_SRLI, "c.srli", CShiftB, All),
+    BISCUIT_OPCODE(C_SUB, "c.sub", CA, All),
+    BISCUIT_OPCODE(C_SUBW, "c.subw", CA, RV64_128),
+    BISCUIT_OPCODE(C_SW, "c.sw", CMemW, All),
+    BISCUIT_OPCODE(C_SWSP, "c.swsp", CSwsp, All),
+    BISCUIT_OPCODE(C_UNDEF, "c.undef", CNone, All),
+    BISCUIT_OPCODE(C_XOR, "c.xor", CA, All),
+
+    // Zc Extension Instructions
+    BISCUIT_OPCODE(C_LBU, "c.lbu", CMemB, All),
+    BISCUIT_OPCODE(C_LH, "c.lh", CMemH, All),
+    BISCUIT_OPCODE(C_LHU, "c.lhu", CMemH, All),
+    BISCUIT_OPCODE(C_SB, "c.sb", CMemB, All),
+    BISCUIT_OPCODE(C_SH, "c.sh", CMemH, All),
+    BISCUIT_OPCODE(C_SEXT_B, "c.sext.b", CUnary, All),
+    BISCUIT_OPCODE(C_SEXT_H, "c.sext.h", CUnary, All),
+    BISCUIT_OPCODE(C_ZEXT_B, "c.zext.b", CUnary, All),
+    BISCUIT_OPCODE(C_ZEXT_H, "c.zext.h", CUnary, All),
+    BISCUIT_OPCODE(C_ZEXT_W, "c.zext.w", CUnary, RV64),
+    BISCUIT_OPCODE(C_MUL, "c.mul", CA, All),
+    BISCUIT_OPCODE(C_NOT, "c.not", CUnary, All),
+    BISCUIT_OPCODE(CM_MVA01S, "cm.mva01s", CMMove, RV32_64),
+    BISCUIT_OPCODE(CM_MVSA01, "cm.mvsa01", CMMove, RV32_64),
+    BISCUIT_OPCODE(CM_POP, "cm.pop", CMPop, RV32_64),
+    BISCUIT_OPCODE(CM_POPRET, "cm.popret", CMPop, RV32_64),
+    BISCUIT_OPCODE(CM_POPRETZ, "cm.popretz", CMPop, RV32_64),
+    BISCUIT_OPCODE(CM_PUSH, "cm.push", CMPush, RV32_64),
+    BISCUIT_OPCODE(CM_JALT, "cm.jalt", CMJumpTableLink, RV32_64),
+    BISCUIT_OPCODE(CM_JT, "cm.jt", CMJumpTable, RV32_64),
+
+    // Cache Management Operation Extension Instructions
+    BISCUIT_OPCODE(CBO_CLEAN, "cbo.clean", CacheBlock, All),
+    BISCUIT_OPCODE(CBO_FLUSH, "cbo.flush", CacheBlock, All),
+    BISCUIT_OPCODE(CBO_INVAL, "cbo.inval", CacheBlock, All),
+    BISCUIT_OPCODE(CBO_ZERO, "cbo.zero", CacheBlock, All),
+    BISCUIT_OPCODE(PREFETCH_I, "prefetch.i", Prefetch, All),
+    BISCUIT_OPCODE(PREFETCH_R, "prefetch.r", Prefetch, All),
+    BISCUIT_OPCODE(PREFETCH_W, "prefetch.w", Prefetch, All),
+    BISCUIT_OPCODE(SSAMOSWAP_D, "ssamoswap.d", Amo, RV64),
+    BISCUIT_OPCODE(SSAMOSWAP_W, "ssamoswap.w", Amo, All),
+    BISCUIT_OPCODE(SSRDP, "ssrdp", SSReadPointer, All),
+    BISCUIT_OPCODE(SSPOPCHK, "sspopchk", SSPopChk, All),
+    BISCUIT_OPCODE(SSPUSH, "sspush", SSPush, All),
+    BISCUIT_OPCODE(C_SSPOPCHK, "c.sspopchk", CNone, All),
+    BISCUIT_OPCODE(C_SSPUSH, "c.sspush", CNone, All),
+    BISCUIT_OPCODE(LPAD, "lpad", Lpad, All),
+
+    // Privileged Instructions
+    BISCUIT_OPCODE(HFENCE_GVMA, "hfence.gvma", RFence, All),
+    BISCUIT_OPCODE(HFENCE_VVMA, "hfence.vvma", RFence, All),
+    BISCUIT_OPCODE(HINVAL_GVMA, "hinval.gvma", RFence, All),
+    BISCUIT_OPCODE(HINVAL_VVMA, "hinval.vvma", RFence, All),
+    BISCUIT_OPCODE(HLV_B, "hlv.b", HypervisorLoad, All),
+    BISCUIT_OPCODE(HLV_BU, "hlv.bu", HypervisorLoad, All),
+    BISCUIT_OPCODE(HLV_D, "hlv.d", HypervisorLoad, RV64),
+    BISCUIT_OPCODE(HLV_H, "hlv.h", HypervisorLoad, All),
+    BISCUIT_OPCODE(HLV_HU, "hlv.hu", HypervisorLoad, All),
+    BISCUIT_OPCODE(HLV_W, "hlv.w", HypervisorLoad, All),
+    BISCUIT_OPCODE(HLV_WU, "hlv.wu", HypervisorLoad, RV64),
+    BISCUIT_OPCODE(HLVX_HU, "hlvx.hu", HypervisorLoad, All),
+    BISCUIT_OPCODE(HLVX_WU, "hlvx.wu", HypervisorLoad, All),
+    BISCUIT_OPCODE(HSV_B, "hsv.b", HypervisorStore, All),
+    BISCUIT_OPCODE(HSV_D, "hsv.d", HypervisorStore, RV64),
+    BISCUIT_OPCODE(HSV_H, "hsv.h", HypervisorStore, All),
+    BISCUIT_OPCODE(HSV_W, "hsv.w", HypervisorStore, All),
+    BISCUIT_OPCODE(MRET, "mret", None, All),
+    BISCUIT_OPCODE(SCTRCLR, "sctrclr", None, All),
+    BISCUIT_OPCODE(SFENCE_INVAL_IR, "sfence.inval.ir", None, All),
+    BISCUIT_OPCODE(SFENCE_VMA, "sfence.vma", RFence, All),
+    BISCUIT_OPCODE(SFENCE_W_INVAL, "sfence.w.inval", None, All),
+    BISCUIT_OPCODE(SINVAL_VMA, "sinval.vma", RFence, All),
+    BISCUIT_OPCODE(SRET, "sret", None, All),
+    BISCUIT_OPCODE(URET, "uret", None, All),
+    BISCUIT_OPCODE(WFI, "wfi", None, All),
+
+    // Vector Integer Instructions
+    BISCUIT_OVERLOAD(VAADD_VV, VAADD, "vaadd.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VAADD_VX, VAADD, "vaadd.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VAADDU_VV, VAADDU, "vaaddu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VAADDU_VX, VAADDU, "vaaddu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VADC_VVM, VADC, "vadc.vvm", VVNoMask, All, Vec, Vec, Vec),
+    BISCUIT_OVERLOAD(VADC_VXM, VADC, "vadc.vxm", VXNoMask, All, Vec, Vec, GPR),
+    BISCUIT_OVERLOAD(VADC_VIM, VADC, "vadc.vim", VINoMask, All, Vec, Vec, int32_t),
+    BISCUIT_OVERLOAD(VADD_VV, VADD, "vadd.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VADD_VX, VADD, "vadd.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VADD_VI, VADD, "vadd.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VAND_VV, VAND, "vand.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VAND_VX, VAND, "vand.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VAND_VI, VAND, "vand.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VASUB_VV, VASUB, "vasub.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VASUB_VX, VASUB, "vasub.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VASUBU_VV, VASUBU, "vasubu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VASUBU_VX, VASUBU, "vasubu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OPCODE(VCOMPRESS, "vcompress.vm", VVNoMask, All),
+    BISCUIT_OVERLOAD(VDIV_VV, VDIV, "vdiv.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VDIV_VX, VDIV, "vdiv.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VDIVU_VV, VDIVU, "vdivu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VDIVU_VX, VDIVU, "vdivu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OPCODE(VFIRST, "vfirst.m", VMaskToX, All),
+    BISCUIT_OPCODE(VID, "vid.v", VIndex, All),
+    BISCUIT_OPCODE(VIOTA, "viota.m", VUnary, All),
+    BISCUIT_OVERLOAD(VMACC_VV, VMACC, "vmacc.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMACC_VX, VMACC, "vmacc.vx", VXMultiplyAdd, All, Vec, GPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMADC_VV, VMADC, "vmadc.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMADC_VX, VMADC, "vmadc.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMADC_VI, VMADC, "vmadc.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VMADD_VV, VMADD, "vmadd.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMADD_VX, VMADD, "vmadd.vx", VXMultiplyAdd, All, Vec, GPR, Vec, VecMask),
+    BISCUIT_OPCODE(VMAND, "vmand.mm", VVNoMask, All),
+    BISCUIT_OPCODE(VMANDNOT, "vmandn.mm", VVNoMask, All),
+    BISCUIT_OPCODE(VMNAND, "vmnand.mm", VVNoMask, All),
+    BISCUIT_OPCODE(VMNOR, "vmnor.mm", VVNoMask, All),
+    BISCUIT_OPCODE(VMOR, "vmor.mm", VVNoMask, All),
+    BISCUIT_OPCODE(VMORNOT, "vmorn.mm", VVNoMask, All),
+    BISCUIT_OPCODE(VMXNOR, "vmxnor.mm", VVNoMask, All),
+    BISCUIT_OPCODE(VMXOR, "vmxor.mm", VVNoMask, All),
+    BISCUIT_OVERLOAD(VMAX_VV, VMAX, "vmax.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMAX_VX, VMAX, "vmax.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMAXU_VV, VMAXU, "vmaxu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMAXU_VX, VMAXU, "vmaxu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMERGE_VVM, VMERGE, "vmerge.vvm", VVNoMask, All, Vec, Vec, Vec),
+    BISCUIT_OVERLOAD(VMERGE_VXM, VMERGE, "vmerge.vxm", VXNoMask, All, Vec, Vec, GPR),
+    BISCUIT_OVERLOAD(VMERGE_VIM, VMERGE, "vmerge.vim", VINoMask, All, Vec, Vec, int32_t),
+    BISCUIT_OVERLOAD(VMIN_VV, VMIN, "vmin.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMIN_VX, VMIN, "vmin.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMINU_VV, VMINU, "vminu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMINU_VX, VMINU, "vminu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMSBC_VV, VMSBC, "vmsbc.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMSBC_VX, VMSBC, "vmsbc.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OPCODE(VMSBF, "vmsbf.m", VUnary, All),
+    BISCUIT_OPCODE(VMSIF, "vmsif.m", VUnary, All),
+    BISCUIT_OPCODE(VMSOF, "vmsof.m", VUnary, All),
+    BISCUIT_OVERLOAD(VMSEQ_VV, VMSEQ, "vmseq.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMSEQ_VX, VMSEQ, "vmseq.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMSEQ_VI, VMSEQ, "vmseq.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VMSGT_VX, VMSGT, "vmsgt.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMSGT_VI, VMSGT, "vmsgt.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VMSGTU_VX, VMSGTU, "vmsgtu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMSGTU_VI, VMSGTU, "vmsgtu.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VMSLE_VV, VMSLE, "vmsle.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMSLE_VX, VMSLE, "vmsle.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMSLE_VI, VMSLE, "vmsle.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VMSLEU_VV, VMSLEU, "vmsleu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMSLEU_VX, VMSLEU, "vmsleu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMSLEU_VI, VMSLEU, "vmsleu.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VMSLT_VV, VMSLT, "vmslt.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMSLT_VX, VMSLT, "vmslt.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMSLTU_VV, VMSLTU, "vmsltu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMSLTU_VX, VMSLTU, "vmsltu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMSNE_VV, VMSNE, "vmsne.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMSNE_VX, VMSNE, "vmsne.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMSNE_VI, VMSNE, "vmsne.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VMUL_VV, VMUL, "vmul.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMUL_VX, VMUL, "vmul.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMULH_VV, VMULH, "vmulh.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMULH_VX, VMULH, "vmulh.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMULHSU_VV, VMULHSU, "vmulhsu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMULHSU_VX, VMULHSU, "vmulhsu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMULHU_VV, VMULHU, "vmulhu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMULHU_VX, VMULHU, "vmulhu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VMV_VV, VMV, "vmv.v.v", VMoveV, All, Vec, Vec),
+    BISCUIT_OVERLOAD(VMV_VX, VMV, "vmv.v.x", VMoveX, All, Vec, GPR),
+    BISCUIT_OVERLOAD(VMV_VI, VMV, "vmv.v.i", VMoveI, All, Vec, int32_t),
+    BISCUIT_OPCODE(VMV1R, "vmv1r.v", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VMV2R, "vmv2r.v", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VMV4R, "vmv4r.v", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VMV8R, "vmv8r.v", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VMV_SX, "vmv.s.x", VMoveX, All),
+    BISCUIT_OPCODE(VMV_XS, "vmv.x.s", VMoveToX, All),
+    BISCUIT_OVERLOAD(VNCLIP_VV, VNCLIP, "vnclip.wv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VNCLIP_VX, VNCLIP, "vnclip.wx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VNCLIP_VI, VNCLIP, "vnclip.wi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VNCLIPU_VV, VNCLIPU, "vnclipu.wv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VNCLIPU_VX, VNCLIPU, "vnclipu.wx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VNCLIPU_VI, VNCLIPU, "vnclipu.wi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VNMSAC_VV, VNMSAC, "vnmsac.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VNMSAC_VX, VNMSAC, "vnmsac.vx", VXMultiplyAdd, All, Vec, GPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VNMSUB_VV, VNMSUB, "vnmsub.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VNMSUB_VX, VNMSUB, "vnmsub.vx", VXMultiplyAdd, All, Vec, GPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VNSRA_VV, VNSRA, "vnsra.wv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VNSRA_VX, VNSRA, "vnsra.wx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VNSRA_VI, VNSRA, "vnsra.wi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VNSRL_VV, VNSRL, "vnsrl.wv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VNSRL_VX, VNSRL, "vnsrl.wx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VNSRL_VI, VNSRL, "vnsrl.wi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VOR_VV, VOR, "vor.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VOR_VX, VOR, "vor.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VOR_VI, VOR, "vor.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OPCODE(VPOPC, "vcpop.m", VMaskToX, All),
+    BISCUIT_OPCODE(VREDAND, "vredand.vs", VV, All),
+    BISCUIT_OPCODE(VREDMAX, "vredmax.vs", VV, All),
+    BISCUIT_OPCODE(VREDMAXU, "vredmaxu.vs", VV, All),
+    BISCUIT_OPCODE(VREDMIN, "vredmin.vs", VV, All),
+    BISCUIT_OPCODE(VREDMINU, "vredminu.vs", VV, All),
+    BISCUIT_OPCODE(VREDOR, "vredor.vs", VV, All),
+    BISCUIT_OPCODE(VREDSUM, "vredsum.vs", VV, All),
+    BISCUIT_OPCODE(VREDXOR, "vredxor.vs", VV, All),
+    BISCUIT_OVERLOAD(VREM_VV, VREM, "vrem.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VREM_VX, VREM, "vrem.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VREMU_VV, VREMU, "vremu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VREMU_VX, VREMU, "vremu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VRGATHER_VV, VRGATHER, "vrgather.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VRGATHER_VX, VRGATHER, "vrgather.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VRGATHER_VI, VRGATHER, "vrgather.vi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OPCODE(VRGATHEREI16, "vrgatherei16.vv", VV, All),
+    BISCUIT_OVERLOAD(VRSUB_VX, VRSUB, "vrsub.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VRSUB_VI, VRSUB, "vrsub.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VSADD_VV, VSADD, "vsadd.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VSADD_VX, VSADD, "vsadd.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSADD_VI, VSADD, "vsadd.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VSADDU_VV, VSADDU, "vsaddu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VSADDU_VX, VSADDU, "vsaddu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSADDU_VI, VSADDU, "vsaddu.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OVERLOAD(VSBC_VVM, VSBC, "vsbc.vvm", VVNoMask, All, Vec, Vec, Vec),
+    BISCUIT_OVERLOAD(VSBC_VXM, VSBC, "vsbc.vxm", VXNoMask, All, Vec, Vec, GPR),
+    BISCUIT_OPCODE(VSEXTVF2, "vsext.vf2", VUnary, All),
+    BISCUIT_OPCODE(VSEXTVF4, "vsext.vf4", VUnary, All),
+    BISCUIT_OPCODE(VSEXTVF8, "vsext.vf8", VUnary, All),
+    BISCUIT_OPCODE(VSLIDE1DOWN, "vslide1down.vx", VX, All),
+    BISCUIT_OVERLOAD(VSLIDEDOWN_VX, VSLIDEDOWN, "vslidedown.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSLIDEDOWN_VI, VSLIDEDOWN, "vslidedown.vi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OPCODE(VSLIDE1UP, "vslide1up.vx", VX, All),
+    BISCUIT_OVERLOAD(VSLIDEUP_VX, VSLIDEUP, "vslideup.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSLIDEUP_VI, VSLIDEUP, "vslideup.vi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VSLL_VV, VSLL, "vsll.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VSLL_VX, VSLL, "vsll.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSLL_VI, VSLL, "vsll.vi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VSMUL_VV, VSMUL, "vsmul.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VSMUL_VX, VSMUL, "vsmul.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSRA_VV, VSRA, "vsra.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VSRA_VX, VSRA, "vsra.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSRA_VI, VSRA, "vsra.vi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VSRL_VV, VSRL, "vsrl.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VSRL_VX, VSRL, "vsrl.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSRL_VI, VSRL, "vsrl.vi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VSSRA_VV, VSSRA, "vssra.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VSSRA_VX, VSSRA, "vssra.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSSRA_VI, VSSRA, "vssra.vi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VSSRL_VV, VSSRL, "vssrl.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VSSRL_VX, VSSRL, "vssrl.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSSRL_VI, VSSRL, "vssrl.vi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VSSUB_VV, VSSUB, "vssub.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VSSUB_VX, VSSUB, "vssub.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSSUBU_VV, VSSUBU, "vssubu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VSSUBU_VX, VSSUBU, "vssubu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VSUB_VV, VSUB, "vsub.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VSUB_VX, VSUB, "vsub.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VWADD_VV, VWADD, "vwadd.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWADD_VX, VWADD, "vwadd.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VWADDW_VV, VWADDW, "vwadd.wv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWADDW_VX, VWADDW, "vwadd.wx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VWADDU_VV, VWADDU, "vwaddu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWADDU_VX, VWADDU, "vwaddu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VWADDUW_VV, VWADDUW, "vwaddu.wv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWADDUW_VX, VWADDUW, "vwaddu.wx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VWMACC_VV, VWMACC, "vwmacc.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWMACC_VX, VWMACC, "vwmacc.vx", VXMultiplyAdd, All, Vec, GPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWMACCSU_VV, VWMACCSU, "vwmaccsu.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWMACCSU_VX, VWMACCSU, "vwmaccsu.vx", VXMultiplyAdd, All, Vec, GPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWMACCU_VV, VWMACCU, "vwmaccu.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWMACCU_VX, VWMACCU, "vwmaccu.vx", VXMultiplyAdd, All, Vec, GPR, Vec, VecMask),
+    BISCUIT_OPCODE(VWMACCUS, "vwmaccus.vx", VXMultiplyAdd, All),
+    BISCUIT_OVERLOAD(VWMUL_VV, VWMUL, "vwmul.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWMUL_VX, VWMUL, "vwmul.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VWMULSU_VV, VWMULSU, "vwmulsu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWMULSU_VX, VWMULSU, "vwmulsu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VWMULU_VV, VWMULU, "vwmulu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWMULU_VX, VWMULU, "vwmulu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OPCODE(VWREDSUM, "vwredsum.vs", VV, All),
+    BISCUIT_OPCODE(VWREDSUMU, "vwredsumu.vs", VV, All),
+    BISCUIT_OVERLOAD(VWSUB_VV, VWSUB, "vwsub.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWSUB_VX, VWSUB, "vwsub.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VWSUBW_VV, VWSUBW, "vwsub.wv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWSUBW_VX, VWSUBW, "vwsub.wx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VWSUBU_VV, VWSUBU, "vwsubu.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWSUBU_VX, VWSUBU, "vwsubu.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VWSUBUW_VV, VWSUBUW, "vwsubu.wv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWSUBUW_VX, VWSUBUW, "vwsubu.wx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VXOR_VV, VXOR, "vxor.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VXOR_VX, VXOR, "vxor.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VXOR_VI, VXOR, "vxor.vi", VI, All, Vec, Vec, int32_t, VecMask),
+    BISCUIT_OPCODE(VZEXTVF2, "vzext.vf2", VUnary, All),
+    BISCUIT_OPCODE(VZEXTVF4, "vzext.vf4", VUnary, All),
+    BISCUIT_OPCODE(VZEXTVF8, "vzext.vf8", VUnary, All),
+
+    // Vector Floating-Point Instructions
+    BISCUIT_OVERLOAD(VFADD_VV, VFADD, "vfadd.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFADD_VF, VFADD, "vfadd.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OPCODE(VFCLASS, "vfclass.v", VUnary, All),
+    BISCUIT_OPCODE(VFCVT_F_X, "vfcvt.f.x.v", VUnary, All),
+    BISCUIT_OPCODE(VFCVT_F_XU, "vfcvt.f.xu.v", VUnary, All),
+    BISCUIT_OPCODE(VFCVT_RTZ_X_F, "vfcvt.rtz.x.f.v", VUnary, All),
+    BISCUIT_OPCODE(VFCVT_RTZ_XU_F, "vfcvt.rtz.xu.f.v", VUnary, All),
+    BISCUIT_OPCODE(VFCVT_X_F, "vfcvt.x.f.v", VUnary, All),
+    BISCUIT_OPCODE(VFCVT_XU_F, "vfcvt.xu.f.v", VUnary, All),
+    BISCUIT_OPCODE(VFNCVT_F_F, "vfncvt.f.f.w", VUnary, All),
+    BISCUIT_OPCODE(VFNCVT_F_X, "vfncvt.f.x.w", VUnary, All),
+    BISCUIT_OPCODE(VFNCVT_F_XU, "vfncvt.f.xu.w", VUnary, All),
+    BISCUIT_OPCODE(VFNCVT_ROD_F_F, "vfncvt.rod.f.f.w", VUnary, All),
+    BISCUIT_OPCODE(VFNCVT_RTZ_X_F, "vfncvt.rtz.x.f.w", VUnary, All),
+    BISCUIT_OPCODE(VFNCVT_RTZ_XU_F, "vfncvt.rtz.xu.f.w", VUnary, All),
+    BISCUIT_OPCODE(VFNCVT_X_F, "vfncvt.x.f.w", VUnary, All),
+    BISCUIT_OPCODE(VFNCVT_XU_F, "vfncvt.xu.f.w", VUnary, All),
+    BISCUIT_OPCODE(VFWCVT_F_F, "vfwcvt.f.f.v", VUnary, All),
+    BISCUIT_OPCODE(VFWCVT_F_X, "vfwcvt.f.x.v", VUnary, All),
+    BISCUIT_OPCODE(VFWCVT_F_XU, "vfwcvt.f.xu.v", VUnary, All),
+    BISCUIT_OPCODE(VFWCVT_RTZ_X_F, "vfwcvt.rtz.x.f.v", VUnary, All),
+    BISCUIT_OPCODE(VFWCVT_RTZ_XU_F, "vfwcvt.rtz.xu.f.v", VUnary, All),
+    BISCUIT_OPCODE(VFWCVT_X_F, "vfwcvt.x.f.v", VUnary, All),
+    BISCUIT_OPCODE(VFWCVT_XU_F, "vfwcvt.xu.f.v", VUnary, All),
+    BISCUIT_OVERLOAD(VFDIV_VV, VFDIV, "vfdiv.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFDIV_VF, VFDIV, "vfdiv.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OPCODE(VFRDIV, "vfrdiv.vf", VF, All),
+    BISCUIT_OPCODE(VFREDMAX, "vfredmax.vs", VV, All),
+    BISCUIT_OPCODE(VFREDMIN, "vfredmin.vs", VV, All),
+    BISCUIT_OPCODE(VFREDSUM, "vfredusum.vs", VV, All),
+    BISCUIT_OPCODE(VFREDOSUM, "vfredosum.vs", VV, All),
+    BISCUIT_OVERLOAD(VFMACC_VV, VFMACC, "vfmacc.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFMACC_VF, VFMACC, "vfmacc.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFMADD_VV, VFMADD, "vfmadd.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFMADD_VF, VFMADD, "vfmadd.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFMAX_VV, VFMAX, "vfmax.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFMAX_VF, VFMAX, "vfmax.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OPCODE(VFMERGE, "vfmerge.vfm", VFNoMask, All),
+    BISCUIT_OVERLOAD(VFMIN_VV, VFMIN, "vfmin.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFMIN_VF, VFMIN, "vfmin.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OVERLOAD(VFMSAC_VV, VFMSAC, "vfmsac.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFMSAC_VF, VFMSAC, "vfmsac.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFMSUB_VV, VFMSUB, "vfmsub.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFMSUB_VF, VFMSUB, "vfmsub.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFMUL_VV, VFMUL, "vfmul.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFMUL_VF, VFMUL, "vfmul.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OPCODE(VFMV, "vfmv.v.f", VMoveF, All),
+    BISCUIT_OPCODE(VFMV_FS, "vfmv.f.s", VMoveToF, All),
+    BISCUIT_OPCODE(VFMV_SF, "vfmv.s.f", VMoveF, All),
+    BISCUIT_OVERLOAD(VFNMACC_VV, VFNMACC, "vfnmacc.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFNMACC_VF, VFNMACC, "vfnmacc.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFNMADD_VV, VFNMADD, "vfnmadd.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFNMADD_VF, VFNMADD, "vfnmadd.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFNMSAC_VV, VFNMSAC, "vfnmsac.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFNMSAC_VF, VFNMSAC, "vfnmsac.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFNMSUB_VV, VFNMSUB, "vfnmsub.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFNMSUB_VF, VFNMSUB, "vfnmsub.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OPCODE(VFREC7, "vfrec7.v", VUnary, All),
+    BISCUIT_OVERLOAD(VFSGNJ_VV, VFSGNJ, "vfsgnj.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFSGNJ_VF, VFSGNJ, "vfsgnj.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OVERLOAD(VFSGNJN_VV, VFSGNJN, "vfsgnjn.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFSGNJN_VF, VFSGNJN, "vfsgnjn.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OVERLOAD(VFSGNJX_VV, VFSGNJX, "vfsgnjx.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFSGNJX_VF, VFSGNJX, "vfsgnjx.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OPCODE(VFSQRT, "vfsqrt.v", VUnary, All),
+    BISCUIT_OPCODE(VFRSQRT7, "vfrsqrt7.v", VUnary, All),
+    BISCUIT_OPCODE(VFSLIDE1DOWN, "vfslide1down.vf", VF, All),
+    BISCUIT_OPCODE(VFSLIDE1UP, "vfslide1up.vf", VF, All),
+    BISCUIT_OVERLOAD(VFSUB_VV, VFSUB, "vfsub.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFSUB_VF, VFSUB, "vfsub.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OPCODE(VFRSUB, "vfrsub.vf", VF, All),
+    BISCUIT_OVERLOAD(VFWADD_VV, VFWADD, "vfwadd.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWADD_VF, VFWADD, "vfwadd.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OVERLOAD(VFWADDW_VV, VFWADDW, "vfwadd.wv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWADDW_VF, VFWADDW, "vfwadd.wf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OVERLOAD(VFWMACC_VV, VFWMACC, "vfwmacc.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWMACC_VF, VFWMACC, "vfwmacc.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWMUL_VV, VFWMUL, "vfwmul.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWMUL_VF, VFWMUL, "vfwmul.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OVERLOAD(VFWNMACC_VV, VFWNMACC, "vfwnmacc.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWNMACC_VF, VFWNMACC, "vfwnmacc.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWNMSAC_VV, VFWNMSAC, "vfwnmsac.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWNMSAC_VF, VFWNMSAC, "vfwnmsac.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OPCODE(VFWREDSUM, "vfwredusum.vs", VV, All),
+    BISCUIT_OPCODE(VFWREDOSUM, "vfwredosum.vs", VV, All),
+    BISCUIT_OVERLOAD(VFWMSAC_VV, VFWMSAC, "vfwmsac.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWMSAC_VF, VFWMSAC, "vfwmsac.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWSUB_VV, VFWSUB, "vfwsub.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWSUB_VF, VFWSUB, "vfwsub.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OVERLOAD(VFWSUBW_VV, VFWSUBW, "vfwsub.wv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWSUBW_VF, VFWSUBW, "vfwsub.wf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OVERLOAD(VMFEQ_VV, VMFEQ, "vmfeq.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMFEQ_VF, VMFEQ, "vmfeq.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OPCODE(VMFGE, "vmfge.vf", VF, All),
+    BISCUIT_OPCODE(VMFGT, "vmfgt.vf", VF, All),
+    BISCUIT_OVERLOAD(VMFLE_VV, VMFLE, "vmfle.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMFLE_VF, VMFLE, "vmfle.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OVERLOAD(VMFLT_VV, VMFLT, "vmflt.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMFLT_VF, VMFLT, "vmflt.vf", VF, All, Vec, Vec, FPR, VecMask),
+    BISCUIT_OVERLOAD(VMFNE_VV, VMFNE, "vmfne.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VMFNE_VF, VMFNE, "vmfne.vf", VF, All, Vec, Vec, FPR, VecMask),
+
+    // Vector Load/Store Instructions
+    BISCUIT_OPCODE(VLE8, "vle8.v", VMemUnit, All),
+    BISCUIT_OPCODE(VLE16, "vle16.v", VMemUnit, All),
+    BISCUIT_OPCODE(VLE32, "vle32.v", VMemUnit, All),
+    BISCUIT_OPCODE(VLE64, "vle64.v", VMemUnit, All),
+    BISCUIT_OPCODE(VLM, "vlm.v", VMemWhole, All),
+    BISCUIT_OPCODE(VLSE8, "vlse8.v", VMemStrided, All),
+    BISCUIT_OPCODE(VLSE16, "vlse16.v", VMemStrided, All),
+    BISCUIT_OPCODE(VLSE32, "vlse32.v", VMemStrided, All),
+    BISCUIT_OPCODE(VLSE64, "vlse64.v", VMemStrided, All),
+    BISCUIT_OPCODE(VLOXEI8, "vloxei8.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VLOXEI16, "vloxei16.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VLOXEI32, "vloxei32.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VLOXEI64, "vloxei64.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VLUXEI8, "vluxei8.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VLUXEI16, "vluxei16.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VLUXEI32, "vluxei32.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VLUXEI64, "vluxei64.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VLE8FF, "vle8ff.v", VMemUnit, All),
+    BISCUIT_OPCODE(VLE16FF, "vle16ff.v", VMemUnit, All),
+    BISCUIT_OPCODE(VLE32FF, "vle32ff.v", VMemUnit, All),
+    BISCUIT_OPCODE(VLE64FF, "vle64ff.v", VMemUnit, All),
+    BISCUIT_OPCODE(VLSEGE8, "vlsege8.v", VMemSegUnit, All),
+    BISCUIT_OPCODE(VLSEGE16, "vlsege16.v", VMemSegUnit, All),
+    BISCUIT_OPCODE(VLSEGE32, "vlsege32.v", VMemSegUnit, All),
+    BISCUIT_OPCODE(VLSEGE64, "vlsege64.v", VMemSegUnit, All),
+    BISCUIT_OPCODE(VLSSEGE8, "vlssege8.v", VMemSegStrided, All),
+    BISCUIT_OPCODE(VLSSEGE16, "vlssege16.v", VMemSegStrided, All),
+    BISCUIT_OPCODE(VLSSEGE32, "vlssege32.v", VMemSegStrided, All),
+    BISCUIT_OPCODE(VLSSEGE64, "vlssege64.v", VMemSegStrided, All),
+    BISCUIT_OPCODE(VLOXSEGEI8, "vloxsegei8.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VLOXSEGEI16, "vloxsegei16.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VLOXSEGEI32, "vloxsegei32.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VLOXSEGEI64, "vloxsegei64.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VLUXSEGEI8, "vluxsegei8.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VLUXSEGEI16, "vluxsegei16.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VLUXSEGEI32, "vluxsegei32.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VLUXSEGEI64, "vluxsegei64.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VL1RE8, "vl1re8.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL2RE8, "vl2re8.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL4RE8, "vl4re8.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL8RE8, "vl8re8.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL1RE16, "vl1re16.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL2RE16, "vl2re16.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL4RE16, "vl4re16.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL8RE16, "vl8re16.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL1RE32, "vl1re32.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL2RE32, "vl2re32.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL4RE32, "vl4re32.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL8RE32, "vl8re32.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL1RE64, "vl1re64.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL2RE64, "vl2re64.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL4RE64, "vl4re64.v", VMemWhole, All),
+    BISCUIT_OPCODE(VL8RE64, "vl8re64.v", VMemWhole, All),
+    BISCUIT_OPCODE(VSE8, "vse8.v", VMemUnit, All),
+    BISCUIT_OPCODE(VSE16, "vse16.v", VMemUnit, All),
+    BISCUIT_OPCODE(VSE32, "vse32.v", VMemUnit, All),
+    BISCUIT_OPCODE(VSE64, "vse64.v", VMemUnit, All),
+    BISCUIT_OPCODE(VSM, "vsm.v", VMemWhole, All),
+    BISCUIT_OPCODE(VSSE8, "vsse8.v", VMemStrided, All),
+    BISCUIT_OPCODE(VSSE16, "vsse16.v", VMemStrided, All),
+    BISCUIT_OPCODE(VSSE32, "vsse32.v", VMemStrided, All),
+    BISCUIT_OPCODE(VSSE64, "vsse64.v", VMemStrided, All),
+    BISCUIT_OPCODE(VSOXEI8, "vsoxei8.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VSOXEI16, "vsoxei16.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VSOXEI32, "vsoxei32.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VSOXEI64, "vsoxei64.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VSUXEI8, "vsuxei8.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VSUXEI16, "vsuxei16.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VSUXEI32, "vsuxei32.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VSUXEI64, "vsuxei64.v", VMemIndexed, All),
+    BISCUIT_OPCODE(VSSEGE8, "vssege8.v", VMemSegUnit, All),
+    BISCUIT_OPCODE(VSSEGE16, "vssege16.v", VMemSegUnit, All),
+    BISCUIT_OPCODE(VSSEGE32, "vssege32.v", VMemSegUnit, All),
+    BISCUIT_OPCODE(VSSEGE64, "vssege64.v", VMemSegUnit, All),
+    BISCUIT_OPCODE(VSSSEGE8, "vsssege8.v", VMemSegStrided, All),
+    BISCUIT_OPCODE(VSSSEGE16, "vsssege16.v", VMemSegStrided, All),
+    BISCUIT_OPCODE(VSSSEGE32, "vsssege32.v", VMemSegStrided, All),
+    BISCUIT_OPCODE(VSSSEGE64, "vsssege64.v", VMemSegStrided, All),
+    BISCUIT_OPCODE(VSOXSEGEI8, "vsoxsegei8.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VSOXSEGEI16, "vsoxsegei16.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VSOXSEGEI32, "vsoxsegei32.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VSOXSEGEI64, "vsoxsegei64.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VSUXSEGEI8, "vsuxsegei8.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VSUXSEGEI16, "vsuxsegei16.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VSUXSEGEI32, "vsuxsegei32.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VSUXSEGEI64, "vsuxsegei64.v", VMemSegIndexed, All),
+    BISCUIT_OPCODE(VS1R, "vs1r.v", VMemWhole, All),
+    BISCUIT_OPCODE(VS2R, "vs2r.v", VMemWhole, All),
+    BISCUIT_OPCODE(VS4R, "vs4r.v", VMemWhole, All),
+    BISCUIT_OPCODE(VS8R, "vs8r.v", VMemWhole, All),
+
+    // Vector Configuration Setting Instructions
+    BISCUIT_CUSTOM(VSETIVLI, "vsetivli", VSetIVLI, All, EmitVSETIVLI),
+    BISCUIT_OPCODE(VSETVL, "vsetvl", R, All),
+    BISCUIT_CUSTOM(VSETVLI, "vsetvli", VSetVLI, All, EmitVSETVLI),
+
+    // Vector Cryptography Instructions
+    BISCUIT_OVERLOAD(VANDN_VV, VANDN, "vandn.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VANDN_VX, VANDN, "vandn.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OPCODE(VBREV, "vbrev.v", VUnary, All),
+    BISCUIT_OPCODE(VBREV8, "vbrev8.v", VUnary, All),
+    BISCUIT_OPCODE(VREV8, "vrev8.v", VUnary, All),
+    BISCUIT_OPCODE(VCLZ, "vclz.v", VUnary, All),
+    BISCUIT_OPCODE(VCTZ, "vctz.v", VUnary, All),
+    BISCUIT_OPCODE(VCPOP, "vcpop.v", VUnary, All),
+    BISCUIT_OVERLOAD(VROL_VV, VROL, "vrol.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VROL_VX, VROL, "vrol.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VROR_VV, VROR, "vror.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VROR_VX, VROR, "vror.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VROR_VI, VROR, "vror.vi", VRotateImm, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VWSLL_VV, VWSLL, "vwsll.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VWSLL_VX, VWSLL, "vwsll.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VWSLL_VI, VWSLL, "vwsll.vi", VUI, All, Vec, Vec, uint32_t, VecMask),
+    BISCUIT_OVERLOAD(VCLMUL_VV, VCLMUL, "vclmul.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VCLMUL_VX, VCLMUL, "vclmul.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OVERLOAD(VCLMULH_VV, VCLMULH, "vclmulh.vv", VV, All, Vec, Vec, Vec, VecMask),
+    BISCUIT_OVERLOAD(VCLMULH_VX, VCLMULH, "vclmulh.vx", VX, All, Vec, Vec, GPR, VecMask),
+    BISCUIT_OPCODE(VGHSH, "vghsh.vv", VVNoMask, All),
+    BISCUIT_OPCODE(VGMUL, "vgmul.vv", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VAESDF_VV, "vaesdf.vv", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VAESDF_VS, "vaesdf.vs", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VAESDM_VV, "vaesdm.vv", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VAESDM_VS, "vaesdm.vs", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VAESEF_VV, "vaesef.vv", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VAESEF_VS, "vaesef.vs", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VAESEM_VV, "vaesem.vv", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VAESEM_VS, "vaesem.vs", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VAESKF1, "vaeskf1.vi", VUINoMask, All),
+    BISCUIT_OPCODE(VAESKF2, "vaeskf2.vi", VUINoMask, All),
+    BISCUIT_OPCODE(VAESZ, "vaesz.vs", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VSHA2MS, "vsha2ms.vv", VVNoMask, All),
+    BISCUIT_OPCODE(VSHA2CH, "vsha2ch.vv", VVNoMask, All),
+    BISCUIT_OPCODE(VSHA2CL, "vsha2cl.vv", VVNoMask, All),
+    BISCUIT_OPCODE(VSM4K, "vsm4k.vi", VUINoMask, All),
+    BISCUIT_OPCODE(VSM4R_VV, "vsm4r.vv", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VSM4R_VS, "vsm4r.vs", VUnaryNoMask, All),
+    BISCUIT_OPCODE(VSM3C, "vsm3c.vi", VUINoMask, All),
+    BISCUIT_OPCODE(VSM3ME, "vsm3me.vv", VVNoMask, All),
+
+    // Zvfbfmin, Zvfbfwma Extension Instructions
+    BISCUIT_OPCODE(VFNCVTBF16_F_F_W, "vfncvtbf16.f.f.w", VUnary, All),
+    BISCUIT_OPCODE(VFWCVTBF16_F_F_V, "vfwcvtbf16.f.f.v", VUnary, All),
+    BISCUIT_OVERLOAD(VFWMACCBF16_VF, VFWMACCBF16, "vfwmaccbf16.vf", VFMultiplyAdd, All, Vec, FPR, Vec, VecMask),
+    BISCUIT_OVERLOAD(VFWMACCBF16_VV, VFWMACCBF16, "vfwmaccbf16.vv", VVMultiplyAdd, All, Vec, Vec, Vec, VecMask),
+};
+// clang-format on
+
+#undef BISCUIT_CUSTOM
+#undef BISCUIT_OVERLOAD
+#undef BISCUIT_OPCODE
+
+static_assert(opcode_infos.size() == static_cast<size_t>(Opcode::Invalid));
+static_assert([] {
+    for (size_t i = 0; i < opcode_infos.size(); i++) {
+        if (static_cast<size_t>(opcode_infos[i].opcode) != i) {
+            return false;
+        }
+    }
+    return true;
+}(), "Opcode info table must be in the same order as the Opcode enum");
+} // Anonymous namespace
+
+std::span<const OpcodeInfo> GetOpcodeInfos() noexcept {
+    return opcode_infos;
+}
+
+} // namespace biscuit
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/decoder.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// Internal header describing every instruction known to the decoder.
+
+namespace biscuit {
+
+// Describes the operand layout of an instruction. Operands of each format are listed
+// in the same order as the parameters of the Assembler functions that emit them.
+enum class Format : uint8_t {
+    // Scalar integer formats
+    None,             // (no operands)
+    R,                // rd, rs1, rs2
+    RUnary,           // rd, rs1
+    RFence,           // rs1, rs2
+    RShiftAdd,        // rd, rs1, rs2, shift
+    RByteSelect,      // rd, rs1, rs2, bs
+    RRoundNum,        // rd, rs1, rnum
+    I,                // rd, rs1, imm
+    Shift,            // rd, rs1, shamt[5:0]
+    ShiftW,           // rd, rs1, shamt[4:0]
+    Load,             // rd, imm, rs1
+    Store,            // rs2, imm, rs1
+    Branch,           // rs1, rs2, offset
+    U,                // rd, imm[31:12]
+    Jal,              // rd, offset
+    Lpad,             // imm[31:12]
+    Fence,            // pred, succ
+    FenceI,           // rd, rs1, imm
+    Csr,              // rd, csr, rs1
+    CsrImm,           // rd, csr, uimm
+    Prefetch,         // rs1, offset
+    CacheBlock,       // rs1
+    HypervisorLoad,   // rd, rs1
+    HypervisorStore,  // rs2, rs1
+    Amo,              // ordering, rd, rs2, rs1
+    LoadReserved,     // ordering, rd, rs1
+    StoreRelease,     // ordering, rs2, rs1
+    SSPush,           // rs2 (x1 or x5)
+    SSPopChk,         // rs1 (x1 or x5)
+    SSReadPointer,    // rd (not x0)
+
+    // Floating-point formats
+    FR,               // frd, frs1, frs2
+    FRRm,             // frd, frs1, frs2, rm
+    FR4,              // frd, frs1, frs2, frs3, rm
+    FUnaryRm,         // frd, frs1, rm
+    FCompare,         // rd, frs1, frs2
+    FToX,             // rd, frs1
+    FToXRm,           // rd, frs1, rm
+    XToF,             // frd, rs1
+    XToFRm,           // frd, rs1, rm
+    FMovePair,        // frd, rs1, rs2
+    FLoad,            // frd, imm, rs1
+    FStore,           // frs2, imm, rs1
+    FLoadImm,         // frd, constant index
+
+    // Vector formats
+    VV,               // vd, vs2, vs1, vm
+    VX,               // vd, vs2, rs1, vm
+    VF,               // vd, vs2, frs1, vm
+    VI,               // vd, vs2, simm5, vm
+    VUI,              // vd, vs2, uimm5, vm
+    VRotateImm,       // vd, vs2, uimm6, vm
+    VVMultiplyAdd,    // vd, vs1, vs2, vm
+    VXMultiplyAdd,    // vd, rs1, vs2, vm
+    VFMultiplyAdd,    // vd, frs1, vs2, vm
+    VVNoMask,         // vd, vs2, vs1
+    VXNoMask,         // vd, vs2, rs1
+    VINoMask,         // vd, vs2, simm5
+    VFNoMask,         // vd, vs2, frs1
+    VUINoMask,        // vd, vs2, uimm5
+    VUnary,           // vd, vs2, vm
+    VUnaryNoMask,     // vd, vs2
+    VMoveV,           // vd, vs1
+    VMoveX,           // vd, rs1
+    VMoveF,           // vd, frs1
+    VMoveI,           // vd, simm5
+    VMoveToX,         // rd, vs2
+    VMoveToF,         // frd, vs2
+    VMaskToX,         // rd, vs2, vm
+    VIndex,           // vd, vm
+    VMemUnit,         // vd, rs1, vm
+    VMemWhole,        // vd, rs1
+    VMemStrided,      // vd, rs1, rs2, vm
+    VMemIndexed,      // vd, rs1, vs2, vm
+    VMemSegUnit,      // nf, vd, rs1, vm
+    VMemSegStrided,   // nf, vd, rs1, rs2, vm
+    VMemSegIndexed,   // nf, vd, rs1, vs2, vm
+    VSetVLI,          // rd, rs1, vtype
+    VSetIVLI,         // rd, uimm5, vtype
+
+    // Compressed formats
+    CNone,            // (no operands)
+    CR,               // rd, rs2 (not x0)
+    CMove,            // rd (not x0), rs2 (not x0)
+    CJumpReg,         // rs1 (not x0)
+    CI,               // rd (not x0), imm
+    CAddi,            // rd (not x0), imm (not 0)
+    CLui,             // rd (not x0 or x2), imm (not 0)
+    CShift,           // rd (not x0), shamt
+    CShiftB,          // rd', shamt
+    CAndi,            // rd', imm
+    CAddi16sp,        // imm
+    CAddi4spn,        // rd', imm
+    CLwsp,            // rd (not x0), imm
+    CLdsp,            // rd (not x0), imm
+    CLqsp,            // rd (not x0), imm
+    CFlwsp,           // frd, imm
+    CFldsp,           // frd, imm
+    CSwsp,            // rs2, imm
+    CSdsp,            // rs2, imm
+    CSqsp,            // rs2, imm
+    CFswsp,           // frs2, imm
+    CFsdsp,           // frs2, imm
+    CMemB,            // rd', imm, rs1'
+    CMemH,            // rd', imm, rs1'
+    CMemW,            // rd', imm, rs1'
+    CMemD,            // rd', imm, rs1'
+    CMemQ,            // rd', imm, rs1'
+    CFMemW,           // frd', imm, rs1'
+    CFMemD,           // frd', imm, rs1'
+    CA,               // rd', rs2'
+    CUnary,           // rd'
+    CBranch,          // rs1', offset
+    CJump,            // offset
+    CMMove,           // r1s', r2s'
+    CMPush,           // rlist, stack adjustment
+    CMPop,            // rlist, stack adjustment
+    CMJumpTable,      // index
+    CMJumpTableLink,  // index
+
+    Count,
+};
+
+// Bitmask of the base ISAs an instruction is available on.
+namespace XLen {
+constexpr uint8_t RV32 = 1U << 0;
+constexpr uint8_t RV64 = 1U << 1;
+constexpr uint8_t RV128 = 1U << 2;
+constexpr uint8_t RV32_64 = RV32 | RV64;
+constexpr uint8_t RV64_128 = RV64 | RV128;
+constexpr uint8_t All = RV32 | RV64 | RV128;
+
+[[nodiscard]] constexpr uint8_t FromArchFeature(ArchFeature feature) {
+    switch (feature) {
+    case ArchFeature::RV32:
+        return RV32;
+    case ArchFeature::RV64:
+        return RV64;
+    case ArchFeature::RV128:
+        return RV128;
+    }
+    return 0;
+}
+} // namespace XLen
+
+// Describes a single instruction.
+struct OpcodeInfo {
+    // Emits the given instruction with the Assembler function that encodes it.
+    using EmitFunction = void (*)(Assembler&, const Instruction&) noexcept;
+
+    Opcode opcode;
+    std::string_view mnemonic;
+    Format format;
+    uint8_t xlen;
+    EmitFunction emit;
+};
+
+// Retrieves the info of every instruction, ordered by opcode.
+[[nodiscard]] std::span<const OpcodeInfo> GetOpcodeInfos() noexcept;
+
+// Retrieves the info for a single opcode.
+[[nodiscard]] inline const OpcodeInfo& GetOpcodeInfo(Opcode opcode) noexcept {
+    const auto infos = GetOpcodeInfos();
+    const auto index = static_cast<size_t>(opcode);
+    BISCUIT_ASSERT(index < infos.size());
+    return infos[index];
+}
+
+} // namespace biscuit
@@ -0,0 +1,1119 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/decoder.hpp>
+#include <biscuit/disassembler.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <string_view>
+#include <vector>
+
+#include "decoder_table.hpp"
+
+// Textual disassembly, following the output conventions of GNU objdump.
+
+namespace biscuit {
+namespace {
+constexpr std::array<std::string_view, 32> gpr_names{
+    "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2",
+    "s0",   "s1", "a0", "a1", "a2", "a3", "a4", "a5",
+    "a6",   "a7", "s2", "s3", "s4", "s5", "s6", "s7",
+    "s8",   "s9", "s10", "s11", "t3", "t4", "t5", "t6",
+};
+
+constexpr std::array<std::string_view, 32> fpr_names{
+    "ft0", "ft1", "ft2",  "ft3",  "ft4", "ft5", "ft6",  "ft7",
+    "fs0", "fs1", "fa0",  "fa1",  "fa2", "fa3", "fa4",  "fa5",
+    "fa6", "fa7", "fs2",  "fs3",  "fs4", "fs5", "fs6",  "fs7",
+    "fs8", "fs9", "fs10", "fs11", "ft8", "ft9", "ft10", "ft11",
+};
+
+constexpr std::array<std::string_view, 8> rounding_mode_names{
+    "rne", "rtz", "rdn", "rup", "rmm", "", "", "dyn",
+};
+
+constexpr std::array<std::string_view, 8> sew_names{
+    "e8", "e16", "e32", "e64", "e128", "e256", "e512", "e1024",
+};
+
+constexpr std::array<std::string_view, 8> lmul_names{
+    "m1", "m2", "m4", "m8", "", "mf8", "mf4", "mf2",
+};
+
+// Constants loadable with the Zfa FLI instructions, in the same form objdump prints them.
+constexpr std::array<std::string_view, 32> fli_names{
+    "-1.0",    "min",   "1.52587890625e-05", "3.0517578125e-05",
+    "0.00390625", "0.0078125", "0.0625", "0.125",
+    "0.25",    "0.3125", "0.375",  "0.4375",
+    "0.5",     "0.625", "0.75",   "0.875",
+    "1.0",     "1.25",  "1.5",    "1.75",
+    "2.0",     "2.5",   "3.0",    "4.0",
+    "8.0",     "16.0",  "128.0",  "256.0",
+    "32768.0", "65536.0", "inf",  "nan",
+};
+
+struct CSRName {
+    uint32_t csr;
+    std::string_view name;
+};
+
+// clang-format off
+constexpr std::array csr_names{
+    CSRName{0x001, "fflags"},   CSRName{0x002, "frm"},       CSRName{0x003, "fcsr"},
+    CSRName{0x008, "vstart"},   CSRName{0x009, "vxsat"},     CSRName{0x00A, "vxrm"},
+    CSRName{0x00F, "vcsr"},     CSRName{0x011, "ssp"},       CSRName{0x015, "seed"},
+    CSRName{0x017, "jvt"},      CSRName{0xC00, "cycle"},     CSRName{0xC01, "time"},
+    CSRName{0xC02, "instret"},  CSRName{0xC20, "vl"},        CSRName{0xC21, "vtype"},
+    CSRName{0xC22, "vlenb"},    CSRName{0xC80, "cycleh"},    CSRName{0xC81, "timeh"},
+    CSRName{0xC82, "instreth"},
+
+    CSRName{0x100, "sstatus"},  CSRName{0x104, "sie"},       CSRName{0x105, "stvec"},
+    CSRName{0x106, "scounteren"}, CSRName{0x10A, "senvcfg"}, CSRName{0x140, "sscratch"},
+    CSRName{0x141, "sepc"},     CSRName{0x142, "scause"},    CSRName{0x143, "stval"},
+    CSRName{0x144, "sip"},      CSRName{0x180, "satp"},
+
+    CSRName{0x300, "mstatus"},  CSRName{0x301, "misa"},      CSRName{0x302, "medeleg"},
+    CSRName{0x303, "mideleg"},  CSRName{0x304, "mie"},       CSRName{0x305, "mtvec"},
+    CSRName{0x306, "mcounteren"}, CSRName{0x30A, "menvcfg"}, CSRName{0x310, "mstatush"},
+    CSRName{0x340, "mscratch"}, CSRName{0x341, "mepc"},      CSRName{0x342, "mcause"},
+    CSRName{0x343, "mtval"},    CSRName{0x344, "mip"},       CSRName{0xB00, "mcycle"},
+    CSRName{0xB02, "minstret"}, CSRName{0xF11, "mvendorid"}, CSRName{0xF12, "marchid"},
+    CSRName{0xF13, "mimpid"},   CSRName{0xF14, "mhartid"},
+};
+// clang-format on
+
+void AppendDecimal(std::string& out, int64_t value) {
+    std::array<char, 24> buffer{};
+    const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    out.append(buffer.data(), result.ptr);
+}
+
+void AppendHex(std::string& out, uint64_t value, size_t min_digits = 1) {
+    std::array<char, 16> buffer{};
+    const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, 16);
+    const auto digits = static_cast<size_t>(result.ptr - buffer.data());
+    if (digits < min_digits) {
+        out.append(min_digits - digits, '0');
+    }
+    out.append(buffer.data(), result.ptr);
+}
+
+void AppendCSR(std::string& out, uint32_t csr) {
+    const auto iter = std::find_if(csr_names.begin(), csr_names.end(), [csr](const CSRName& entry) {
+        return entry.csr == csr;
+    });
+    if (iter != csr_names.end()) {
+        out += iter->name;
+        return;
+    }
+
+    // Counters are numbered rather than listed individually.
+    if (csr >= 0xC03 && csr <= 0xC1F) {
+        out += "hpmcounter";
+        AppendDecimal(out, csr - 0xC00);
+    } else if (csr >= 0xC83 && csr <= 0xC9F) {
+        out += "hpmcounter";
+        AppendDecimal(out, csr - 0xC80);
+        out += 'h';
+    } else if (csr >= 0xB03 && csr <= 0xB1F) {
+        out += "mhpmcounter";
+        AppendDecimal(out, csr - 0xB00);
+    } else if (csr >= 0x323 && csr <= 0x33F) {
+        out += "mhpmevent";
+        AppendDecimal(out, csr - 0x320);
+    } else {
+        out += "0x";
+        AppendHex(out, csr);
+    }
+}
+
+// Formats a single instruction. Labels may optionally be provided
+// to annotate branch targets with.
+class InstructionPrinter {
+public:
+    InstructionPrinter(uint64_t address, const std::vector<uint64_t>* labels)
+        : m_address{address}, m_labels{labels} {}
+
+    [[nodiscard]] std::string Print(const Instruction& instruction, bool use_aliases) {
+        if (!use_aliases || !PrintAlias(instruction)) {
+            PrintCanonical(instruction);
+        }
+
+        std::string result = std::move(m_mnemonic);
+        if (!m_operands.empty()) {
+            result += '\t';
+            result += m_operands;
+        }
+        return result;
+    }
+
+private:
+    // Operand helpers
+
+    void Separator() {
+        if (!m_operands.empty()) {
+            m_operands += ',';
+        }
+    }
+
+    void Text(std::string_view text) {
+        Separator();
+        m_operands += text;
+    }
+
+    void Reg(GPR reg) {
+        Text(gpr_names[reg.Index()]);
+    }
+
+    void Imm(int64_t value) {
+        Separator();
+        AppendDecimal(m_operands, value);
+    }
+
+    void HexImm(uint64_t value) {
+        Separator();
+        m_operands += "0x";
+        AppendHex(m_operands, value);
+    }
+
+    void Target(int32_t offset) {
+        Separator();
+
+        const auto target = m_address + static_cast<uint64_t>(static_cast<int64_t>(offset));
+        AppendHex(m_operands, target);
+
+        if (m_labels == nullptr) {
+            return;
+        }
+        const auto iter = std::lower_bound(m_labels->begin(), m_labels->end(), target);
+        if (iter != m_labels->end() && *iter == target) {
+            m_operands += " <.L";
+            AppendDecimal(m_operands, iter - m_labels->begin());
+            m_operands += '>';
+        }
+    }
+
+    // Appends `offset(base)` memory operands.
+    void Memory(int32_t offset, GPR base) {
+        Imm(offset);
+        m_operands += '(';
+        m_operands += gpr_names[base.Index()];
+        m_operands += ')';
+    }
+
+    // Appends `(base)` memory operands, as used by atomics and vector memory operations.
+    void Memory(GPR base) {
+        Separator();
+        m_operands += '(';
+        m_operands += gpr_names[base.Index()];
+        m_operands += ')';
+    }
+
+    void Operand(const biscuit::Operand& operand) {
+        const auto value = operand.value;
+        const auto index = static_cast<size_t>(value);
+
+        switch (operand.type) {
+        case OperandType::None:
+            break;
+        case OperandType::GPR:
+            Text(gpr_names[index]);
+            break;
+        case OperandType::FPR:
+            Text(fpr_names[index]);
+            break;
+        case OperandType::Vec:
+            Separator();
+            m_operands += 'v';
+            AppendDecimal(m_operands, value);
+            break;
+        case OperandType::Imm:
+            Imm(value);
+            break;
+        case OperandType::PCOffset:
+            Target(value);
+            break;
+        case OperandType::CSR:
+            Separator();
+            AppendCSR(m_operands, static_cast<uint32_t>(value));
+            break;
+        case OperandType::RMode:
+            // The dynamic rounding mode is implied when none is given.
+            if (static_cast<RMode>(value) != RMode::DYN) {
+                Text(rounding_mode_names[index]);
+            }
+            break;
+        case OperandType::Ordering:
+            // Printed as part of the mnemonic.
+            break;
+        case OperandType::FenceOrder:
+            FenceSet(static_cast<uint32_t>(value));
+            break;
+        case OperandType::VecMask:
+            if (static_cast<VecMask>(value) == VecMask::Yes) {
+                Text("v0.t");
+            }
+            break;
+        case OperandType::VType:
+            VType(static_cast<uint32_t>(value));
+            break;
+        case OperandType::RegList:
+            RegList(static_cast<uint32_t>(value));
+            break;
+        case OperandType::FloatConstant:
+            Text(fli_names[index]);
+            break;
+        }
+    }
+
+    void FenceSet(uint32_t set) {
+        Separator();
+        if (set == 0) {
+            m_operands += '0';
+            return;
+        }
+        if ((set & static_cast<uint32_t>(FenceOrder::I)) != 0) {
+            m_operands += 'i';
+        }
+        if ((set & static_cast<uint32_t>(FenceOrder::O)) != 0) {
+            m_operands += 'o';
+        }
+        if ((set & static_cast<uint32_t>(FenceOrder::R)) != 0) {
+            m_operands += 'r';
+        }
+        if ((set & static_cast<uint32_t>(FenceOrder::W)) != 0) {
+            m_operands += 'w';
+        }
+    }
+
+    void VType(uint32_t vtype) {
+        Text(sew_names[(vtype >> 3) & 0b111]);
+        Text(lmul_names[vtype & 0b111]);
+        Text((vtype & 0x40) != 0 ? "ta" : "tu");
+        Text((vtype & 0x80) != 0 ? "ma" : "mu");
+    }
+
+    void RegList(uint32_t rlist) {
+        Separator();
+        m_operands += "{ra";
+        if (rlist >= 5) {
+            m_operands += ",s0";
+        }
+        if (rlist >= 6) {
+            m_operands += "-s";
+            AppendDecimal(m_operands, rlist == 15 ? 11 : rlist - 5);
+        }
+        m_operands += '}';
+    }
+
+    void Operands(const Instruction& instruction, size_t first = 0) {
+        for (size_t i = first; i < instruction.num_operands; i++) {
+            Operand(instruction.operands[i]);
+        }
+    }
+
+    // Prints an instruction exactly as it's encoded.
+    void PrintCanonical(const Instruction& instruction) {
+        const auto& info = GetOpcodeInfo(instruction.opcode);
+        const auto& ops = instruction.operands;
+
+        m_mnemonic = info.mnemonic;
+
+        switch (info.format) {
+        case Format::Load:
+        case Format::Store:
+        case Format::FLoad:
+        case Format::FStore:
+        case Format::CMemB:
+        case Format::CMemH:
+        case Format::CMemW:
+        case Format::CMemD:
+        case Format::CMemQ:
+        case Format::CFMemW:
+        case Format::CFMemD:
+            Operand(ops[0]);
+            Memory(ops[1].value, instruction.GetGPR(2));
+            break;
+        case Format::CLwsp:
+        case Format::CLdsp:
+        case Format::CLqsp:
+        case Format::CFlwsp:
+        case Format::CFldsp:
+        case Format::CSwsp:
+        case Format::CSdsp:
+        case Format::CSqsp:
+        case Format::CFswsp:
+        case Format::CFsdsp:
+            Operand(ops[0]);
+            Memory(ops[1].value, sp);
+            break;
+        case Format::Prefetch:
+            Memory(ops[1].value, instruction.GetGPR(0));
+            break;
+        case Format::CacheBlock:
+            Memory(instruction.GetGPR(0));
+            break;
+        case Format::Amo:
+            OrderingSuffix(static_cast<Ordering>(ops[0].value));
+            Operand(ops[1]);
+            Operand(ops[2]);
+            Memory(instruction.GetGPR(3));
+            break;
+        case Format::LoadReserved:
+        case Format::StoreRelease:
+            OrderingSuffix(static_cast<Ordering>(ops[0].value));
+            Operand(ops[1]);
+            Memory(instruction.GetGPR(2));
+            break;
+        case Format::HypervisorLoad:
+        case Format::HypervisorStore:
+            Operand(ops[0]);
+            Memory(instruction.GetGPR(1));
+            break;
+        case Format::VMemUnit:
+        case Format::VMemWhole:
+        case Format::VMemStrided:
+        case Format::VMemIndexed:
+            Operand(ops[0]);
+            Memory(instruction.GetGPR(1));
+            Operands(instruction, 2);
+            break;
+        case Format::VMemSegUnit:
+        case Format::VMemSegStrided:
+        case Format::VMemSegIndexed: {
+            // Segment accesses encode the number of fields into the mnemonic (e.g. vlseg3e8.v).
+            const auto insert_at = m_mnemonic.find("seg") + 3;
+            std::string nf;
+            AppendDecimal(nf, ops[0].value);
+            m_mnemonic.insert(insert_at, nf);
+
+            Operand(ops[1]);
+            Memory(instruction.GetGPR(2));
+            Operands(instruction, 3);
+            break;
+        }
+        case Format::CAddi16sp:
+            Reg(sp);
+            Operands(instruction);
+            break;
+        case Format::CAddi4spn:
+            Operand(ops[0]);
+            Reg(sp);
+            Operand(ops[1]);
+            break;
+        case Format::U:
+        case Format::CLui:
+            Operand(ops[0]);
+            HexImm(static_cast<uint32_t>(ops[1].value));
+            break;
+        case Format::Lpad:
+            HexImm(static_cast<uint32_t>(ops[0].value));
+            break;
+        case Format::CNone:
+            // Shadow stack instructions implicitly operate on a link register.
+            if (instruction.opcode == Opcode::C_SSPUSH) {
+                Reg(ra);
+            } else if (instruction.opcode == Opcode::C_SSPOPCHK) {
+                Reg(t0);
+            }
+            break;
+        case Format::VV:
+        case Format::VX:
+        case Format::VI:
+            // VMADC and VMSBC take the carry in v0 when masked, rather than
+            // using it as a mask (e.g. vmadc.vvm v1,v2,v3,v0).
+            if (IsCarryOut(instruction.opcode) &&
+                static_cast<VecMask>(ops[3].value) == VecMask::Yes) {
+                m_mnemonic += 'm';
+                Operand(ops[0]);
+                Operand(ops[1]);
+                Operand(ops[2]);
+                Text("v0");
+                break;
+            }
+            Operands(instruction);
+            break;
+        default:
+            Operands(instruction);
+
+            // Instructions that consume a carry or merge mask always use v0.
+            if (m_mnemonic.size() > 4 && m_mnemonic.ends_with('m') &&
+                m_mnemonic.substr(m_mnemonic.size() - 4, 2) == ".v") {
+                Text("v0");
+            }
+            break;
+        }
+    }
+
+    [[nodiscard]] static bool IsCarryOut(Opcode opcode) {
+        switch (opcode) {
+        case Opcode::VMADC_VV:
+        case Opcode::VMADC_VX:
+        case Opcode::VMADC_VI:
+        case Opcode::VMSBC_VV:
+        case Opcode::VMSBC_VX:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void OrderingSuffix(Ordering ordering) {
+        switch (ordering) {
+        case Ordering::None:
+            break;
+        case Ordering::AQ:
+            m_mnemonic += ".aq";
+            break;
+        case Ordering::RL:
+            m_mnemonic += ".rl";
+            break;
+        case Ordering::AQRL:
+            m_mnemonic += ".aqrl";
+            break;
+        }
+    }
+
+    // Pseudo-instructions
+
+    void Alias(std::string_view mnemonic) {
+        m_mnemonic = mnemonic;
+    }
+
+    // Prints the base instruction that a compressed instruction expands to.
+    bool PrintExpanded(Opcode opcode, std::initializer_list<biscuit::Operand> operands) {
+        Instruction expanded;
+        expanded.opcode = opcode;
+        expanded.num_operands = static_cast<uint8_t>(operands.size());
+        std::copy(operands.begin(), operands.end(), expanded.operands.begin());
+
+        if (!PrintAlias(expanded)) {
+            PrintCanonical(expanded);
+        }
+        return true;
+    }
+
+    // Prints RV128 quadword loads and stores, which have no uncompressed opcode.
+    bool PrintQuadword(std::string_view mnemonic, GPR reg, int32_t offset, GPR base) {
+        Alias(mnemonic);
+        Reg(reg);
+        Memory(offset, base);
+        return true;
+    }
+
+    bool PrintCompressedAlias(const Instruction& instruction) {
+        const auto& ops = instruction.operands;
+        const auto gpr = [](GPR reg) {
+            return biscuit::Operand{OperandType::GPR, static_cast<int32_t>(reg.Index())};
+        };
+        const auto imm = [](int32_t value) {
+            return biscuit::Operand{OperandType::Imm, value};
+        };
+
+        switch (instruction.opcode) {
+        case Opcode::C_ADDI:
+            return PrintExpanded(Opcode::ADDI, {ops[0], ops[0], ops[1]});
+        case Opcode::C_ADDIW:
+            return PrintExpanded(Opcode::ADDIW, {ops[0], ops[0], ops[1]});
+        case Opcode::C_LI:
+            return PrintExpanded(Opcode::ADDI, {ops[0], gpr(zero), ops[1]});
+        case Opcode::C_ADDI16SP:
+            return PrintExpanded(Opcode::ADDI, {gpr(sp), gpr(sp), ops[0]});
+        case Opcode::C_ADDI4SPN:
+            return PrintExpanded(Opcode::ADDI, {ops[0], gpr(sp), ops[1]});
+        case Opcode::C_LUI: {
+            // The 6-bit immediate is sign-extended into the 20-bit LUI immediate.
+            const auto value = static_cast<uint32_t>(ops[1].value);
+            const auto extended = (value & 0x20) != 0 ? (value | 0xFFFC0) : value;
+            return PrintExpanded(Opcode::LUI, {ops[0], imm(static_cast<int32_t>(extended))});
+        }
+        case Opcode::C_SLLI:
+            return PrintExpanded(Opcode::SLLI, {ops[0], ops[0], ops[1]});
+        case Opcode::C_SRLI:
+            return PrintExpanded(Opcode::SRLI, {ops[0], ops[0], ops[1]});
+        case Opcode::C_SRAI:
+            return PrintExpanded(Opcode::SRAI, {ops[0], ops[0], ops[1]});
+        case Opcode::C_ANDI:
+            return PrintExpanded(Opcode::ANDI, {ops[0], ops[0], ops[1]});
+        case Opcode::C_MV:
+            return PrintExpanded(Opcode::ADD, {ops[0], gpr(zero), ops[1]});
+        case Opcode::C_ADD:
+            return PrintExpanded(Opcode::ADD, {ops[0], ops[0], ops[1]});
+        case Opcode::C_SUB:
+            return PrintExpanded(Opcode::SUB, {ops[0], ops[0], ops[1]});
+        case Opcode::C_XOR:
+            return PrintExpanded(Opcode::XOR, {ops[0], ops[0], ops[1]});
+        case Opcode::C_OR:
+            return PrintExpanded(Opcode::OR, {ops[0], ops[0], ops[1]});
+        case Opcode::C_AND:
+            return PrintExpanded(Opcode::AND, {ops[0], ops[0], ops[1]});
+        case Opcode::C_SUBW:
+            return PrintExpanded(Opcode::SUBW, {ops[0], ops[0], ops[1]});
+        case Opcode::C_ADDW:
+            return PrintExpanded(Opcode::ADDW, {ops[0], ops[0], ops[1]});
+        case Opcode::C_MUL:
+            return PrintExpanded(Opcode::MUL, {ops[0], ops[0], ops[1]});
+        case Opcode::C_J:
+            return PrintExpanded(Opcode::JAL, {gpr(zero), ops[0]});
+        case Opcode::C_JAL:
+            return PrintExpanded(Opcode::JAL, {gpr(ra), ops[0]});
+        case Opcode::C_JR:
+            return PrintExpanded(Opcode::JALR, {gpr(zero), imm(0), ops[0]});
+        case Opcode::C_JALR:
+            return PrintExpanded(Opcode::JALR, {gpr(ra), imm(0), ops[0]});
+        case Opcode::C_BEQZ:
+            return PrintExpanded(Opcode::BEQ, {ops[0], gpr(zero), ops[1]});
+        case Opcode::C_BNEZ:
+            return PrintExpanded(Opcode::BNE, {ops[0], gpr(zero), ops[1]});
+        case Opcode::C_LW:
+            return PrintExpanded(Opcode::LW, {ops[0], ops[1], ops[2]});
+        case Opcode::C_LD:
+            return PrintExpanded(Opcode::LD, {ops[0], ops[1], ops[2]});
+        case Opcode::C_FLW:
+            return PrintExpanded(Opcode::FLW, {ops[0], ops[1], ops[2]});
+        case Opcode::C_FLD:
+            return PrintExpanded(Opcode::FLD, {ops[0], ops[1], ops[2]});
+        case Opcode::C_SW:
+            return PrintExpanded(Opcode::SW, {ops[0], ops[1], ops[2]});
+        case Opcode::C_SD:
+            return PrintExpanded(Opcode::SD, {ops[0], ops[1], ops[2]});
+        case Opcode::C_FSW:
+            return PrintExpanded(Opcode::FSW, {ops[0], ops[1], ops[2]});
+        case Opcode::C_FSD:
+            return PrintExpanded(Opcode::FSD, {ops[0], ops[1], ops[2]});
+        case Opcode::C_LBU:
+            return PrintExpanded(Opcode::LBU, {ops[0], ops[1], ops[2]});
+        case Opcode::C_LH:
+            return PrintExpanded(Opcode::LH, {ops[0], ops[1], ops[2]});
+        case Opcode::C_LHU:
+            return PrintExpanded(Opcode::LHU, {ops[0], ops[1], ops[2]});
+        case Opcode::C_SB:
+            return PrintExpanded(Opcode::SB, {ops[0], ops[1], ops[2]});
+        case Opcode::C_SH:
+            return PrintExpanded(Opcode::SH, {ops[0], ops[1], ops[2]});
+        case Opcode::C_LQ:
+            return PrintQuadword("lq", instruction.GetGPR(0), ops[1].value, instruction.GetGPR(2));
+        case Opcode::C_SQ:
+            return PrintQuadword("sq", instruction.GetGPR(0), ops[1].value, instruction.GetGPR(2));
+        case Opcode::C_LWSP:
+            return PrintExpanded(Opcode::LW, {ops[0], ops[1], gpr(sp)});
+        case Opcode::C_LDSP:
+            return PrintExpanded(Opcode::LD, {ops[0], ops[1], gpr(sp)});
+        case Opcode::C_FLWSP:
+            return PrintExpanded(Opcode::FLW, {ops[0], ops[1], gpr(sp)});
+        case Opcode::C_FLDSP:
+            return PrintExpanded(Opcode::FLD, {ops[0], ops[1], gpr(sp)});
+        case Opcode::C_SWSP:
+            return PrintExpanded(Opcode::SW, {ops[0], ops[1], gpr(sp)});
+        case Opcode::C_SDSP:
+            return PrintExpanded(Opcode::SD, {ops[0], ops[1], gpr(sp)});
+        case Opcode::C_FSWSP:
+            return PrintExpanded(Opcode::FSW, {ops[0], ops[1], gpr(sp)});
+        case Opcode::C_FSDSP:
+            return PrintExpanded(Opcode::FSD, {ops[0], ops[1], gpr(sp)});
+        case Opcode::C_LQSP:
+            return PrintQuadword("lq", instruction.GetGPR(0), ops[1].value, sp);
+        case Opcode::C_SQSP:
+            return PrintQuadword("sq", instruction.GetGPR(0), ops[1].value, sp);
+        case Opcode::C_NOP:
+            return PrintExpanded(Opcode::ADDI, {gpr(zero), gpr(zero), imm(0)});
+        case Opcode::C_EBREAK:
+            return PrintExpanded(Opcode::EBREAK, {});
+        case Opcode::C_UNDEF:
+            Alias("unimp");
+            return true;
+        case Opcode::C_SEXT_B:
+            return PrintExpanded(Opcode::SEXTB, {ops[0], ops[0]});
+        case Opcode::C_SEXT_H:
+            return PrintExpanded(Opcode::SEXTH, {ops[0], ops[0]});
+        case Opcode::C_ZEXT_B:
+            return PrintExpanded(Opcode::ANDI, {ops[0], ops[0], imm(255)});
+        case Opcode::C_ZEXT_H:
+            return PrintExpanded(Opcode::ZEXTH, {ops[0], ops[0]});
+        case Opcode::C_ZEXT_W:
+            return PrintExpanded(Opcode::ADDUW, {ops[0], ops[0], gpr(zero)});
+        case Opcode::C_NOT:
+            return PrintExpanded(Opcode::XORI, {ops[0], ops[0], imm(-1)});
+        case Opcode::C_SSPUSH:
+            return PrintExpanded(Opcode::SSPUSH, {gpr(ra)});
+        case Opcode::C_SSPOPCHK:
+            return PrintExpanded(Opcode::SSPOPCHK, {gpr(t0)});
+        default:
+            return false;
+        }
+    }
+
+    // Prints the pseudo-instruction form of an instruction, if it has one.
+    bool PrintAlias(const Instruction& instruction) {
+        if (IsCompressedFormat(instruction.opcode)) {
+            return PrintCompressedAlias(instruction);
+        }
+
+        const auto& ops = instruction.operands;
+        const auto reg = [&](size_t index) { return instruction.GetGPR(index); };
+        const auto value = [&](size_t index) { return ops[index].value; };
+
+        switch (instruction.opcode) {
+        case Opcode::ADDI:
+            if (reg(0) == zero && reg(1) == zero && value(2) == 0) {
+                Alias("nop");
+                return true;
+            }
+            if (reg(1) == zero) {
+                Alias("li");
+                Reg(reg(0));
+                Imm(value(2));
+                return true;
+            }
+            if (value(2) == 0) {
+                Alias("mv");
+                Reg(reg(0));
+                Reg(reg(1));
+                return true;
+            }
+            return false;
+        case Opcode::ADD:
+            if (reg(1) == zero) {
+                Alias("mv");
+                Reg(reg(0));
+                Reg(reg(2));
+                return true;
+            }
+            return false;
+        case Opcode::ADDIW:
+            return UnaryAlias(instruction, "sext.w", value(2) == 0);
+        case Opcode::XORI:
+            return UnaryAlias(instruction, "not", value(2) == -1);
+        case Opcode::ANDI:
+            return UnaryAlias(instruction, "zext.b", value(2) == 255);
+        case Opcode::SLTIU:
+            return UnaryAlias(instruction, "seqz", value(2) == 1);
+        case Opcode::SUB:
+            return ReversedUnaryAlias(instruction, "neg");
+        case Opcode::SUBW:
+            return ReversedUnaryAlias(instruction, "negw");
+        case Opcode::SLTU:
+            return ReversedUnaryAlias(instruction, "snez");
+        case Opcode::SLT:
+            if (reg(2) == zero) {
+                return UnaryAlias(instruction, "sltz", true);
+            }
+            return ReversedUnaryAlias(instruction, "sgtz");
+        case Opcode::ADDUW:
+            return UnaryAlias(instruction, "zext.w", reg(2) == zero);
+
+        case Opcode::BEQ:
+            return BranchAlias(instruction, "beqz", {});
+        case Opcode::BNE:
+            return BranchAlias(instruction, "bnez", {});
+        case Opcode::BGE:
+            return BranchAlias(instruction, "bgez", "blez");
+        case Opcode::BLT:
+            return BranchAlias(instruction, "bltz", "bgtz");
+        case Opcode::JAL:
+            if (reg(0) == zero || reg(0) == ra) {
+                Alias(reg(0) == zero ? "j" : "jal");
+                Target(value(1));
+                return true;
+            }
+            return false;
+        case Opcode::JALR:
+            if (reg(0) == zero && reg(2) == ra && value(1) == 0) {
+                Alias("ret");
+                return true;
+            }
+            if (reg(0) == zero || reg(0) == ra) {
+                Alias(reg(0) == zero ? "jr" : "jalr");
+                if (value(1) == 0) {
+                    Reg(reg(2));
+                } else {
+                    Memory(value(1), reg(2));
+                }
+                return true;
+            }
+            return false;
+
+        case Opcode::FENCE:
+            if (value(0) == 0b1111 && value(1) == 0b1111) {
+                Alias("fence");
+                return true;
+            }
+            return false;
+        case Opcode::FENCEI:
+            return PrintCanonicalWithoutZeroOperands(instruction);
+
+        case Opcode::CSRRS:
+            if (reg(2) == zero) {
+                return CSRReadAlias(instruction);
+            }
+            return CSRWriteAlias(instruction, "csrs");
+        case Opcode::CSRRW:
+            return CSRWriteAlias(instruction, "csrw");
+        case Opcode::CSRRC:
+            return CSRWriteAlias(instruction, "csrc");
+        case Opcode::CSRRWI:
+            return CSRWriteAlias(instruction, "csrwi");
+        case Opcode::CSRRSI:
+            return CSRWriteAlias(instruction, "csrsi");
+        case Opcode::CSRRCI:
+            return CSRWriteAlias(instruction, "csrci");
+
+        case Opcode::FSGNJ_S:
+        case Opcode::FSGNJ_D:
+        case Opcode::FSGNJ_Q:
+        case Opcode::FSGNJ_H:
+            return FloatSignAlias(instruction, "fmv");
+        case Opcode::FSGNJN_S:
+        case Opcode::FSGNJN_D:
+        case Opcode::FSGNJN_Q:
+        case Opcode::FSGNJN_H:
+            return FloatSignAlias(instruction, "fneg");
+        case Opcode::FSGNJX_S:
+        case Opcode::FSGNJX_D:
+        case Opcode::FSGNJX_Q:
+        case Opcode::FSGNJX_H:
+            return FloatSignAlias(instruction, "fabs");
+
+        case Opcode::VMAND:
+            return VectorMaskAlias(instruction, "vmmv.m", false);
+        case Opcode::VMNAND:
+            return VectorMaskAlias(instruction, "vmnot.m", false);
+        case Opcode::VMXOR:
+            return VectorMaskAlias(instruction, "vmclr.m", true);
+        case Opcode::VMXNOR:
+            return VectorMaskAlias(instruction, "vmset.m", true);
+        case Opcode::VFSGNJN_VV:
+            return VectorUnaryAlias(instruction, "vfneg.v", ops[1] == ops[2]);
+        case Opcode::VFSGNJX_VV:
+            return VectorUnaryAlias(instruction, "vfabs.v", ops[1] == ops[2]);
+        case Opcode::VXOR_VI:
+            return VectorUnaryAlias(instruction, "vnot.v", value(2) == -1);
+        case Opcode::VRSUB_VX:
+            return VectorUnaryAlias(instruction, "vneg.v", reg(2) == zero);
+        case Opcode::VNSRL_VX:
+            return VectorUnaryAlias(instruction, "vncvt.x.x.w", reg(2) == zero);
+        case Opcode::VWADD_VX:
+            return VectorUnaryAlias(instruction, "vwcvt.x.x.v", reg(2) == zero);
+        case Opcode::VWADDU_VX:
+            return VectorUnaryAlias(instruction, "vwcvtu.x.x.v", reg(2) == zero);
+
+        default:
+            return false;
+        }
+    }
+
+    // Handles aliases of the form `op rd, rs` for `op rd, rs, <fixed operand>`.
+    bool UnaryAlias(const Instruction& instruction, std::string_view mnemonic, bool condition) {
+        if (!condition) {
+            return false;
+        }
+        Alias(mnemonic);
+        Reg(instruction.GetGPR(0));
+        Reg(instruction.GetGPR(1));
+        return true;
+    }
+
+    // Handles aliases of the form `op rd, rs` for `op rd, zero, rs`.
+    bool ReversedUnaryAlias(const Instruction& instruction, std::string_view mnemonic) {
+        if (instruction.GetGPR(1) != zero) {
+            return false;
+        }
+        Alias(mnemonic);
+        Reg(instruction.GetGPR(0));
+        Reg(instruction.GetGPR(2));
+        return true;
+    }
+
+    // Handles comparisons against zero. `zero_rhs` is used for `op rs, zero, offset`,
+    // while `zero_lhs` is used for `op zero, rs, offset`.
+    bool BranchAlias(const Instruction& instruction, std::string_view zero_rhs,
+                     std::string_view zero_lhs) {
+        const auto rs1 = instruction.GetGPR(0);
+        const auto rs2 = instruction.GetGPR(1);
+
+        if (rs2 == zero) {
+            Alias(zero_rhs);
+            Reg(rs1);
+        } else if (rs1 == zero && !zero_lhs.empty()) {
+            Alias(zero_lhs);
+            Reg(rs2);
+        } else {
+            return false;
+        }
+
+        Target(instruction.operands[2].value);
+        return true;
+    }
+
+    bool PrintCanonicalWithoutZeroOperands(const Instruction& instruction) {
+        const auto operands = instruction.GetOperands();
+        const bool all_zero = std::all_of(operands.begin(), operands.end(), [](const biscuit::Operand& operand) {
+            return operand.value == 0;
+        });
+        if (!all_zero) {
+            return false;
+        }
+        Alias(GetMnemonic(instruction.opcode));
+        return true;
+    }
+
+    bool CSRReadAlias(const Instruction& instruction) {
+        const auto csr = static_cast<uint32_t>(instruction.operands[1].value);
+        const auto rd = instruction.GetGPR(0);
+
+        switch (static_cast<CSR>(csr)) {
+        case CSR::Cycle:
+            Alias("rdcycle");
+            break;
+        case CSR::Time:
+            Alias("rdtime");
+            break;
+        case CSR::InstRet:
+            Alias("rdinstret");
+            break;
+        case CSR::CycleH:
+            Alias("rdcycleh");
+            break;
+        case CSR::TimeH:
+            Alias("rdtimeh");
+            break;
+        case CSR::InstRetH:
+            Alias("rdinstreth");
+            break;
+        case CSR::FFlags:
+            Alias("frflags");
+            break;
+        case CSR::FRM:
+            Alias("frrm");
+            break;
+        case CSR::FCSR:
+            Alias("frcsr");
+            break;
+        default:
+            Alias("csrr");
+            Reg(rd);
+            Operand(instruction.operands[1]);
+            return true;
+        }
+
+        Reg(rd);
+        return true;
+    }
+
+    bool CSRWriteAlias(const Instruction& instruction, std::string_view mnemonic) {
+        if (instruction.GetGPR(0) != zero) {
+            return false;
+        }
+        Alias(mnemonic);
+        Operand(instruction.operands[1]);
+        Operand(instruction.operands[2]);
+        return true;
+    }
+
+    bool FloatSignAlias(const Instruction& instruction, std::string_view mnemonic) {
+        const auto& ops = instruction.operands;
+        if (ops[1] != ops[2]) {
+            return false;
+        }
+
+        // Keep the precision suffix of the original mnemonic (e.g. fsgnj.d -> fmv.d).
+        const auto original = GetMnemonic(instruction.opcode);
+        m_mnemonic = mnemonic;
+        m_mnemonic += original.substr(original.find('.'));
+
+        Operand(ops[0]);
+        Operand(ops[1]);
+        return true;
+    }
+
+    // Handles mask register aliases. `all_same` requires every operand to be the same
+    // register (e.g. vmclr.m vd), otherwise only the sources need to match (e.g. vmmv.m vd, vs).
+    bool VectorMaskAlias(const Instruction& instruction, std::string_view mnemonic, bool all_same) {
+        const auto& ops = instruction.operands;
+        if (ops[1] != ops[2] || (all_same && ops[0] != ops[1])) {
+            return false;
+        }
+
+        Alias(mnemonic);
+        Operand(ops[0]);
+        if (!all_same) {
+            Operand(ops[1]);
+        }
+        return true;
+    }
+
+    bool VectorUnaryAlias(const Instruction& instruction, std::string_view mnemonic, bool condition) {
+        if (!condition) {
+            return false;
+        }
+
+        const auto& ops = instruction.operands;
+        Alias(mnemonic);
+        Operand(ops[0]);
+        Operand(ops[1]);
+        Operand(ops[3]);
+        return true;
+    }
+
+    [[nodiscard]] static bool IsCompressedFormat(Opcode opcode) {
+        return GetOpcodeInfo(opcode).format >= Format::CNone;
+    }
+
+    uint64_t m_address;
+    const std::vector<uint64_t>* m_labels;
+    std::string m_mnemonic;
+    std::string m_operands;
+};
+
+// Determines the width of the address column, matching how objdump determines it:
+// leading zeros shared by all addresses are dropped in groups of four digits.
+[[nodiscard]] size_t GetAddressWidth(uint64_t end_address) {
+    const auto leading_zero_digits = static_cast<size_t>(std::countl_zero(end_address) / 4);
+    const auto skipped = leading_zero_digits == 0 ? 0 : (leading_zero_digits - 1) & ~size_t{3};
+    return 16 - skipped;
+}
+
+void AppendRawBytes(std::string& out, const uint8_t* bytes, size_t size) {
+    // objdump prints each instruction as a single little-endian value,
+    // padded as if 8 bytes of instructions were printed per line.
+    constexpr size_t bytes_per_line = 8;
+
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+        value |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+    }
+
+    AppendHex(out, value, size * 2);
+    out += ' ';
+
+    for (size_t printed = size; printed < bytes_per_line; printed += size) {
+        out.append(size * 2 + 1, ' ');
+    }
+}
+} // Anonymous namespace
+
+std::string Disassemble(std::span<const uint8_t> code, uint64_t base_address,
+                        const DisassemblerOptions& options) {
+    struct Entry {
+        uint64_t address;
+        size_t offset;
+        Instruction instruction;
+    };
+
+    // Decode everything first, so that labels can be placed before
+    // the instructions that are targeted by later branches.
+    std::vector<Entry> entries;
+    std::vector<uint64_t> labels;
+
+    size_t offset = 0;
+    while (offset < code.size()) {
+        Instruction instruction;
+        if (code.size() - offset >= 2) {
+            if (code.size() - offset >= 4 || (code[offset] & 0b11) != 0b11) {
+                instruction = Decode(code.data() + offset, options.features, options.decode_options);
+            } else {
+                instruction.size = 2;
+            }
+        }
+        // Trailing bytes that don't form a whole instruction.
+        if (instruction.size == 0 || instruction.size > code.size() - offset) {
+            instruction = {};
+            instruction.size = static_cast<uint8_t>(std::min<size_t>(code.size() - offset, 2));
+        }
+
+        const auto address = base_address + offset;
+        if (options.show_labels) {
+            for (const auto& operand : instruction.GetOperands()) {
+                if (operand.type != OperandType::PCOffset) {
+                    continue;
+                }
+
+                const auto target = address + static_cast<uint64_t>(static_cast<int64_t>(operand.value));
+                if (target >= base_address && target - base_address < code.size()) {
+                    labels.push_back(target);
+                }
+            }
+        }
+
+        entries.push_back({address, offset, instruction});
+        offset += instruction.size;
+    }
+
+    std::sort(labels.begin(), labels.end());
+    labels.erase(std::unique(labels.begin(), labels.end()), labels.end());
+
+    const auto address_width = GetAddressWidth(base_address + code.size());
+
+    std::string out;
+    auto next_label = labels.begin();
+
+    for (const auto& entry : entries) {
+        // Labels that point into the middle of an instruction are only used for annotations.
+        while (next_label != labels.end() && *next_label < entry.address) {
+            ++next_label;
+        }
+        if (next_label != labels.end() && *next_label == entry.address) {
+            if (!out.empty()) {
+                out += '\n';
+            }
+            AppendHex(out, entry.address, 16);
+            out += " <.L";
+            AppendDecimal(out, next_label - labels.begin());
+            out += ">:\n";
+        }
+
+        std::string address;
+        AppendHex(address, entry.address);
+        if (address.size() < address_width) {
+            out.append(address_width - address.size(), ' ');
+        }
+        out += address;
+        out += ":\t";
+
+        const auto& instruction = entry.instruction;
+        const auto* bytes = code.data() + entry.offset;
+
+        if (options.show_raw_bytes) {
+            AppendRawBytes(out, bytes, instruction.size);
+            out += '\t';
+        }
+
+        if (instruction.IsValid()) {
+            InstructionPrinter printer{entry.address, options.show_labels ? &labels : nullptr};
+            out += printer.Print(instruction, options.use_aliases);
+        } else if (instruction.size == 2 || instruction.size == 4) {
+            out += ".insn\t";
+            AppendDecimal(out, instruction.size);
+            out += ", 0x";
+
+            uint32_t value = 0;
+            for (size_t i = 0; i < instruction.size; i++) {
+                value |= static_cast<uint32_t>(bytes[i]) << (i * 8);
+            }
+            AppendHex(out, value, instruction.size * 2U);
+        } else {
+            out += ".byte\t";
+            for (size_t i = 0; i < instruction.size; i++) {
+                if (i != 0) {
+                    out += ", ";
+                }
+                out += "0x";
+                AppendHex(out, bytes[i], 2);
+            }
+        }
+
+        out += '\n';
+    }
+
+    return out;
+}
+
+std::string FormatInstruction(const Instruction& instruction, uint64_t address, bool use_aliases) {
+    BISCUIT_ASSERT(instruction.IsValid());
+
+    InstructionPrinter printer{address, nullptr};
+    return printer.Print(instruction, use_aliases);
+}
+
+} // namespace biscuit
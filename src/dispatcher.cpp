@@ -0,0 +1,157 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/dispatcher.hpp>
+#include <biscuit/icache.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace biscuit {
+namespace {
+// Arguments may also be passed in FPRs, which only exist with
+// hardware double-precision floating-point on RISC-V hosts.
+#if !defined(__riscv) || (defined(__riscv_flen) && __riscv_flen >= 64)
+constexpr bool stub_saves_fprs = true;
+#else
+constexpr bool stub_saves_fprs = false;
+#endif
+
+constexpr size_t stub_capacity = 256;
+
+// a0-a7, fa0-fa7 and ra, rounded up to keep SP 16-byte aligned.
+constexpr int32_t stub_frame_size = 144;
+constexpr int32_t stub_fpr_offset = 64;
+constexpr int32_t stub_ra_offset = 136;
+} // Anonymous namespace
+
+Dispatcher::Dispatcher(size_t capacity)
+    : m_assembler(capacity), m_stub_assembler(stub_capacity) {
+    EmitResolverStub();
+}
+
+Dispatcher::~Dispatcher() = default;
+
+void Dispatcher::AddVariant(const ExtensionSet& requirements, Generator generator,
+                            std::optional<int32_t> priority) {
+    BISCUIT_ASSERT(generator);
+
+    std::scoped_lock lock{m_mutex};
+    BISCUIT_ASSERT(!IsResolved());
+
+    Variant variant{
+        .requirements = requirements,
+        .generator = std::move(generator),
+        .priority = priority.value_or(static_cast<int32_t>(requirements.Count())),
+        .index = m_variants.size(),
+    };
+
+    // Keep variants ordered from most to least preferred, so that
+    // resolution only needs to find the first usable variant.
+    const auto iter = std::upper_bound(m_variants.begin(), m_variants.end(), variant,
+                                       [](const Variant& lhs, const Variant& rhs) {
+                                           return lhs.priority > rhs.priority;
+                                       });
+    m_variants.insert(iter, std::move(variant));
+}
+
+const void* Dispatcher::Resolve() {
+    return ResolveImpl([](const ExtensionSet& requirements) {
+        static const CPUInfo cpu_info;
+        return cpu_info.HasAll(requirements);
+    });
+}
+
+const void* Dispatcher::Resolve(const ExtensionSet& available) {
+    return ResolveImpl([&available](const ExtensionSet& requirements) {
+        return requirements.IsSubsetOf(available);
+    });
+}
+
+std::optional<size_t> Dispatcher::GetSelectedVariant() const {
+    std::scoped_lock lock{m_mutex};
+    return m_selected;
+}
+
+template <typename Predicate>
+const void* Dispatcher::ResolveImpl(Predicate&& is_available) {
+    // Fast path: A variant has already been generated and published.
+    if (const auto entry = m_slot.load(std::memory_order_acquire); entry != m_stub_entry) {
+        return reinterpret_cast<const void*>(entry);
+    }
+
+    std::scoped_lock lock{m_mutex};
+
+    // Another thread may have generated the variant while we were waiting.
+    if (const auto entry = m_slot.load(std::memory_order_relaxed); entry != m_stub_entry) {
+        return reinterpret_cast<const void*>(entry);
+    }
+
+    const auto iter = std::find_if(m_variants.begin(), m_variants.end(),
+                                   [&](const Variant& variant) {
+                                       return is_available(variant.requirements);
+                                   });
+    BISCUIT_ASSERT(iter != m_variants.end());
+
+    // Callers may enter the variant with any vector configuration.
+    auto* const entry = m_assembler.GetCursorPointer();
+    m_assembler.InvalidateVectorConfig();
+    iter->generator(m_assembler);
+
+    auto& buffer = m_assembler.GetCodeBuffer();
+    BISCUIT_ASSERT(buffer.GetCursorPointer() != entry);
+
+#ifdef BISCUIT_CODE_BUFFER_MMAP
+    buffer.SetExecutable();
+#endif
+    PublishCode(entry, static_cast<size_t>(buffer.GetCursorPointer() - entry));
+
+    m_selected = iter->index;
+    m_slot.store(reinterpret_cast<uintptr_t>(entry), std::memory_order_release);
+    return entry;
+}
+
+void Dispatcher::EmitResolverStub() {
+    auto& as = m_stub_assembler;
+    auto* const entry = as.GetCursorPointer();
+
+    // Preserve the arguments for the variant, as well as the return address of the caller.
+    as.ADDI(sp, sp, -stub_frame_size);
+    as.SD(ra, stub_ra_offset, sp);
+    for (uint32_t i = 0; i < 8; i++) {
+        const auto offset = static_cast<int32_t>(i * 8);
+        as.SD(GPR{a0.Index() + i}, offset, sp);
+        if constexpr (stub_saves_fprs) {
+            as.FSD(FPR{fa0.Index() + i}, stub_fpr_offset + offset, sp);
+        }
+    }
+
+    as.LI(a0, reinterpret_cast<uintptr_t>(this));
+    as.LI(t0, reinterpret_cast<uintptr_t>(&Dispatcher::ResolveFromStub));
+    as.JALR(t0);
+    as.MV(t0, a0);
+
+    for (uint32_t i = 0; i < 8; i++) {
+        const auto offset = static_cast<int32_t>(i * 8);
+        as.LD(GPR{a0.Index() + i}, offset, sp);
+        if constexpr (stub_saves_fprs) {
+            as.FLD(FPR{fa0.Index() + i}, stub_fpr_offset + offset, sp);
+        }
+    }
+    as.LD(ra, stub_ra_offset, sp);
+    as.ADDI(sp, sp, stub_frame_size);
+    as.JR(t0);
+
+    auto& buffer = as.GetCodeBuffer();
+#ifdef BISCUIT_CODE_BUFFER_MMAP
+    buffer.SetExecutable();
+#endif
+    PublishCode(entry, static_cast<size_t>(buffer.GetCursorPointer() - entry));
+
+    m_stub_entry = reinterpret_cast<uintptr_t>(entry);
+    m_slot.store(m_stub_entry, std::memory_order_release);
+}
+
+const void* Dispatcher::ResolveFromStub(Dispatcher* dispatcher) {
+    return dispatcher->Resolve();
+}
+
+} // namespace biscuit
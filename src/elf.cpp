@@ -0,0 +1,200 @@
+#include <biscuit/assert.hpp>
+
+#include <cstring>
+#include <utility>
+
+#include "elf.hpp"
+
+namespace biscuit::elf {
+namespace {
+[[nodiscard]] size_t AlignUp(size_t value, uint64_t alignment) {
+    const auto align = static_cast<size_t>(alignment == 0 ? 1 : alignment);
+    return (value + align - 1) & ~(align - 1);
+}
+
+template <typename T>
+void WriteAt(std::vector<uint8_t>& out, size_t offset, const T& value) {
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+} // Anonymous namespace
+
+uint32_t GetHostFlags() noexcept {
+    uint32_t flags = 0;
+#if defined(__riscv)
+#if defined(__riscv_compressed)
+    flags |= EF_RISCV_RVC;
+#endif
+#if defined(__riscv_float_abi_quad)
+    flags |= EF_RISCV_FLOAT_ABI_QUAD;
+#elif defined(__riscv_float_abi_double)
+    flags |= EF_RISCV_FLOAT_ABI_DOUBLE;
+#elif defined(__riscv_float_abi_single)
+    flags |= EF_RISCV_FLOAT_ABI_SINGLE;
+#else
+    flags |= EF_RISCV_FLOAT_ABI_SOFT;
+#endif
+#endif
+    return flags;
+}
+
+StringTable::StringTable() : m_data{0} {}
+
+uint32_t StringTable::Add(std::string_view string) {
+    if (string.empty()) {
+        return 0;
+    }
+
+    // Look for an existing copy of the string (including as the suffix of another string).
+    const std::string_view existing{reinterpret_cast<const char*>(m_data.data()), m_data.size()};
+    std::string needle{string};
+    needle += '\0';
+    if (const auto offset = existing.find(needle); offset != std::string_view::npos) {
+        return static_cast<uint32_t>(offset);
+    }
+
+    const auto offset = static_cast<uint32_t>(m_data.size());
+    m_data.insert(m_data.end(), needle.begin(), needle.end());
+    return offset;
+}
+
+SymbolTable::SymbolTable() : m_symbols(1) {}
+
+uint32_t SymbolTable::Add(std::string_view name, uint8_t info, uint16_t section, uint64_t value,
+                          uint64_t size) {
+    const bool is_local = (info >> 4) == STB_LOCAL;
+    BISCUIT_ASSERT(!is_local || m_first_global == m_symbols.size());
+
+    const auto index = static_cast<uint32_t>(m_symbols.size());
+    m_symbols.push_back({
+        .st_name = m_strings.Add(name),
+        .st_info = info,
+        .st_other = 0,
+        .st_shndx = section,
+        .st_value = value,
+        .st_size = size,
+    });
+
+    if (is_local) {
+        m_first_global = index + 1;
+    }
+    return index;
+}
+
+std::vector<uint8_t> SymbolTable::GetData() const {
+    std::vector<uint8_t> data(m_symbols.size() * sizeof(Elf64_Sym));
+    std::memcpy(data.data(), m_symbols.data(), data.size());
+    return data;
+}
+
+ImageBuilder::ImageBuilder(uint16_t type, uint32_t flags)
+    : m_type{type}, m_flags{flags}, m_sections(1) {}
+
+uint16_t ImageBuilder::AddSection(Section section) {
+    // The last index is reserved for the section header string table.
+    BISCUIT_ASSERT(m_sections.size() < SHN_ABS - 1);
+
+    const auto index = static_cast<uint16_t>(m_sections.size());
+    m_sections.push_back(std::move(section));
+    return index;
+}
+
+std::vector<uint8_t> ImageBuilder::Build() const {
+    StringTable section_names;
+    std::vector<uint32_t> name_offsets;
+    name_offsets.reserve(m_sections.size() + 1);
+    for (const auto& section : m_sections) {
+        name_offsets.push_back(section_names.Add(section.name));
+    }
+    name_offsets.push_back(section_names.Add(".shstrtab"));
+
+    // Lay out the contents of every section after the header,
+    // followed by the section header string table and the section headers.
+    std::vector<size_t> data_offsets;
+    data_offsets.reserve(m_sections.size());
+
+    size_t offset = sizeof(Elf64_Ehdr);
+    for (const auto& section : m_sections) {
+        offset = AlignUp(offset, section.alignment);
+        data_offsets.push_back(offset);
+        if (section.type != SHT_NOBITS) {
+            offset += section.data.size();
+        }
+    }
+
+    const auto shstrtab_offset = offset;
+    offset += section_names.GetData().size();
+
+    const auto headers_offset = AlignUp(offset, 8);
+    const auto num_sections = m_sections.size() + 1;
+
+    std::vector<uint8_t> image(headers_offset + num_sections * sizeof(Elf64_Shdr));
+
+    Elf64_Ehdr header{};
+    header.e_ident[0] = 0x7F;
+    header.e_ident[1] = 'E';
+    header.e_ident[2] = 'L';
+    header.e_ident[3] = 'F';
+    header.e_ident[4] = ELFCLASS64;
+    header.e_ident[5] = ELFDATA2LSB;
+    header.e_ident[6] = EV_CURRENT;
+    header.e_ident[7] = ELFOSABI_NONE;
+    header.e_type = m_type;
+    header.e_machine = EM_RISCV;
+    header.e_version = EV_CURRENT;
+    header.e_shoff = headers_offset;
+    header.e_flags = m_flags;
+    header.e_ehsize = sizeof(Elf64_Ehdr);
+    header.e_shentsize = sizeof(Elf64_Shdr);
+    header.e_shnum = static_cast<uint16_t>(num_sections);
+    header.e_shstrndx = static_cast<uint16_t>(m_sections.size());
+    WriteAt(image, 0, header);
+
+    for (size_t i = 0; i < m_sections.size(); i++) {
+        const auto& section = m_sections[i];
+        const bool has_data = section.type != SHT_NOBITS;
+
+        if (has_data && !section.data.empty()) {
+            std::memcpy(image.data() + data_offsets[i], section.data.data(), section.data.size());
+        }
+
+        // The null section is entirely zero.
+        if (i == 0) {
+            continue;
+        }
+
+        const Elf64_Shdr section_header{
+            .sh_name = name_offsets[i],
+            .sh_type = section.type,
+            .sh_flags = section.flags,
+            .sh_addr = section.address,
+            .sh_offset = data_offsets[i],
+            .sh_size = has_data ? section.data.size() : section.nobits_size,
+            .sh_link = section.link,
+            .sh_info = section.info,
+            .sh_addralign = section.alignment,
+            .sh_entsize = section.entry_size,
+        };
+        WriteAt(image, headers_offset + i * sizeof(Elf64_Shdr), section_header);
+    }
+
+    const auto& names = section_names.GetData();
+    std::memcpy(image.data() + shstrtab_offset, names.data(), names.size());
+
+    const Elf64_Shdr shstrtab_header{
+        .sh_name = name_offsets.back(),
+        .sh_type = SHT_STRTAB,
+        .sh_flags = 0,
+        .sh_addr = 0,
+        .sh_offset = shstrtab_offset,
+        .sh_size = names.size(),
+        .sh_link = 0,
+        .sh_info = 0,
+        .sh_addralign = 1,
+        .sh_entsize = 0,
+    };
+    WriteAt(image, headers_offset + m_sections.size() * sizeof(Elf64_Shdr), shstrtab_header);
+
+    return image;
+}
+
+} // namespace biscuit::elf
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Internal header for building ELF64 images.
+
+namespace biscuit::elf {
+
+// Identification
+constexpr uint8_t ELFCLASS64 = 2;
+constexpr uint8_t ELFDATA2LSB = 1;
+constexpr uint8_t EV_CURRENT = 1;
+constexpr uint8_t ELFOSABI_NONE = 0;
+
+// Object file types
+constexpr uint16_t ET_REL = 1;
+constexpr uint16_t ET_EXEC = 2;
+
+// Machine
+constexpr uint16_t EM_RISCV = 243;
+
+// RISC-V specific header flags
+constexpr uint32_t EF_RISCV_RVC = 0x0001;
+constexpr uint32_t EF_RISCV_FLOAT_ABI_SOFT = 0x0000;
+constexpr uint32_t EF_RISCV_FLOAT_ABI_SINGLE = 0x0002;
+constexpr uint32_t EF_RISCV_FLOAT_ABI_DOUBLE = 0x0004;
+constexpr uint32_t EF_RISCV_FLOAT_ABI_QUAD = 0x0006;
+
+// Special section indices
+constexpr uint16_t SHN_UNDEF = 0;
+constexpr uint16_t SHN_ABS = 0xFFF1;
+
+// Section types
+constexpr uint32_t SHT_NULL = 0;
+constexpr uint32_t SHT_PROGBITS = 1;
+constexpr uint32_t SHT_SYMTAB = 2;
+constexpr uint32_t SHT_STRTAB = 3;
+constexpr uint32_t SHT_RELA = 4;
+constexpr uint32_t SHT_NOBITS = 8;
+
+// Section flags
+constexpr uint64_t SHF_WRITE = 0x1;
+constexpr uint64_t SHF_ALLOC = 0x2;
+constexpr uint64_t SHF_EXECINSTR = 0x4;
+constexpr uint64_t SHF_INFO_LINK = 0x40;
+
+// Symbol bindings and types
+constexpr uint8_t STB_LOCAL = 0;
+constexpr uint8_t STB_GLOBAL = 1;
+constexpr uint8_t STT_NOTYPE = 0;
+constexpr uint8_t STT_OBJECT = 1;
+constexpr uint8_t STT_FUNC = 2;
+constexpr uint8_t STT_SECTION = 3;
+
+[[nodiscard]] constexpr uint8_t MakeSymbolInfo(uint8_t binding, uint8_t type) {
+    return static_cast<uint8_t>((binding << 4) | (type & 0xF));
+}
+
+[[nodiscard]] constexpr uint64_t MakeRelocationInfo(uint32_t symbol, uint32_t type) {
+    return (static_cast<uint64_t>(symbol) << 32) | type;
+}
+
+struct Elf64_Ehdr {
+    uint8_t e_ident[16];
+    uint16_t e_type;
+    uint16_t e_machine;
+    uint32_t e_version;
+    uint64_t e_entry;
+    uint64_t e_phoff;
+    uint64_t e_shoff;
+    uint32_t e_flags;
+    uint16_t e_ehsize;
+    uint16_t e_phentsize;
+    uint16_t e_phnum;
+    uint16_t e_shentsize;
+    uint16_t e_shnum;
+    uint16_t e_shstrndx;
+};
+static_assert(sizeof(Elf64_Ehdr) == 64);
+
+struct Elf64_Shdr {
+    uint32_t sh_name;
+    uint32_t sh_type;
+    uint64_t sh_flags;
+    uint64_t sh_addr;
+    uint64_t sh_offset;
+    uint64_t sh_size;
+    uint32_t sh_link;
+    uint32_t sh_info;
+    uint64_t sh_addralign;
+    uint64_t sh_entsize;
+};
+static_assert(sizeof(Elf64_Shdr) == 64);
+
+struct Elf64_Sym {
+    uint32_t st_name;
+    uint8_t st_info;
+    uint8_t st_other;
+    uint16_t st_shndx;
+    uint64_t st_value;
+    uint64_t st_size;
+};
+static_assert(sizeof(Elf64_Sym) == 24);
+
+struct Elf64_Rela {
+    uint64_t r_offset;
+    uint64_t r_info;
+    int64_t r_addend;
+};
+static_assert(sizeof(Elf64_Rela) == 24);
+
+// Retrieves the RISC-V header flags that describe the ABI of the host, or zero
+// if the host isn't RISC-V.
+[[nodiscard]] uint32_t GetHostFlags() noexcept;
+
+// A string table, such as .strtab or .shstrtab.
+class StringTable {
+public:
+    StringTable();
+
+    // Adds a string to the table, returning its offset.
+    // Strings that were previously added are reused.
+    uint32_t Add(std::string_view string);
+
+    [[nodiscard]] const std::vector<uint8_t>& GetData() const noexcept {
+        return m_data;
+    }
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+// A symbol table along with its string table.
+class SymbolTable {
+public:
+    SymbolTable();
+
+    // Adds a symbol, returning its index.
+    //
+    // All local symbols must be added before any global symbol.
+    uint32_t Add(std::string_view name, uint8_t info, uint16_t section, uint64_t value, uint64_t size);
+
+    // The index of the first non-local symbol (which is used as the sh_info of the table).
+    [[nodiscard]] uint32_t GetFirstGlobalIndex() const noexcept {
+        return m_first_global;
+    }
+
+    [[nodiscard]] std::vector<uint8_t> GetData() const;
+
+    [[nodiscard]] const StringTable& GetStrings() const noexcept {
+        return m_strings;
+    }
+
+private:
+    std::vector<Elf64_Sym> m_symbols;
+    StringTable m_strings;
+    uint32_t m_first_global = 1;
+};
+
+// Describes a single section of an image.
+struct Section {
+    std::string name;
+    uint32_t type = SHT_NULL;
+    uint64_t flags = 0;
+    uint64_t address = 0;
+    uint32_t link = 0;
+    uint32_t info = 0;
+    uint64_t alignment = 1;
+    uint64_t entry_size = 0;
+
+    // Contents of the section. Ignored for SHT_NOBITS sections.
+    std::vector<uint8_t> data;
+
+    // The size of an SHT_NOBITS section.
+    uint64_t nobits_size = 0;
+};
+
+// Lays out sections into an ELF64 image without program headers.
+class ImageBuilder {
+public:
+    ImageBuilder(uint16_t type, uint32_t flags);
+
+    // Adds a section to the image, returning its index.
+    uint16_t AddSection(Section section);
+
+    // Retrieves the index that the next added section will receive.
+    [[nodiscard]] uint16_t GetNextSectionIndex() const noexcept {
+        return static_cast<uint16_t>(m_sections.size());
+    }
+
+    // Builds the image. A section header string table is automatically added.
+    [[nodiscard]] std::vector<uint8_t> Build() const;
+
+private:
+    uint16_t m_type;
+    uint32_t m_flags;
+    std::vector<Section> m_sections;
+};
+
+} // namespace biscuit::elf
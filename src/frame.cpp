@@ -0,0 +1,292 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/frame.hpp>
+
+#include <algorithm>
+#include <bit>
+
+#include "assembler_util.hpp"
+
+namespace biscuit {
+namespace {
+// The largest frame that is allocated with a single adjustment, so that every saved register
+// can still be reached with the 12-bit offsets of loads and stores. This is the largest multiple
+// of 16 that ADDI can add back to SP in the epilogue.
+constexpr uint32_t max_single_adjustment = 2032;
+
+// The largest additional adjustment CM.PUSH and CM.POP can make past their base adjustment.
+constexpr uint32_t max_push_pop_extra = 48;
+
+constexpr uint32_t fpr_slot_size = 8;
+
+// ra and s0-s11
+constexpr uint32_t saveable_gprs = (1U << 1) | (1U << 8) | (1U << 9) | (0x3FFU << 18);
+
+// fs0-fs11
+constexpr uint32_t saveable_fprs = (1U << 8) | (1U << 9) | (0x3FFU << 18);
+
+[[nodiscard]] constexpr uint32_t AlignUp16(uint32_t value) noexcept {
+    return (value + 15) & ~15U;
+}
+} // Anonymous namespace
+
+FrameBuilder::FrameBuilder(Assembler& assembler, const ExtensionSet& extensions) noexcept
+    : m_assembler{assembler}, m_extensions{extensions} {
+    // Zcmp reuses the encodings of Zcd, so the two can't be enabled at once.
+    BISCUIT_ASSERT(!m_extensions.Has(RISCVExtension::Zcmp) || !m_extensions.Has(RISCVExtension::Zcd));
+}
+
+void FrameBuilder::SaveRegister(GPR reg) {
+    const auto bit = 1U << reg.Index();
+    BISCUIT_ASSERT((saveable_gprs & bit) != 0);
+    m_saved_gprs |= bit;
+}
+
+void FrameBuilder::SaveRegister(FPR reg) {
+    const auto bit = 1U << reg.Index();
+    BISCUIT_ASSERT((saveable_fprs & bit) != 0);
+    m_saved_fprs |= bit;
+}
+
+void FrameBuilder::SaveRegisters(std::span<const GPR> regs) {
+    for (const auto reg : regs) {
+        SaveRegister(reg);
+    }
+}
+
+void FrameBuilder::SaveRegisters(std::span<const FPR> regs) {
+    for (const auto reg : regs) {
+        SaveRegister(reg);
+    }
+}
+
+uint32_t FrameBuilder::GetFrameSize() const noexcept {
+    return AlignUp16(GetGPRSaveAreaSize() + GetFPRSaveAreaSize() + m_locals_size);
+}
+
+void FrameBuilder::EmitPrologue() {
+    BISCUIT_ASSERT(IsRV32OrRV64(m_assembler.GetArchFeatures()));
+
+    const auto first = GetFirstAdjustment();
+
+    if (UsesPushPop()) {
+        const auto push_adj = GetPushPopStackAdjustment();
+        m_assembler.CM_PUSH(GetPushPopList(), -static_cast<int32_t>(push_adj));
+        AdjustStack(-static_cast<int32_t>(first - push_adj));
+    } else {
+        AdjustStack(-static_cast<int32_t>(first));
+    }
+
+    TransferRegisters(first, true);
+    AdjustStack(-static_cast<int32_t>(GetFrameSize() - first));
+}
+
+void FrameBuilder::EmitEpilogue(FrameExit exit) {
+    BISCUIT_ASSERT(IsRV32OrRV64(m_assembler.GetArchFeatures()));
+
+    const auto first = GetFirstAdjustment();
+
+    AdjustStack(static_cast<int32_t>(GetFrameSize() - first));
+    TransferRegisters(first, false);
+
+    if (UsesPushPop()) {
+        const auto pop_adj = GetPushPopStackAdjustment();
+        AdjustStack(static_cast<int32_t>(first - pop_adj));
+
+        const auto list = GetPushPopList();
+        const auto stack_adj = static_cast<int32_t>(pop_adj);
+        switch (exit) {
+        case FrameExit::Return:
+            m_assembler.CM_POPRET(list, stack_adj);
+            break;
+        case FrameExit::ReturnZero:
+            m_assembler.CM_POPRETZ(list, stack_adj);
+            break;
+        case FrameExit::Restore:
+            m_assembler.CM_POP(list, stack_adj);
+            break;
+        }
+        return;
+    }
+
+    AdjustStack(static_cast<int32_t>(first));
+
+    if (exit == FrameExit::Restore) {
+        return;
+    }
+    if (exit == FrameExit::ReturnZero) {
+        if (HasZca()) {
+            m_assembler.C_LI(a0, 0);
+        } else {
+            m_assembler.LI(a0, 0);
+        }
+    }
+    if (HasZca()) {
+        m_assembler.C_JR(ra);
+    } else {
+        m_assembler.RET();
+    }
+}
+
+bool FrameBuilder::HasZca() const noexcept {
+    // Zcmp depends on Zca, so it being available implies Zca is as well.
+    return m_extensions.Has(RISCVExtension::Zca) || m_extensions.Has(RISCVExtension::C) ||
+           m_extensions.Has(RISCVExtension::Zcmp);
+}
+
+bool FrameBuilder::HasZcd() const noexcept {
+    return m_extensions.Has(RISCVExtension::Zcd) ||
+           (m_extensions.Has(RISCVExtension::C) && m_extensions.Has(RISCVExtension::D) &&
+            !m_extensions.Has(RISCVExtension::Zcmp));
+}
+
+bool FrameBuilder::UsesPushPop() const noexcept {
+    return m_extensions.Has(RISCVExtension::Zcmp) && m_saved_gprs != 0;
+}
+
+uint32_t FrameBuilder::GetGPRSize() const noexcept {
+    return IsRV32(m_assembler.GetArchFeatures()) ? 4 : 8;
+}
+
+uint32_t FrameBuilder::GetGPRSaveAreaSize() const noexcept {
+    if (UsesPushPop()) {
+        const auto bitmask = GetPushPopList().GetBitmask();
+        return IsRV32(m_assembler.GetArchFeatures()) ? stack_adj_bases_rv32[bitmask]
+                                                     : stack_adj_bases_rv64[bitmask];
+    }
+
+    // FPRs are saved as 64-bit values right below the GPRs, so keep them 8-byte aligned on RV32.
+    const auto size = static_cast<uint32_t>(std::popcount(m_saved_gprs)) * GetGPRSize();
+    return m_saved_fprs != 0 ? (size + 7) & ~7U : size;
+}
+
+uint32_t FrameBuilder::GetFPRSaveAreaSize() const noexcept {
+    return static_cast<uint32_t>(std::popcount(m_saved_fprs)) * fpr_slot_size;
+}
+
+uint32_t FrameBuilder::GetFirstAdjustment() const noexcept {
+    const auto frame_size = GetFrameSize();
+    if (frame_size <= max_single_adjustment) {
+        return frame_size;
+    }
+    return AlignUp16(GetGPRSaveAreaSize() + GetFPRSaveAreaSize());
+}
+
+PushPopList FrameBuilder::GetPushPopList() const noexcept {
+    const auto saved_s_registers = m_saved_gprs & ~(1U << ra.Index());
+    if (saved_s_registers == 0) {
+        return {ra};
+    }
+
+    const auto last = GPR{31U - static_cast<uint32_t>(std::countl_zero(saved_s_registers))};
+    if (last == s0) {
+        return {ra, {s0}};
+    }
+
+    // s10 can only be saved along with s11.
+    return {ra, {s0, last == s10 ? s11 : last}};
+}
+
+uint32_t FrameBuilder::GetPushPopStackAdjustment() const noexcept {
+    const auto base = GetGPRSaveAreaSize();
+    return base + std::min(GetFirstAdjustment() - base, max_push_pop_extra);
+}
+
+void FrameBuilder::AdjustStack(int32_t amount) {
+    if (amount == 0) {
+        return;
+    }
+
+    if (HasZca() && amount % 16 == 0 && amount >= -512 && amount <= 496) {
+        m_assembler.C_ADDI16SP(amount);
+    } else if (amount >= -2048 && amount <= 2047) {
+        m_assembler.ADDI(sp, sp, amount);
+    } else if (amount < 0) {
+        m_assembler.LI(t0, static_cast<uint64_t>(-static_cast<int64_t>(amount)));
+        m_assembler.SUB(sp, sp, t0);
+    } else {
+        m_assembler.LI(t0, static_cast<uint64_t>(amount));
+        m_assembler.ADD(sp, sp, t0);
+    }
+}
+
+void FrameBuilder::TransferRegisters(uint32_t frame_top, bool is_save) {
+    const auto gpr_size = GetGPRSize();
+
+    // CM.PUSH and CM.POP already take care of the GPRs.
+    if (!UsesPushPop()) {
+        uint32_t offset = frame_top;
+        for (uint32_t i = 0; i < 32; i++) {
+            if ((m_saved_gprs & (1U << i)) == 0) {
+                continue;
+            }
+
+            offset -= gpr_size;
+            const GPR reg{i};
+            if (is_save) {
+                SaveGPR(reg, offset);
+            } else {
+                RestoreGPR(reg, offset);
+            }
+        }
+    }
+
+    uint32_t offset = frame_top - GetGPRSaveAreaSize();
+    for (uint32_t i = 0; i < 32; i++) {
+        if ((m_saved_fprs & (1U << i)) == 0) {
+            continue;
+        }
+
+        offset -= fpr_slot_size;
+        const FPR reg{i};
+        const auto is_compressed = HasZcd() && offset <= 504;
+        if (is_save) {
+            if (is_compressed) {
+                m_assembler.C_FSDSP(reg, offset);
+            } else {
+                m_assembler.FSD(reg, static_cast<int32_t>(offset), sp);
+            }
+        } else {
+            if (is_compressed) {
+                m_assembler.C_FLDSP(reg, offset);
+            } else {
+                m_assembler.FLD(reg, static_cast<int32_t>(offset), sp);
+            }
+        }
+    }
+}
+
+void FrameBuilder::SaveGPR(GPR reg, uint32_t offset) {
+    const auto imm = static_cast<int32_t>(offset);
+    if (IsRV32(m_assembler.GetArchFeatures())) {
+        if (HasZca() && offset <= 252) {
+            m_assembler.C_SWSP(reg, offset);
+        } else {
+            m_assembler.SW(reg, imm, sp);
+        }
+    } else {
+        if (HasZca() && offset <= 504) {
+            m_assembler.C_SDSP(reg, offset);
+        } else {
+            m_assembler.SD(reg, imm, sp);
+        }
+    }
+}
+
+void FrameBuilder::RestoreGPR(GPR reg, uint32_t offset) {
+    const auto imm = static_cast<int32_t>(offset);
+    if (IsRV32(m_assembler.GetArchFeatures())) {
+        if (HasZca() && offset <= 252) {
+            m_assembler.C_LWSP(reg, offset);
+        } else {
+            m_assembler.LW(reg, imm, sp);
+        }
+    } else {
+        if (HasZca() && offset <= 504) {
+            m_assembler.C_LDSP(reg, offset);
+        } else {
+            m_assembler.LD(reg, imm, sp);
+        }
+    }
+}
+
+} // namespace biscuit
@@ -0,0 +1,175 @@
+#include <biscuit/assembler.hpp>
+#include <biscuit/assert.hpp>
+#include <biscuit/decoder.hpp>
+#include <biscuit/fusion.hpp>
+
+#include <cstdint>
+
+#include "assembler_util.hpp"
+
+namespace biscuit {
+namespace {
+[[nodiscard]] bool IsIntegerLoad(Opcode opcode) noexcept {
+    switch (opcode) {
+    case Opcode::LB:
+    case Opcode::LBU:
+    case Opcode::LD:
+    case Opcode::LH:
+    case Opcode::LHU:
+    case Opcode::LW:
+    case Opcode::LWU:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Whether or not an instruction with the operands (rd, rs, ...) overwrites
+// the given register with a value computed from it.
+[[nodiscard]] bool IsChainedOp(const Instruction& instruction, GPR reg) noexcept {
+    return instruction.GetGPR(0) == reg && instruction.GetGPR(1) == reg;
+}
+
+// Whether or not a load or JALR, which have the operands (rd, imm, rs),
+// overwrites the given register with a value computed from it.
+[[nodiscard]] bool IsChainedMemoryOp(const Instruction& instruction, GPR reg) noexcept {
+    return instruction.GetGPR(0) == reg && instruction.GetGPR(2) == reg;
+}
+} // Anonymous namespace
+
+FusionProfile GetFusiblePair(const Instruction& first, const Instruction& second) noexcept {
+    switch (first.opcode) {
+    case Opcode::LUI:
+    case Opcode::AUIPC:
+    case Opcode::SLLI:
+    case Opcode::ADD:
+        break;
+    default:
+        return FusionProfile::None;
+    }
+
+    // The pair has to write a single register, so writing the zero register can't be fused.
+    const auto rd = first.GetGPR(0);
+    if (rd == zero) {
+        return FusionProfile::None;
+    }
+
+    const auto second_opcode = second.opcode;
+
+    switch (first.opcode) {
+    case Opcode::LUI:
+        if ((second_opcode == Opcode::ADDI || second_opcode == Opcode::ADDIW) && IsChainedOp(second, rd)) {
+            return FusionProfile::LuiAddi;
+        }
+        break;
+    case Opcode::AUIPC:
+        if (second_opcode == Opcode::ADDI && IsChainedOp(second, rd)) {
+            return FusionProfile::AuipcAddi;
+        }
+        if (second_opcode == Opcode::JALR && IsChainedMemoryOp(second, rd)) {
+            return FusionProfile::AuipcJalr;
+        }
+        if (IsIntegerLoad(second_opcode) && IsChainedMemoryOp(second, rd)) {
+            return FusionProfile::AuipcLoad;
+        }
+        break;
+    case Opcode::SLLI:
+        if (second_opcode == Opcode::SRLI && IsChainedOp(second, rd) && first.GetValue(2) == second.GetValue(2)) {
+            return FusionProfile::ZeroExtend;
+        }
+        break;
+    case Opcode::ADD:
+        if (IsIntegerLoad(second_opcode) && IsChainedMemoryOp(second, rd) && second.GetValue(1) == 0) {
+            return FusionProfile::IndexedLoad;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return FusionProfile::None;
+}
+
+bool IsFusedPair(FusionProfile profile, const Instruction& first, const Instruction& second) noexcept {
+    const auto pair = GetFusiblePair(first, second);
+    return pair != FusionProfile::None && (profile & pair) == pair;
+}
+
+void Assembler::LoadAddress(GPR rd, uint64_t address) noexcept {
+    BISCUIT_ASSERT(rd != zero);
+
+    // LI materializes these with at most a LUI+ADDI(W) pair.
+    const auto is_32bit = static_cast<uint64_t>(static_cast<int64_t>(address << 32) >> 32) == address;
+    if (IsRV32(m_features) || is_32bit) {
+        LI(rd, address);
+        return;
+    }
+
+    const auto distance = static_cast<int64_t>(address - m_buffer.GetCursorAddress());
+
+    // The sign-extended lower 12 bits are compensated for by rounding the upper 20 bits.
+    const auto rounded = distance + 0x800;
+    if (rounded < INT32_MIN || rounded > INT32_MAX) {
+        LI(rd, address);
+        return;
+    }
+
+    const auto hi20 = static_cast<uint32_t>(rounded) >> 12 & 0xFFFFF;
+    const auto lo12 = static_cast<int32_t>(static_cast<uint32_t>(distance) << 20) >> 20;
+
+    EmitPair(FusionProfile::AuipcAddi, [&] {
+        AUIPC(rd, hi20);
+        ADDI(rd, rd, lo12);
+    });
+}
+
+void Assembler::LoadIndexed(GPR rd, GPR base, GPR index, LoadWidth width) noexcept {
+    BISCUIT_ASSERT(rd != zero);
+
+    EmitPair(FusionProfile::IndexedLoad, [&] {
+        ADD(rd, base, index);
+
+        switch (width) {
+        case LoadWidth::Byte:
+            LB(rd, 0, rd);
+            break;
+        case LoadWidth::ByteUnsigned:
+            LBU(rd, 0, rd);
+            break;
+        case LoadWidth::Half:
+            LH(rd, 0, rd);
+            break;
+        case LoadWidth::HalfUnsigned:
+            LHU(rd, 0, rd);
+            break;
+        case LoadWidth::Word:
+            LW(rd, 0, rd);
+            break;
+        case LoadWidth::WordUnsigned:
+            LWU(rd, 0, rd);
+            break;
+        case LoadWidth::Doubleword:
+            LD(rd, 0, rd);
+            break;
+        }
+    });
+}
+
+void Assembler::ZeroExtend(GPR rd, GPR rs, uint32_t bits) noexcept {
+    const auto xlen = IsRV32(m_features) ? 32U : 64U;
+    BISCUIT_ASSERT(bits >= 1 && bits < xlen);
+
+    // Masks of up to 11 bits are positive 12-bit immediates.
+    if (bits <= 11) {
+        ANDI(rd, rs, (1U << bits) - 1);
+        return;
+    }
+
+    const auto shift = xlen - bits;
+    EmitPair(FusionProfile::ZeroExtend, [&] {
+        SLLI(rd, rs, shift);
+        SRLI(rd, rd, shift);
+    });
+}
+
+} // namespace biscuit
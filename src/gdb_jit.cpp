@@ -0,0 +1,197 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/gdb_jit.hpp>
+
+#include <algorithm>
+#include <utility>
+
+#include "elf.hpp"
+
+// Definitions of the interface that debuggers use to find generated code.
+// See the "JIT Compilation Interface" section of the GDB manual.
+//
+// These must have exactly these names and layouts. They're defined as weak symbols
+// so that they may coexist with other JIT compilers within the same process that
+// also define them (e.g. LLVM), in which case a single definition is shared by all.
+
+extern "C" {
+enum jit_actions_t : uint32_t {
+    JIT_NOACTION = 0,
+    JIT_REGISTER_FN,
+    JIT_UNREGISTER_FN,
+};
+
+struct jit_code_entry {
+    jit_code_entry* next_entry;
+    jit_code_entry* prev_entry;
+    const char* symfile_addr;
+    uint64_t symfile_size;
+};
+
+struct jit_descriptor {
+    uint32_t version;
+    uint32_t action_flag;
+    jit_code_entry* relevant_entry;
+    jit_code_entry* first_entry;
+};
+
+#if defined(__GNUC__)
+#define BISCUIT_GDB_JIT_SYMBOL __attribute__((weak, used, visibility("default")))
+#define BISCUIT_GDB_JIT_NOINLINE __attribute__((noinline))
+#else
+#define BISCUIT_GDB_JIT_SYMBOL
+#define BISCUIT_GDB_JIT_NOINLINE
+#endif
+
+// Debuggers place a breakpoint on this function in order to be notified about changes.
+BISCUIT_GDB_JIT_SYMBOL BISCUIT_GDB_JIT_NOINLINE void __jit_debug_register_code() {
+#if defined(__GNUC__)
+    // Prevents the call from being optimized away.
+    __asm__ volatile("" ::: "memory");
+#endif
+}
+
+BISCUIT_GDB_JIT_SYMBOL jit_descriptor __jit_debug_descriptor = {1, JIT_NOACTION, nullptr, nullptr};
+}
+
+namespace biscuit {
+namespace {
+// Guards the descriptor, which is shared by all registries.
+std::mutex& GetDescriptorMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Builds an image that describes a single function. The code itself isn't
+// contained in the image, since the debugger can read it from memory.
+std::vector<uint8_t> BuildImage(std::string_view name, uintptr_t address, size_t size) {
+    elf::ImageBuilder builder{elf::ET_REL, elf::GetHostFlags()};
+
+    const auto text_index = builder.AddSection({
+        .name = ".text",
+        .type = elf::SHT_NOBITS,
+        .flags = elf::SHF_ALLOC | elf::SHF_EXECINSTR,
+        .address = address,
+        .alignment = 2,
+        .data = {},
+        .nobits_size = size,
+    });
+
+    // Symbols of relocatable images are relative to their section, which
+    // is placed at the address of the code, so the function starts at offset 0.
+    elf::SymbolTable symbols;
+    symbols.Add(name, elf::MakeSymbolInfo(elf::STB_GLOBAL, elf::STT_FUNC), text_index, 0, size);
+
+    const auto strtab_index = static_cast<uint16_t>(builder.GetNextSectionIndex() + 1);
+    builder.AddSection({
+        .name = ".symtab",
+        .type = elf::SHT_SYMTAB,
+        .link = strtab_index,
+        .info = symbols.GetFirstGlobalIndex(),
+        .alignment = 8,
+        .entry_size = sizeof(elf::Elf64_Sym),
+        .data = symbols.GetData(),
+    });
+    builder.AddSection({
+        .name = ".strtab",
+        .type = elf::SHT_STRTAB,
+        .data = symbols.GetStrings().GetData(),
+    });
+
+    return builder.Build();
+}
+
+// Removes an entry from the descriptor and notifies the debugger about it.
+void UnlinkEntry(jit_code_entry* entry) {
+    if (entry->prev_entry != nullptr) {
+        entry->prev_entry->next_entry = entry->next_entry;
+    } else {
+        __jit_debug_descriptor.first_entry = entry->next_entry;
+    }
+    if (entry->next_entry != nullptr) {
+        entry->next_entry->prev_entry = entry->prev_entry;
+    }
+
+    __jit_debug_descriptor.relevant_entry = entry;
+    __jit_debug_descriptor.action_flag = JIT_UNREGISTER_FN;
+    __jit_debug_register_code();
+}
+} // Anonymous namespace
+
+struct GdbJitRegistry::Entry {
+    jit_code_entry entry{};
+    std::vector<uint8_t> image;
+    uintptr_t address = 0;
+};
+
+GdbJitRegistry::GdbJitRegistry() = default;
+
+GdbJitRegistry::~GdbJitRegistry() {
+    UnregisterAll();
+}
+
+void GdbJitRegistry::RegisterFunction(std::string_view name, const void* code, size_t size) {
+    BISCUIT_ASSERT(code != nullptr);
+
+    auto entry = std::make_unique<Entry>();
+    entry->address = reinterpret_cast<uintptr_t>(code);
+    entry->image = BuildImage(name, entry->address, size);
+    entry->entry.symfile_addr = reinterpret_cast<const char*>(entry->image.data());
+    entry->entry.symfile_size = entry->image.size();
+
+    std::scoped_lock lock{m_mutex, GetDescriptorMutex()};
+
+    auto* const new_entry = &entry->entry;
+    new_entry->next_entry = __jit_debug_descriptor.first_entry;
+    if (new_entry->next_entry != nullptr) {
+        new_entry->next_entry->prev_entry = new_entry;
+    }
+
+    __jit_debug_descriptor.first_entry = new_entry;
+    __jit_debug_descriptor.relevant_entry = new_entry;
+    __jit_debug_descriptor.action_flag = JIT_REGISTER_FN;
+    __jit_debug_register_code();
+
+    m_entries.push_back(std::move(entry));
+}
+
+bool GdbJitRegistry::UnregisterFunction(const void* code) {
+    const auto address = reinterpret_cast<uintptr_t>(code);
+
+    std::scoped_lock lock{m_mutex, GetDescriptorMutex()};
+
+    const auto iter = std::stable_partition(m_entries.begin(), m_entries.end(),
+                                            [address](const auto& entry) {
+                                                return entry->address != address;
+                                            });
+    if (iter == m_entries.end()) {
+        return false;
+    }
+
+    for (auto it = iter; it != m_entries.end(); ++it) {
+        UnlinkEntry(&(*it)->entry);
+    }
+
+    m_entries.erase(iter, m_entries.end());
+    return true;
+}
+
+void GdbJitRegistry::UnregisterAll() {
+    std::scoped_lock lock{m_mutex, GetDescriptorMutex()};
+
+    for (const auto& entry : m_entries) {
+        UnlinkEntry(&entry->entry);
+    }
+
+    m_entries.clear();
+}
+
+size_t GdbJitRegistry::GetNumRegistered() const {
+    std::scoped_lock lock{m_mutex};
+    return m_entries.size();
+}
+
+void GdbJitRegistry::OnFunctionFinalized(const FinalizedFunction& function) {
+    RegisterFunction(function.name, function.code, function.size);
+}
+
+} // namespace biscuit
@@ -0,0 +1,106 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/icache.hpp>
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace biscuit {
+namespace {
+#if defined(__linux__)
+[[nodiscard]] bool RegisterMembarrierSyncCore() noexcept {
+    const auto commands = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+    if (commands < 0 || (commands & MEMBARRIER_CMD_PRIVATE_EXPEDITED_SYNC_CORE) == 0) {
+        return false;
+    }
+    return syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED_SYNC_CORE, 0, 0) == 0;
+}
+#endif
+
+[[nodiscard]] ICacheSyncMethod DetectMethod() noexcept {
+#if defined(__linux__)
+    if (RegisterMembarrierSyncCore()) {
+        return ICacheSyncMethod::Membarrier;
+    }
+#endif
+#if defined(__linux__) && defined(__riscv)
+    return ICacheSyncMethod::FlushICacheSyscall;
+#else
+    return ICacheSyncMethod::ClearCache;
+#endif
+}
+
+// Synchronizes instruction fetch of the calling hart with prior stores to the range.
+void SynchronizeLocal(uintptr_t begin, uintptr_t end) noexcept {
+#if defined(__riscv)
+    // FENCE.I isn't ranged, and __builtin___clear_cache would broadcast it to every hart.
+    static_cast<void>(begin);
+    static_cast<void>(end);
+    asm volatile("fence.i" ::: "memory");
+#else
+    __builtin___clear_cache(reinterpret_cast<char*>(begin), reinterpret_cast<char*>(end));
+#endif
+}
+
+void Synchronize(uintptr_t begin, uintptr_t end) noexcept {
+    switch (CodePublisher::GetMethod()) {
+    case ICacheSyncMethod::ClearCache:
+        __builtin___clear_cache(reinterpret_cast<char*>(begin), reinterpret_cast<char*>(end));
+        break;
+    case ICacheSyncMethod::FlushICacheSyscall:
+#if defined(__linux__) && defined(__riscv)
+        // A flags value of 0 flushes every hart, rather than only the local one.
+        syscall(__NR_riscv_flush_icache, begin, end, 0UL);
+#endif
+        break;
+    case ICacheSyncMethod::Membarrier:
+        SynchronizeLocal(begin, end);
+#if defined(__linux__)
+        syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED_SYNC_CORE, 0, 0);
+#endif
+        break;
+    }
+}
+} // Anonymous namespace
+
+CodePublisher::~CodePublisher() noexcept {
+    // It's a logic bug if code is modified, but the modification is never published.
+    BISCUIT_ASSERT(!HasPending());
+}
+
+void CodePublisher::Add(const void* begin, size_t size) noexcept {
+    if (size == 0) {
+        return;
+    }
+
+    const auto address = reinterpret_cast<uintptr_t>(begin);
+    m_begin = std::min(m_begin, address);
+    m_end = std::max(m_end, address + size);
+}
+
+void CodePublisher::Publish() noexcept {
+    if (!HasPending()) {
+        return;
+    }
+
+    Synchronize(m_begin, m_end);
+    m_begin = UINTPTR_MAX;
+    m_end = 0;
+}
+
+ICacheSyncMethod CodePublisher::GetMethod() noexcept {
+    static const ICacheSyncMethod method = DetectMethod();
+    return method;
+}
+
+void PublishCode(const void* begin, size_t size) noexcept {
+    CodePublisher publisher;
+    publisher.Add(begin, size);
+    publisher.Publish();
+}
+
+} // namespace biscuit
@@ -0,0 +1,314 @@
+#include <biscuit/assembler.hpp>
+#include <biscuit/assert.hpp>
+#include <biscuit/ir.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <utility>
+
+namespace biscuit {
+namespace {
+// Clears the offset encoded into a label link, so that it can be resolved again.
+void ClearLinkOffset(CodeBuffer& buffer, ptrdiff_t offset) {
+    auto* const ptr = buffer.GetOffsetPointer(offset);
+
+    uint16_t low_half = 0;
+    std::memcpy(&low_half, ptr, sizeof(low_half));
+
+    if ((low_half & 0b11) != 0b11) {
+        // C.BEQZ and C.BNEZ keep their register, C.J and C.JAL only keep funct3 and op.
+        const bool is_cb_type = (low_half & 0xE000) >= 0xC000;
+        low_half &= is_cb_type ? 0xE383 : 0xE003;
+        std::memcpy(ptr, &low_half, sizeof(low_half));
+        return;
+    }
+
+    uint32_t instruction = 0;
+    std::memcpy(&instruction, ptr, sizeof(instruction));
+
+    switch (instruction & 0x7F) {
+    case 0b1100011: // B-type
+        instruction &= 0x01FFF07F;
+        break;
+    case 0b1101111: // J-type
+        instruction &= 0x00000FFF;
+        break;
+    case 0b0010111: { // AUIPC+ADDI pair of LILabel
+        uint32_t next_instruction = 0;
+        std::memcpy(&next_instruction, ptr + 4, sizeof(next_instruction));
+        next_instruction &= 0x000FFFFF;
+        std::memcpy(ptr + 4, &next_instruction, sizeof(next_instruction));
+
+        instruction &= 0x00000FFF;
+        break;
+    }
+    default:
+        BISCUIT_ASSERT(false);
+        break;
+    }
+
+    std::memcpy(ptr, &instruction, sizeof(instruction));
+}
+
+[[nodiscard]] const Operand* FindPCOffset(const Instruction& instruction) noexcept {
+    const auto operands = instruction.GetOperands();
+    const auto iter = std::find_if(operands.begin(), operands.end(), [](const Operand& operand) {
+        return operand.type == OperandType::PCOffset;
+    });
+    return iter == operands.end() ? nullptr : &*iter;
+}
+} // Anonymous namespace
+
+void Assembler::BeginRecording() {
+    BISCUIT_ASSERT(!IsRecording());
+
+    m_recording_start = m_buffer.GetCursorOffset();
+    m_recording_optimizations = m_optimizations;
+    m_recording_num_relocations = m_relocations.size();
+
+    // Passes should see instructions the way they were written.
+    DisableOptimization(Optimization::AutoCompress);
+}
+
+IRStream Assembler::EndRecording() {
+    BISCUIT_ASSERT(IsRecording());
+
+    // Relocations refer to fixed offsets within the code, which passes don't preserve.
+    BISCUIT_ASSERT(m_relocations.size() == m_recording_num_relocations);
+
+    const auto start = *m_recording_start;
+    const auto end = m_buffer.GetCursorOffset();
+
+    IRStream stream{m_features};
+
+    // Labels by the offset they're bound to within the recorded code.
+    std::multimap<ptrdiff_t, IRLabel> binds;
+    std::map<Label*, IRLabel> labels;
+    std::map<ptrdiff_t, IRLabel> internal_labels;
+
+    const auto get_label = [&](Label* label) {
+        const auto [iter, inserted] = labels.try_emplace(label, no_ir_label);
+        if (inserted) {
+            iter->second = stream.AddLabel(label);
+        }
+        return iter->second;
+    };
+
+    // Branches with plain offsets get a label of their own, so that they
+    // still reach the same instruction once the code around them changes.
+    const auto get_internal_label = [&](ptrdiff_t target) {
+        // Code following the recording isn't known yet, so it can't be targeted.
+        BISCUIT_ASSERT(target <= end);
+
+        const auto [iter, inserted] = internal_labels.try_emplace(target, no_ir_label);
+        if (inserted) {
+            iter->second = stream.AddLabel();
+            if (target < start) {
+                stream.m_labels[iter->second].fixed_offset = target;
+            } else {
+                binds.emplace(target, iter->second);
+            }
+        }
+        return iter->second;
+    };
+
+    for (const auto& bind : m_recorded_binds) {
+        binds.emplace(bind.offset, get_label(bind.label));
+    }
+
+    // Zcmp and Zcmt reuse the encodings of C.FSDSP, so the recording can't mix them.
+    BISCUIT_ASSERT(!m_recorded_fsdsp || (!m_recorded_zcmp && !m_recorded_zcmt));
+
+    auto decode_options = DecodeOptions::None;
+    if (m_recorded_zcmp) {
+        decode_options |= DecodeOptions::Zcmp;
+    }
+    if (m_recorded_zcmt) {
+        decode_options |= DecodeOptions::Zcmt;
+    }
+
+    std::vector<std::pair<ptrdiff_t, IRNode>> decoded;
+    for (auto offset = start; offset < end;) {
+        const auto* const ptr = m_buffer.GetOffsetPointer(offset);
+        const auto instruction = Decode(ptr, m_features, decode_options);
+
+        if (!instruction.IsValid()) {
+            // Nodes hold at most 32 bits, so longer encodings are split into 16-bit parcels.
+            const uint8_t node_size = instruction.size > 4 ? 2 : instruction.size;
+            for (uint8_t i = 0; i < instruction.size; i += node_size) {
+                IRNode node{{}, IRNodeKind::Data, no_ir_label};
+                node.instruction.size = node_size;
+                std::memcpy(&node.instruction.encoding, ptr + i, node_size);
+                decoded.emplace_back(offset + i, node);
+            }
+            offset += instruction.size;
+            continue;
+        }
+
+        IRNode node{instruction, IRNodeKind::Instruction, no_ir_label};
+        auto size = static_cast<ptrdiff_t>(instruction.size);
+
+        if (const auto link = m_recorded_links.find(offset); link != m_recorded_links.end()) {
+            node.label = get_label(link->second);
+
+            // The AUIPC of LILabel is followed by the ADDI completing the address.
+            if (instruction.opcode == Opcode::AUIPC) {
+                node.kind = IRNodeKind::LabelAddress;
+                size += 4;
+            }
+        } else {
+            // Any other AUIPC computes an address that depends on where it's placed.
+            BISCUIT_ASSERT(instruction.opcode != Opcode::AUIPC);
+
+            if (const auto* const pc_offset = FindPCOffset(instruction)) {
+                node.label = get_internal_label(offset + pc_offset->value);
+            }
+        }
+
+        decoded.emplace_back(offset, node);
+        offset += size;
+    }
+
+    // Interleave the binds with the instructions they precede.
+    auto& nodes = stream.m_nodes;
+    auto bind = binds.begin();
+    for (const auto& [offset, node] : decoded) {
+        for (; bind != binds.end() && bind->first <= offset; ++bind) {
+            // Labels must be bound at instruction boundaries.
+            BISCUIT_ASSERT(bind->first == offset);
+            nodes.push_back({{}, IRNodeKind::Bind, bind->second});
+        }
+        nodes.push_back(node);
+    }
+    for (; bind != binds.end(); ++bind) {
+        BISCUIT_ASSERT(bind->first == end);
+        nodes.push_back({{}, IRNodeKind::Bind, bind->second});
+    }
+
+    // Labels bound while recording are bound again when the stream is emitted.
+    // Until then, links from preceding code are pending again, as if they'd never been bound.
+    for (const auto& recorded_bind : m_recorded_binds) {
+        auto* const label = recorded_bind.label;
+        label->m_location.reset();
+
+        for (const auto link : recorded_bind.external_links) {
+            ClearLinkOffset(m_buffer, link);
+            label->AddOffset(link);
+        }
+    }
+
+    // Links from the recorded code are made again when the stream is emitted.
+    for (const auto& [offset, label] : m_recorded_links) {
+        std::erase_if(label->m_offsets, [start](ptrdiff_t link) { return link >= start; });
+    }
+
+    m_buffer.RewindCursor(start);
+    InvalidateVectorConfig();
+    m_optimizations = m_recording_optimizations;
+
+    m_recording_start.reset();
+    m_recorded_links.clear();
+    m_recorded_binds.clear();
+    m_recorded_zcmp = false;
+    m_recorded_zcmt = false;
+    m_recorded_fsdsp = false;
+
+    return stream;
+}
+
+void Assembler::EndRecording(const IRPassPipeline& passes) {
+    auto stream = EndRecording();
+    passes.Run(stream);
+    EmitIR(stream);
+}
+
+void Assembler::EmitIR(const IRStream& stream) {
+    BISCUIT_ASSERT(!IsRecording());
+    BISCUIT_ASSERT(stream.GetArchFeatures() == m_features);
+
+    // Labels that only exist within the stream are backed by temporaries.
+    std::vector<Label> temporaries(stream.m_labels.size());
+    const auto get_label = [&](IRLabel label) {
+        auto* const external = stream.GetLabel(label);
+        return external != nullptr ? external : &temporaries[label];
+    };
+
+    for (size_t i = 0; i < stream.m_labels.size(); i++) {
+        if (const auto& fixed_offset = stream.m_labels[i].fixed_offset) {
+            BindToOffset(&temporaries[i], *fixed_offset);
+        }
+    }
+
+    for (const auto& node : stream.GetNodes()) {
+        const auto& instruction = node.instruction;
+
+        switch (node.kind) {
+        case IRNodeKind::Instruction:
+            if (node.HasLabel()) {
+                EmitWithLabel(instruction, get_label(node.label));
+            } else {
+                Encode(*this, instruction);
+            }
+            break;
+        case IRNodeKind::Bind:
+            Bind(get_label(node.label));
+            break;
+        case IRNodeKind::LabelAddress:
+            LILabel(instruction.GetGPR(0), get_label(node.label));
+            break;
+        case IRNodeKind::Data:
+            if (instruction.size == 2) {
+                m_buffer.Emit16(static_cast<uint16_t>(instruction.encoding));
+            } else {
+                BISCUIT_ASSERT(instruction.size == 4);
+                m_buffer.Emit32(instruction.encoding);
+            }
+            break;
+        }
+    }
+}
+
+void Assembler::EmitWithLabel(const Instruction& instruction, Label* label) {
+    switch (instruction.opcode) {
+    case Opcode::BEQ:
+        BEQ(instruction.GetGPR(0), instruction.GetGPR(1), label);
+        break;
+    case Opcode::BNE:
+        BNE(instruction.GetGPR(0), instruction.GetGPR(1), label);
+        break;
+    case Opcode::BLT:
+        BLT(instruction.GetGPR(0), instruction.GetGPR(1), label);
+        break;
+    case Opcode::BGE:
+        BGE(instruction.GetGPR(0), instruction.GetGPR(1), label);
+        break;
+    case Opcode::BLTU:
+        BLTU(instruction.GetGPR(0), instruction.GetGPR(1), label);
+        break;
+    case Opcode::BGEU:
+        BGEU(instruction.GetGPR(0), instruction.GetGPR(1), label);
+        break;
+    case Opcode::JAL:
+        JAL(instruction.GetGPR(0), label);
+        break;
+    case Opcode::C_J:
+        C_J(label);
+        break;
+    case Opcode::C_JAL:
+        C_JAL(label);
+        break;
+    case Opcode::C_BEQZ:
+        C_BEQZ(instruction.GetGPR(0), label);
+        break;
+    case Opcode::C_BNEZ:
+        C_BNEZ(instruction.GetGPR(0), label);
+        break;
+    default:
+        // Only branches and jumps can target labels.
+        BISCUIT_ASSERT(false);
+        break;
+    }
+}
+
+} // namespace biscuit
@@ -0,0 +1,112 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/island_manager.hpp>
+
+#include <cstring>
+
+#include "assembler_util.hpp"
+
+namespace biscuit {
+namespace {
+[[nodiscard]] bool IsInJalRange(int64_t distance) noexcept {
+    return distance >= -IslandManager::jal_range && distance < IslandManager::jal_range;
+}
+} // Anonymous namespace
+
+IslandManager::IslandManager(Assembler& assembler) : m_assembler{assembler} {}
+
+IslandManager::~IslandManager() noexcept {
+    // It's a logic bug if a call or jump is emitted, but its veneer never is.
+    BISCUIT_ASSERT(!HasPendingSites());
+}
+
+void IslandManager::Call(uint64_t address) {
+    EmitJump(ra, address);
+}
+
+void IslandManager::Jump(uint64_t address) {
+    EmitJump(zero, address);
+}
+
+void IslandManager::Place() {
+    auto& buffer = m_assembler.GetCodeBuffer();
+    const bool is_rv32 = IsRV32(m_assembler.GetArchFeatures());
+
+    for (const auto& [address, sites] : m_pending) {
+        const auto veneer = buffer.GetCursorOffset();
+        (void)EmitVeneer(buffer, address, is_rv32);
+
+        for (const auto site : sites) {
+            PatchJump(site, veneer);
+        }
+
+        m_veneers[address] = veneer;
+        m_num_veneers++;
+    }
+
+    m_pending.clear();
+}
+
+void IslandManager::PlaceInline() {
+    if (!HasPendingSites()) {
+        return;
+    }
+
+    // Islands can be larger than a compressed jump can skip over.
+    auto& buffer = m_assembler.GetCodeBuffer();
+    const auto skip = buffer.GetCursorOffset();
+    EmitJType(buffer, 0, zero, 0b1101111);
+    Place();
+    PatchJump(skip, buffer.GetCursorOffset());
+}
+
+bool IslandManager::NeedsIsland(ptrdiff_t distance) const noexcept {
+    if (!HasPendingSites()) {
+        return false;
+    }
+
+    // Leave room for a jump over the island, in case it's placed inline.
+    const auto island_size = static_cast<ptrdiff_t>(m_pending.size()) * max_veneer_size + 4;
+    const auto last_veneer = m_assembler.GetCodeBuffer().GetCursorOffset() + distance + island_size;
+    return last_veneer - m_earliest_pending >= jal_range;
+}
+
+void IslandManager::EmitJump(GPR rd, uint64_t address) {
+    m_assembler.InvalidateVectorConfig();
+
+    auto& buffer = m_assembler.GetCodeBuffer();
+    const auto site = buffer.GetCursorOffset();
+    const auto distance = static_cast<int64_t>(address - buffer.GetCursorAddress());
+
+    // JALs are always emitted uncompressed, so that they can be patched with any offset in range.
+    if (IsInJalRange(distance)) {
+        EmitJType(buffer, static_cast<uint32_t>(distance), rd, 0b1101111);
+        return;
+    }
+
+    if (const auto iter = m_veneers.find(address);
+        iter != m_veneers.end() && IsInJalRange(iter->second - site)) {
+        EmitJType(buffer, static_cast<uint32_t>(iter->second - site), rd, 0b1101111);
+        return;
+    }
+
+    if (!HasPendingSites()) {
+        m_earliest_pending = site;
+    }
+
+    EmitJType(buffer, 0, rd, 0b1101111);
+    m_pending[address].push_back(site);
+}
+
+void IslandManager::PatchJump(ptrdiff_t offset, ptrdiff_t target) {
+    const auto distance = target - offset;
+    BISCUIT_ASSERT(IsInJalRange(distance));
+
+    auto* const ptr = m_assembler.GetCodeBuffer().GetOffsetPointer(offset);
+
+    uint32_t instruction = 0;
+    std::memcpy(&instruction, ptr, sizeof(instruction));
+    instruction = (instruction & 0xFFF) | TransformToJTypeImm(static_cast<uint32_t>(distance) & 0x1FFFFE);
+    std::memcpy(ptr, &instruction, sizeof(instruction));
+}
+
+} // namespace biscuit
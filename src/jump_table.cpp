@@ -0,0 +1,203 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/jump_table.hpp>
+
+#include <algorithm>
+#include <utility>
+
+#include "assembler_util.hpp"
+
+namespace biscuit {
+
+JumpTable::JumpTable(Assembler& assembler) : m_assembler{assembler} {}
+
+JumpTable::~JumpTable() noexcept {
+    // It's a logic bug if code refers to the table, but the table is never placed.
+    BISCUIT_ASSERT(IsPlaced() || (!m_has_table_sites && m_pending_setups.empty()));
+}
+
+std::optional<uint32_t> JumpTable::AddCall(uint64_t target) {
+    if (const auto index = GetCallIndex(target)) {
+        return index;
+    }
+    if (IsPlaced() || first_call_index + m_calls.size() >= max_entries) {
+        return std::nullopt;
+    }
+
+    const auto index = first_call_index + static_cast<uint32_t>(m_calls.size());
+    m_calls.push_back(target);
+    m_call_indices.emplace(target, index);
+    return index;
+}
+
+std::optional<uint32_t> JumpTable::AddJump(uint64_t target) {
+    if (const auto index = GetJumpIndex(target)) {
+        return index;
+    }
+    if (IsPlaced() || m_jumps.size() >= num_jump_entries) {
+        return std::nullopt;
+    }
+
+    const auto index = static_cast<uint32_t>(m_jumps.size());
+    m_jumps.push_back(target);
+    m_jump_indices.emplace(target, index);
+    return index;
+}
+
+void JumpTable::CountCall(uint64_t target, uint64_t count) {
+    m_call_counts[target] += count;
+}
+
+void JumpTable::CountJump(uint64_t target, uint64_t count) {
+    m_jump_counts[target] += count;
+}
+
+void JumpTable::AssignByFrequency(uint64_t min_count) {
+    AssignCounted(m_call_counts, min_count, true);
+    AssignCounted(m_jump_counts, min_count, false);
+}
+
+void JumpTable::AssignCounted(std::unordered_map<uint64_t, uint64_t>& counts,
+                              uint64_t min_count, bool is_call) {
+    std::vector<std::pair<uint64_t, uint64_t>> ranked(counts.begin(), counts.end());
+    counts.clear();
+
+    // Ties are broken by address, so that assignment doesn't depend on hashing.
+    std::sort(ranked.begin(), ranked.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second != rhs.second ? lhs.second > rhs.second : lhs.first < rhs.first;
+    });
+
+    for (const auto& [target, count] : ranked) {
+        if (count < min_count) {
+            break;
+        }
+
+        const auto index = is_call ? AddCall(target) : AddJump(target);
+        if (!index) {
+            break;
+        }
+    }
+}
+
+void JumpTable::Call(uint64_t target) {
+    if (const auto index = GetCallIndex(target)) {
+        m_assembler.CM_JALT(*index);
+        m_has_table_sites = true;
+    } else {
+        EmitFallback(ra, target);
+    }
+}
+
+void JumpTable::Jump(uint64_t target) {
+    if (const auto index = GetJumpIndex(target)) {
+        m_assembler.CM_JT(*index);
+        m_has_table_sites = true;
+    } else {
+        EmitFallback(zero, target);
+    }
+}
+
+void JumpTable::EmitFallback(GPR rd, uint64_t target) {
+    m_assembler.InvalidateVectorConfig();
+
+    auto& buffer = m_assembler.GetCodeBuffer();
+    const auto site = buffer.GetCursorOffset();
+
+    EmitUType(buffer, 0, t1, 0b0010111);
+    EmitIType(buffer, 0, t1, 0b000, rd, 0b1100111);
+    if (PatchAUIPCPair(buffer, site, target)) {
+        return;
+    }
+
+    // Out of range of the pair, so load the full address instead.
+    buffer.RewindCursor(site);
+    m_assembler.LI(t1, target);
+    m_assembler.JALR(rd, 0, t1);
+}
+
+void JumpTable::EmitSetup(GPR scratch) {
+    BISCUIT_ASSERT(scratch != zero);
+
+    auto& buffer = m_assembler.GetCodeBuffer();
+    const auto site = buffer.GetCursorOffset();
+
+    // The pair is emitted uncompressed so that it can be patched with any offset.
+    EmitUType(buffer, 0, scratch, 0b0010111);
+    EmitIType(buffer, 0, scratch, 0b000, scratch, 0b0010011);
+    m_assembler.CSRRW(zero, CSR::JVT, scratch);
+
+    if (IsPlaced()) {
+        [[maybe_unused]] const bool patched = PatchAUIPCPair(buffer, site, *m_table_address);
+        BISCUIT_ASSERT(patched);
+    } else {
+        m_pending_setups.push_back(site);
+    }
+}
+
+void JumpTable::Place() {
+    BISCUIT_ASSERT(!IsPlaced());
+
+    auto& buffer = m_assembler.GetCodeBuffer();
+    const bool is_rv32 = IsRV32(m_assembler.GetArchFeatures());
+    const uint64_t entry_size = is_rv32 ? 4 : 8;
+
+    while (buffer.GetCursorAddress() % alignment != 0) {
+        buffer.Emit16(0);
+    }
+
+    // Without jumps, the CM.JT entries are never accessed, so the table base can
+    // point before the table. This works since the offset of the first CM.JALT
+    // entry is a multiple of the alignment for both entry sizes.
+    const auto cursor = static_cast<uint64_t>(buffer.GetCursorAddress());
+    if (m_jumps.empty()) {
+        m_table_address = cursor - first_call_index * entry_size;
+    } else {
+        m_table_address = cursor;
+    }
+
+    const auto emit_entry = [&](uint64_t target) {
+        if (is_rv32) {
+            BISCUIT_ASSERT(target <= UINT32_MAX);
+            buffer.Emit32(static_cast<uint32_t>(target));
+        } else {
+            buffer.Emit(target);
+        }
+    };
+
+    if (!m_jumps.empty()) {
+        for (const auto target : m_jumps) {
+            emit_entry(target);
+        }
+
+        // Calls are indexed after every jump entry, used or not.
+        if (!m_calls.empty()) {
+            for (size_t i = m_jumps.size(); i < num_jump_entries; i++) {
+                emit_entry(0);
+            }
+        }
+    }
+    for (const auto target : m_calls) {
+        emit_entry(target);
+    }
+
+    for (const auto site : m_pending_setups) {
+        [[maybe_unused]] const bool patched = PatchAUIPCPair(buffer, site, *m_table_address);
+        BISCUIT_ASSERT(patched);
+    }
+    m_pending_setups.clear();
+}
+
+std::optional<uint32_t> JumpTable::GetCallIndex(uint64_t target) const {
+    if (const auto iter = m_call_indices.find(target); iter != m_call_indices.end()) {
+        return iter->second;
+    }
+    return std::nullopt;
+}
+
+std::optional<uint32_t> JumpTable::GetJumpIndex(uint64_t target) const {
+    if (const auto iter = m_jump_indices.find(target); iter != m_jump_indices.end()) {
+        return iter->second;
+    }
+    return std::nullopt;
+}
+
+} // namespace biscuit
@@ -0,0 +1,264 @@
+#include <biscuit/assembler.hpp>
+#include <biscuit/assert.hpp>
+#include <biscuit/object_writer.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include "elf.hpp"
+
+namespace biscuit {
+namespace {
+[[nodiscard]] uint32_t GetElfRelocationType(RelocationType type) {
+    switch (type) {
+    case RelocationType::Absolute32:
+        return 1; // R_RISCV_32
+    case RelocationType::Absolute64:
+        return 2; // R_RISCV_64
+    case RelocationType::Branch:
+        return 16; // R_RISCV_BRANCH
+    case RelocationType::Jal:
+        return 17; // R_RISCV_JAL
+    case RelocationType::Call:
+        return 19; // R_RISCV_CALL_PLT
+    case RelocationType::PCRelHi20:
+        return 23; // R_RISCV_PCREL_HI20
+    case RelocationType::PCRelLo12I:
+        return 24; // R_RISCV_PCREL_LO12_I
+    case RelocationType::PCRelLo12S:
+        return 25; // R_RISCV_PCREL_LO12_S
+    }
+    BISCUIT_ASSERT(false);
+    return 0;
+}
+
+[[nodiscard]] uint64_t GetSectionFlags(SectionKind kind) {
+    switch (kind) {
+    case SectionKind::Code:
+        return elf::SHF_ALLOC | elf::SHF_EXECINSTR;
+    case SectionKind::ReadOnlyData:
+        return elf::SHF_ALLOC;
+    case SectionKind::Data:
+        return elf::SHF_ALLOC | elf::SHF_WRITE;
+    }
+    return 0;
+}
+
+[[nodiscard]] uint32_t GetFloatABIFlags(FloatABI abi) {
+    switch (abi) {
+    case FloatABI::Soft:
+        return elf::EF_RISCV_FLOAT_ABI_SOFT;
+    case FloatABI::Single:
+        return elf::EF_RISCV_FLOAT_ABI_SINGLE;
+    case FloatABI::Double:
+        return elf::EF_RISCV_FLOAT_ABI_DOUBLE;
+    case FloatABI::Quad:
+        return elf::EF_RISCV_FLOAT_ABI_QUAD;
+    }
+    return 0;
+}
+
+[[nodiscard]] bool IsPCRelLo12(RelocationType type) {
+    return type == RelocationType::PCRelLo12I || type == RelocationType::PCRelLo12S;
+}
+} // Anonymous namespace
+
+ObjectWriter::ObjectWriter(FloatABI float_abi) : m_float_abi{float_abi} {}
+
+uint32_t ObjectWriter::AddSection(std::string_view name, Assembler& assembler, SectionKind kind,
+                                  size_t alignment) {
+    auto& buffer = assembler.GetCodeBuffer();
+    const std::span<const uint8_t> data{buffer.GetOffsetPointer(0), buffer.GetSizeInBytes()};
+
+    return AddSection(name, data, assembler.GetExportedSymbols(), assembler.GetRelocations(),
+                      kind, alignment);
+}
+
+uint32_t ObjectWriter::AddSection(std::string_view name, std::span<const uint8_t> data,
+                                  std::span<const ExportedSymbol> symbols,
+                                  std::span<const Relocation> relocations,
+                                  SectionKind kind, size_t alignment) {
+    BISCUIT_ASSERT(!name.empty());
+    BISCUIT_ASSERT(std::has_single_bit(alignment));
+    BISCUIT_ASSERT(std::none_of(m_sections.begin(), m_sections.end(), [name](const Section& section) {
+        return section.name == name;
+    }));
+
+    const auto size = static_cast<ptrdiff_t>(data.size());
+    for (const auto& symbol : symbols) {
+        BISCUIT_ASSERT(symbol.offset >= 0 && symbol.offset <= size);
+    }
+    for (const auto& relocation : relocations) {
+        const auto end = relocation.offset + static_cast<ptrdiff_t>(GetRelocationSize(relocation.type));
+        BISCUIT_ASSERT(relocation.offset >= 0 && end <= size);
+    }
+
+    m_sections.push_back({
+        .name = std::string{name},
+        .kind = kind,
+        .alignment = alignment,
+        .data{data.begin(), data.end()},
+        .symbols{symbols.begin(), symbols.end()},
+        .relocations{relocations.begin(), relocations.end()},
+    });
+
+    // Section zero is the null section.
+    return static_cast<uint32_t>(m_sections.size());
+}
+
+std::vector<uint8_t> ObjectWriter::Write() const {
+    elf::ImageBuilder builder{elf::ET_REL, elf::EF_RISCV_RVC | GetFloatABIFlags(m_float_abi)};
+
+    // Layout: [null] [sections...] [relocation sections...] .symtab .strtab
+    const auto num_relocated = static_cast<size_t>(
+        std::count_if(m_sections.begin(), m_sections.end(), [](const Section& section) {
+            return !section.relocations.empty();
+        }));
+    const auto symtab_index = static_cast<uint32_t>(1 + m_sections.size() + num_relocated);
+
+    elf::SymbolTable symbols;
+
+    // Local symbols that PCREL_LO12 relocations refer to, which mark the
+    // location of their paired AUIPC, keyed by section index and offset.
+    std::map<std::pair<size_t, ptrdiff_t>, uint32_t> pcrel_hi_symbols;
+    for (size_t i = 0; i < m_sections.size(); i++) {
+        const auto section_index = static_cast<uint16_t>(i + 1);
+
+        for (const auto& relocation : m_sections[i].relocations) {
+            if (!IsPCRelLo12(relocation.type)) {
+                continue;
+            }
+
+            const auto key = std::make_pair(i, relocation.hi20_offset);
+            if (pcrel_hi_symbols.contains(key)) {
+                continue;
+            }
+
+            std::string name = ".Lpcrel_hi";
+            name += std::to_string(pcrel_hi_symbols.size());
+
+            pcrel_hi_symbols[key] = symbols.Add(name, elf::MakeSymbolInfo(elf::STB_LOCAL, elf::STT_NOTYPE),
+                                                section_index, static_cast<uint64_t>(relocation.hi20_offset), 0);
+        }
+    }
+
+    // Symbols defined by the sections.
+    std::map<std::string, uint32_t, std::less<>> global_symbols;
+    for (size_t i = 0; i < m_sections.size(); i++) {
+        const auto section_index = static_cast<uint16_t>(i + 1);
+
+        for (const auto& symbol : m_sections[i].symbols) {
+            BISCUIT_ASSERT(!global_symbols.contains(symbol.name));
+
+            const auto type = symbol.type == SymbolType::Function ? elf::STT_FUNC : elf::STT_OBJECT;
+            global_symbols[symbol.name] = symbols.Add(symbol.name,
+                                                      elf::MakeSymbolInfo(elf::STB_GLOBAL, type),
+                                                      section_index, static_cast<uint64_t>(symbol.offset),
+                                                      symbol.size);
+        }
+    }
+
+    // Everything else that's referenced is defined elsewhere.
+    for (const auto& section : m_sections) {
+        for (const auto& relocation : section.relocations) {
+            if (IsPCRelLo12(relocation.type) || global_symbols.contains(relocation.symbol)) {
+                continue;
+            }
+
+            BISCUIT_ASSERT(!relocation.symbol.empty());
+            global_symbols[relocation.symbol] = symbols.Add(relocation.symbol,
+                                                            elf::MakeSymbolInfo(elf::STB_GLOBAL, elf::STT_NOTYPE),
+                                                            elf::SHN_UNDEF, 0, 0);
+        }
+    }
+
+    for (const auto& section : m_sections) {
+        builder.AddSection({
+            .name = section.name,
+            .type = elf::SHT_PROGBITS,
+            .flags = GetSectionFlags(section.kind),
+            .address = 0,
+            .link = 0,
+            .info = 0,
+            .alignment = section.alignment,
+            .entry_size = 0,
+            .data = section.data,
+            .nobits_size = 0,
+        });
+    }
+
+    for (size_t i = 0; i < m_sections.size(); i++) {
+        const auto& section = m_sections[i];
+        if (section.relocations.empty()) {
+            continue;
+        }
+
+        std::vector<uint8_t> data(section.relocations.size() * sizeof(elf::Elf64_Rela));
+        for (size_t r = 0; r < section.relocations.size(); r++) {
+            const auto& relocation = section.relocations[r];
+
+            elf::Elf64_Rela rela{
+                .r_offset = static_cast<uint64_t>(relocation.offset),
+                .r_info = 0,
+                .r_addend = relocation.addend,
+            };
+            if (IsPCRelLo12(relocation.type)) {
+                const auto symbol = pcrel_hi_symbols.at({i, relocation.hi20_offset});
+                rela.r_info = elf::MakeRelocationInfo(symbol, GetElfRelocationType(relocation.type));
+                rela.r_addend = 0;
+            } else {
+                const auto symbol = global_symbols.find(relocation.symbol)->second;
+                rela.r_info = elf::MakeRelocationInfo(symbol, GetElfRelocationType(relocation.type));
+            }
+
+            std::memcpy(data.data() + r * sizeof(rela), &rela, sizeof(rela));
+        }
+
+        builder.AddSection({
+            .name = ".rela" + section.name,
+            .type = elf::SHT_RELA,
+            .flags = elf::SHF_INFO_LINK,
+            .address = 0,
+            .link = symtab_index,
+            .info = static_cast<uint32_t>(i + 1),
+            .alignment = 8,
+            .entry_size = sizeof(elf::Elf64_Rela),
+            .data = std::move(data),
+            .nobits_size = 0,
+        });
+    }
+
+    [[maybe_unused]] const auto actual_symtab_index = builder.AddSection({
+        .name = ".symtab",
+        .type = elf::SHT_SYMTAB,
+        .flags = 0,
+        .address = 0,
+        .link = symtab_index + 1,
+        .info = symbols.GetFirstGlobalIndex(),
+        .alignment = 8,
+        .entry_size = sizeof(elf::Elf64_Sym),
+        .data = symbols.GetData(),
+        .nobits_size = 0,
+    });
+    BISCUIT_ASSERT(actual_symtab_index == symtab_index);
+
+    builder.AddSection({
+        .name = ".strtab",
+        .type = elf::SHT_STRTAB,
+        .flags = 0,
+        .address = 0,
+        .link = 0,
+        .info = 0,
+        .alignment = 1,
+        .entry_size = 0,
+        .data = symbols.GetStrings().GetData(),
+        .nobits_size = 0,
+    });
+
+    return builder.Build();
+}
+
+} // namespace biscuit
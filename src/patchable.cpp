@@ -0,0 +1,192 @@
+#include <biscuit/assembler.hpp>
+#include <biscuit/assert.hpp>
+#include <biscuit/patchable.hpp>
+
+#include <atomic>
+
+#include "assembler_util.hpp"
+
+namespace biscuit {
+namespace {
+// Offsets within a patchable jump slot.
+constexpr uint32_t jump_offset = 0;
+constexpr uint32_t far_path_offset = 4;
+constexpr uint32_t literal_offset = 16;
+
+constexpr uint32_t jal_opcode = 0b1101111;
+
+[[nodiscard]] bool IsInJumpRange(int64_t distance) noexcept {
+    return distance >= -(int64_t{1} << 20) && distance < (int64_t{1} << 20);
+}
+
+[[nodiscard]] uint32_t EncodeJump(int64_t distance) noexcept {
+    return TransformToJTypeImm(static_cast<uint32_t>(distance) & 0x1FFFFE) | jal_opcode;
+}
+
+[[nodiscard]] int64_t DecodeJump(uint32_t instruction) noexcept {
+    const auto imm = ((instruction >> 11) & 0x100000) | (instruction & 0xFF000) |
+                     ((instruction >> 9) & 0x800) | ((instruction >> 20) & 0x7FE);
+    return static_cast<int32_t>(imm << 11) >> 11;
+}
+
+template <typename T>
+void AtomicStore(uintptr_t address, T value) noexcept {
+    std::atomic_ref<T>{*reinterpret_cast<T*>(address)}.store(value, std::memory_order_release);
+}
+
+template <typename T>
+[[nodiscard]] T AtomicLoad(uintptr_t address) noexcept {
+    return std::atomic_ref<T>{*reinterpret_cast<T*>(address)}.load(std::memory_order_acquire);
+}
+
+// Stores a value into the literal of a patchable sequence.
+void StoreLiteral(uintptr_t address, uint64_t value, bool is_rv32) {
+    if (is_rv32) {
+        BISCUIT_ASSERT(value <= UINT32_MAX);
+        AtomicStore(address, static_cast<uint32_t>(value));
+    } else {
+        AtomicStore(address, value);
+    }
+}
+
+[[nodiscard]] uint64_t LoadLiteral(uintptr_t address, bool is_rv32) noexcept {
+    if (is_rv32) {
+        return AtomicLoad<uint32_t>(address);
+    }
+    return AtomicLoad<uint64_t>(address);
+}
+
+// Pads the code buffer with NOPs until the cursor address is `remainder` past a multiple of `alignment`.
+void AlignWithNops(CodeBuffer& buffer, uintptr_t alignment, uintptr_t remainder) {
+    if (buffer.GetCursorAddress() % 4 != 0) {
+        buffer.Emit16(0x0001); // C.NOP
+    }
+    while (buffer.GetCursorAddress() % alignment != remainder) {
+        buffer.Emit32(0x00000013); // NOP
+    }
+}
+
+// Emits a literal with the size of a register.
+void EmitLiteral(CodeBuffer& buffer, uint64_t value, bool is_rv32) {
+    if (is_rv32) {
+        BISCUIT_ASSERT(value <= UINT32_MAX);
+        buffer.Emit32(static_cast<uint32_t>(value));
+    } else {
+        buffer.Emit(value);
+    }
+}
+} // Anonymous namespace
+
+PatchableJump Assembler::EmitPatchableJump(uint64_t target) {
+    InvalidateVectorConfig();
+
+    const bool is_rv32 = IsRV32(m_features);
+
+    // Padding is executed, so it has to consist of NOPs.
+    AlignWithNops(m_buffer, PatchableJump::alignment, 0);
+
+    const auto address = m_buffer.GetCursorAddress();
+    const auto distance = static_cast<int64_t>(target - address);
+    const bool is_near = IsInJumpRange(distance);
+
+    m_buffer.Emit32(EncodeJump(is_near ? distance : static_cast<int64_t>(far_path_offset)));
+    EmitUType(m_buffer, 0, t1, 0b0010111);
+    EmitIType(m_buffer, literal_offset - far_path_offset, t1, is_rv32 ? 0b010 : 0b011, t1, 0b0000011);
+    EmitIType(m_buffer, 0, t1, 0b000, zero, 0b1100111);
+
+    EmitLiteral(m_buffer, is_near ? 0 : target, is_rv32);
+    if (is_rv32) {
+        m_buffer.Emit32(0);
+    }
+
+    return PatchableJump{address, target, is_rv32};
+}
+
+PatchableConstant Assembler::EmitPatchableLI(GPR rd, uint64_t value) {
+    BISCUIT_ASSERT(rd != x0);
+    const bool is_rv32 = IsRV32(m_features);
+
+    // The literal follows 12 bytes of code.
+    if (is_rv32) {
+        AlignWithNops(m_buffer, 4, 0);
+    } else {
+        AlignWithNops(m_buffer, 8, 4);
+    }
+
+    const auto address = m_buffer.GetCursorAddress();
+    EmitUType(m_buffer, 0, rd, 0b0010111);
+    EmitIType(m_buffer, 12, rd, is_rv32 ? 0b010 : 0b011, rd, 0b0000011);
+    m_buffer.Emit32(EncodeJump(is_rv32 ? 8 : 12));
+    EmitLiteral(m_buffer, value, is_rv32);
+
+    return PatchableConstant{address, is_rv32};
+}
+
+PatchableCall Assembler::EmitPatchableCall(uint64_t target) {
+    InvalidateVectorConfig();
+
+    const bool is_rv32 = IsRV32(m_features);
+
+    // The literal follows 16 bytes of code.
+    AlignWithNops(m_buffer, is_rv32 ? 4 : 8, 0);
+
+    const auto address = m_buffer.GetCursorAddress();
+    EmitUType(m_buffer, 0, t1, 0b0010111);
+    EmitIType(m_buffer, 16, t1, is_rv32 ? 0b010 : 0b011, t1, 0b0000011);
+    EmitIType(m_buffer, 0, t1, 0b000, ra, 0b1100111);
+    m_buffer.Emit32(EncodeJump(is_rv32 ? 8 : 12));
+    EmitLiteral(m_buffer, target, is_rv32);
+
+    return PatchableCall{address, is_rv32};
+}
+
+void PatchableJump::Retarget(uint64_t target) const {
+    CodePublisher publisher;
+    Retarget(target, publisher);
+    publisher.Publish();
+}
+
+void PatchableJump::Retarget(uint64_t target, CodePublisher& publisher) const {
+    const auto jump = m_address + jump_offset;
+    const auto distance = static_cast<int64_t>(target - jump);
+
+    if (IsInJumpRange(distance)) {
+        AtomicStore(jump, EncodeJump(distance));
+    } else {
+        // The literal must be visible before any hart can take the far path to it.
+        StoreLiteral(m_address + literal_offset, target, m_is_rv32);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        AtomicStore(jump, EncodeJump(static_cast<int64_t>(far_path_offset - jump_offset)));
+    }
+
+    publisher.Add(reinterpret_cast<const void*>(m_address), size);
+}
+
+uint64_t PatchableJump::GetTarget() const noexcept {
+    const auto jump = m_address + jump_offset;
+    const auto distance = DecodeJump(AtomicLoad<uint32_t>(jump));
+
+    if (distance != static_cast<int64_t>(far_path_offset - jump_offset)) {
+        return jump + static_cast<uint64_t>(distance);
+    }
+    return LoadLiteral(m_address + literal_offset, m_is_rv32);
+}
+
+uint64_t PatchableConstant::GetValue() const noexcept {
+    return LoadLiteral(GetLiteralAddress(), m_is_rv32);
+}
+
+uint64_t PatchableCall::GetTarget() const noexcept {
+    return LoadLiteral(GetLiteralAddress(), m_is_rv32);
+}
+
+// Literals are only ever read as data, so no instruction cache synchronization is necessary.
+void Repatch(const PatchableConstant& constant, uint64_t value) {
+    StoreLiteral(constant.GetLiteralAddress(), value, constant.IsRV32());
+}
+
+void Repatch(const PatchableCall& call, uint64_t target) {
+    StoreLiteral(call.GetLiteralAddress(), target, call.IsRV32());
+}
+
+} // namespace biscuit
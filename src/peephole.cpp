@@ -0,0 +1,316 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/peephole.hpp>
+
+#include <optional>
+#include <vector>
+
+#include "assembler_util.hpp"
+
+namespace biscuit {
+namespace {
+// How an instruction accesses the registers within its operands.
+enum class Access {
+    // The first operand is written, any other register operand is read.
+    WritesFirst,
+
+    // Every register operand is read, and nothing else is accessed.
+    ReadsAll,
+
+    // Anything else, e.g. control flow or implicit register accesses.
+    Unknown,
+};
+
+[[nodiscard]] Access GetAccess(Opcode opcode) noexcept {
+    switch (opcode) {
+    case Opcode::ADD:
+    case Opcode::ADDI:
+    case Opcode::ADDIW:
+    case Opcode::ADDW:
+    case Opcode::ADDUW:
+    case Opcode::AND:
+    case Opcode::ANDI:
+    case Opcode::CZERO_EQZ:
+    case Opcode::CZERO_NEZ:
+    case Opcode::LB:
+    case Opcode::LBU:
+    case Opcode::LD:
+    case Opcode::LH:
+    case Opcode::LHU:
+    case Opcode::LUI:
+    case Opcode::LW:
+    case Opcode::LWU:
+    case Opcode::OR:
+    case Opcode::ORI:
+    case Opcode::SH1ADD:
+    case Opcode::SH2ADD:
+    case Opcode::SH3ADD:
+    case Opcode::SLL:
+    case Opcode::SLLI:
+    case Opcode::SLLIW:
+    case Opcode::SLLW:
+    case Opcode::SLT:
+    case Opcode::SLTI:
+    case Opcode::SLTIU:
+    case Opcode::SLTU:
+    case Opcode::SRA:
+    case Opcode::SRAI:
+    case Opcode::SRAIW:
+    case Opcode::SRAW:
+    case Opcode::SRL:
+    case Opcode::SRLI:
+    case Opcode::SRLIW:
+    case Opcode::SRLW:
+    case Opcode::SUB:
+    case Opcode::SUBW:
+    case Opcode::XOR:
+    case Opcode::XORI:
+        return Access::WritesFirst;
+    case Opcode::SB:
+    case Opcode::SD:
+    case Opcode::SH:
+    case Opcode::SW:
+        return Access::ReadsAll;
+    default:
+        return Access::Unknown;
+    }
+}
+
+[[nodiscard]] bool IsGPR(const Instruction& instruction, size_t index, GPR reg) noexcept {
+    if (index >= instruction.num_operands) {
+        return false;
+    }
+
+    const auto& operand = instruction.operands[index];
+    return operand.type == OperandType::GPR && static_cast<uint32_t>(operand.value) == reg.Index();
+}
+
+[[nodiscard]] bool IsPlainInstruction(const IRNode& node) noexcept {
+    return node.IsInstruction() && !node.HasLabel();
+}
+
+// Determines whether or not the value of a register after the node at `index`
+// is overwritten before it's read. This gives up at anything that isn't known
+// to only access registers through its operands, including the end of the block.
+[[nodiscard]] bool IsDeadAfter(const std::vector<IRNode>& nodes, size_t index, GPR reg) noexcept {
+    for (size_t i = index + 1; i < nodes.size(); i++) {
+        const auto& node = nodes[i];
+        if (!IsPlainInstruction(node)) {
+            return false;
+        }
+
+        const auto& instruction = node.instruction;
+        const auto access = GetAccess(instruction.opcode);
+        if (access == Access::Unknown) {
+            return false;
+        }
+
+        const size_t first_read = access == Access::WritesFirst ? 1 : 0;
+        for (size_t operand = first_read; operand < instruction.num_operands; operand++) {
+            if (IsGPR(instruction, operand, reg)) {
+                return false;
+            }
+        }
+        if (access == Access::WritesFirst && IsGPR(instruction, 0, reg)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// If one of the register operands at 1 and 2 is `reg` and the other isn't,
+// retrieves the other one.
+[[nodiscard]] std::optional<GPR> GetOtherAddend(const Instruction& instruction, GPR reg) noexcept {
+    const auto lhs = instruction.GetGPR(1);
+    const auto rhs = instruction.GetGPR(2);
+    if (lhs == reg && rhs != reg) {
+        return rhs;
+    }
+    if (rhs == reg && lhs != reg) {
+        return lhs;
+    }
+    return std::nullopt;
+}
+
+// Determines whether or not an instruction is a single instruction LI, which
+// is either an ADDI or (on RV64) an ADDIW with the zero register as source.
+[[nodiscard]] bool IsLoadImmediate(const Instruction& instruction) noexcept {
+    return (instruction.opcode == Opcode::ADDI || instruction.opcode == Opcode::ADDIW) &&
+           instruction.GetGPR(1) == zero;
+}
+
+[[nodiscard]] bool IsRedundantMove(const Instruction& instruction) noexcept {
+    if (GetAccess(instruction.opcode) != Access::WritesFirst || instruction.num_operands != 3) {
+        return false;
+    }
+
+    const auto rd = instruction.GetGPR(0);
+    if (rd == zero) {
+        return false;
+    }
+
+    switch (instruction.opcode) {
+    case Opcode::ADDI:
+    case Opcode::ORI:
+    case Opcode::XORI:
+    case Opcode::SLLI:
+    case Opcode::SRLI:
+    case Opcode::SRAI:
+        return instruction.GetGPR(1) == rd && instruction.GetValue(2) == 0;
+    case Opcode::ADD:
+    case Opcode::OR:
+    case Opcode::XOR:
+        return (instruction.GetGPR(1) == rd && instruction.GetGPR(2) == zero) ||
+               (instruction.GetGPR(1) == zero && instruction.GetGPR(2) == rd);
+    case Opcode::SUB:
+    case Opcode::SLL:
+    case Opcode::SRL:
+    case Opcode::SRA:
+        return instruction.GetGPR(1) == rd && instruction.GetGPR(2) == zero;
+    default:
+        return false;
+    }
+}
+} // Anonymous namespace
+
+bool Peephole::IsRuleEnabled(PeepholeRule rule, ArchFeature features) const noexcept {
+    if ((m_rules & rule) != rule) {
+        return false;
+    }
+
+    switch (rule) {
+    case PeepholeRule::ShiftAdd:
+        return m_extensions.Has(RISCVExtension::Zba);
+    case PeepholeRule::ZeroExtend:
+        return m_extensions.Has(RISCVExtension::Zba) && !IsRV32(features);
+    case PeepholeRule::ConditionalZero:
+        return m_extensions.Has(RISCVExtension::Zicond);
+    default:
+        return true;
+    }
+}
+
+size_t Peephole::Run(IRStream& stream) const {
+    const auto features = stream.GetArchFeatures();
+    auto& nodes = stream.GetNodes();
+
+    const bool redundant_move = IsRuleEnabled(PeepholeRule::RedundantMove, features);
+    const bool fold_immediate = IsRuleEnabled(PeepholeRule::FoldImmediate, features);
+    const bool shift_add = IsRuleEnabled(PeepholeRule::ShiftAdd, features);
+    const bool zero_extend = IsRuleEnabled(PeepholeRule::ZeroExtend, features);
+    const bool conditional_zero = IsRuleEnabled(PeepholeRule::ConditionalZero, features);
+
+    // Replaces the two instructions starting at `index` with a single one.
+    const auto replace_pair = [&](size_t index, const Instruction& instruction) {
+        nodes[index] = IRNode::FromInstruction(instruction);
+        nodes.erase(nodes.begin() + static_cast<ptrdiff_t>(index) + 1);
+    };
+
+    const auto try_rewrite = [&](size_t index) {
+        const auto& node = nodes[index];
+        const auto& first = node.instruction;
+
+        if (redundant_move && IsPlainInstruction(node) && IsRedundantMove(first)) {
+            nodes.erase(nodes.begin() + static_cast<ptrdiff_t>(index));
+            return true;
+        }
+
+        if (index + 1 >= nodes.size() || !node.IsInstruction() || !IsPlainInstruction(nodes[index + 1])) {
+            return false;
+        }
+        const auto& second = nodes[index + 1].instruction;
+
+        // LI tmp, imm + ADD rd, rs, tmp -> ADDI rd, rs, imm
+        if (fold_immediate && IsPlainInstruction(node) && IsLoadImmediate(first) &&
+            second.opcode == Opcode::ADD) {
+            const auto tmp = first.GetGPR(0);
+            const auto rd = second.GetGPR(0);
+            const auto rs = GetOtherAddend(second, tmp);
+
+            if (tmp != zero && rs && (rd == tmp || IsDeadAfter(nodes, index + 1, tmp))) {
+                const auto imm = first.GetValue(2);
+                replace_pair(index, MakeInstruction(features, [&](Assembler& as) {
+                    as.ADDI(rd, *rs, imm);
+                }));
+                return true;
+            }
+        }
+
+        // SLLI tmp, rs, 1-3 + ADD rd, tmp, rt -> SHxADD rd, rs, rt
+        if (shift_add && IsPlainInstruction(node) && first.opcode == Opcode::SLLI &&
+            second.opcode == Opcode::ADD) {
+            const auto tmp = first.GetGPR(0);
+            const auto rs = first.GetGPR(1);
+            const auto shift = first.GetValue(2);
+            const auto rd = second.GetGPR(0);
+            const auto rt = GetOtherAddend(second, tmp);
+
+            if (tmp != zero && shift >= 1 && shift <= 3 && rt &&
+                (rd == tmp || IsDeadAfter(nodes, index + 1, tmp))) {
+                replace_pair(index, MakeInstruction(features, [&](Assembler& as) {
+                    if (shift == 1) {
+                        as.SH1ADD(rd, rs, *rt);
+                    } else if (shift == 2) {
+                        as.SH2ADD(rd, rs, *rt);
+                    } else {
+                        as.SH3ADD(rd, rs, *rt);
+                    }
+                }));
+                return true;
+            }
+        }
+
+        // SLLI rd, rs, 32 + SRLI rd, rd, 32 -> ZEXT.W rd, rs
+        if (zero_extend && IsPlainInstruction(node) && first.opcode == Opcode::SLLI &&
+            second.opcode == Opcode::SRLI && first.GetValue(2) == 32 && second.GetValue(2) == 32) {
+            const auto rd = first.GetGPR(0);
+            const auto rs = first.GetGPR(1);
+
+            if (rd != zero && second.GetGPR(0) == rd && second.GetGPR(1) == rd) {
+                replace_pair(index, MakeInstruction(features, [&](Assembler& as) {
+                    as.ZEXTW(rd, rs);
+                }));
+                return true;
+            }
+        }
+
+        // BNEZ cond, skip + LI rd, 0 + skip: -> CZERO.EQZ rd, rd, cond
+        // BEQZ cond, skip + LI rd, 0 + skip: -> CZERO.NEZ rd, rd, cond
+        if (conditional_zero && node.HasLabel() && (first.opcode == Opcode::BEQ || first.opcode == Opcode::BNE) &&
+            index + 2 < nodes.size() && nodes[index + 2].kind == IRNodeKind::Bind &&
+            nodes[index + 2].label == node.label && IsLoadImmediate(second) && second.GetValue(2) == 0) {
+            const auto lhs = first.GetGPR(0);
+            const auto rhs = first.GetGPR(1);
+            const auto cond = lhs == zero ? rhs : lhs;
+            const auto rd = second.GetGPR(0);
+
+            if ((lhs == zero) != (rhs == zero) && rd != zero) {
+                const bool is_bnez = first.opcode == Opcode::BNE;
+                replace_pair(index, MakeInstruction(features, [&](Assembler& as) {
+                    if (is_bnez) {
+                        as.CZERO_EQZ(rd, rd, cond);
+                    } else {
+                        as.CZERO_NEZ(rd, rd, cond);
+                    }
+                }));
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    size_t num_rewrites = 0;
+    for (size_t index = 0; index < nodes.size();) {
+        if (try_rewrite(index)) {
+            num_rewrites++;
+
+            // The rewritten instruction may complete a pattern with the one before it.
+            index = index > 0 ? index - 1 : 0;
+        } else {
+            index++;
+        }
+    }
+    return num_rewrites;
+}
+
+} // namespace biscuit
@@ -0,0 +1,290 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/perf.hpp>
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace biscuit {
+namespace {
+// Format of jitdump files, as described in tools/perf/Documentation/jitdump-specification.txt
+// within the Linux kernel source tree.
+constexpr uint32_t jitdump_magic = 0x4A695444;
+constexpr uint32_t jitdump_version = 1;
+constexpr uint32_t jitdump_elf_machine = 243; // EM_RISCV
+
+enum class JitDumpRecordType : uint32_t {
+    CodeLoad = 0,
+    Close = 3,
+};
+
+struct JitDumpHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_size;
+    uint32_t elf_mach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+};
+static_assert(sizeof(JitDumpHeader) == 40);
+
+struct JitDumpRecordHeader {
+    JitDumpRecordType id;
+    uint32_t total_size;
+    uint64_t timestamp;
+};
+static_assert(sizeof(JitDumpRecordHeader) == 16);
+
+// Followed by the null-terminated function name and the code itself.
+struct JitDumpCodeLoad {
+    JitDumpRecordHeader header;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t code_addr;
+    uint64_t code_size;
+    uint64_t code_index;
+};
+static_assert(sizeof(JitDumpCodeLoad) == 56);
+
+#if defined(__linux__)
+// Timestamps must use the same clock as perf, which is selected with `perf record -k 1`.
+uint64_t GetTimestamp() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint32_t GetProcessID() {
+    return static_cast<uint32_t>(getpid());
+}
+
+uint32_t GetThreadID() {
+    return static_cast<uint32_t>(syscall(SYS_gettid));
+}
+
+// Writes all of the given data to a file, returning whether or not it succeeded.
+bool WriteAll(int fd, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size != 0) {
+        const auto written = write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+void AppendHex(std::string& out, uint64_t value) {
+    std::array<char, 16> buffer{};
+    const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, 16);
+    out.append(buffer.data(), result.ptr);
+}
+#else
+uint32_t GetProcessID() {
+    return 0;
+}
+#endif
+
+std::string MakePath(std::string_view directory, std::string_view prefix, std::string_view suffix) {
+    std::string path{directory};
+    if (!path.empty() && path.back() != '/') {
+        path += '/';
+    }
+    path += prefix;
+
+    std::array<char, 16> pid{};
+    const auto result = std::to_chars(pid.data(), pid.data() + pid.size(), GetProcessID());
+    path.append(pid.data(), result.ptr);
+
+    path += suffix;
+    return path;
+}
+} // Anonymous namespace
+
+PerfSink::PerfSink(PerfFormat formats, std::string_view directory)
+    : m_perf_map_path{MakePath(directory, "perf-", ".map")}
+    , m_jitdump_path{MakePath(directory, "jit-", ".dump")} {
+    if ((formats & PerfFormat::PerfMap) != PerfFormat::None) {
+        OpenPerfMap();
+    }
+    if ((formats & PerfFormat::JitDump) != PerfFormat::None) {
+        OpenJitDump();
+    }
+}
+
+PerfSink::~PerfSink() {
+#if defined(__linux__)
+    if (m_perf_map_fd >= 0) {
+        close(m_perf_map_fd);
+    }
+#endif
+    CloseJitDump();
+}
+
+void PerfSink::RecordFunction(std::string_view name, const void* code, size_t size) {
+    BISCUIT_ASSERT(code != nullptr);
+
+    const auto address = reinterpret_cast<uintptr_t>(code);
+
+    std::scoped_lock lock{m_mutex};
+    if (IsEnabled(PerfFormat::PerfMap)) {
+        WritePerfMapEntry(name, address, size);
+    }
+    if (IsEnabled(PerfFormat::JitDump)) {
+        WriteJitDumpEntry(name, address, size);
+    }
+}
+
+void PerfSink::OnFunctionFinalized(const FinalizedFunction& function) {
+    RecordFunction(function.name, function.code, function.size);
+}
+
+void PerfSink::OpenPerfMap() {
+#if defined(__linux__)
+    // The map is appended to, since other parts of the process (or other
+    // sinks) may also be describing their own code within the same map.
+    m_perf_map_fd = open(m_perf_map_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (m_perf_map_fd >= 0) {
+        m_enabled |= PerfFormat::PerfMap;
+    }
+#endif
+}
+
+void PerfSink::OpenJitDump() {
+#if defined(__linux__)
+    m_jitdump_fd = open(m_jitdump_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_jitdump_fd < 0) {
+        return;
+    }
+
+    const JitDumpHeader header{
+        .magic = jitdump_magic,
+        .version = jitdump_version,
+        .total_size = sizeof(JitDumpHeader),
+        .elf_mach = jitdump_elf_machine,
+        .pad1 = 0,
+        .pid = GetProcessID(),
+        .timestamp = GetTimestamp(),
+        .flags = 0,
+    };
+    if (!WriteAll(m_jitdump_fd, &header, sizeof(header))) {
+        CloseJitDump();
+        return;
+    }
+
+    // perf locates the dump by looking for an executable mapping of it within
+    // the recorded mmap events, so the mapping must exist for as long as
+    // the file is written to.
+    m_jitdump_marker_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    m_jitdump_marker = mmap(nullptr, m_jitdump_marker_size, PROT_READ | PROT_EXEC, MAP_PRIVATE,
+                            m_jitdump_fd, 0);
+    if (m_jitdump_marker == MAP_FAILED) {
+        m_jitdump_marker = nullptr;
+        CloseJitDump();
+        return;
+    }
+
+    m_enabled |= PerfFormat::JitDump;
+#endif
+}
+
+void PerfSink::CloseJitDump() {
+#if defined(__linux__)
+    if (m_jitdump_fd < 0) {
+        return;
+    }
+
+    if (IsEnabled(PerfFormat::JitDump)) {
+        const JitDumpRecordHeader record{
+            .id = JitDumpRecordType::Close,
+            .total_size = sizeof(JitDumpRecordHeader),
+            .timestamp = GetTimestamp(),
+        };
+        WriteAll(m_jitdump_fd, &record, sizeof(record));
+    }
+    if (m_jitdump_marker != nullptr) {
+        munmap(m_jitdump_marker, m_jitdump_marker_size);
+        m_jitdump_marker = nullptr;
+    }
+
+    close(m_jitdump_fd);
+    m_jitdump_fd = -1;
+    m_enabled &= ~PerfFormat::JitDump;
+#endif
+}
+
+void PerfSink::WritePerfMapEntry(std::string_view name, uintptr_t address, size_t size) {
+#if defined(__linux__)
+    // Each line has the form "START SIZE symbolname", with both numbers in hex.
+    std::string line;
+    line.reserve(name.size() + 36);
+    AppendHex(line, address);
+    line += ' ';
+    AppendHex(line, size);
+    line += ' ';
+    line += name;
+    line += '\n';
+
+    // Each line is written with a single write, so that lines from multiple
+    // processes or sinks can't end up interleaved with each other.
+    WriteAll(m_perf_map_fd, line.data(), line.size());
+#else
+    (void)name;
+    (void)address;
+    (void)size;
+#endif
+}
+
+void PerfSink::WriteJitDumpEntry(std::string_view name, uintptr_t address, size_t size) {
+#if defined(__linux__)
+    const auto total_size = sizeof(JitDumpCodeLoad) + name.size() + 1 + size;
+
+    const JitDumpCodeLoad record{
+        .header{
+            .id = JitDumpRecordType::CodeLoad,
+            .total_size = static_cast<uint32_t>(total_size),
+            .timestamp = GetTimestamp(),
+        },
+        .pid = GetProcessID(),
+        .tid = GetThreadID(),
+        .vma = address,
+        .code_addr = address,
+        .code_size = size,
+        .code_index = m_code_index++,
+    };
+
+    std::vector<uint8_t> data(total_size);
+    auto* out = data.data();
+    std::memcpy(out, &record, sizeof(record));
+    out += sizeof(record);
+    std::memcpy(out, name.data(), name.size());
+    out += name.size() + 1;
+    std::memcpy(out, reinterpret_cast<const void*>(address), size);
+
+    WriteAll(m_jitdump_fd, data.data(), data.size());
+#else
+    (void)name;
+    (void)address;
+    (void)size;
+#endif
+}
+
+} // namespace biscuit
@@ -0,0 +1,442 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/profile.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <iterator>
+#include <vector>
+
+#include "assembler_util.hpp"
+
+namespace biscuit {
+namespace {
+
+using enum RISCVExtension;
+
+// Names of every RISCVExtension, indexed by enum value.
+constexpr std::array<std::string_view, 63> extension_names{
+    "i", "m", "a", "f", "d", "c", "v",
+    "zba", "zbb", "zbs", "zicboz", "zbc", "zbkb", "zbkc", "zbkx",
+    "zknd", "zkne", "zknh", "zksed", "zksh", "zkt",
+    "zvbb", "zvbc", "zvkb", "zvkg", "zvkned", "zvknha", "zvknhb", "zvksed", "zvksh", "zvkt",
+    "zfh", "zfhmin", "zihintntl", "zvfh", "zvfhmin", "zfa", "ztso", "zacas", "zicond",
+    "zihintpause", "zve32x", "zve32f", "zve64x", "zve64f", "zve64d", "zimop",
+    "zca", "zcb", "zcd", "zcf", "zcmop", "zawrs", "supm", "zicntr", "zihpm",
+    "zfbfmin", "zvfbfmin", "zvfbfwma", "zicbom", "zaamo", "zalrsc", "zcmp",
+};
+static_assert(extension_names.size() == static_cast<size_t>(Zcmp) + 1,
+              "Every RISCVExtension must have a name");
+
+// Extensions that are shorthand for a group of other extensions.
+struct Shorthand {
+    std::string_view name;
+    ExtensionSet extensions;
+};
+
+constexpr ExtensionSet zkn_set{Zbkb, Zbkc, Zbkx, Zkne, Zknd, Zknh};
+constexpr ExtensionSet zks_set{Zbkb, Zbkc, Zbkx, Zksed, Zksh};
+constexpr ExtensionSet zvkn_set{Zvkned, Zvknhb, Zvkb, Zvkt};
+constexpr ExtensionSet zvks_set{Zvksed, Zvksh, Zvkb, Zvkt};
+
+constexpr std::array shorthands{
+    Shorthand{"g", {I, M, A, F, D}},
+    Shorthand{"b", {Zba, Zbb, Zbs}},
+    Shorthand{"zk", zkn_set | ExtensionSet{Zkt}},
+    Shorthand{"zkn", zkn_set},
+    Shorthand{"zks", zks_set},
+    Shorthand{"zvkn", zvkn_set},
+    Shorthand{"zvknc", zvkn_set | ExtensionSet{Zvbc}},
+    Shorthand{"zvkng", zvkn_set | ExtensionSet{Zvkg}},
+    Shorthand{"zvks", zvks_set},
+    Shorthand{"zvksc", zvks_set | ExtensionSet{Zvbc}},
+    Shorthand{"zvksg", zvks_set | ExtensionSet{Zvkg}},
+};
+
+// Standard extensions that are accepted, but not tracked within profiles.
+constexpr std::array ignored_extensions{
+    std::string_view{"q"}, std::string_view{"h"},
+    std::string_view{"za64rs"}, std::string_view{"za128rs"}, std::string_view{"zabha"},
+    std::string_view{"zalasr"}, std::string_view{"zama16b"},
+    std::string_view{"zcmt"}, std::string_view{"zclsd"},
+    std::string_view{"zdinx"}, std::string_view{"zfinx"}, std::string_view{"zhinx"},
+    std::string_view{"zhinxmin"}, std::string_view{"zic64b"}, std::string_view{"ziccamoa"},
+    std::string_view{"ziccif"}, std::string_view{"zicclsm"}, std::string_view{"ziccrse"},
+    std::string_view{"zicbop"}, std::string_view{"zicfilp"}, std::string_view{"zicfiss"},
+    std::string_view{"zicsr"}, std::string_view{"zifencei"}, std::string_view{"zilsd"},
+    std::string_view{"zkr"}, std::string_view{"zmmul"},
+    std::string_view{"sha"}, std::string_view{"shcounterenw"}, std::string_view{"shgatpa"},
+    std::string_view{"shtvala"}, std::string_view{"shvsatpa"}, std::string_view{"shvstvala"},
+    std::string_view{"shvstvecd"}, std::string_view{"ssccptr"}, std::string_view{"sscofpmf"},
+    std::string_view{"sscounterenw"}, std::string_view{"ssctr"}, std::string_view{"ssnpm"},
+    std::string_view{"sspm"}, std::string_view{"ssstateen"}, std::string_view{"sstc"},
+    std::string_view{"sstvala"}, std::string_view{"sstvecd"}, std::string_view{"ssu64xl"},
+    std::string_view{"sv39"}, std::string_view{"sv48"}, std::string_view{"sv57"},
+    std::string_view{"svade"}, std::string_view{"svbare"}, std::string_view{"svinval"},
+    std::string_view{"svnapot"}, std::string_view{"svpbmt"},
+};
+
+// Canonical ordering of single-letter extensions, which also
+// determines the category ordering of multi-letter Z extensions.
+constexpr std::string_view canonical_order = "imafdqlcbkjtpvh";
+
+constexpr ExtensionSet rva20u64_set{I, M, A, F, D, C, Zicntr, Zihpm};
+constexpr ExtensionSet rva22u64_set = rva20u64_set | ExtensionSet{
+    Zihintpause, Zba, Zbb, Zbs, Zicbom, Zicboz, Zfhmin, Zkt,
+};
+constexpr ExtensionSet rva23u64_set = rva22u64_set | ExtensionSet{
+    V, Zvfhmin, Zvbb, Zvkt, Zihintntl, Zicond, Zimop, Zcmop, Zcb, Zfa, Zawrs, Supm,
+};
+
+struct Preset {
+    std::string_view name;
+    ExtensionSet extensions;
+};
+
+constexpr std::array presets{
+    Preset{"rva20u64", rva20u64_set},
+    Preset{"rva22u64", rva22u64_set},
+    Preset{"rva23u64", rva23u64_set},
+};
+
+// Adds all extensions implied by the extensions within the given set.
+ExtensionSet ExpandImplied(ExtensionSet set, ArchFeature xlen) {
+    struct Implication {
+        RISCVExtension extension;
+        ExtensionSet implies;
+    };
+
+    static constexpr std::array implications{
+        Implication{A, {Zaamo, Zalrsc}},
+        Implication{D, {F}},
+        Implication{C, {Zca}},
+        Implication{V, {Zve64d}},
+        Implication{Zacas, {Zaamo}},
+        Implication{Zcb, {Zca}},
+        Implication{Zcd, {Zca, D}},
+        Implication{Zcf, {Zca, F}},
+        Implication{Zcmop, {Zca}},
+        Implication{Zcmp, {Zca}},
+        Implication{Zfa, {F}},
+        Implication{Zfbfmin, {F}},
+        Implication{Zfh, {Zfhmin}},
+        Implication{Zfhmin, {F}},
+        Implication{Zve32f, {Zve32x, F}},
+        Implication{Zve64d, {Zve64f, D}},
+        Implication{Zve64f, {Zve64x, Zve32f}},
+        Implication{Zve64x, {Zve32x}},
+        Implication{Zvbb, {Zvkb}},
+        Implication{Zvbc, {Zve64x}},
+        Implication{Zvfbfmin, {Zve32f}},
+        Implication{Zvfbfwma, {Zvfbfmin, Zfbfmin}},
+        Implication{Zvfh, {Zvfhmin, Zfhmin}},
+        Implication{Zvfhmin, {Zve32f}},
+        Implication{Zvkb, {Zve32x}},
+        Implication{Zvkg, {Zve32x}},
+        Implication{Zvkned, {Zve32x}},
+        Implication{Zvknha, {Zve32x}},
+        Implication{Zvknhb, {Zve64x}},
+        Implication{Zvksed, {Zve32x}},
+        Implication{Zvksh, {Zve32x}},
+    };
+
+    ExtensionSet previous;
+    while (previous != set) {
+        previous = set;
+
+        for (const auto& implication : implications) {
+            if (set.Has(implication.extension)) {
+                set |= implication.implies;
+            }
+        }
+
+        // C is made up of several subsets depending on what else is available.
+        if (set.Has(C)) {
+            if (set.Has(D)) {
+                set.Add(Zcd);
+            }
+            if (set.Has(F) && IsRV32(xlen)) {
+                set.Add(Zcf);
+            }
+        }
+
+        // Likewise, the subsets together also form the whole.
+        const bool has_zcd_if_needed = !set.Has(D) || set.Has(Zcd);
+        const bool has_zcf_if_needed = !set.Has(F) || !IsRV32(xlen) || set.Has(Zcf);
+        if (set.Has(Zca) && has_zcd_if_needed && has_zcf_if_needed) {
+            set.Add(C);
+        }
+        if (set.Has(Zaamo) && set.Has(Zalrsc)) {
+            set.Add(A);
+        }
+    }
+
+    return set;
+}
+
+std::optional<RISCVExtension> FindExtension(std::string_view name) {
+    const auto iter = std::find(extension_names.begin(), extension_names.end(), name);
+    if (iter == extension_names.end()) {
+        return std::nullopt;
+    }
+    return static_cast<RISCVExtension>(std::distance(extension_names.begin(), iter));
+}
+
+bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Zvl<N>b extensions only describe the minimum vector length.
+bool IsZvlExtension(std::string_view name) {
+    if (name.size() < 5 || !name.starts_with("zvl") || !name.ends_with('b')) {
+        return false;
+    }
+    const auto digits = name.substr(3, name.size() - 4);
+    return std::all_of(digits.begin(), digits.end(), IsDigit);
+}
+
+// Non-standard X extensions are vendor-specific, so none of them are tracked.
+bool IsVendorExtension(std::string_view name) {
+    return name.size() > 1 && name[0] == 'x';
+}
+
+// Attempts to add an extension (or a set of extensions) by name.
+// Returns false if the name is unrecognized.
+bool AddByName(std::string_view name, ExtensionSet& set) {
+    if (const auto extension = FindExtension(name)) {
+        set.Add(*extension);
+        return true;
+    }
+
+    const auto shorthand = std::find_if(shorthands.begin(), shorthands.end(),
+                                        [name](const Shorthand& s) { return s.name == name; });
+    if (shorthand != shorthands.end()) {
+        set |= shorthand->extensions;
+        return true;
+    }
+
+    if (IsZvlExtension(name) || IsVendorExtension(name)) {
+        return true;
+    }
+
+    return std::find(ignored_extensions.begin(), ignored_extensions.end(), name) !=
+           ignored_extensions.end();
+}
+
+// Strips a version suffix (e.g. 2p1) from the end of a multi-letter extension name.
+std::string_view StripVersion(std::string_view name) {
+    auto end = name.size();
+    while (end > 0 && IsDigit(name[end - 1])) {
+        end--;
+    }
+    if (end == name.size()) {
+        return name;
+    }
+    if (end > 1 && name[end - 1] == 'p' && IsDigit(name[end - 2])) {
+        end--;
+        while (end > 0 && IsDigit(name[end - 1])) {
+            end--;
+        }
+    }
+    return name.substr(0, end);
+}
+
+// Parses a run of single-letter extensions, e.g. "imafdc" or "i2p1m2p0".
+bool ParseSingleLetters(std::string_view letters, ExtensionSet& set) {
+    size_t i = 0;
+    while (i < letters.size()) {
+        const char letter = letters[i++];
+        if (!AddByName(std::string_view{&letter, 1}, set)) {
+            return false;
+        }
+
+        // Skip over any version number.
+        while (i < letters.size() && IsDigit(letters[i])) {
+            i++;
+        }
+        if (i + 1 < letters.size() && letters[i] == 'p' && IsDigit(letters[i + 1]) &&
+            IsDigit(letters[i - 1])) {
+            i++;
+            while (i < letters.size() && IsDigit(letters[i])) {
+                i++;
+            }
+        }
+    }
+    return true;
+}
+
+bool IsMultiLetterPrefix(char c) {
+    return c == 'z' || c == 's' || c == 'x';
+}
+
+// Canonical sort key for extension names.
+// Single letter extensions are first, followed by Z, S, and X extensions.
+std::pair<size_t, size_t> CanonicalRank(std::string_view name) {
+    if (name.size() == 1) {
+        return {0, canonical_order.find(name[0])};
+    }
+    switch (name[0]) {
+    case 'z':
+        return {1, canonical_order.find(name[1])};
+    case 's':
+        return {2, 0};
+    default:
+        return {3, 0};
+    }
+}
+
+} // Anonymous namespace
+
+Profile::Profile(ArchFeature xlen, const ExtensionSet& extensions)
+    : m_xlen{xlen}, m_extensions{ExpandImplied(extensions, xlen)} {}
+
+std::optional<Profile> Profile::Parse(std::string_view isa) {
+    // ISA strings are relatively short, so a small stack buffer avoids allocating.
+    std::array<char, 512> buffer{};
+    if (isa.size() > buffer.size()) {
+        return std::nullopt;
+    }
+    for (size_t i = 0; i < isa.size(); i++) {
+        buffer[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(isa[i])));
+    }
+    std::string_view str{buffer.data(), isa.size()};
+
+    for (const auto& preset : presets) {
+        if (str == preset.name) {
+            return Profile{ArchFeature::RV64, preset.extensions};
+        }
+    }
+
+    ArchFeature xlen{};
+    if (str.starts_with("rv32")) {
+        xlen = ArchFeature::RV32;
+        str.remove_prefix(4);
+    } else if (str.starts_with("rv64")) {
+        xlen = ArchFeature::RV64;
+        str.remove_prefix(4);
+    } else if (str.starts_with("rv128")) {
+        xlen = ArchFeature::RV128;
+        str.remove_prefix(5);
+    } else {
+        return std::nullopt;
+    }
+
+    // The base ISA must always be specified first.
+    if (str.empty() || (str[0] != 'i' && str[0] != 'g')) {
+        return std::nullopt;
+    }
+
+    ExtensionSet set;
+    while (!str.empty()) {
+        const auto separator = str.find('_');
+        const auto token = str.substr(0, separator);
+        str.remove_prefix(separator == std::string_view::npos ? str.size() : separator + 1);
+
+        if (token.empty()) {
+            return std::nullopt;
+        }
+
+        if (token.size() > 1 && IsMultiLetterPrefix(token[0])) {
+            if (!AddByName(token, set) && !AddByName(StripVersion(token), set)) {
+                return std::nullopt;
+            }
+            continue;
+        }
+
+        // A run of single letter extensions may be directly followed by a
+        // multi-letter extension without a separating underscore.
+        const auto multi = std::find_if(token.begin(), token.end(), IsMultiLetterPrefix);
+        const auto letters = token.substr(0, static_cast<size_t>(multi - token.begin()));
+        if (!ParseSingleLetters(letters, set)) {
+            return std::nullopt;
+        }
+        if (multi != token.end()) {
+            const auto name = token.substr(letters.size());
+            if (!AddByName(name, set) && !AddByName(StripVersion(name), set)) {
+                return std::nullopt;
+            }
+        }
+    }
+
+    return Profile{xlen, set};
+}
+
+Profile Profile::FromCPU(const CPUInfo& cpu_info, ArchFeature xlen) {
+    ExtensionSet set;
+    for (size_t i = 0; i < extension_names.size(); i++) {
+        const auto extension = static_cast<RISCVExtension>(i);
+        if (cpu_info.Has(extension)) {
+            set.Add(extension);
+        }
+    }
+    return Profile{xlen, set};
+}
+
+Profile Profile::RVA20U64() {
+    return Profile{ArchFeature::RV64, rva20u64_set};
+}
+
+Profile Profile::RVA22U64() {
+    return Profile{ArchFeature::RV64, rva22u64_set};
+}
+
+Profile Profile::RVA23U64() {
+    return Profile{ArchFeature::RV64, rva23u64_set};
+}
+
+bool Profile::IsSupportedBy(const CPUInfo& cpu_info) const {
+    // Probing every extension the CPU may have is relatively costly,
+    // so only the extensions we actually care about are checked.
+    //
+    // Since the CPU may not directly report extensions that are implied
+    // by others, the check falls back to building the full CPU profile.
+    if (cpu_info.HasAll(m_extensions)) {
+        return true;
+    }
+    return IsSupportedBy(FromCPU(cpu_info, m_xlen));
+}
+
+std::string Profile::ToString() const {
+    std::vector<std::string_view> names;
+    for (size_t i = 0; i < extension_names.size(); i++) {
+        if (m_extensions.Has(static_cast<RISCVExtension>(i))) {
+            names.push_back(extension_names[i]);
+        }
+    }
+
+    std::sort(names.begin(), names.end(), [](std::string_view lhs, std::string_view rhs) {
+        const auto lhs_rank = CanonicalRank(lhs);
+        const auto rhs_rank = CanonicalRank(rhs);
+        if (lhs_rank != rhs_rank) {
+            return lhs_rank < rhs_rank;
+        }
+        return lhs < rhs;
+    });
+
+    std::string result;
+    switch (m_xlen) {
+    case ArchFeature::RV32:
+        result = "rv32";
+        break;
+    case ArchFeature::RV64:
+        result = "rv64";
+        break;
+    case ArchFeature::RV128:
+        result = "rv128";
+        break;
+    }
+
+    bool previous_was_multi = false;
+    for (const auto name : names) {
+        const bool is_multi = name.size() > 1;
+        if (is_multi || previous_was_multi) {
+            result += '_';
+        }
+        result += name;
+        previous_was_multi = is_multi;
+    }
+
+    return result;
+}
+
+} // namespace biscuit
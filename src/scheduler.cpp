@@ -0,0 +1,663 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/scheduler.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+namespace biscuit {
+namespace {
+// Registers are numbered with GPRs first, followed by FPRs and vector registers.
+constexpr size_t num_registers = 96;
+constexpr uint8_t no_register = UINT8_MAX;
+
+struct RegisterAccess {
+    std::array<uint8_t, Instruction::max_operands> uses{};
+    size_t num_uses = 0;
+    uint8_t def = no_register;
+
+    [[nodiscard]] bool Uses(uint8_t reg) const noexcept {
+        return reg != no_register && std::find(uses.begin(), uses.begin() + static_cast<ptrdiff_t>(num_uses), reg) !=
+                                         uses.begin() + static_cast<ptrdiff_t>(num_uses);
+    }
+};
+
+[[nodiscard]] uint8_t GetRegisterId(const Operand& operand) noexcept {
+    const auto index = static_cast<uint8_t>(operand.value);
+
+    switch (operand.type) {
+    case OperandType::GPR:
+        // The zero register never carries a dependency.
+        return index == 0 ? no_register : index;
+    case OperandType::FPR:
+        return static_cast<uint8_t>(32 + index);
+    case OperandType::Vec:
+        return static_cast<uint8_t>(64 + index);
+    default:
+        return no_register;
+    }
+}
+
+[[nodiscard]] RegisterAccess GetRegisterAccess(const Instruction& instruction,
+                                               InstructionClass instruction_class) noexcept {
+    // Every class but these writes its first operand.
+    const bool writes_first = instruction_class != InstructionClass::Store &&
+                              instruction_class != InstructionClass::Branch &&
+                              instruction_class != InstructionClass::Other;
+
+    RegisterAccess access;
+    for (size_t i = 0; i < instruction.num_operands; i++) {
+        const auto reg = GetRegisterId(instruction.operands[i]);
+        if (reg == no_register) {
+            continue;
+        }
+
+        if (i == 0 && writes_first) {
+            access.def = reg;
+        } else {
+            access.uses[access.num_uses++] = reg;
+        }
+    }
+    return access;
+}
+
+[[nodiscard]] bool IsMemoryAccess(InstructionClass instruction_class) noexcept {
+    return instruction_class == InstructionClass::Load || instruction_class == InstructionClass::Store;
+}
+
+// An instruction along with what the scheduler needs to know about it.
+struct ScheduledInstruction {
+    InstructionClass instruction_class;
+    RegisterAccess access;
+    bool is_fused;
+};
+
+[[nodiscard]] ScheduledInstruction Analyze(const Instruction& instruction) noexcept {
+    const auto instruction_class = GetInstructionClass(instruction);
+    return {instruction_class, GetRegisterAccess(instruction, instruction_class), false};
+}
+
+// Simulates in-order issue on a core.
+class Pipeline {
+public:
+    explicit Pipeline(const MachineModel& model) noexcept : m_model{model} {
+        BISCUIT_ASSERT(model.issue_width != 0);
+        BISCUIT_ASSERT(model.num_ports != 0 && model.num_ports <= MachineModel::max_ports);
+    }
+
+    void Issue(const ScheduledInstruction& instruction) noexcept {
+        const auto& timing = m_model.GetTiming(instruction.instruction_class);
+        const auto& access = instruction.access;
+
+        // Fused instructions issue along with the instruction before them.
+        if (instruction.is_fused && m_num_issued != 0) {
+            if (access.def != no_register) {
+                m_ready[access.def] = m_cycle + timing.latency;
+            }
+            return;
+        }
+
+        uint64_t cycle = m_cycle;
+        if (instruction.instruction_class == InstructionClass::Other) {
+            // Nothing is known about what these access, so wait for every result.
+            cycle = std::max(cycle, *std::max_element(m_ready.begin(), m_ready.end()));
+        }
+        for (size_t i = 0; i < access.num_uses; i++) {
+            cycle = std::max(cycle, m_ready[access.uses[i]]);
+        }
+
+        const auto port = FindPort(timing.ports, cycle);
+        if (cycle != m_cycle) {
+            m_cycle = cycle;
+            m_issued_in_cycle = 0;
+        }
+
+        m_issued_in_cycle++;
+        m_num_issued++;
+        m_port_free[port] = cycle + timing.occupancy;
+        if (access.def != no_register) {
+            m_ready[access.def] = cycle + timing.latency;
+        }
+    }
+
+    [[nodiscard]] uint64_t GetCycles() const noexcept {
+        return m_num_issued == 0 ? 0 : m_cycle + 1;
+    }
+
+private:
+    // Finds a port that can accept an instruction at the given cycle or later,
+    // and updates the cycle to the one the instruction can issue at.
+    [[nodiscard]] size_t FindPort(uint8_t ports, uint64_t& cycle) const noexcept {
+        BISCUIT_ASSERT(ports != 0 && ports < (1U << m_model.num_ports));
+
+        while (true) {
+            if (cycle == m_cycle && m_issued_in_cycle >= m_model.issue_width) {
+                cycle++;
+                continue;
+            }
+
+            uint64_t next_free = UINT64_MAX;
+            for (size_t port = 0; port < m_model.num_ports; port++) {
+                if ((ports & (1U << port)) == 0) {
+                    continue;
+                }
+                if (m_port_free[port] <= cycle) {
+                    return port;
+                }
+                next_free = std::min(next_free, m_port_free[port]);
+            }
+            cycle = next_free;
+        }
+    }
+
+    const MachineModel& m_model;
+    uint64_t m_cycle = 0;
+    uint32_t m_issued_in_cycle = 0;
+    size_t m_num_issued = 0;
+    std::array<uint64_t, num_registers> m_ready{};
+    std::array<uint64_t, MachineModel::max_ports> m_port_free{};
+};
+
+[[nodiscard]] bool IsSchedulable(const IRNode& node) noexcept {
+    if (!node.IsInstruction() || node.HasLabel()) {
+        return false;
+    }
+
+    const auto instruction_class = GetInstructionClass(node.instruction);
+    return instruction_class != InstructionClass::Branch && instruction_class != InstructionClass::Other;
+}
+
+// Determines the number of cycles that instruction `b` has to issue after instruction `a`
+// preceding it, or std::nullopt if the two are independent.
+[[nodiscard]] std::optional<uint32_t> GetDependency(const ScheduledInstruction& a, const ScheduledInstruction& b,
+                                                    const MachineModel& model) noexcept {
+    std::optional<uint32_t> latency;
+    const auto require = [&latency](uint32_t cycles) {
+        latency = std::max(latency.value_or(0), cycles);
+    };
+
+    if (a.access.def != no_register) {
+        if (b.access.Uses(a.access.def)) {
+            require(model.GetTiming(a.instruction_class).latency);
+        }
+        if (b.access.def == a.access.def) {
+            require(1);
+        }
+    }
+    if (a.access.Uses(b.access.def)) {
+        require(0);
+    }
+
+    const bool a_is_store = a.instruction_class == InstructionClass::Store;
+    const bool b_is_store = b.instruction_class == InstructionClass::Store;
+    if (IsMemoryAccess(a.instruction_class) && IsMemoryAccess(b.instruction_class) && (a_is_store || b_is_store)) {
+        require(0);
+    }
+
+    return latency;
+}
+
+// Reorders the instructions in [begin, end), returning whether or not they were reordered.
+bool ScheduleBlock(std::vector<IRNode>& nodes, size_t begin, size_t end, const MachineModel& model) {
+    const auto size = end - begin;
+
+    std::vector<ScheduledInstruction> instructions;
+    instructions.reserve(size);
+    for (size_t i = begin; i < end; i++) {
+        instructions.push_back(Analyze(nodes[i].instruction));
+    }
+
+    // Fused pairs are scheduled as a single unit, with the first instruction of each
+    // unit determining the port it issues on.
+    struct Unit {
+        size_t first;
+        size_t count;
+    };
+    std::vector<Unit> units;
+    for (size_t i = 0; i < size;) {
+        if (i + 1 < size &&
+            IsFusedPair(model.fusion, nodes[begin + i].instruction, nodes[begin + i + 1].instruction)) {
+            instructions[i + 1].is_fused = true;
+            units.push_back({i, 2});
+            i += 2;
+        } else {
+            units.push_back({i, 1});
+            i += 1;
+        }
+    }
+
+    const auto num_units = units.size();
+    if (num_units < 2) {
+        return false;
+    }
+
+    struct Edge {
+        size_t to;
+        uint32_t latency;
+    };
+    std::vector<std::vector<Edge>> successors(num_units);
+    std::vector<size_t> num_predecessors(num_units);
+
+    for (size_t to = 0; to < num_units; to++) {
+        for (size_t from = 0; from < to; from++) {
+            std::optional<uint32_t> latency;
+            for (size_t a = 0; a < units[from].count; a++) {
+                for (size_t b = 0; b < units[to].count; b++) {
+                    const auto dependency = GetDependency(instructions[units[from].first + a],
+                                                          instructions[units[to].first + b], model);
+                    if (dependency) {
+                        latency = std::max(latency.value_or(0), *dependency);
+                    }
+                }
+            }
+
+            if (latency) {
+                successors[from].push_back({to, *latency});
+                num_predecessors[to]++;
+            }
+        }
+    }
+
+    // Units heading the longest chain of latencies go first.
+    std::vector<uint64_t> heights(num_units);
+    for (size_t i = num_units; i-- > 0;) {
+        uint64_t height = 0;
+        for (size_t j = 0; j < units[i].count; j++) {
+            height = std::max<uint64_t>(height, model.GetTiming(instructions[units[i].first + j].instruction_class).latency);
+        }
+        for (const auto& edge : successors[i]) {
+            height = std::max(height, edge.latency + heights[edge.to]);
+        }
+        heights[i] = height;
+    }
+
+    std::vector<size_t> order;
+    order.reserve(num_units);
+    std::vector<uint64_t> earliest(num_units);
+    std::vector<bool> is_scheduled(num_units);
+    std::array<uint64_t, MachineModel::max_ports> port_free{};
+
+    for (uint64_t cycle = 0; order.size() < num_units; cycle++) {
+        uint32_t num_issued = 0;
+
+        while (num_issued < model.issue_width) {
+            std::optional<size_t> best;
+            size_t best_port = 0;
+
+            for (size_t i = 0; i < num_units; i++) {
+                if (is_scheduled[i] || num_predecessors[i] != 0 || earliest[i] > cycle) {
+                    continue;
+                }
+                if (best && heights[i] <= heights[*best]) {
+                    continue;
+                }
+
+                const auto& timing = model.GetTiming(instructions[units[i].first].instruction_class);
+                for (size_t port = 0; port < model.num_ports; port++) {
+                    if ((timing.ports & (1U << port)) != 0 && port_free[port] <= cycle) {
+                        best = i;
+                        best_port = port;
+                        break;
+                    }
+                }
+            }
+
+            if (!best) {
+                break;
+            }
+
+            const auto unit = *best;
+            is_scheduled[unit] = true;
+            order.push_back(unit);
+            num_issued++;
+            port_free[best_port] = cycle + model.GetTiming(instructions[units[unit].first].instruction_class).occupancy;
+
+            // Successors with a latency of 0 may still issue within this cycle.
+            for (const auto& edge : successors[unit]) {
+                num_predecessors[edge.to]--;
+                earliest[edge.to] = std::max(earliest[edge.to], cycle + edge.latency);
+            }
+        }
+    }
+
+    if (std::is_sorted(order.begin(), order.end())) {
+        return false;
+    }
+
+    // Only keep the new order if it's an improvement.
+    Pipeline original{model};
+    for (const auto& instruction : instructions) {
+        original.Issue(instruction);
+    }
+
+    Pipeline scheduled{model};
+    std::vector<IRNode> reordered;
+    reordered.reserve(size);
+    for (const auto unit : order) {
+        for (size_t i = 0; i < units[unit].count; i++) {
+            scheduled.Issue(instructions[units[unit].first + i]);
+            reordered.push_back(nodes[begin + units[unit].first + i]);
+        }
+    }
+
+    if (scheduled.GetCycles() >= original.GetCycles()) {
+        return false;
+    }
+
+    std::copy(reordered.begin(), reordered.end(), nodes.begin() + static_cast<ptrdiff_t>(begin));
+    return true;
+}
+} // Anonymous namespace
+
+InstructionClass GetInstructionClass(const Instruction& instruction) noexcept {
+    switch (instruction.opcode) {
+    case Opcode::ADD:
+    case Opcode::ADDI:
+    case Opcode::ADDIW:
+    case Opcode::ADDUW:
+    case Opcode::ADDW:
+    case Opcode::AND:
+    case Opcode::ANDI:
+    case Opcode::ANDN:
+    case Opcode::BCLR:
+    case Opcode::BCLRI:
+    case Opcode::BEXT:
+    case Opcode::BEXTI:
+    case Opcode::BINV:
+    case Opcode::BINVI:
+    case Opcode::BSET:
+    case Opcode::BSETI:
+    case Opcode::CLZ:
+    case Opcode::CLZW:
+    case Opcode::CPOP:
+    case Opcode::CPOPW:
+    case Opcode::CTZ:
+    case Opcode::CTZW:
+    case Opcode::CZERO_EQZ:
+    case Opcode::CZERO_NEZ:
+    case Opcode::LUI:
+    case Opcode::MAX:
+    case Opcode::MAXU:
+    case Opcode::MIN:
+    case Opcode::MINU:
+    case Opcode::OR:
+    case Opcode::ORCB:
+    case Opcode::ORI:
+    case Opcode::ORN:
+    case Opcode::PACK:
+    case Opcode::PACKH:
+    case Opcode::PACKW:
+    case Opcode::REV8:
+    case Opcode::ROL:
+    case Opcode::ROLW:
+    case Opcode::ROR:
+    case Opcode::RORI:
+    case Opcode::RORIW:
+    case Opcode::RORW:
+    case Opcode::SEXTB:
+    case Opcode::SEXTH:
+    case Opcode::SH1ADD:
+    case Opcode::SH1ADDUW:
+    case Opcode::SH2ADD:
+    case Opcode::SH2ADDUW:
+    case Opcode::SH3ADD:
+    case Opcode::SH3ADDUW:
+    case Opcode::SLL:
+    case Opcode::SLLI:
+    case Opcode::SLLIUW:
+    case Opcode::SLLIW:
+    case Opcode::SLLW:
+    case Opcode::SLT:
+    case Opcode::SLTI:
+    case Opcode::SLTIU:
+    case Opcode::SLTU:
+    case Opcode::SRA:
+    case Opcode::SRAI:
+    case Opcode::SRAIW:
+    case Opcode::SRAW:
+    case Opcode::SRL:
+    case Opcode::SRLI:
+    case Opcode::SRLIW:
+    case Opcode::SRLW:
+    case Opcode::SUB:
+    case Opcode::SUBW:
+    case Opcode::XNOR:
+    case Opcode::XOR:
+    case Opcode::XORI:
+    case Opcode::ZEXTH:
+        return InstructionClass::IntAlu;
+
+    case Opcode::CLMUL:
+    case Opcode::CLMULH:
+    case Opcode::CLMULR:
+    case Opcode::MUL:
+    case Opcode::MULH:
+    case Opcode::MULHSU:
+    case Opcode::MULHU:
+    case Opcode::MULW:
+        return InstructionClass::IntMul;
+
+    case Opcode::DIV:
+    case Opcode::DIVU:
+    case Opcode::DIVUW:
+    case Opcode::DIVW:
+    case Opcode::REM:
+    case Opcode::REMU:
+    case Opcode::REMUW:
+    case Opcode::REMW:
+        return InstructionClass::IntDiv;
+
+    case Opcode::FLD:
+    case Opcode::FLH:
+    case Opcode::FLW:
+    case Opcode::LB:
+    case Opcode::LBU:
+    case Opcode::LD:
+    case Opcode::LH:
+    case Opcode::LHU:
+    case Opcode::LW:
+    case Opcode::LWU:
+        return InstructionClass::Load;
+
+    case Opcode::FSD:
+    case Opcode::FSH:
+    case Opcode::FSW:
+    case Opcode::SB:
+    case Opcode::SD:
+    case Opcode::SH:
+    case Opcode::SW:
+        return InstructionClass::Store;
+
+    case Opcode::FADD_D:
+    case Opcode::FADD_S:
+    case Opcode::FCLASS_D:
+    case Opcode::FCLASS_S:
+    case Opcode::FCVT_D_L:
+    case Opcode::FCVT_D_LU:
+    case Opcode::FCVT_D_S:
+    case Opcode::FCVT_D_W:
+    case Opcode::FCVT_D_WU:
+    case Opcode::FCVT_L_D:
+    case Opcode::FCVT_L_S:
+    case Opcode::FCVT_LU_D:
+    case Opcode::FCVT_LU_S:
+    case Opcode::FCVT_S_D:
+    case Opcode::FCVT_S_L:
+    case Opcode::FCVT_S_LU:
+    case Opcode::FCVT_S_W:
+    case Opcode::FCVT_S_WU:
+    case Opcode::FCVT_W_D:
+    case Opcode::FCVT_W_S:
+    case Opcode::FCVT_WU_D:
+    case Opcode::FCVT_WU_S:
+    case Opcode::FEQ_D:
+    case Opcode::FEQ_S:
+    case Opcode::FLE_D:
+    case Opcode::FLE_S:
+    case Opcode::FLT_D:
+    case Opcode::FLT_S:
+    case Opcode::FMAX_D:
+    case Opcode::FMAX_S:
+    case Opcode::FMIN_D:
+    case Opcode::FMIN_S:
+    case Opcode::FMV_D_X:
+    case Opcode::FMV_W_X:
+    case Opcode::FMV_X_D:
+    case Opcode::FMV_X_W:
+    case Opcode::FSGNJ_D:
+    case Opcode::FSGNJ_S:
+    case Opcode::FSGNJN_D:
+    case Opcode::FSGNJN_S:
+    case Opcode::FSGNJX_D:
+    case Opcode::FSGNJX_S:
+    case Opcode::FSUB_D:
+    case Opcode::FSUB_S:
+        return InstructionClass::FpAlu;
+
+    case Opcode::FMADD_D:
+    case Opcode::FMADD_S:
+    case Opcode::FMSUB_D:
+    case Opcode::FMSUB_S:
+    case Opcode::FMUL_D:
+    case Opcode::FMUL_S:
+    case Opcode::FNMADD_D:
+    case Opcode::FNMADD_S:
+    case Opcode::FNMSUB_D:
+    case Opcode::FNMSUB_S:
+        return InstructionClass::FpMul;
+
+    case Opcode::FDIV_D:
+    case Opcode::FDIV_S:
+    case Opcode::FSQRT_D:
+    case Opcode::FSQRT_S:
+        return InstructionClass::FpDiv;
+
+    case Opcode::BEQ:
+    case Opcode::BGE:
+    case Opcode::BGEU:
+    case Opcode::BLT:
+    case Opcode::BLTU:
+    case Opcode::BNE:
+    case Opcode::JAL:
+        return InstructionClass::Branch;
+
+    default:
+        return InstructionClass::Other;
+    }
+}
+
+MachineModel MachineModel::SiFiveU74() noexcept {
+    // Ports: 0 and 1 are the ALUs of both pipes, 2 is the memory pipe,
+    // 3 is the multiply/divide unit, and 4 is the floating-point unit.
+    return {
+        .name = "SiFive U74",
+        .issue_width = 2,
+        .num_ports = 5,
+        .fetch_block_size = 8,
+        .timings = {{
+            {.latency = 1, .occupancy = 1, .ports = 0b00011},   // IntAlu
+            {.latency = 3, .occupancy = 1, .ports = 0b01000},   // IntMul
+            {.latency = 20, .occupancy = 20, .ports = 0b01000}, // IntDiv
+            {.latency = 3, .occupancy = 1, .ports = 0b00100},   // Load
+            {.latency = 1, .occupancy = 1, .ports = 0b00100},   // Store
+            {.latency = 5, .occupancy = 1, .ports = 0b10000},   // FpAlu
+            {.latency = 5, .occupancy = 1, .ports = 0b10000},   // FpMul
+            {.latency = 20, .occupancy = 20, .ports = 0b10000}, // FpDiv
+            {.latency = 1, .occupancy = 1, .ports = 0b00011},   // Branch
+            {.latency = 1, .occupancy = 1, .ports = 0b00011},   // Other
+        }},
+        .fusion = FusionProfile::None,
+    };
+}
+
+MachineModel MachineModel::TheadC906() noexcept {
+    // Ports: 0 is the ALU, 1 is the load/store unit, 2 is the
+    // multiply/divide unit, and 3 is the floating-point unit.
+    return {
+        .name = "T-Head C906",
+        .issue_width = 1,
+        .num_ports = 4,
+        .fetch_block_size = 8,
+        .timings = {{
+            {.latency = 1, .occupancy = 1, .ports = 0b0001},   // IntAlu
+            {.latency = 3, .occupancy = 1, .ports = 0b0100},   // IntMul
+            {.latency = 20, .occupancy = 20, .ports = 0b0100}, // IntDiv
+            {.latency = 3, .occupancy = 1, .ports = 0b0010},   // Load
+            {.latency = 1, .occupancy = 1, .ports = 0b0010},   // Store
+            {.latency = 3, .occupancy = 1, .ports = 0b1000},   // FpAlu
+            {.latency = 4, .occupancy = 1, .ports = 0b1000},   // FpMul
+            {.latency = 17, .occupancy = 17, .ports = 0b1000}, // FpDiv
+            {.latency = 1, .occupancy = 1, .ports = 0b0001},   // Branch
+            {.latency = 1, .occupancy = 1, .ports = 0b0001},   // Other
+        }},
+        .fusion = FusionProfile::None,
+    };
+}
+
+uint64_t EstimateCycles(const IRStream& stream, const MachineModel& model) {
+    Pipeline pipeline{model};
+    const Instruction* previous = nullptr;
+
+    for (const auto& node : stream.GetNodes()) {
+        switch (node.kind) {
+        case IRNodeKind::Instruction: {
+            auto instruction = Analyze(node.instruction);
+            instruction.is_fused = previous != nullptr && IsFusedPair(model.fusion, *previous, node.instruction);
+            pipeline.Issue(instruction);
+
+            // Each instruction fuses with at most one other.
+            previous = instruction.is_fused ? nullptr : &node.instruction;
+            break;
+        }
+        case IRNodeKind::LabelAddress: {
+            // An AUIPC followed by an ADDI completing the address.
+            const auto rd = GetRegisterId(node.instruction.operands[0]);
+
+            RegisterAccess access;
+            access.def = rd;
+            pipeline.Issue({InstructionClass::IntAlu, access, false});
+
+            if (rd != no_register) {
+                access.uses[access.num_uses++] = rd;
+            }
+            const auto is_fused = (model.fusion & FusionProfile::AuipcAddi) == FusionProfile::AuipcAddi;
+            pipeline.Issue({InstructionClass::IntAlu, access, is_fused});
+
+            previous = nullptr;
+            break;
+        }
+        case IRNodeKind::Bind:
+        case IRNodeKind::Data:
+            previous = nullptr;
+            break;
+        }
+    }
+
+    return pipeline.GetCycles();
+}
+
+size_t Scheduler::Run(IRStream& stream) const {
+    auto& nodes = stream.GetNodes();
+    size_t num_reordered = 0;
+
+    for (size_t begin = 0; begin < nodes.size();) {
+        if (!IsSchedulable(nodes[begin])) {
+            begin++;
+            continue;
+        }
+
+        auto end = begin + 1;
+        while (end < nodes.size() && IsSchedulable(nodes[end])) {
+            end++;
+        }
+
+        if (ScheduleBlock(nodes, begin, end, m_model)) {
+            num_reordered++;
+        }
+        begin = end;
+    }
+
+    return num_reordered;
+}
+
+} // namespace biscuit
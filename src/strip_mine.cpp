@@ -0,0 +1,126 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/label.hpp>
+#include <biscuit/strip_mine.hpp>
+
+#include <bit>
+#include <optional>
+
+namespace biscuit {
+namespace {
+// Retrieves the number of registers within a group, treating fractional groups as one register.
+[[nodiscard]] uint32_t GetGroupSize(LMUL lmul) noexcept {
+    switch (lmul) {
+    case LMUL::M2:
+        return 2;
+    case LMUL::M4:
+        return 4;
+    case LMUL::M8:
+        return 8;
+    default:
+        return 1;
+    }
+}
+} // Anonymous namespace
+
+Vec StripMineStrip::GetGroup(uint32_t index) const noexcept {
+    BISCUIT_ASSERT(index < groups_per_body);
+    return Vec{first_group.Index() + (unroll_index * groups_per_body + index) * group_size};
+}
+
+StripMineLoop::StripMineLoop(Assembler& assembler, SEW sew, LMUL lmul, const ExtensionSet& extensions) noexcept
+    : m_assembler{assembler}, m_extensions{extensions}, m_sew{sew}, m_lmul{lmul} {}
+
+void StripMineLoop::SetUnroll(uint32_t factor, uint32_t groups_per_body) {
+    BISCUIT_ASSERT(factor >= 1 && groups_per_body >= 1);
+
+    // v0 is skipped, so the first aligned group is the group size itself.
+    const auto group_size = GetGroupSize(m_lmul);
+    BISCUIT_ASSERT(group_size + factor * groups_per_body * group_size <= 32);
+
+    m_unroll_factor = factor;
+    m_groups_per_body = groups_per_body;
+}
+
+void StripMineLoop::AddPointer(GPR pointer, uint32_t element_size) {
+    BISCUIT_ASSERT(pointer != zero);
+    BISCUIT_ASSERT(std::has_single_bit(element_size) || element_size == 0);
+
+    const auto shift = element_size == 0 ? static_cast<uint32_t>(m_sew)
+                                         : static_cast<uint32_t>(std::countr_zero(element_size));
+    m_pointers.push_back({
+        .reg = pointer,
+        .shift = shift,
+    });
+}
+
+void StripMineLoop::Emit(GPR count, GPR vl, GPR scratch, const Body& body) {
+    BISCUIT_ASSERT(count != zero && vl != zero && scratch != zero);
+    BISCUIT_ASSERT(count != vl && count != scratch && vl != scratch);
+    for (const auto& pointer : m_pointers) {
+        BISCUIT_ASSERT(pointer.reg != count && pointer.reg != vl && pointer.reg != scratch);
+    }
+
+    const auto group_size = GetGroupSize(m_lmul);
+    const auto groups_per_body = m_groups_per_body != 0 ? m_groups_per_body
+                                                        : (32 - group_size) / group_size;
+
+    Label loop;
+    Label done;
+
+    m_assembler.BEQZ(count, &done);
+    m_assembler.Bind(&loop);
+
+    for (uint32_t i = 0; i < m_unroll_factor; i++) {
+        m_assembler.VSETVLI(vl, count, m_sew, m_lmul, m_vta, m_vma);
+
+        body(m_assembler, StripMineStrip{
+                              .vl = vl,
+                              .unroll_index = i,
+                              .groups_per_body = groups_per_body,
+                              .first_group = Vec{group_size},
+                              .group_size = group_size,
+                          });
+
+        m_assembler.SUB(count, count, vl);
+        EmitPointerIncrements(vl, scratch);
+
+        // Every strip but the last leaves early once nothing remains,
+        // the last one loops back while something remains.
+        if (i + 1 < m_unroll_factor) {
+            m_assembler.BEQZ(count, &done);
+        }
+    }
+
+    m_assembler.BNEZ(count, &loop);
+    m_assembler.Bind(&done);
+}
+
+void StripMineLoop::EmitPointerIncrements(GPR vl, GPR scratch) {
+    const bool has_zba = m_extensions.Has(RISCVExtension::Zba);
+
+    // The shifted length is kept around in case further pointers need it.
+    std::optional<uint32_t> scratch_shift;
+
+    for (const auto& pointer : m_pointers) {
+        const auto reg = pointer.reg;
+        const auto shift = pointer.shift;
+
+        if (shift == 0) {
+            m_assembler.ADD(reg, reg, vl);
+        } else if (has_zba && shift == 1) {
+            m_assembler.SH1ADD(reg, vl, reg);
+        } else if (has_zba && shift == 2) {
+            m_assembler.SH2ADD(reg, vl, reg);
+        } else if (has_zba && shift == 3) {
+            m_assembler.SH3ADD(reg, vl, reg);
+        } else {
+            if (scratch_shift != shift) {
+                m_assembler.SLLI(scratch, vl, shift);
+                scratch_shift = shift;
+            }
+            m_assembler.ADD(reg, reg, scratch);
+        }
+    }
+}
+
+} // namespace biscuit
@@ -0,0 +1,304 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/switch.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include "assembler_util.hpp"
+
+namespace biscuit {
+namespace {
+// The number of values in [low, high], saturated for ranges that don't fit.
+[[nodiscard]] uint64_t GetRangeSize(int64_t low, int64_t high) noexcept {
+    const auto distance = static_cast<uint64_t>(high) - static_cast<uint64_t>(low);
+    return distance == UINT64_MAX ? UINT64_MAX : distance + 1;
+}
+} // Anonymous namespace
+
+Switch::Switch(Assembler& assembler, const ExtensionSet& extensions)
+    : m_assembler{assembler}, m_extensions{extensions} {}
+
+Switch::~Switch() noexcept {
+    // It's a logic bug if a jump table refers to a destination that's never resolved.
+    BISCUIT_ASSERT(!HasPendingEntries());
+}
+
+void Switch::AddCase(int64_t value, Label* target) {
+    BISCUIT_ASSERT(target != nullptr);
+    BISCUIT_ASSERT(!m_is_emitted);
+    BISCUIT_ASSERT(!IsRV32(m_assembler.GetArchFeatures()) ||
+                   (value >= INT32_MIN && value <= INT32_MAX));
+
+    m_cases.push_back({value, target});
+}
+
+void Switch::Emit(GPR value, Label* default_target, GPR scratch1, GPR scratch2) {
+    BISCUIT_ASSERT(!m_is_emitted);
+    BISCUIT_ASSERT(default_target != nullptr);
+    BISCUIT_ASSERT(value != zero && scratch1 != zero && scratch2 != zero);
+    BISCUIT_ASSERT(value != scratch1 && value != scratch2 && scratch1 != scratch2);
+
+    m_value = value;
+    m_scratch1 = scratch1;
+    m_scratch2 = scratch2;
+    m_default = default_target;
+    m_is_emitted = true;
+
+    std::sort(m_cases.begin(), m_cases.end(), [](const Case& lhs, const Case& rhs) {
+        return lhs.value < rhs.value;
+    });
+    BISCUIT_ASSERT(std::adjacent_find(m_cases.begin(), m_cases.end(), [](const Case& lhs, const Case& rhs) {
+                       return lhs.value == rhs.value;
+                   }) == m_cases.end());
+
+    BuildClusters();
+    EmitTree(0, m_clusters.size());
+}
+
+void Switch::Resolve() {
+    std::erase_if(m_pending_entries, [this](const TableEntry& entry) {
+        BISCUIT_ASSERT(entry.target->IsBound());
+        WriteEntry(entry);
+        return true;
+    });
+}
+
+void Switch::BuildClusters() {
+    const auto xlen = IsRV32(m_assembler.GetArchFeatures()) ? 32U : 64U;
+    const auto num_cases = m_cases.size();
+
+    size_t first = 0;
+    while (first < num_cases) {
+        const auto low = m_cases[first].value;
+
+        // Prefer the largest jump table starting at this case that's dense enough.
+        size_t last = num_cases;
+        while (last >= first + min_jump_table_cases) {
+            const auto high = m_cases[last - 1].value;
+            const auto range = GetRangeSize(low, high);
+            const auto count = last - first;
+
+            if (range <= max_jump_table_entries && count * 100 >= range * min_jump_table_density) {
+                break;
+            }
+            last--;
+        }
+        if (last >= first + min_jump_table_cases) {
+            m_clusters.push_back({SwitchClusterKind::JumpTable, low, m_cases[last - 1].value});
+            first = last;
+            continue;
+        }
+
+        // Otherwise take as many cases as fit into a bit test.
+        std::vector<Label*> destinations;
+        last = first;
+        while (last < num_cases && GetRangeSize(low, m_cases[last].value) <= xlen) {
+            auto* const target = m_cases[last].target;
+            if (std::find(destinations.begin(), destinations.end(), target) == destinations.end()) {
+                if (destinations.size() == max_bit_test_destinations) {
+                    break;
+                }
+                destinations.push_back(target);
+            }
+            last++;
+        }
+        if (last - first >= min_bit_test_cases) {
+            m_clusters.push_back({SwitchClusterKind::BitTest, low, m_cases[last - 1].value});
+            first = last;
+            continue;
+        }
+
+        m_clusters.push_back({SwitchClusterKind::Compare, low, low});
+        first++;
+    }
+}
+
+void Switch::EmitTree(size_t first, size_t last) {
+    // A few single compares are cheaper to chain than to search.
+    const bool is_chain = last - first <= 3 &&
+                          std::all_of(m_clusters.begin() + static_cast<ptrdiff_t>(first),
+                                      m_clusters.begin() + static_cast<ptrdiff_t>(last),
+                                      [](const SwitchCluster& cluster) {
+                                          return cluster.kind == SwitchClusterKind::Compare;
+                                      });
+
+    if (last - first <= 1 || is_chain) {
+        for (size_t i = first; i < last; i++) {
+            const auto& cluster = m_clusters[i];
+            switch (cluster.kind) {
+            case SwitchClusterKind::Compare:
+                EmitCompare(cluster);
+                break;
+            case SwitchClusterKind::BitTest:
+                EmitBitTest(cluster);
+                break;
+            case SwitchClusterKind::JumpTable:
+                EmitJumpTable(cluster);
+                break;
+            }
+        }
+
+        // Jump tables always end in an indirect jump.
+        if (last - first != 1 || m_clusters[first].kind != SwitchClusterKind::JumpTable) {
+            m_assembler.J(m_default);
+        }
+        return;
+    }
+
+    const auto middle = first + (last - first) / 2;
+
+    // Labels within the tree are bound before this returns, so they're resolved by then.
+    Label lower;
+    m_assembler.LI(m_scratch1, static_cast<uint64_t>(m_clusters[middle].low));
+    m_assembler.BLT(m_value, m_scratch1, &lower);
+    EmitTree(middle, last);
+    m_assembler.Bind(&lower);
+    EmitTree(first, middle);
+}
+
+void Switch::EmitCompare(const SwitchCluster& cluster) {
+    auto* const target = GetCases(cluster.low, cluster.high).front().target;
+
+    if (cluster.low == 0) {
+        EmitJumpIfZero(m_value, target);
+        return;
+    }
+
+    Label skip;
+    m_assembler.LI(m_scratch1, static_cast<uint64_t>(cluster.low));
+    m_assembler.BNE(m_value, m_scratch1, &skip);
+    m_assembler.J(target);
+    m_assembler.Bind(&skip);
+}
+
+void Switch::EmitBitTest(const SwitchCluster& cluster) {
+    EmitRangeCheck(cluster.low, cluster.high);
+
+    // scratch1 = 1 << (value - low)
+    m_assembler.LI(m_scratch2, 1);
+    m_assembler.SLL(m_scratch1, m_scratch2, m_scratch1);
+
+    // Destinations are tested in the order of their first case.
+    std::vector<std::pair<Label*, uint64_t>> masks;
+    for (const auto& [value, target] : GetCases(cluster.low, cluster.high)) {
+        const auto bit = uint64_t{1} << (static_cast<uint64_t>(value) - static_cast<uint64_t>(cluster.low));
+        const auto iter = std::find_if(masks.begin(), masks.end(), [target](const auto& mask) {
+            return mask.first == target;
+        });
+
+        if (iter == masks.end()) {
+            masks.emplace_back(target, bit);
+        } else {
+            iter->second |= bit;
+        }
+    }
+
+    for (const auto& [target, mask] : masks) {
+        m_assembler.LI(m_scratch2, mask);
+        m_assembler.AND(m_scratch2, m_scratch1, m_scratch2);
+        EmitJumpIfNotZero(m_scratch2, target);
+    }
+}
+
+void Switch::EmitJumpTable(const SwitchCluster& cluster) {
+    EmitRangeCheck(cluster.low, cluster.high);
+
+    auto& buffer = m_assembler.GetCodeBuffer();
+
+    // The address of the table is patched in once its location is known.
+    const auto auipc = buffer.GetCursorOffset();
+    EmitUType(buffer, 0, m_scratch2, 0b0010111);
+    EmitIType(buffer, 0, m_scratch2, 0b000, m_scratch2, 0b0010011);
+
+    if (m_extensions.Has(RISCVExtension::Zba)) {
+        m_assembler.SH2ADD(m_scratch1, m_scratch1, m_scratch2);
+    } else {
+        m_assembler.SLLI(m_scratch1, m_scratch1, 2);
+        m_assembler.ADD(m_scratch1, m_scratch1, m_scratch2);
+    }
+    m_assembler.LW(m_scratch1, 0, m_scratch1);
+    m_assembler.ADD(m_scratch1, m_scratch1, m_scratch2);
+    m_assembler.JR(m_scratch1);
+
+    // The padding is never executed.
+    if (buffer.GetCursorOffset() % 4 != 0) {
+        buffer.Emit16(0);
+    }
+
+    const auto table = buffer.GetCursorOffset();
+    [[maybe_unused]] const bool patched = PatchAUIPCPair(buffer, auipc, buffer.GetOffsetAddress(table));
+    BISCUIT_ASSERT(patched);
+
+    const auto cases = GetCases(cluster.low, cluster.high);
+    auto iter = cases.begin();
+
+    const auto num_entries = GetRangeSize(cluster.low, cluster.high);
+    for (uint64_t i = 0; i < num_entries; i++) {
+        const auto value = static_cast<int64_t>(static_cast<uint64_t>(cluster.low) + i);
+
+        Label* target = m_default;
+        if (iter != cases.end() && iter->value == value) {
+            target = iter->target;
+            ++iter;
+        }
+
+        const TableEntry entry{buffer.GetCursorOffset(), table, target};
+        buffer.Emit32(0);
+
+        if (target->IsBound()) {
+            WriteEntry(entry);
+        } else {
+            m_pending_entries.push_back(entry);
+        }
+    }
+}
+
+void Switch::EmitRangeCheck(int64_t low, int64_t high) {
+    if (low > INT64_MIN && IsValidSigned12BitImm(-low)) {
+        m_assembler.ADDI(m_scratch1, m_value, static_cast<int32_t>(-low));
+    } else {
+        m_assembler.LI(m_scratch1, static_cast<uint64_t>(low));
+        m_assembler.SUB(m_scratch1, m_value, m_scratch1);
+    }
+
+    // Values below the range wrap around to large unsigned values.
+    Label in_range;
+    m_assembler.LI(m_scratch2, static_cast<uint64_t>(high) - static_cast<uint64_t>(low));
+    m_assembler.BLEU(m_scratch1, m_scratch2, &in_range);
+    m_assembler.J(m_default);
+    m_assembler.Bind(&in_range);
+}
+
+void Switch::EmitJumpIfZero(GPR rs, Label* target) {
+    Label skip;
+    m_assembler.BNEZ(rs, &skip);
+    m_assembler.J(target);
+    m_assembler.Bind(&skip);
+}
+
+void Switch::EmitJumpIfNotZero(GPR rs, Label* target) {
+    Label skip;
+    m_assembler.BEQZ(rs, &skip);
+    m_assembler.J(target);
+    m_assembler.Bind(&skip);
+}
+
+void Switch::WriteEntry(const TableEntry& entry) {
+    const auto distance = *entry.target->GetLocation() - entry.table;
+    BISCUIT_ASSERT(distance >= INT32_MIN && distance <= INT32_MAX);
+
+    const auto value = static_cast<int32_t>(distance);
+    std::memcpy(m_assembler.GetCodeBuffer().GetOffsetPointer(entry.offset), &value, sizeof(value));
+}
+
+std::vector<Switch::Case> Switch::GetCases(int64_t low, int64_t high) const {
+    const auto begin = std::lower_bound(m_cases.begin(), m_cases.end(), low, [](const Case& c, int64_t value) {
+        return c.value < value;
+    });
+    const auto end = std::upper_bound(begin, m_cases.end(), high, [](int64_t value, const Case& c) {
+        return value < c.value;
+    });
+    return {begin, end};
+}
+
+} // namespace biscuit
@@ -0,0 +1,195 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/vector_allocator.hpp>
+
+#include <bit>
+
+namespace biscuit {
+namespace {
+// A range of consecutive vector registers.
+struct RegisterRange {
+    uint32_t first;
+    uint32_t size;
+};
+
+[[nodiscard]] bool IsFractional(LMUL lmul) noexcept {
+    return lmul == LMUL::MF2 || lmul == LMUL::MF4 || lmul == LMUL::MF8;
+}
+
+// Retrieves the number of registers within a group, treating fractional groups as one register.
+[[nodiscard]] uint32_t GetGroupSize(LMUL lmul) noexcept {
+    switch (lmul) {
+    case LMUL::M2:
+        return 2;
+    case LMUL::M4:
+        return 4;
+    case LMUL::M8:
+        return 8;
+    default:
+        return 1;
+    }
+}
+
+[[nodiscard]] bool IsAligned(RegisterRange group) noexcept {
+    return group.size <= 8 && group.first % group.size == 0 && group.first + group.size <= 32;
+}
+
+[[nodiscard]] bool Overlaps(RegisterRange lhs, RegisterRange rhs) noexcept {
+    return lhs.first < rhs.first + rhs.size && rhs.first < lhs.first + lhs.size;
+}
+
+[[nodiscard]] uint32_t GetMask(RegisterRange group) noexcept {
+    return ((1U << group.size) - 1) << group.first;
+}
+} // Anonymous namespace
+
+bool AreVectorOperandsLegal(VectorShape shape, LMUL lmul, Vec vd, Vec vs2,
+                            std::optional<Vec> vs1, VecMask mask) noexcept {
+    const auto narrow = GetGroupSize(lmul);
+    const auto wide = IsFractional(lmul) ? 1U : narrow * 2;
+
+    RegisterRange dest{vd.Index(), narrow};
+    RegisterRange src2{vs2.Index(), narrow};
+    RegisterRange src1{vs1.value_or(vs2).Index(), narrow};
+
+    switch (shape) {
+    case VectorShape::SingleWidth:
+        break;
+    case VectorShape::Widening:
+        dest.size = wide;
+        break;
+    case VectorShape::WideningWide:
+        dest.size = wide;
+        src2.size = wide;
+        break;
+    case VectorShape::Narrowing:
+        src2.size = wide;
+        break;
+    case VectorShape::Reduction:
+    case VectorShape::WideningReduction:
+        dest.size = 1;
+        src1.size = 1;
+        break;
+    }
+
+    if (!IsAligned(dest) || !IsAligned(src2) || (vs1 && !IsAligned(src1))) {
+        return false;
+    }
+
+    // A destination of a wider element width may only overlap a source in its highest-numbered
+    // part, and only if the source group is made up of whole registers.
+    const auto is_legal_widening_overlap = [&](RegisterRange source) {
+        if (!Overlaps(dest, source)) {
+            return true;
+        }
+        return !IsFractional(lmul) && source.first + source.size == dest.first + dest.size;
+    };
+
+    // A destination of a narrower element width may only overlap the lowest-numbered part of the source.
+    const auto is_legal_narrowing_overlap = [&](RegisterRange source) {
+        return !Overlaps(dest, source) || dest.first == source.first;
+    };
+
+    switch (shape) {
+    case VectorShape::Widening:
+        if (!is_legal_widening_overlap(src2) || (vs1 && !is_legal_widening_overlap(src1))) {
+            return false;
+        }
+        break;
+    case VectorShape::WideningWide:
+        if (vs1 && (!is_legal_widening_overlap(src1) || Overlaps(src1, src2))) {
+            return false;
+        }
+        break;
+    case VectorShape::Narrowing:
+        if (!is_legal_narrowing_overlap(src2) || (vs1 && Overlaps(src1, src2))) {
+            return false;
+        }
+        break;
+    case VectorShape::WideningReduction:
+        // The scalar source is read with twice the element width of the vector source.
+        if (vs1 && Overlaps(src1, src2)) {
+            return false;
+        }
+        break;
+    default:
+        break;
+    }
+
+    // The mask is a source with an element width of one bit.
+    if (mask == VecMask::Yes) {
+        const RegisterRange mask_range{0, 1};
+        if (Overlaps(src2, mask_range) || (vs1 && Overlaps(src1, mask_range))) {
+            return false;
+        }
+        const auto is_reduction = shape == VectorShape::Reduction || shape == VectorShape::WideningReduction;
+        if (!is_reduction && Overlaps(dest, mask_range)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+VectorRegisterAllocator::Scope::Scope(VectorRegisterAllocator& allocator) noexcept
+    : m_allocator{allocator}, m_depth{++allocator.m_depth} {}
+
+VectorRegisterAllocator::Scope::~Scope() noexcept {
+    BISCUIT_ASSERT(m_allocator.m_depth == m_depth);
+
+    for (uint32_t i = 0; i < m_allocator.m_groups.size(); i++) {
+        const auto& group = m_allocator.m_groups[i];
+        if (group.size != 0 && group.depth == m_depth) {
+            m_allocator.Free(Vec{i});
+        }
+    }
+
+    m_allocator.m_depth--;
+}
+
+std::optional<Vec> VectorRegisterAllocator::TryAllocate(LMUL lmul) noexcept {
+    const auto size = GetGroupSize(lmul);
+
+    // Starting at the group size skips over v0, which is reserved for masks.
+    for (uint32_t first = size; first + size <= 32; first += size) {
+        if ((m_live & GetMask({first, size})) == 0) {
+            MarkLive(first, size);
+            return Vec{first};
+        }
+    }
+
+    return std::nullopt;
+}
+
+Vec VectorRegisterAllocator::Allocate(LMUL lmul) noexcept {
+    const auto group = TryAllocate(lmul);
+    BISCUIT_ASSERT(group.has_value());
+    return *group;
+}
+
+Vec VectorRegisterAllocator::AllocateMask() noexcept {
+    BISCUIT_ASSERT(!IsLive(v0));
+    MarkLive(0, 1);
+    return v0;
+}
+
+void VectorRegisterAllocator::Free(Vec group) noexcept {
+    auto& entry = m_groups[group.Index()];
+    BISCUIT_ASSERT(entry.size != 0);
+
+    m_live &= ~GetMask({group.Index(), entry.size});
+    entry = {};
+}
+
+uint32_t VectorRegisterAllocator::GetFreeCount() const noexcept {
+    return 32 - static_cast<uint32_t>(std::popcount(m_live));
+}
+
+void VectorRegisterAllocator::MarkLive(uint32_t index, uint32_t size) noexcept {
+    m_live |= GetMask({index, size});
+    m_groups[index] = {
+        .size = static_cast<uint8_t>(size),
+        .depth = static_cast<uint8_t>(m_depth),
+    };
+}
+
+} // namespace biscuit
@@ -0,0 +1,651 @@
+#include <biscuit/assert.hpp>
+#include <biscuit/virtual_registers.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <span>
+
+#include "assembler_util.hpp"
+
+namespace biscuit {
+namespace {
+// Values referenced by at least this many nodes prefer registers that compressed instructions can encode.
+constexpr uint32_t compressible_reference_count = 3;
+
+// Registers handed out by the allocator, grouped by how they're preferred.
+struct RegisterPool {
+    std::span<const uint32_t> caller_saved_compressible;
+    std::span<const uint32_t> caller_saved;
+    std::span<const uint32_t> callee_saved_compressible;
+    std::span<const uint32_t> callee_saved;
+};
+
+// a0-a5, t0-t4 and a6-a7, s0-s1, s2-s11. t5 and t6 are kept for spill code.
+constexpr std::array<uint32_t, 6> gpr_caller_saved_compressible{10, 11, 12, 13, 14, 15};
+constexpr std::array<uint32_t, 7> gpr_caller_saved{5, 6, 7, 28, 29, 16, 17};
+constexpr std::array<uint32_t, 2> gpr_callee_saved_compressible{8, 9};
+constexpr std::array<uint32_t, 10> gpr_callee_saved{18, 19, 20, 21, 22, 23, 24, 25, 26, 27};
+
+// fa0-fa5, ft0-ft8 and fa6-fa7, fs0-fs1, fs2-fs11. ft9-ft11 are kept for spill code.
+constexpr std::array<uint32_t, 6> fpr_caller_saved_compressible{10, 11, 12, 13, 14, 15};
+constexpr std::array<uint32_t, 11> fpr_caller_saved{0, 1, 2, 3, 4, 5, 6, 7, 28, 16, 17};
+constexpr std::array<uint32_t, 2> fpr_callee_saved_compressible{8, 9};
+constexpr std::array<uint32_t, 10> fpr_callee_saved{18, 19, 20, 21, 22, 23, 24, 25, 26, 27};
+
+constexpr RegisterPool gpr_pool{
+    .caller_saved_compressible = gpr_caller_saved_compressible,
+    .caller_saved = gpr_caller_saved,
+    .callee_saved_compressible = gpr_callee_saved_compressible,
+    .callee_saved = gpr_callee_saved,
+};
+
+constexpr RegisterPool fpr_pool{
+    .caller_saved_compressible = fpr_caller_saved_compressible,
+    .caller_saved = fpr_caller_saved,
+    .callee_saved_compressible = fpr_callee_saved_compressible,
+    .callee_saved = fpr_callee_saved,
+};
+
+constexpr std::array<uint32_t, 2> scratch_gprs{30, 31};
+constexpr std::array<uint32_t, 3> scratch_fprs{29, 30, 31};
+
+// The range of positions a virtual register is live within. Node i reads its uses
+// at position 2i and writes its definitions at position 2i + 1.
+struct LiveInterval {
+    uint32_t reg;
+    uint32_t start;
+    uint32_t end;
+    bool crosses_call;
+};
+
+[[nodiscard]] bool IsCalleeSaved(const RegisterPool& pool, uint32_t index) noexcept {
+    const auto contains = [index](std::span<const uint32_t> regs) {
+        return std::find(regs.begin(), regs.end(), index) != regs.end();
+    };
+    return contains(pool.callee_saved_compressible) || contains(pool.callee_saved);
+}
+
+// Retrieves the registers an interval may be assigned, in order of preference.
+[[nodiscard]] std::vector<uint32_t> GetCandidates(const RegisterPool& pool, bool crosses_call,
+                                                  bool prefers_compressible) {
+    std::vector<uint32_t> candidates;
+    const auto append = [&](std::span<const uint32_t> regs) {
+        candidates.insert(candidates.end(), regs.begin(), regs.end());
+    };
+
+    // Values that don't need compressible registers leave them to values that do.
+    if (crosses_call) {
+        if (prefers_compressible) {
+            append(pool.callee_saved_compressible);
+            append(pool.callee_saved);
+        } else {
+            append(pool.callee_saved);
+            append(pool.callee_saved_compressible);
+        }
+    } else if (prefers_compressible) {
+        append(pool.caller_saved_compressible);
+        append(pool.callee_saved_compressible);
+        append(pool.caller_saved);
+        append(pool.callee_saved);
+    } else {
+        append(pool.caller_saved);
+        append(pool.caller_saved_compressible);
+        append(pool.callee_saved);
+        append(pool.callee_saved_compressible);
+    }
+
+    return candidates;
+}
+
+// A set of virtual registers.
+class RegisterSet {
+public:
+    explicit RegisterSet(size_t num_registers) : m_words((num_registers + 63) / 64) {}
+
+    void Add(uint32_t reg) noexcept {
+        m_words[reg / 64] |= uint64_t{1} << (reg % 64);
+    }
+
+    void Remove(uint32_t reg) noexcept {
+        m_words[reg / 64] &= ~(uint64_t{1} << (reg % 64));
+    }
+
+    // Adds every register of another set, returning whether or not any of them were new.
+    bool Merge(const RegisterSet& other) noexcept {
+        bool changed = false;
+        for (size_t i = 0; i < m_words.size(); i++) {
+            const auto merged = m_words[i] | other.m_words[i];
+            changed |= merged != m_words[i];
+            m_words[i] = merged;
+        }
+        return changed;
+    }
+
+    template <typename Func>
+    void ForEach(Func&& func) const {
+        for (size_t i = 0; i < m_words.size(); i++) {
+            auto word = m_words[i];
+            while (word != 0) {
+                func(static_cast<uint32_t>(i * 64 + static_cast<size_t>(std::countr_zero(word))));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    std::vector<uint64_t> m_words;
+};
+} // Anonymous namespace
+
+GPR RegisterMap::Use(VirtualGPR reg) {
+    return GPR{Resolve(reg.id, false)};
+}
+
+FPR RegisterMap::Use(VirtualFPR reg) {
+    return FPR{Resolve(reg.id, false)};
+}
+
+GPR RegisterMap::Def(VirtualGPR reg) {
+    return GPR{Resolve(reg.id, true)};
+}
+
+FPR RegisterMap::Def(VirtualFPR reg) {
+    return FPR{Resolve(reg.id, true)};
+}
+
+Label* RegisterMap::GetLabel(VirtualLabel label) {
+    auto& builder = m_builder;
+    BISCUIT_ASSERT(label < builder.m_labels.size());
+
+    if (!builder.m_analyzing) {
+        auto* const external = builder.m_labels[label].external;
+        return external != nullptr ? external : &(*builder.m_emit_labels)[label];
+    }
+
+    // The node is only emitted to find out what it refers to, so it gets a stand-in label.
+    const auto iter = std::find(m_analysis_label_ids.begin(), m_analysis_label_ids.end(), label);
+    if (iter != m_analysis_label_ids.end()) {
+        return &m_analysis_labels[static_cast<size_t>(iter - m_analysis_label_ids.begin())];
+    }
+
+    builder.m_nodes[m_node].targets.push_back(label);
+    m_analysis_label_ids.push_back(label);
+    return &m_analysis_labels.emplace_back();
+}
+
+uint32_t RegisterMap::Resolve(uint32_t reg, bool is_def) {
+    auto& builder = m_builder;
+    BISCUIT_ASSERT(reg < builder.m_registers.size());
+
+    const auto& assignment = builder.m_registers[reg];
+
+    if (builder.m_analyzing) {
+        auto& node = builder.m_nodes[m_node];
+        auto& refs = is_def ? node.defs : node.uses;
+        if (std::find(refs.begin(), refs.end(), reg) == refs.end()) {
+            refs.push_back(reg);
+        }
+
+        // Hand out distinct compressible registers, so that emitters that
+        // check their operands see something they accept.
+        auto iter = std::find(m_analysis_registers.begin(), m_analysis_registers.end(), reg);
+        if (iter == m_analysis_registers.end()) {
+            iter = m_analysis_registers.insert(iter, reg);
+        }
+
+        const auto num_preceding = std::count_if(m_analysis_registers.begin(), iter, [&](uint32_t other) {
+            return builder.m_registers[other].is_fpr == assignment.is_fpr;
+        });
+        return 8 + static_cast<uint32_t>(num_preceding) % 8;
+    }
+
+    if (!assignment.is_spilled) {
+        return assignment.index;
+    }
+
+    const auto& scratch = is_def ? builder.m_scratch_defs : builder.m_scratch_uses;
+    const auto iter = std::find_if(scratch.begin(), scratch.end(),
+                                   [reg](const auto& entry) { return entry.first == reg; });
+
+    // Spilled registers can only be resolved the way they were during analysis.
+    BISCUIT_ASSERT(iter != scratch.end());
+    return iter->second;
+}
+
+VirtualCodeBuilder::VirtualCodeBuilder(ArchFeature features) noexcept
+    : m_features{features} {}
+
+VirtualGPR VirtualCodeBuilder::NewGPR() {
+    BISCUIT_ASSERT(!m_allocated);
+    m_registers.push_back({});
+    return VirtualGPR{static_cast<uint32_t>(m_registers.size() - 1)};
+}
+
+VirtualFPR VirtualCodeBuilder::NewFPR() {
+    BISCUIT_ASSERT(!m_allocated);
+    m_registers.push_back({.is_fpr = true, .is_spilled = false, .index = 0, .num_references = 0});
+    return VirtualFPR{static_cast<uint32_t>(m_registers.size() - 1)};
+}
+
+VirtualLabel VirtualCodeBuilder::NewLabel(Label* external) {
+    m_labels.push_back({external, std::nullopt});
+    return static_cast<VirtualLabel>(m_labels.size() - 1);
+}
+
+void VirtualCodeBuilder::Reserve(GPR reg) {
+    BISCUIT_ASSERT(!m_allocated);
+    m_reserved_gprs |= 1U << reg.Index();
+}
+
+void VirtualCodeBuilder::Reserve(FPR reg) {
+    BISCUIT_ASSERT(!m_allocated);
+    m_reserved_fprs |= 1U << reg.Index();
+}
+
+void VirtualCodeBuilder::Add(Emitter emitter) {
+    AddNode(std::move(emitter), false);
+}
+
+void VirtualCodeBuilder::AddCall(Emitter emitter) {
+    AddNode(std::move(emitter), true);
+}
+
+void VirtualCodeBuilder::Bind(VirtualLabel label) {
+    BISCUIT_ASSERT(!m_allocated);
+    BISCUIT_ASSERT(label < m_labels.size());
+
+    auto& info = m_labels[label];
+    BISCUIT_ASSERT(info.external == nullptr);
+    BISCUIT_ASSERT(!info.node.has_value());
+
+    info.node = m_nodes.size();
+    m_nodes.push_back({
+        .emitter = nullptr,
+        .uses = {},
+        .defs = {},
+        .targets = {},
+        .bound_label = label,
+        .is_call = false,
+    });
+}
+
+void VirtualCodeBuilder::AddNode(Emitter emitter, bool is_call) {
+    BISCUIT_ASSERT(!m_allocated);
+    BISCUIT_ASSERT(emitter);
+
+    const auto index = m_nodes.size();
+    m_nodes.push_back({
+        .emitter = std::move(emitter),
+        .uses = {},
+        .defs = {},
+        .targets = {},
+        .bound_label = UINT32_MAX,
+        .is_call = is_call,
+    });
+
+    // Emit the node once to find out which registers and labels it refers to.
+    std::array<uint8_t, 256> storage{};
+    Assembler as{storage.data(), storage.size(), m_features};
+    {
+        RegisterMap map{*this, index};
+        m_analyzing = true;
+        m_nodes[index].emitter(as, map);
+        m_analyzing = false;
+
+        for (auto& label : map.m_analysis_labels) {
+            as.Bind(&label);
+        }
+    }
+
+    const auto& node = m_nodes[index];
+    for (const auto reg : node.uses) {
+        m_registers[reg].num_references++;
+    }
+    for (const auto reg : node.defs) {
+        if (std::find(node.uses.begin(), node.uses.end(), reg) == node.uses.end()) {
+            m_registers[reg].num_references++;
+        }
+    }
+}
+
+void VirtualCodeBuilder::Allocate() {
+    BISCUIT_ASSERT(!m_allocated);
+    m_allocated = true;
+
+    const auto num_nodes = m_nodes.size();
+    const auto num_registers = m_registers.size();
+
+    // Find the registers that are live into and out of each node. Nodes fall through to the next
+    // node, and nodes referring to labels within the builder may also continue at those labels.
+    std::vector<RegisterSet> live_in(num_nodes, RegisterSet{num_registers});
+    std::vector<RegisterSet> live_out(num_nodes, RegisterSet{num_registers});
+
+    for (bool changed = true; changed;) {
+        changed = false;
+
+        for (size_t i = num_nodes; i-- > 0;) {
+            const auto& node = m_nodes[i];
+
+            if (i + 1 < num_nodes) {
+                changed |= live_out[i].Merge(live_in[i + 1]);
+            }
+            for (const auto target : node.targets) {
+                if (const auto& bound = m_labels[target].node) {
+                    changed |= live_out[i].Merge(live_in[*bound]);
+                }
+            }
+
+            auto in = live_out[i];
+            for (const auto reg : node.defs) {
+                in.Remove(reg);
+            }
+            for (const auto reg : node.uses) {
+                in.Add(reg);
+            }
+            changed |= live_in[i].Merge(in);
+        }
+    }
+
+    // Build the interval of every register that is referenced.
+    std::vector<LiveInterval> intervals(num_registers);
+    std::vector<bool> is_referenced(num_registers);
+    for (uint32_t reg = 0; reg < num_registers; reg++) {
+        intervals[reg] = {
+            .reg = reg,
+            .start = UINT32_MAX,
+            .end = 0,
+            .crosses_call = false,
+        };
+    }
+
+    const auto extend = [&](uint32_t reg, uint32_t position) {
+        auto& interval = intervals[reg];
+        interval.start = std::min(interval.start, position);
+        interval.end = std::max(interval.end, position);
+        is_referenced[reg] = true;
+    };
+
+    for (size_t i = 0; i < num_nodes; i++) {
+        const auto& node = m_nodes[i];
+        const auto read = static_cast<uint32_t>(i * 2);
+        const auto write = read + 1;
+
+        live_in[i].ForEach([&](uint32_t reg) { extend(reg, read); });
+        live_out[i].ForEach([&](uint32_t reg) {
+            extend(reg, write);
+
+            // Registers live out of a call that it doesn't define must survive the call.
+            if (node.is_call && std::find(node.defs.begin(), node.defs.end(), reg) == node.defs.end()) {
+                intervals[reg].crosses_call = true;
+            }
+        });
+        for (const auto reg : node.uses) {
+            extend(reg, read);
+        }
+        for (const auto reg : node.defs) {
+            extend(reg, write);
+        }
+    }
+
+    std::erase_if(intervals, [&](const LiveInterval& interval) { return !is_referenced[interval.reg]; });
+    std::stable_sort(intervals.begin(), intervals.end(),
+                     [](const LiveInterval& lhs, const LiveInterval& rhs) { return lhs.start < rhs.start; });
+
+    // Linear scan over the intervals in order of their start.
+    std::vector<LiveInterval> active;
+    std::array<uint32_t, 2> in_use{m_reserved_gprs, m_reserved_fprs};
+
+    // Nodes can only load and store as many spilled values as there are scratch registers,
+    // so track how many of the values each node reads and writes have been spilled.
+    std::vector<std::vector<uint32_t>> referencing_nodes(num_registers);
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        const auto& node = m_nodes[i];
+        for (const auto reg : node.uses) {
+            referencing_nodes[reg].push_back(i);
+        }
+        for (const auto reg : node.defs) {
+            if (referencing_nodes[reg].empty() || referencing_nodes[reg].back() != i) {
+                referencing_nodes[reg].push_back(i);
+            }
+        }
+    }
+
+    using SpillCounts = std::array<uint32_t, 2>;
+    std::vector<SpillCounts> spilled_uses(num_nodes);
+    std::vector<SpillCounts> spilled_defs(num_nodes);
+
+    const auto can_spill = [&](uint32_t reg) {
+        const auto is_fpr = m_registers[reg].is_fpr;
+        const auto limit = is_fpr ? num_scratch_fprs : num_scratch_gprs;
+        const size_t index = is_fpr ? 1 : 0;
+
+        return std::all_of(referencing_nodes[reg].begin(), referencing_nodes[reg].end(), [&](uint32_t i) {
+            const auto& node = m_nodes[i];
+            const auto is_use = std::find(node.uses.begin(), node.uses.end(), reg) != node.uses.end();
+            const auto is_def = std::find(node.defs.begin(), node.defs.end(), reg) != node.defs.end();
+            return (!is_use || spilled_uses[i][index] < limit) && (!is_def || spilled_defs[i][index] < limit);
+        });
+    };
+
+    const auto spill = [&](uint32_t reg) {
+        auto& assignment = m_registers[reg];
+        assignment.is_spilled = true;
+        assignment.index = m_num_spill_slots++;
+
+        const size_t index = assignment.is_fpr ? 1 : 0;
+        for (const auto i : referencing_nodes[reg]) {
+            const auto& node = m_nodes[i];
+            if (std::find(node.uses.begin(), node.uses.end(), reg) != node.uses.end()) {
+                spilled_uses[i][index]++;
+            }
+            if (std::find(node.defs.begin(), node.defs.end(), reg) != node.defs.end()) {
+                spilled_defs[i][index]++;
+            }
+        }
+    };
+
+    for (const auto& interval : intervals) {
+        auto& assignment = m_registers[interval.reg];
+        const auto is_fpr = assignment.is_fpr;
+        auto& used = in_use[is_fpr ? 1 : 0];
+
+        // Registers of intervals that ended before this one started are free again.
+        std::erase_if(active, [&](const LiveInterval& other) {
+            if (other.end >= interval.start) {
+                return false;
+            }
+            const auto& other_assignment = m_registers[other.reg];
+            in_use[other_assignment.is_fpr ? 1 : 0] &= ~(1U << other_assignment.index);
+            return true;
+        });
+
+        const auto& pool = is_fpr ? fpr_pool : gpr_pool;
+        const auto prefers_compressible = assignment.num_references >= compressible_reference_count;
+        const auto candidates = GetCandidates(pool, interval.crosses_call, prefers_compressible);
+
+        const auto free = std::find_if(candidates.begin(), candidates.end(),
+                                       [used](uint32_t index) { return (used & (1U << index)) == 0; });
+        if (free != candidates.end()) {
+            assignment.index = *free;
+            used |= 1U << *free;
+            active.push_back(interval);
+            continue;
+        }
+
+        // Otherwise, spill whichever interval that could give up its register ends last,
+        // as long as none of the nodes referring to it run out of scratch registers.
+        auto victim = active.end();
+        for (auto iter = active.begin(); iter != active.end(); ++iter) {
+            const auto& other = m_registers[iter->reg];
+            if (other.is_fpr != is_fpr ||
+                std::find(candidates.begin(), candidates.end(), other.index) == candidates.end() ||
+                !can_spill(iter->reg)) {
+                continue;
+            }
+            if (victim == active.end() || iter->end > victim->end) {
+                victim = iter;
+            }
+        }
+
+        const auto can_spill_interval = can_spill(interval.reg);
+        if (victim == active.end() || (victim->end <= interval.end && can_spill_interval)) {
+            // Every register is held by values that some node needs in a register at the same time.
+            BISCUIT_ASSERT(can_spill_interval);
+            spill(interval.reg);
+            continue;
+        }
+
+        assignment.index = m_registers[victim->reg].index;
+        spill(victim->reg);
+        *victim = interval;
+    }
+
+    BISCUIT_ASSERT(m_spill_offset + static_cast<int64_t>(GetSpillAreaSize()) <= 2048);
+}
+
+void VirtualCodeBuilder::Emit(Assembler& as) {
+    BISCUIT_ASSERT(as.GetArchFeatures() == m_features);
+
+    if (!m_allocated) {
+        Allocate();
+    }
+
+    std::vector<Label> labels(m_labels.size());
+    m_emit_labels = &labels;
+
+    for (size_t i = 0; i < m_nodes.size(); i++) {
+        const auto& node = m_nodes[i];
+
+        if (!node.emitter) {
+            as.Bind(&labels[node.bound_label]);
+            continue;
+        }
+
+        // Spilled registers are loaded into scratch registers before the node,
+        // and stored from scratch registers after it. Uses are read before
+        // definitions are written, so both can use the same scratch registers.
+        m_scratch_uses.clear();
+        m_scratch_defs.clear();
+
+        const auto assign_scratch = [&](const std::vector<uint32_t>& regs, auto& scratch) {
+            std::array<uint32_t, 2> num_scratch{};
+            for (const auto reg : regs) {
+                const auto& assignment = m_registers[reg];
+                if (!assignment.is_spilled) {
+                    continue;
+                }
+
+                auto& count = num_scratch[assignment.is_fpr ? 1 : 0];
+                if (assignment.is_fpr) {
+                    BISCUIT_ASSERT(count < num_scratch_fprs);
+                    scratch.emplace_back(reg, scratch_fprs[count]);
+                } else {
+                    BISCUIT_ASSERT(count < num_scratch_gprs);
+                    scratch.emplace_back(reg, scratch_gprs[count]);
+                }
+                count++;
+            }
+        };
+        assign_scratch(node.uses, m_scratch_uses);
+        assign_scratch(node.defs, m_scratch_defs);
+
+        for (const auto& [reg, scratch] : m_scratch_uses) {
+            EmitSpillCode(as, reg, scratch, true);
+        }
+
+        RegisterMap map{*this, i};
+        node.emitter(as, map);
+
+        for (const auto& [reg, scratch] : m_scratch_defs) {
+            EmitSpillCode(as, reg, scratch, false);
+        }
+    }
+
+    m_emit_labels = nullptr;
+}
+
+void VirtualCodeBuilder::EmitSpillCode(Assembler& as, uint32_t reg, uint32_t scratch, bool is_load) const {
+    const auto& assignment = m_registers[reg];
+    const auto offset = m_spill_offset + static_cast<int32_t>(assignment.index * spill_slot_size);
+
+    if (assignment.is_fpr) {
+        if (is_load) {
+            as.FLD(FPR{scratch}, offset, m_spill_base);
+        } else {
+            as.FSD(FPR{scratch}, offset, m_spill_base);
+        }
+    } else if (IsRV32(m_features)) {
+        if (is_load) {
+            as.LW(GPR{scratch}, offset, m_spill_base);
+        } else {
+            as.SW(GPR{scratch}, offset, m_spill_base);
+        }
+    } else {
+        if (is_load) {
+            as.LD(GPR{scratch}, offset, m_spill_base);
+        } else {
+            as.SD(GPR{scratch}, offset, m_spill_base);
+        }
+    }
+}
+
+std::optional<GPR> VirtualCodeBuilder::GetAssignment(VirtualGPR reg) const noexcept {
+    BISCUIT_ASSERT(m_allocated);
+    const auto& assignment = m_registers[reg.id];
+    if (assignment.is_spilled) {
+        return std::nullopt;
+    }
+    return GPR{assignment.index};
+}
+
+std::optional<FPR> VirtualCodeBuilder::GetAssignment(VirtualFPR reg) const noexcept {
+    BISCUIT_ASSERT(m_allocated);
+    const auto& assignment = m_registers[reg.id];
+    if (assignment.is_spilled) {
+        return std::nullopt;
+    }
+    return FPR{assignment.index};
+}
+
+std::vector<GPR> VirtualCodeBuilder::GetUsedCalleeSavedGPRs() const {
+    BISCUIT_ASSERT(m_allocated);
+
+    uint32_t used = 0;
+    for (const auto& assignment : m_registers) {
+        if (!assignment.is_fpr && !assignment.is_spilled && assignment.num_references != 0 &&
+            IsCalleeSaved(gpr_pool, assignment.index)) {
+            used |= 1U << assignment.index;
+        }
+    }
+
+    std::vector<GPR> regs;
+    for (uint32_t i = 0; i < 32; i++) {
+        if ((used & (1U << i)) != 0) {
+            regs.emplace_back(i);
+        }
+    }
+    return regs;
+}
+
+std::vector<FPR> VirtualCodeBuilder::GetUsedCalleeSavedFPRs() const {
+    BISCUIT_ASSERT(m_allocated);
+
+    uint32_t used = 0;
+    for (const auto& assignment : m_registers) {
+        if (assignment.is_fpr && !assignment.is_spilled && assignment.num_references != 0 &&
+            IsCalleeSaved(fpr_pool, assignment.index)) {
+            used |= 1U << assignment.index;
+        }
+    }
+
+    std::vector<FPR> regs;
+    for (uint32_t i = 0; i < 32; i++) {
+        if ((used & (1U << i)) != 0) {
+            regs.emplace_back(i);
+        }
+    }
+    return regs;
+}
+
+} // namespace biscuit
@@ -0,0 +1,109 @@
+#include <catch/catch.hpp>
+
+#include <array>
+#include <cstring>
+#include <biscuit/assembler.hpp>
+
+using namespace biscuit;
+
+namespace {
+struct alignas(64) Buffer {
+    std::array<uint8_t, 128> bytes{};
+};
+
+uint16_t Read16(const Buffer& buffer, size_t offset) {
+    uint16_t value = 0;
+    std::memcpy(&value, buffer.bytes.data() + offset, sizeof(value));
+    return value;
+}
+
+uint32_t Read32(const Buffer& buffer, size_t offset) {
+    uint32_t value = 0;
+    std::memcpy(&value, buffer.bytes.data() + offset, sizeof(value));
+    return value;
+}
+} // Anonymous namespace
+
+TEST_CASE("Align pads with NOPs", "[align]") {
+    Buffer buffer;
+    Assembler as(buffer.bytes.data(), buffer.bytes.size());
+
+    // Already aligned, nothing to do.
+    as.Align(16);
+    REQUIRE(as.GetCodeBuffer().GetCursorOffset() == 0);
+
+    // A C.NOP realigns to 4 bytes, the rest are regular NOPs.
+    as.C_NOP();
+    as.Align(16);
+    REQUIRE(as.GetCodeBuffer().GetCursorOffset() == 16);
+    REQUIRE(Read16(buffer, 2) == 0x0001);
+    REQUIRE(Read32(buffer, 4) == 0x00000013);
+    REQUIRE(Read32(buffer, 8) == 0x00000013);
+    REQUIRE(Read32(buffer, 12) == 0x00000013);
+
+    // 2-byte alignment never needs padding.
+    as.C_NOP();
+    as.Align(2);
+    REQUIRE(as.GetCodeBuffer().GetCursorOffset() == 18);
+}
+
+TEST_CASE("Align pads with zeros", "[align]") {
+    Buffer buffer;
+    buffer.bytes.fill(0xFF);
+    Assembler as(buffer.bytes.data(), buffer.bytes.size());
+
+    // Literals linked before the padding point past it once placed.
+    Literal<uint64_t> literal{0x1234567890ABCDEF};
+    as.LILiteral(a0, &literal);
+    as.GetCodeBuffer().Emit(uint8_t{0xAA});
+    as.Align(8, FillPolicy::Zero);
+    REQUIRE(as.GetCodeBuffer().GetCursorOffset() == 16);
+    for (size_t i = 9; i < 16; i++) {
+        REQUIRE(buffer.bytes[i] == 0);
+    }
+
+    as.Place(&literal);
+    REQUIRE(Read32(buffer, 0) == 0x00000517); // auipc a0, 0
+    REQUIRE(Read32(buffer, 4) == 0x01050513); // addi a0, a0, 16
+}
+
+TEST_CASE("AlignLoopHead", "[align]") {
+    Buffer buffer;
+
+    SECTION("Aligns within the maximum padding") {
+        Assembler as(buffer.bytes.data(), buffer.bytes.size());
+        Label loop;
+        Label exit;
+
+        // Forward branches linked before the padding are resolved across it.
+        as.BEQZ(a0, &exit);
+        REQUIRE(as.AlignLoopHead(16, 12));
+        REQUIRE(as.GetCodeBuffer().GetCursorOffset() == 16);
+
+        as.Bind(&loop);
+        as.ADDI(a0, a0, -1);
+        as.BNEZ(a0, &loop);
+        as.Bind(&exit);
+
+        Buffer expected;
+        Assembler expected_as(expected.bytes.data(), expected.bytes.size());
+        expected_as.BEQZ(a0, 24);
+        expected_as.BNEZ(a0, -4);
+        REQUIRE(Read32(buffer, 0) == Read32(expected, 0));
+        REQUIRE(Read32(buffer, 20) == Read32(expected, 4));
+    }
+
+    SECTION("Skips alignment that needs too much padding") {
+        Assembler as(buffer.bytes.data(), buffer.bytes.size());
+
+        as.NOP();
+        REQUIRE_FALSE(as.AlignLoopHead(16, 8));
+        REQUIRE(as.GetCodeBuffer().GetCursorOffset() == 4);
+
+        // The head is still kept 4-byte aligned.
+        as.C_NOP();
+        REQUIRE_FALSE(as.AlignLoopHead(16, 8));
+        REQUIRE(as.GetCodeBuffer().GetCursorOffset() == 8);
+        REQUIRE(Read16(buffer, 6) == 0x0001);
+    }
+}
@@ -1,5 +1,7 @@
 #include <catch/catch.hpp>
 
+#include <array>
+
 #include <biscuit/assembler.hpp>
 
 #include "assembler_test_utils.hpp"
@@ -5412,3 +5414,98 @@ TEST_CASE("VSETVLI", "[rvv]") {
     as.VSETVLI(x15, x12, SEW::E32, LMUL::M4, VTA::No, VMA::No);
     REQUIRE(value == 0x012677D7);
 }
+
+TEST_CASE("ElideVectorConfig", "[rvv]") {
+    std::array<uint32_t, 16> buffer{};
+    auto as = MakeAssembler64(buffer);
+    as.EnableOptimization(Optimization::ElideVectorConfig);
+
+    const auto size = [&] {
+        return as.GetCodeBuffer().GetCursorOffset();
+    };
+
+    SECTION("Redundant configurations are skipped") {
+        as.VSETIVLI(x0, 16, SEW::E32, LMUL::M2, VTA::Yes, VMA::Yes);
+        as.VADD(v2, v4, v6);
+        as.VSETIVLI(x0, 16, SEW::E32, LMUL::M2, VTA::Yes, VMA::Yes);
+        as.VSETVLI(x0, x0, SEW::E32, LMUL::M2, VTA::Yes, VMA::Yes);
+        REQUIRE(size() == 8);
+
+        // Anything that differs is emitted.
+        as.VSETIVLI(x0, 8, SEW::E32, LMUL::M2, VTA::Yes, VMA::Yes);
+        as.VSETIVLI(x0, 8, SEW::E32, LMUL::M2, VTA::No, VMA::Yes);
+        as.VSETIVLI(x10, 8, SEW::E32, LMUL::M2, VTA::No, VMA::Yes);
+        REQUIRE(size() == 20);
+    }
+
+    SECTION("Register AVLs are never assumed to be unchanged") {
+        as.VSETVLI(x0, x11, SEW::E8, LMUL::M1);
+        as.VSETVLI(x0, x11, SEW::E8, LMUL::M1);
+        REQUIRE(size() == 8);
+
+        // vl is kept, so only vtype matters.
+        as.VSETVLI(x0, x0, SEW::E8, LMUL::M1);
+        REQUIRE(size() == 8);
+
+        // VLMAX doesn't depend on any register.
+        as.VSETVLI(x10, x0, SEW::E16, LMUL::M2);
+        as.VSETVLI(x0, x0, SEW::E8, LMUL::M1);
+        as.VSETVLI(x0, x0, SEW::E8, LMUL::M1);
+        REQUIRE(size() == 16);
+    }
+
+    SECTION("Configurations are forgotten at control flow") {
+        Label label;
+
+        as.VSETIVLI(x0, 4, SEW::E64);
+        as.Bind(&label);
+        as.VSETIVLI(x0, 4, SEW::E64);
+        as.JAL(0);
+        as.VSETIVLI(x0, 4, SEW::E64);
+        as.VLE64FF(v1, x10);
+        as.VSETIVLI(x0, 4, SEW::E64);
+        REQUIRE(size() == 24);
+
+        as.InvalidateVectorConfig();
+        as.VSETIVLI(x0, 4, SEW::E64);
+        as.RewindBuffer(size());
+        as.VSETIVLI(x0, 4, SEW::E64);
+        REQUIRE(size() == 32);
+    }
+
+    SECTION("Nothing is skipped unless enabled") {
+        as.DisableOptimization(Optimization::ElideVectorConfig);
+        as.VSETIVLI(x0, 16, SEW::E32);
+        as.VSETIVLI(x0, 16, SEW::E32);
+        REQUIRE(size() == 8);
+    }
+}
+
+TEST_CASE("SetVectorConfig", "[rvv]") {
+    std::array<uint32_t, 8> buffer{};
+    auto as = MakeAssembler64(buffer);
+
+    std::array<uint32_t, 8> expected_buffer{};
+    auto expected = MakeAssembler64(expected_buffer);
+
+    as.SetVectorConfig(16, SEW::E32, LMUL::M1);
+    expected.VSETIVLI(x0, 16, SEW::E32, LMUL::M1);
+
+    // Already in effect.
+    as.SetVectorConfig(16, SEW::E32, LMUL::M1);
+
+    // Same AVL and SEW/LMUL ratio, so vl is kept.
+    as.SetVectorConfig(16, SEW::E64, LMUL::M2, VTA::Yes);
+    expected.VSETVLI(x0, x0, SEW::E64, LMUL::M2, VTA::Yes);
+
+    // Different ratio.
+    as.SetVectorConfig(16, SEW::E8, LMUL::M2);
+    expected.VSETIVLI(x0, 16, SEW::E8, LMUL::M2);
+
+    // Different AVL.
+    as.SetVectorConfig(4, SEW::E8, LMUL::M2);
+    expected.VSETIVLI(x0, 4, SEW::E8, LMUL::M2);
+
+    REQUIRE(as.GetCodeBuffer().GetCursorOffset() == 16);
+    REQUIRE(buffer == expected_buffer);
+}
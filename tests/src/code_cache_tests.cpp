@@ -0,0 +1,213 @@
+#include <catch/catch.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/code_cache.hpp>
+#include <biscuit/profile.hpp>
+
+using namespace biscuit;
+
+namespace {
+constexpr uint64_t helper_address = 0x0000'1234'5678'9ABC;
+
+std::optional<uint64_t> ResolveHelper(std::string_view name) {
+    if (name == "helper") {
+        return helper_address;
+    }
+    return std::nullopt;
+}
+
+uint32_t ReadWord(const uint8_t* code, size_t offset) {
+    uint32_t word = 0;
+    std::memcpy(&word, code + offset, sizeof(word));
+    return word;
+}
+
+int64_t GetUTypeImm(uint32_t instruction) {
+    return static_cast<int32_t>(instruction & 0xFFFFF000);
+}
+
+int64_t GetITypeImm(uint32_t instruction) {
+    return static_cast<int32_t>(instruction) >> 20;
+}
+
+// Emits a function that calls another function within the same code, and a
+// table containing the address of the callee and an external helper.
+void EmitCode(Assembler& as) {
+    Label entry;
+    Label callee;
+
+    as.Bind(&entry);
+    as.AddRelocation(RelocationType::Call, "callee");
+    as.AUIPC(ra, 0);
+    as.JALR(ra, 0, ra);
+
+    const auto hi20_offset = as.GetCodeBuffer().GetCursorOffset();
+    as.AddRelocation(RelocationType::PCRelHi20, "table", 8);
+    as.AUIPC(a0, 0);
+    as.LD(a0, 0, a0);
+    as.AddRelocation({
+        .offset = hi20_offset + 4,
+        .type = RelocationType::PCRelLo12I,
+        .symbol = {},
+        .addend = 0,
+        .hi20_offset = hi20_offset,
+    });
+    as.RET();
+
+    as.Bind(&callee);
+    as.RET();
+
+    Label table;
+    as.Bind(&table);
+    as.AddRelocation(RelocationType::Absolute64, "callee");
+    as.GetCodeBuffer().Emit(uint64_t{0});
+    as.AddRelocation(RelocationType::Absolute64, "helper", 4);
+    as.GetCodeBuffer().Emit(uint64_t{0});
+
+    as.ExportLabel("entry", &entry);
+    as.ExportLabel("callee", &callee);
+    as.ExportLabel("table", &table, 16, SymbolType::Object);
+}
+
+void CheckRelocatedCode(const CachedCode& cached) {
+    const auto* code = cached.GetCode();
+    const auto base = reinterpret_cast<uintptr_t>(code);
+
+    REQUIRE(cached.GetSizeInBytes() == 40);
+    REQUIRE(cached.GetSymbols().size() == 3);
+    REQUIRE(cached.GetSymbolAddress("entry") == code);
+    REQUIRE(cached.GetSymbolAddress("callee") == code + 20);
+    REQUIRE(cached.GetSymbolAddress("table") == code + 24);
+    REQUIRE(cached.GetSymbolAddress("missing") == nullptr);
+
+    // AUIPC + JALR to the callee
+    const auto call = GetUTypeImm(ReadWord(code, 0)) + GetITypeImm(ReadWord(code, 4));
+    REQUIRE(call == 20);
+
+    // AUIPC + LD of the second table entry, relative to the AUIPC
+    const auto load = GetUTypeImm(ReadWord(code, 8)) + GetITypeImm(ReadWord(code, 12));
+    REQUIRE(load == 24);
+
+    uint64_t entries[2]{};
+    std::memcpy(entries, code + 24, sizeof(entries));
+    REQUIRE(entries[0] == base + 20);
+    REQUIRE(entries[1] == helper_address + 4);
+}
+} // Anonymous namespace
+
+TEST_CASE("CachedCode loads and relocates serialized code", "[code_cache]") {
+    Assembler as;
+    EmitCode(as);
+
+    const auto target = Profile::RVA22U64();
+    const auto data = SerializeCode(as, target);
+
+    CodeCacheStatus status{};
+    const auto cached = CachedCode::Load(data, target, ResolveHelper, &status);
+    REQUIRE(status == CodeCacheStatus::Ok);
+    REQUIRE(cached.has_value());
+    CheckRelocatedCode(*cached);
+
+    // Code that doesn't need relocating is copied over verbatim.
+    REQUIRE(std::memcmp(cached->GetCode() + 16, as.GetCodeBuffer().GetOffsetPointer(16), 8) == 0);
+}
+
+TEST_CASE("CachedCode rejects stale and mismatching caches", "[code_cache]") {
+    Assembler as;
+    EmitCode(as);
+
+    const auto target = Profile::RVA22U64();
+    const auto data = SerializeCode(as, target);
+
+    CodeCacheStatus status{};
+
+    SECTION("Different profile") {
+        REQUIRE(!CachedCode::Load(data, Profile::RVA20U64(), ResolveHelper, &status));
+        REQUIRE(status == CodeCacheStatus::ProfileMismatch);
+    }
+
+    SECTION("Different version") {
+        auto modified = data;
+        modified[4] ^= 0xFF;
+        REQUIRE(!CachedCode::Load(modified, target, ResolveHelper, &status));
+        REQUIRE(status == CodeCacheStatus::VersionMismatch);
+    }
+
+    SECTION("Corrupted code") {
+        auto modified = data;
+        modified.back() ^= 1;
+        REQUIRE(!CachedCode::Load(modified, target, ResolveHelper, &status));
+        REQUIRE(status == CodeCacheStatus::ChecksumMismatch);
+    }
+
+    SECTION("Truncated file") {
+        auto modified = data;
+        modified.pop_back();
+        REQUIRE(!CachedCode::Load(modified, target, ResolveHelper, &status));
+        REQUIRE(status == CodeCacheStatus::ChecksumMismatch);
+    }
+
+    SECTION("Not a cache") {
+        const std::vector<uint8_t> garbage(128, 0xAA);
+        REQUIRE(!CachedCode::Load(garbage, target, ResolveHelper, &status));
+        REQUIRE(status == CodeCacheStatus::InvalidFormat);
+    }
+
+    SECTION("Unresolved symbol") {
+        const auto resolve_nothing = [](std::string_view) -> std::optional<uint64_t> {
+            return std::nullopt;
+        };
+        REQUIRE(!CachedCode::Load(data, target, resolve_nothing, &status));
+        REQUIRE(status == CodeCacheStatus::UnresolvedSymbol);
+    }
+}
+
+TEST_CASE("CachedCode rejects symbols out of range", "[code_cache]") {
+    Assembler as;
+    as.AddRelocation(RelocationType::Call, "helper");
+    as.AUIPC(ra, 0);
+    as.JALR(ra, 0, ra);
+
+    const auto target = Profile::RVA22U64();
+    const auto data = SerializeCode(as, target);
+
+    // Nothing can be mapped within 2GiB of this.
+    const auto resolve_far = [](std::string_view) -> std::optional<uint64_t> {
+        return 0x4000'0000'0000'0000;
+    };
+
+    CodeCacheStatus status{};
+    REQUIRE(!CachedCode::Load(data, target, resolve_far, &status));
+    REQUIRE(status == CodeCacheStatus::OutOfRange);
+}
+
+TEST_CASE("CachedCode loads cache files", "[code_cache]") {
+    const auto path = (std::filesystem::temp_directory_path() / "biscuit_code_cache_test.bcc").string();
+
+    Assembler as;
+    EmitCode(as);
+
+    const auto target = Profile::RVA22U64();
+    REQUIRE(WriteCodeCache(path, as, target));
+
+    {
+        CodeCacheStatus status{};
+        const auto cached = CachedCode::Load(path, target, ResolveHelper, &status);
+        REQUIRE(status == CodeCacheStatus::Ok);
+        REQUIRE(cached.has_value());
+        CheckRelocatedCode(*cached);
+    }
+
+    std::filesystem::remove(path);
+
+    CodeCacheStatus status{};
+    REQUIRE(!CachedCode::Load(path, target, ResolveHelper, &status));
+    REQUIRE(status == CodeCacheStatus::IOError);
+}
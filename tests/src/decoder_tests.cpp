@@ -0,0 +1,284 @@
+#include <catch/catch.hpp>
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/decoder.hpp>
+
+using namespace biscuit;
+
+namespace {
+Instruction Decode16(uint16_t value, ArchFeature features = ArchFeature::RV64,
+                     DecodeOptions options = DecodeOptions::None) {
+    std::array<uint8_t, sizeof(value)> bytes{};
+    std::memcpy(bytes.data(), &value, sizeof(value));
+    return Decode(bytes.data(), features, options);
+}
+
+Instruction Decode32(uint32_t value, ArchFeature features = ArchFeature::RV64,
+                     DecodeOptions options = DecodeOptions::None) {
+    std::array<uint8_t, sizeof(value)> bytes{};
+    std::memcpy(bytes.data(), &value, sizeof(value));
+    return Decode(bytes.data(), features, options);
+}
+
+// Decodes every instruction in a buffer and re-encodes each of them,
+// verifying that the re-encoded bytes are identical to the original ones.
+void VerifyRoundTrip(const std::vector<uint8_t>& code, ArchFeature features,
+                     DecodeOptions options = DecodeOptions::None) {
+    std::vector<uint8_t> output(code.size());
+    Assembler as(output.data(), output.size(), features);
+
+    size_t offset = 0;
+    while (offset < code.size()) {
+        const auto instruction = Decode(code.data() + offset, features, options);
+        INFO("offset " << offset);
+        REQUIRE(instruction.IsValid());
+
+        Encode(as, instruction);
+        offset += instruction.size;
+        REQUIRE(static_cast<size_t>(as.GetCodeBuffer().GetCursorOffset()) == offset);
+    }
+
+    REQUIRE(output == code);
+}
+
+template <typename Func>
+std::vector<uint8_t> Assemble(ArchFeature features, Func&& func) {
+    std::vector<uint8_t> code(1024);
+    Assembler as(code.data(), code.size(), features);
+    func(as);
+    code.resize(static_cast<size_t>(as.GetCodeBuffer().GetCursorOffset()));
+    return code;
+}
+} // Anonymous namespace
+
+TEST_CASE("Decode known encodings", "[decoder]") {
+    const auto bne = Decode32(0x00419063);
+    REQUIRE(bne.opcode == Opcode::BNE);
+    REQUIRE(bne.size == 4);
+    REQUIRE(bne.num_operands == 3);
+    REQUIRE(bne.GetGPR(0) == x3);
+    REQUIRE(bne.GetGPR(1) == x4);
+    REQUIRE(bne.operands[2] == Operand{OperandType::PCOffset, 0});
+
+    const auto czero = Decode32(0x0FDF5FB3);
+    REQUIRE(czero.opcode == Opcode::CZERO_EQZ);
+    REQUIRE(czero.GetGPR(0) == x31);
+    REQUIRE(czero.GetGPR(1) == x30);
+    REQUIRE(czero.GetGPR(2) == x29);
+
+    // addi x10, x11, -1
+    const auto addi = Decode32(0xFFF58513);
+    REQUIRE(addi.opcode == Opcode::ADDI);
+    REQUIRE(addi.GetValue(2) == -1);
+
+    // c.addi x10, -7
+    const auto c_addi = Decode16(0x1565);
+    REQUIRE(c_addi.opcode == Opcode::C_ADDI);
+    REQUIRE(c_addi.IsCompressed());
+    REQUIRE(c_addi.GetGPR(0) == x10);
+    REQUIRE(c_addi.GetValue(1) == -7);
+
+    // c.nop is a special case of c.addi
+    REQUIRE(Decode16(0x0001).opcode == Opcode::C_NOP);
+
+    // vadd.vv v8, v16, v24, v0.t
+    const auto vadd = Decode32(0x010C0457);
+    REQUIRE(vadd.opcode == Opcode::VADD_VV);
+    REQUIRE(vadd.GetVec(0) == v8);
+    REQUIRE(vadd.GetVec(1) == v16);
+    REQUIRE(vadd.GetVec(2) == v24);
+    REQUIRE(vadd.operands[3] == Operand{OperandType::VecMask, static_cast<int32_t>(VecMask::Yes)});
+
+    REQUIRE(GetMnemonic(Opcode::VADD_VV) == "vadd.vv");
+    REQUIRE(GetMnemonic(Opcode::C_ADDI) == "c.addi");
+    REQUIRE(GetMnemonic(Opcode::FENCETSO) == "fence.tso");
+}
+
+TEST_CASE("Decode round-trips RV64 code", "[decoder]") {
+    const auto code = Assemble(ArchFeature::RV64, [](Assembler& as) {
+        as.ADD(x1, x2, x3);
+        as.ADDI(x5, x6, -2048);
+        as.LUI(x7, 0xFFFFF);
+        as.AUIPC(x8, 0x12345);
+        as.JAL(x1, -0x80000);
+        as.JALR(x0, 16, x1);
+        as.BGEU(x9, x10, -4096);
+        as.LD(x11, 2047, x12);
+        as.SD(x13, -2048, x14);
+        as.SLLI(x15, x16, 63);
+        as.SRAIW(x17, x18, 31);
+        as.FENCE(FenceOrder::RW, FenceOrder::W);
+        as.FENCETSO();
+        as.ECALL();
+        as.CSRRS(x1, CSR::Cycle, x0);
+        as.CSRRWI(x0, CSR::FCSR, 31);
+        as.MULHSU(x1, x2, x3);
+        as.AMOADD_D(Ordering::AQRL, x1, x2, x3);
+        as.LR_W(Ordering::AQ, x4, x5);
+        as.SC_D(Ordering::RL, x6, x7, x8);
+        as.FMADD_D(f1, f2, f3, f4, RMode::RNE);
+        as.FCVT_L_D(x1, f2, RMode::RTZ);
+        as.FSD(f31, 8, x2);
+        as.FLI_D(f1, 0.5);
+        as.SH2ADD(x1, x2, x3);
+        as.REV8(x4, x5);
+        as.RORI(x6, x7, 63);
+        as.AES64KS1I(x1, x2, 10);
+        as.CZERO_NEZ(x1, x2, x3);
+        as.PREFETCH_W(x1, -2048);
+        as.CBO_ZERO(x2);
+        as.VSETVLI(x1, x2, SEW::E64, LMUL::MF2, VTA::Yes, VMA::No);
+        as.VSETIVLI(x3, 31, SEW::E8, LMUL::M8, VTA::No, VMA::Yes);
+        as.VLE32(v1, x2, VecMask::No);
+        as.VLSSEGE16(4, v4, x5, x6);
+        as.VLUXEI64(v2, x3, v4, VecMask::Yes);
+        as.VS4R(v4, x1);
+        as.VADD(v1, v2, -16);
+        as.VMACC(v1, x5, v2);
+        as.VFWADD(v2, v4, f1);
+        as.VROR(v1, v2, 63);
+        as.VMV(v4, 15);
+        as.VMV_XS(x1, v2);
+        as.VPOPC(x1, v2);
+        as.VAESKF1(v1, v2, 10);
+        as.LB(Ordering::AQ, x1, x2);
+        as.SD(Ordering::AQRL, x3, x4);
+        as.SSPUSH(x5);
+        as.LPAD(0x12345);
+        as.C_ADDI4SPN(x8, 1020);
+        as.C_LD(x15, 248, x8);
+        as.C_SDSP(x31, 504);
+        as.C_LUI(x31, 0x3F);
+        as.C_SRAI(x9, 63);
+        as.C_BEQZ(x15, -256);
+        as.C_J(2046);
+        as.C_ADDIW(x1, -32);
+        as.C_ADDI16SP(-512);
+        as.C_MV(x1, x2);
+        as.C_JALR(x5);
+        as.C_EBREAK();
+        as.C_LBU(x8, 3, x9);
+        as.C_SH(x10, 2, x11);
+        as.C_ZEXT_W(x12);
+        as.C_MUL(x8, x15);
+    });
+
+    VerifyRoundTrip(code, ArchFeature::RV64);
+}
+
+TEST_CASE("Decode round-trips every compressed encoding", "[decoder]") {
+    for (const auto features : {ArchFeature::RV32, ArchFeature::RV64, ArchFeature::RV128}) {
+        for (const auto options : {DecodeOptions::None, DecodeOptions::Zcmp, DecodeOptions::Zcmt}) {
+            std::array<uint8_t, 2> output{};
+
+            for (uint32_t value = 0; value <= 0xFFFF; value++) {
+                if ((value & 0b11) == 0b11) {
+                    continue;
+                }
+
+                const auto instruction = Decode16(static_cast<uint16_t>(value), features, options);
+                REQUIRE(instruction.size == 2);
+                if (!instruction.IsValid()) {
+                    continue;
+                }
+
+                Assembler as(output.data(), output.size(), features);
+                Encode(as, instruction);
+
+                uint16_t encoded = 0;
+                std::memcpy(&encoded, output.data(), sizeof(encoded));
+                INFO("encoding " << value << ", mnemonic " << GetMnemonic(instruction.opcode));
+                REQUIRE(encoded == value);
+            }
+        }
+    }
+}
+
+TEST_CASE("Decode respects the base ISA", "[decoder]") {
+    // C.JAL on RV32, C.ADDIW on RV64
+    REQUIRE(Decode16(0x2081, ArchFeature::RV32).opcode == Opcode::C_JAL);
+    REQUIRE(Decode16(0x2081, ArchFeature::RV64).opcode == Opcode::C_ADDIW);
+
+    // C.FLD on RV32/RV64, C.LQ on RV128
+    REQUIRE(Decode16(0x2008, ArchFeature::RV64).opcode == Opcode::C_FLD);
+    REQUIRE(Decode16(0x2008, ArchFeature::RV128).opcode == Opcode::C_LQ);
+
+    // REV8 has a different encoding for every base ISA.
+    const auto rv32_rev8 = Assemble(ArchFeature::RV32, [](Assembler& as) { as.REV8(x1, x2); });
+    const auto rv64_rev8 = Assemble(ArchFeature::RV64, [](Assembler& as) { as.REV8(x1, x2); });
+    REQUIRE(Decode(rv32_rev8.data(), ArchFeature::RV32).opcode == Opcode::REV8);
+    REQUIRE(Decode(rv64_rev8.data(), ArchFeature::RV64).opcode == Opcode::REV8);
+    REQUIRE(!Decode(rv32_rev8.data(), ArchFeature::RV64).IsValid());
+
+    // RV64-only instructions
+    REQUIRE(Decode32(0x0000B003, ArchFeature::RV64).opcode == Opcode::LD);
+    REQUIRE(!Decode32(0x0000B003, ArchFeature::RV32).IsValid());
+
+    // Shift amounts above 31 are reserved on RV32.
+    const auto slli = Assemble(ArchFeature::RV64, [](Assembler& as) { as.SLLI(x1, x2, 32); });
+    REQUIRE(Decode(slli.data(), ArchFeature::RV64).opcode == Opcode::SLLI);
+    REQUIRE(!Decode(slli.data(), ArchFeature::RV32).IsValid());
+}
+
+TEST_CASE("Decode Zcmp and Zcmt", "[decoder]") {
+    const auto code = Assemble(ArchFeature::RV64, [](Assembler& as) {
+        as.CM_PUSH({ra, {s0, s11}}, -160);
+        as.CM_POPRET({ra, {s0}}, 32);
+        as.CM_MVSA01(s1, s7);
+        as.CM_JT(31);
+        as.CM_JALT(255);
+    });
+
+    // Without options, these share their encoding space with C.FSDSP.
+    for (size_t offset = 0; offset < code.size(); offset += 2) {
+        REQUIRE(Decode(code.data() + offset).opcode == Opcode::C_FSDSP);
+    }
+
+    const auto push = Decode(code.data(), ArchFeature::RV64, DecodeOptions::Zcmp);
+    REQUIRE(push.opcode == Opcode::CM_PUSH);
+    REQUIRE(push.operands[0] == Operand{OperandType::RegList, 15});
+    REQUIRE(push.GetValue(1) == -160);
+
+    REQUIRE(Decode(code.data() + 2, ArchFeature::RV64, DecodeOptions::Zcmp).opcode == Opcode::CM_POPRET);
+    REQUIRE(Decode(code.data() + 4, ArchFeature::RV64, DecodeOptions::Zcmp).opcode == Opcode::CM_MVSA01);
+    REQUIRE(Decode(code.data() + 6, ArchFeature::RV64, DecodeOptions::Zcmt).opcode == Opcode::CM_JT);
+    REQUIRE(Decode(code.data() + 8, ArchFeature::RV64, DecodeOptions::Zcmt).opcode == Opcode::CM_JALT);
+
+    // Zcmp and Zcmt encodings don't overlap with each other.
+    REQUIRE(!Decode(code.data(), ArchFeature::RV64, DecodeOptions::Zcmt).IsValid());
+    REQUIRE(!Decode(code.data() + 6, ArchFeature::RV64, DecodeOptions::Zcmp).IsValid());
+
+    VerifyRoundTrip(code, ArchFeature::RV64, DecodeOptions::Zcmp | DecodeOptions::Zcmt);
+}
+
+TEST_CASE("Decode invalid encodings", "[decoder]") {
+    // All zeroes is the defined illegal instruction, which biscuit emits as C.UNDEF.
+    REQUIRE(Decode16(0x0000).opcode == Opcode::C_UNDEF);
+
+    // C.ADDI4SPN with a zero immediate is reserved.
+    const auto addi4spn = Decode16(0x0004);
+    REQUIRE(!addi4spn.IsValid());
+    REQUIRE(addi4spn.size == 2);
+
+    // C.ADDI with rd = x0 and a non-zero immediate is a hint.
+    REQUIRE(!Decode16(0x0005).IsValid());
+
+    // Reserved rounding mode
+    REQUIRE(!Decode32(0x0220D0D3).IsValid());
+
+    // Unknown 32-bit instruction
+    const auto unknown = Decode32(0xFFFFFFFB);
+    REQUIRE(!unknown.IsValid());
+    REQUIRE(unknown.size == 4);
+
+    // Longer encodings are sized, but not decoded.
+    REQUIRE(Decode16(0x001F).size == 6);
+    REQUIRE(Decode16(0x003F).size == 8);
+    REQUIRE(Decode16(0x007F).size == 2);
+
+    REQUIRE(GetMnemonic(Opcode::Invalid) == "unknown");
+}
@@ -0,0 +1,178 @@
+#include <catch/catch.hpp>
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/disassembler.hpp>
+
+using namespace biscuit;
+
+namespace {
+// Assembles a single instruction and formats it.
+template <typename Func>
+std::string Format(Func&& func, ArchFeature features = ArchFeature::RV64, bool use_aliases = true) {
+    std::array<uint8_t, 8> code{};
+    Assembler as(code.data(), code.size(), features);
+    func(as);
+
+    const auto instruction = Decode(code.data(), features, DecodeOptions::Zcmp);
+    REQUIRE(instruction.IsValid());
+    return FormatInstruction(instruction, 0, use_aliases);
+}
+} // Anonymous namespace
+
+TEST_CASE("Disassemble objdump output", "[disassembler]") {
+    std::array<uint8_t, 16> code{};
+    Assembler as(code.data(), code.size());
+
+    Label label;
+    as.ADD(a0, a0, a1);
+    as.BEQ(a0, zero, &label);
+    as.C_LI(a0, 1);
+    as.Bind(&label);
+    as.C_JR(ra);
+
+    const std::span<const uint8_t> buffer{code.data(), as.GetCodeBuffer().GetSizeInBytes()};
+
+    REQUIRE(Disassemble(buffer) ==
+            "   0:\t00b50533          \tadd\ta0,a0,a1\n"
+            "   4:\t00050363          \tbeqz\ta0,a <.L0>\n"
+            "   8:\t4505                \tli\ta0,1\n"
+            "\n"
+            "000000000000000a <.L0>:\n"
+            "   a:\t8082                \tret\n");
+
+    SECTION("Without aliases") {
+        DisassemblerOptions options;
+        options.use_aliases = false;
+
+        REQUIRE(Disassemble(buffer, 0, options) ==
+                "   0:\t00b50533          \tadd\ta0,a0,a1\n"
+                "   4:\t00050363          \tbeq\ta0,zero,a <.L0>\n"
+                "   8:\t4505                \tc.li\ta0,1\n"
+                "\n"
+                "000000000000000a <.L0>:\n"
+                "   a:\t8082                \tc.jr\tra\n");
+    }
+
+    SECTION("Without raw bytes or labels") {
+        DisassemblerOptions options;
+        options.show_raw_bytes = false;
+        options.show_labels = false;
+
+        REQUIRE(Disassemble(buffer, 0x10000, options) ==
+                "   10000:\tadd\ta0,a0,a1\n"
+                "   10004:\tbeqz\ta0,1000a\n"
+                "   10008:\tli\ta0,1\n"
+                "   1000a:\tret\n");
+    }
+}
+
+TEST_CASE("Disassemble out-of-buffer targets and invalid encodings", "[disassembler]") {
+    std::array<uint8_t, 16> code{};
+    Assembler as(code.data(), code.size());
+
+    as.JAL(ra, 0x100);
+    as.JAL(zero, -4);
+    // A reserved C.ADDI4SPN encoding, followed by an incomplete 32-bit instruction.
+    as.GetCodeBuffer().Emit16(0x0004);
+    as.GetCodeBuffer().Emit16(0x0013);
+
+    const std::span<const uint8_t> buffer{code.data(), as.GetCodeBuffer().GetSizeInBytes()};
+
+    REQUIRE(Disassemble(buffer, 0x1000) ==
+            "0000000000001000 <.L0>:\n"
+            "    1000:\t100000ef          \tjal\t1100\n"
+            "    1004:\tffdff06f          \tj\t1000 <.L0>\n"
+            "    1008:\t0004                \t.insn\t2, 0x0004\n"
+            "    100a:\t0013                \t.insn\t2, 0x0013\n");
+}
+
+TEST_CASE("FormatInstruction aliases", "[disassembler]") {
+    REQUIRE(Format([](Assembler& as) { as.ADDI(x0, x0, 0); }) == "nop");
+    REQUIRE(Format([](Assembler& as) { as.ADDI(a0, zero, -5); }) == "li\ta0,-5");
+    REQUIRE(Format([](Assembler& as) { as.ADDI(a0, a1, 0); }) == "mv\ta0,a1");
+    REQUIRE(Format([](Assembler& as) { as.ADDIW(a0, a1, 0); }) == "sext.w\ta0,a1");
+    REQUIRE(Format([](Assembler& as) { as.XORI(a0, a1, -1); }) == "not\ta0,a1");
+    REQUIRE(Format([](Assembler& as) { as.SUB(a0, zero, a1); }) == "neg\ta0,a1");
+    REQUIRE(Format([](Assembler& as) { as.SLTIU(a0, a1, 1); }) == "seqz\ta0,a1");
+    REQUIRE(Format([](Assembler& as) { as.SLTU(a0, zero, a1); }) == "snez\ta0,a1");
+    REQUIRE(Format([](Assembler& as) { as.BGE(zero, a1, 16); }) == "blez\ta1,10");
+    REQUIRE(Format([](Assembler& as) { as.BLT(a1, zero, -16); }) == "bltz\ta1,fffffffffffffff0");
+    REQUIRE(Format([](Assembler& as) { as.JALR(zero, 0, ra); }) == "ret");
+    REQUIRE(Format([](Assembler& as) { as.JALR(zero, 8, a0); }) == "jr\t8(a0)");
+    REQUIRE(Format([](Assembler& as) { as.JALR(ra, 0, a0); }) == "jalr\ta0");
+    REQUIRE(Format([](Assembler& as) { as.CSRRS(a0, CSR::Cycle, zero); }) == "rdcycle\ta0");
+    REQUIRE(Format([](Assembler& as) { as.CSRRS(a0, CSR::SStatus, zero); }) == "csrr\ta0,sstatus");
+    REQUIRE(Format([](Assembler& as) { as.CSRRW(zero, CSR::VStart, a0); }) == "csrw\tvstart,a0");
+    REQUIRE(Format([](Assembler& as) { as.CSRRSI(zero, CSR::FFlags, 1); }) == "csrsi\tfflags,1");
+    REQUIRE(Format([](Assembler& as) { as.FSGNJ_D(fa0, fa1, fa1); }) == "fmv.d\tfa0,fa1");
+    REQUIRE(Format([](Assembler& as) { as.FSGNJN_S(fa0, fa1, fa1); }) == "fneg.s\tfa0,fa1");
+    REQUIRE(Format([](Assembler& as) { as.FENCE(); }) == "fence");
+    REQUIRE(Format([](Assembler& as) { as.VMNAND(v1, v2, v2); }) == "vmnot.m\tv1,v2");
+    REQUIRE(Format([](Assembler& as) { as.VMXOR(v1, v1, v1); }) == "vmclr.m\tv1");
+    REQUIRE(Format([](Assembler& as) { as.VXOR(v1, v2, -1, VecMask::Yes); }) == "vnot.v\tv1,v2,v0.t");
+
+    // Compressed instructions are printed as the instructions they expand to.
+    REQUIRE(Format([](Assembler& as) { as.C_ADDI16SP(-32); }) == "addi\tsp,sp,-32");
+    REQUIRE(Format([](Assembler& as) { as.C_ADDI4SPN(a0, 16); }) == "addi\ta0,sp,16");
+    REQUIRE(Format([](Assembler& as) { as.C_LUI(a0, 0x3F); }) == "lui\ta0,0xfffff");
+    REQUIRE(Format([](Assembler& as) { as.C_MV(a0, a1); }) == "mv\ta0,a1");
+    REQUIRE(Format([](Assembler& as) { as.C_SDSP(ra, 8); }) == "sd\tra,8(sp)");
+    REQUIRE(Format([](Assembler& as) { as.C_LW(a0, 4, a1); }) == "lw\ta0,4(a1)");
+    REQUIRE(Format([](Assembler& as) { as.C_BNEZ(a0, 8); }) == "bnez\ta0,8");
+    REQUIRE(Format([](Assembler& as) { as.C_NOP(); }) == "nop");
+    REQUIRE(Format([](Assembler& as) { as.C_ZEXT_B(a0); }) == "zext.b\ta0,a0");
+    REQUIRE(Format([](Assembler& as) { as.C_NOT(a0); }) == "not\ta0,a0");
+    REQUIRE(Format([](Assembler& as) { as.C_LQSP(a0, 16); }, ArchFeature::RV128) == "lq\ta0,16(sp)");
+}
+
+TEST_CASE("FormatInstruction canonical forms", "[disassembler]") {
+    const auto canonical = [](auto&& func, ArchFeature features = ArchFeature::RV64) {
+        return Format(func, features, false);
+    };
+
+    REQUIRE(canonical([](Assembler& as) { as.ADDI(x0, x0, 0); }) == "addi\tzero,zero,0");
+    REQUIRE(canonical([](Assembler& as) { as.LUI(a0, 0x12345); }) == "lui\ta0,0x12345");
+    REQUIRE(canonical([](Assembler& as) { as.SD(ra, -8, sp); }) == "sd\tra,-8(sp)");
+    REQUIRE(canonical([](Assembler& as) { as.FLD(fa0, 16, a0); }) == "fld\tfa0,16(a0)");
+    REQUIRE(canonical([](Assembler& as) { as.FENCE(FenceOrder::R, FenceOrder::RW); }) == "fence\tr,rw");
+    REQUIRE(canonical([](Assembler& as) { as.CSRRS(a0, CSR::HPMCounter4, zero); }) ==
+            "csrrs\ta0,hpmcounter4,zero");
+    REQUIRE(canonical([](Assembler& as) { as.CSRRS(a0, static_cast<CSR>(0x7C0), zero); }) ==
+            "csrrs\ta0,0x7c0,zero");
+
+    REQUIRE(canonical([](Assembler& as) { as.AMOADD_W(Ordering::AQRL, a0, a1, a2); }) ==
+            "amoadd.w.aqrl\ta0,a1,(a2)");
+    REQUIRE(canonical([](Assembler& as) { as.LR_D(Ordering::AQ, a0, a1); }) == "lr.d.aq\ta0,(a1)");
+    REQUIRE(canonical([](Assembler& as) { as.SC_W(Ordering::None, a0, a2, a1); }) == "sc.w\ta0,a2,(a1)");
+
+    REQUIRE(canonical([](Assembler& as) { as.FADD_D(fa0, fa1, fa2); }) == "fadd.d\tfa0,fa1,fa2");
+    REQUIRE(canonical([](Assembler& as) { as.FADD_S(fa0, fa1, fa2, RMode::RTZ); }) ==
+            "fadd.s\tfa0,fa1,fa2,rtz");
+    REQUIRE(canonical([](Assembler& as) { as.FLI_D(fa0, 0.5); }) == "fli.d\tfa0,0.5");
+    REQUIRE(canonical([](Assembler& as) { as.FLI_S(fa0, -1.0); }) == "fli.s\tfa0,-1.0");
+
+    REQUIRE(canonical([](Assembler& as) { as.VSETVLI(a0, a1, SEW::E32, LMUL::M2, VTA::Yes, VMA::No); }) ==
+            "vsetvli\ta0,a1,e32,m2,ta,mu");
+    REQUIRE(canonical([](Assembler& as) { as.VSETIVLI(a0, 8, SEW::E8, LMUL::MF4, VTA::No, VMA::Yes); }) ==
+            "vsetivli\ta0,8,e8,mf4,tu,ma");
+    REQUIRE(canonical([](Assembler& as) { as.VADD(v1, v2, v3, VecMask::Yes); }) == "vadd.vv\tv1,v2,v3,v0.t");
+    REQUIRE(canonical([](Assembler& as) { as.VADD(v1, v2, a0); }) == "vadd.vx\tv1,v2,a0");
+    REQUIRE(canonical([](Assembler& as) { as.VMERGE(v1, v2, v3); }) == "vmerge.vvm\tv1,v2,v3,v0");
+    REQUIRE(canonical([](Assembler& as) { as.VMADC(v1, v2, v3, VecMask::Yes); }) == "vmadc.vvm\tv1,v2,v3,v0");
+    REQUIRE(canonical([](Assembler& as) { as.VLE32(v4, a0, VecMask::Yes); }) == "vle32.v\tv4,(a0),v0.t");
+    REQUIRE(canonical([](Assembler& as) { as.VLSSEGE16(4, v4, a0, a1); }) == "vlsseg4e16.v\tv4,(a0),a1");
+
+    REQUIRE(canonical([](Assembler& as) { as.C_LI(a0, -1); }) == "c.li\ta0,-1");
+    REQUIRE(canonical([](Assembler& as) { as.C_LUI(a0, 1); }) == "c.lui\ta0,0x1");
+    REQUIRE(canonical([](Assembler& as) { as.C_ADDI16SP(-32); }) == "c.addi16sp\tsp,-32");
+    REQUIRE(canonical([](Assembler& as) { as.C_SWSP(a0, 12); }) == "c.swsp\ta0,12(sp)");
+    REQUIRE(canonical([](Assembler& as) { as.CM_PUSH({ra, {s0, s1}}, -32); }, ArchFeature::RV32) ==
+            "cm.push\t{ra,s0-s1},-32");
+    REQUIRE(canonical([](Assembler& as) { as.CM_POPRET({ra}, 16); }, ArchFeature::RV32) ==
+            "cm.popret\t{ra},16");
+}
@@ -0,0 +1,168 @@
+#include <catch/catch.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <biscuit/dispatcher.hpp>
+
+using namespace biscuit;
+
+namespace {
+uint32_t ReadInstruction(const void* entry) {
+    uint32_t instruction = 0;
+    std::memcpy(&instruction, entry, sizeof(instruction));
+    return instruction;
+}
+} // Anonymous namespace
+
+TEST_CASE("ExtensionSet operations", "[dispatcher]") {
+    ExtensionSet set{RISCVExtension::V, RISCVExtension::Zba};
+    REQUIRE(set.Has(RISCVExtension::V));
+    REQUIRE(set.Has(RISCVExtension::Zba));
+    REQUIRE(!set.Has(RISCVExtension::Zbb));
+    REQUIRE(set.Count() == 2);
+
+    REQUIRE(ExtensionSet{}.IsSubsetOf(set));
+    REQUIRE(ExtensionSet{RISCVExtension::V}.IsSubsetOf(set));
+    REQUIRE(!ExtensionSet{RISCVExtension::Zbb}.IsSubsetOf(set));
+
+    set.Remove(RISCVExtension::V);
+    REQUIRE(set == ExtensionSet{RISCVExtension::Zba});
+    REQUIRE((set | ExtensionSet{RISCVExtension::Zalrsc}).Has(RISCVExtension::Zalrsc));
+    REQUIRE((set & ExtensionSet{RISCVExtension::Zbb}).IsEmpty());
+}
+
+TEST_CASE("Dispatcher selects most specialized variant", "[dispatcher]") {
+    Dispatcher dispatcher;
+
+    dispatcher.AddVariant({}, [](Assembler& as) {
+        as.ADDI(x10, x0, 1);
+        as.RET();
+    });
+    dispatcher.AddVariant({RISCVExtension::V}, [](Assembler& as) {
+        as.ADDI(x10, x0, 2);
+        as.RET();
+    });
+    dispatcher.AddVariant({RISCVExtension::V, RISCVExtension::Zvbb}, [](Assembler& as) {
+        as.ADDI(x10, x0, 3);
+        as.RET();
+    });
+
+    REQUIRE(!dispatcher.IsResolved());
+    REQUIRE(!dispatcher.GetSelectedVariant().has_value());
+    const auto stub = dispatcher.GetSlot()->load();
+    REQUIRE(stub != 0);
+
+    const auto* entry = dispatcher.Resolve({RISCVExtension::V, RISCVExtension::Zba});
+    REQUIRE(dispatcher.IsResolved());
+    REQUIRE(dispatcher.GetSelectedVariant() == 1U);
+    REQUIRE(ReadInstruction(entry) == 0x00200513);
+    REQUIRE(dispatcher.GetSlot()->load() == reinterpret_cast<uintptr_t>(entry));
+    REQUIRE(dispatcher.GetSlot()->load() != stub);
+
+    // Subsequent resolutions don't regenerate anything.
+    REQUIRE(dispatcher.Resolve({RISCVExtension::V, RISCVExtension::Zvbb}) == entry);
+    REQUIRE(dispatcher.GetSelectedVariant() == 1U);
+}
+
+TEST_CASE("Dispatcher falls back to baseline variant", "[dispatcher]") {
+    Dispatcher dispatcher;
+
+    dispatcher.AddVariant({RISCVExtension::Zbb}, [](Assembler& as) {
+        as.ADDI(x10, x0, 2);
+    });
+    dispatcher.AddVariant({}, [](Assembler& as) {
+        as.ADDI(x10, x0, 1);
+    });
+
+    const auto* entry = dispatcher.Resolve(ExtensionSet{RISCVExtension::Zba});
+    REQUIRE(dispatcher.GetSelectedVariant() == 1U);
+    REQUIRE(ReadInstruction(entry) == 0x00100513);
+}
+
+TEST_CASE("Dispatcher honors explicit priorities", "[dispatcher]") {
+    Dispatcher dispatcher;
+
+    dispatcher.AddVariant({RISCVExtension::Zba, RISCVExtension::Zbb}, [](Assembler& as) {
+        as.ADDI(x10, x0, 1);
+    }, 0);
+    dispatcher.AddVariant({RISCVExtension::Zba}, [](Assembler& as) {
+        as.ADDI(x10, x0, 2);
+    }, 10);
+
+    const auto* entry = dispatcher.Resolve({RISCVExtension::Zba, RISCVExtension::Zbb});
+    REQUIRE(dispatcher.GetSelectedVariant() == 1U);
+    REQUIRE(ReadInstruction(entry) == 0x00200513);
+}
+
+TEST_CASE("Dispatcher accepts negative priorities", "[dispatcher]") {
+    Dispatcher dispatcher;
+
+    // -1 is an ordinary priority, ranking below a baseline variant's default of 0.
+    dispatcher.AddVariant({RISCVExtension::Zba}, [](Assembler& as) {
+        as.ADDI(x10, x0, 1);
+    }, -1);
+    dispatcher.AddVariant({}, [](Assembler& as) {
+        as.ADDI(x10, x0, 2);
+    });
+
+    const auto* entry = dispatcher.Resolve({RISCVExtension::Zba});
+    REQUIRE(dispatcher.GetSelectedVariant() == 1U);
+    REQUIRE(ReadInstruction(entry) == 0x00200513);
+}
+
+TEST_CASE("Dispatcher slot resolves on first call", "[dispatcher]") {
+    Dispatcher dispatcher;
+    dispatcher.AddVariant({}, [](Assembler& as) {
+        as.ADDI(a0, a0, 1);
+        as.RET();
+    });
+
+    // Before resolution, the slot points at the resolver stub, which
+    // preserves the arguments and the return address around the resolution.
+    const auto* stub = reinterpret_cast<const void*>(dispatcher.GetSlot()->load());
+    REQUIRE(!dispatcher.IsResolved());
+    REQUIRE(ReadInstruction(stub) == 0xF7010113); // addi sp, sp, -144
+    REQUIRE(ReadInstruction(static_cast<const uint8_t*>(stub) + 4) == 0x08113423); // sd ra, 136(sp)
+
+#if defined(__linux__) && defined(__riscv)
+    using Func = uint64_t (*)(uint64_t);
+    const auto func = reinterpret_cast<Func>(dispatcher.GetSlot()->load());
+    REQUIRE(func(41) == 42);
+    REQUIRE(dispatcher.IsResolved());
+    REQUIRE(dispatcher.GetSelectedVariant() == 0U);
+
+    // Later calls through the slot go straight to the variant.
+    REQUIRE(reinterpret_cast<Func>(dispatcher.GetSlot()->load())(1) == 2);
+#endif
+}
+
+TEST_CASE("Dispatcher generates exactly once under contention", "[dispatcher]") {
+    Dispatcher dispatcher;
+    std::atomic<uint32_t> generation_count{0};
+
+    dispatcher.AddVariant({}, [&](Assembler& as) {
+        generation_count++;
+        as.ADDI(x10, x0, 1);
+        as.RET();
+    });
+
+    std::array<const void*, 8> entries{};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < entries.size(); i++) {
+        threads.emplace_back([&, i] {
+            entries[i] = dispatcher.Resolve(ExtensionSet{});
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(generation_count == 1);
+    for (const auto* entry : entries) {
+        REQUIRE(entry == entries[0]);
+    }
+}
@@ -0,0 +1,126 @@
+#include <catch/catch.hpp>
+
+#include <array>
+#include <cstring>
+
+#include <biscuit/assembler.hpp>
+
+using namespace biscuit;
+
+namespace {
+// Nothing can be mapped within 2GiB of this.
+constexpr uint64_t far_address = 0x4000'0000'0000'0000;
+
+uint32_t ReadWord(const uint8_t* code, size_t offset) {
+    uint32_t word = 0;
+    std::memcpy(&word, code + offset, sizeof(word));
+    return word;
+}
+
+// Retrieves the address that an AUIPC and the I-type instruction after it compute.
+uint64_t GetPairTarget(const uint8_t* code, size_t offset) {
+    const auto hi20 = static_cast<int32_t>(ReadWord(code, offset) & 0xFFFFF000);
+    const auto lo12 = static_cast<int32_t>(ReadWord(code, offset + 4)) >> 20;
+    return reinterpret_cast<uintptr_t>(code + offset) + static_cast<uint64_t>(int64_t{hi20} + lo12);
+}
+} // Anonymous namespace
+
+TEST_CASE("CallExternal calls symbols bound before emission", "[external_symbol]") {
+    std::array<uint8_t, 64> code{};
+    Assembler as(code.data(), code.size());
+    as.EnableOptimization(Optimization::AutoCompress);
+
+    const auto target = reinterpret_cast<uintptr_t>(code.data()) + 0x12345678;
+    ExternalSymbol helper{"helper", target};
+
+    as.C_NOP();
+    as.CallExternal(&helper);
+
+    // Call sites keep their shape regardless of compression.
+    REQUIRE(as.GetCodeBuffer().GetSizeInBytes() == 10);
+    REQUIRE((ReadWord(code.data(), 2) & 0xFFF) == 0x097);   // AUIPC ra
+    REQUIRE((ReadWord(code.data(), 6) & 0xFFFFF) == 0x080E7); // JALR ra, ra
+    REQUIRE(GetPairTarget(code.data(), 2) == target);
+    REQUIRE(helper.IsResolved());
+
+    const auto& relocations = as.GetRelocations();
+    REQUIRE(relocations.size() == 1);
+    REQUIRE(relocations[0].offset == 2);
+    REQUIRE(relocations[0].type == RelocationType::Call);
+    REQUIRE(relocations[0].symbol == "helper");
+}
+
+TEST_CASE("BindExternal patches all call sites", "[external_symbol]") {
+    std::array<uint8_t, 64> code{};
+    Assembler as(code.data(), code.size());
+
+    ExternalSymbol helper{"helper"};
+    as.CallExternal(&helper);
+    as.CallExternal(&helper);
+    REQUIRE(!helper.IsBound());
+    REQUIRE(!helper.IsResolved());
+
+    const auto target = reinterpret_cast<uintptr_t>(code.data()) - 0x800;
+    as.BindExternal(&helper, target);
+
+    REQUIRE(helper.GetAddress() == target);
+    REQUIRE(helper.IsResolved());
+    REQUIRE(GetPairTarget(code.data(), 0) == target);
+    REQUIRE(GetPairTarget(code.data(), 8) == target);
+}
+
+TEST_CASE("Out of range symbols are called through veneers", "[external_symbol]") {
+    std::array<uint8_t, 64> code{};
+    Assembler as(code.data(), code.size());
+
+    ExternalSymbol near{"near"};
+    ExternalSymbol far{"far"};
+    as.CallExternal(&near);
+    as.CallExternal(&far);
+    as.RET();
+
+    SECTION("Veneers placed after binding") {
+        as.BindExternal(&near, reinterpret_cast<uintptr_t>(code.data()) + 0x1000);
+        as.BindExternal(&far, far_address);
+        REQUIRE(near.IsResolved());
+        REQUIRE(!far.IsResolved());
+
+        as.PlaceExternalVeneers();
+        REQUIRE(!near.HasVeneer());
+        REQUIRE(far.HasVeneer());
+        REQUIRE(far.IsResolved());
+
+        // AUIPC + LD + JR, aligned slot
+        REQUIRE(as.GetCodeBuffer().GetSizeInBytes() == 20 + 12 + 8);
+        REQUIRE(GetPairTarget(code.data(), 8) == reinterpret_cast<uintptr_t>(code.data() + 20));
+        REQUIRE(GetPairTarget(code.data(), 20) == reinterpret_cast<uintptr_t>(code.data() + 32));
+        REQUIRE(ReadWord(code.data(), 28) == 0x00030067); // JR t1
+
+        uint64_t slot = 0;
+        std::memcpy(&slot, code.data() + 32, sizeof(slot));
+        REQUIRE(slot == far_address);
+    }
+
+    SECTION("Veneers placed before binding") {
+        as.PlaceExternalVeneers();
+        REQUIRE(near.HasVeneer());
+        REQUIRE(far.HasVeneer());
+        REQUIRE(GetPairTarget(code.data(), 0) == reinterpret_cast<uintptr_t>(code.data() + 20));
+
+        // Symbols within range are still called directly once bound.
+        const auto near_address = reinterpret_cast<uintptr_t>(code.data()) + 0x1000;
+        as.BindExternal(&near, near_address);
+        as.BindExternal(&far, far_address);
+        REQUIRE(GetPairTarget(code.data(), 0) == near_address);
+        REQUIRE(GetPairTarget(code.data(), 8) == reinterpret_cast<uintptr_t>(code.data() + 40));
+
+        uint64_t slot = 0;
+        std::memcpy(&slot, code.data() + 56, sizeof(slot));
+        REQUIRE(slot == far_address);
+    }
+
+    // Veneer slots are relocated like any other reference.
+    const auto& relocations = as.GetRelocations();
+    REQUIRE(relocations.back().type == RelocationType::Absolute64);
+    REQUIRE(relocations.back().symbol == "far");
+}
@@ -0,0 +1,235 @@
+#include <catch/catch.hpp>
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/frame.hpp>
+
+using namespace biscuit;
+
+namespace {
+std::vector<uint8_t> Assemble(const std::function<void(Assembler&)>& emit,
+                              ArchFeature features = ArchFeature::RV64) {
+    std::vector<uint8_t> code(128);
+    Assembler as(code.data(), code.size(), features);
+    emit(as);
+    code.resize(static_cast<size_t>(as.GetCodeBuffer().GetSizeInBytes()));
+    return code;
+}
+} // Anonymous namespace
+
+TEST_CASE("Empty frames only return", "[frame]") {
+    const auto code = Assemble([](Assembler& as) {
+        FrameBuilder frame{as};
+        REQUIRE(frame.GetFrameSize() == 0);
+        frame.EmitPrologue();
+        frame.EmitEpilogue();
+    });
+
+    REQUIRE(code == Assemble([](Assembler& as) { as.RET(); }));
+}
+
+TEST_CASE("Frames without extensions", "[frame]") {
+    constexpr std::array saved{ra, s0, s1};
+
+    const auto code = Assemble([&](Assembler& as) {
+        FrameBuilder frame{as};
+        frame.SaveRegisters(saved);
+        frame.SetLocalsSize(20);
+        REQUIRE(frame.GetFrameSize() == 48);
+        frame.EmitPrologue();
+        frame.EmitEpilogue(FrameExit::ReturnZero);
+    });
+
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.ADDI(sp, sp, -48);
+        as.SD(ra, 40, sp);
+        as.SD(s0, 32, sp);
+        as.SD(s1, 24, sp);
+        as.LD(ra, 40, sp);
+        as.LD(s0, 32, sp);
+        as.LD(s1, 24, sp);
+        as.ADDI(sp, sp, 48);
+        as.LI(a0, 0);
+        as.RET();
+    }));
+}
+
+TEST_CASE("Frames with compressed instructions", "[frame]") {
+    SECTION("RV64") {
+        const auto code = Assemble([](Assembler& as) {
+            FrameBuilder frame{as, {RISCVExtension::Zca, RISCVExtension::Zcd}};
+            frame.SaveRegister(ra);
+            frame.SaveRegister(s0);
+            frame.SaveRegister(fs1);
+            frame.SetLocalsSize(8);
+            frame.EmitPrologue();
+            frame.EmitEpilogue();
+        });
+
+        REQUIRE(code == Assemble([](Assembler& as) {
+            as.C_ADDI16SP(-32);
+            as.C_SDSP(ra, 24);
+            as.C_SDSP(s0, 16);
+            as.C_FSDSP(fs1, 8);
+            as.C_LDSP(ra, 24);
+            as.C_LDSP(s0, 16);
+            as.C_FLDSP(fs1, 8);
+            as.C_ADDI16SP(32);
+            as.C_JR(ra);
+        }));
+    }
+
+    SECTION("RV32") {
+        const auto code = Assemble(
+            [](Assembler& as) {
+                FrameBuilder frame{as, {RISCVExtension::C}};
+                frame.SaveRegister(ra);
+                frame.SaveRegister(s0);
+                frame.EmitPrologue();
+                frame.EmitEpilogue(FrameExit::Restore);
+            },
+            ArchFeature::RV32);
+
+        REQUIRE(code == Assemble(
+                            [](Assembler& as) {
+                                as.C_ADDI16SP(-16);
+                                as.C_SWSP(ra, 12);
+                                as.C_SWSP(s0, 8);
+                                as.C_LWSP(ra, 12);
+                                as.C_LWSP(s0, 8);
+                                as.C_ADDI16SP(16);
+                            },
+                            ArchFeature::RV32));
+    }
+}
+
+TEST_CASE("Frames with push/pop", "[frame]") {
+    const auto emit = [](FrameExit exit) {
+        return Assemble([=](Assembler& as) {
+            FrameBuilder frame{as, {RISCVExtension::Zcmp}};
+            frame.SaveRegister(s0);
+            frame.SaveRegister(s2);
+            frame.SetLocalsSize(40);
+            REQUIRE(frame.GetFrameSize() == 80);
+            frame.EmitPrologue();
+            frame.EmitEpilogue(exit);
+        });
+    };
+
+    // s1 and ra are saved along with s0 and s2, taking up the first 32 bytes.
+    REQUIRE(emit(FrameExit::Return) == Assemble([](Assembler& as) {
+        as.CM_PUSH({ra, {s0, s2}}, -80);
+        as.CM_POPRET({ra, {s0, s2}}, 80);
+    }));
+    REQUIRE(emit(FrameExit::ReturnZero) == Assemble([](Assembler& as) {
+        as.CM_PUSH({ra, {s0, s2}}, -80);
+        as.CM_POPRETZ({ra, {s0, s2}}, 80);
+    }));
+    REQUIRE(emit(FrameExit::Restore) == Assemble([](Assembler& as) {
+        as.CM_PUSH({ra, {s0, s2}}, -80);
+        as.CM_POP({ra, {s0, s2}}, 80);
+    }));
+}
+
+TEST_CASE("Frames with push/pop and FPRs", "[frame]") {
+    const auto code = Assemble([](Assembler& as) {
+        FrameBuilder frame{as, {RISCVExtension::Zcmp}};
+        frame.SaveRegister(s0);
+        frame.SaveRegister(fs0);
+        frame.SetLocalsSize(96);
+        REQUIRE(frame.GetFrameSize() == 128);
+        frame.EmitPrologue();
+        frame.EmitEpilogue();
+    });
+
+    // CM.PUSH can only allocate 48 bytes past the saved registers.
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.CM_PUSH({ra, {s0}}, -64);
+        as.C_ADDI16SP(-64);
+        as.FSD(fs0, 104, sp);
+        as.FLD(fs0, 104, sp);
+        as.C_ADDI16SP(64);
+        as.CM_POPRET({ra, {s0}}, 64);
+    }));
+}
+
+TEST_CASE("Large frames are allocated in two steps", "[frame]") {
+    const auto code = Assemble([](Assembler& as) {
+        FrameBuilder frame{as};
+        frame.SaveRegister(ra);
+        frame.SetLocalsSize(4096);
+        REQUIRE(frame.GetFrameSize() == 4112);
+        frame.EmitPrologue();
+        frame.EmitEpilogue();
+    });
+
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.ADDI(sp, sp, -16);
+        as.SD(ra, 8, sp);
+        as.LI(t0, 4096);
+        as.SUB(sp, sp, t0);
+        as.LI(t0, 4096);
+        as.ADD(sp, sp, t0);
+        as.LD(ra, 8, sp);
+        as.ADDI(sp, sp, 16);
+        as.RET();
+    }));
+}
+
+TEST_CASE("Frames at the single adjustment limit", "[frame]") {
+    const auto emit = [](uint32_t locals_size) {
+        return Assemble([=](Assembler& as) {
+            FrameBuilder frame{as};
+            frame.SaveRegister(ra);
+            frame.SetLocalsSize(locals_size);
+            frame.EmitPrologue();
+            frame.EmitEpilogue(FrameExit::Restore);
+        });
+    };
+
+    REQUIRE(emit(2024) == Assemble([](Assembler& as) {
+        as.ADDI(sp, sp, -2032);
+        as.SD(ra, 2024, sp);
+        as.LD(ra, 2024, sp);
+        as.ADDI(sp, sp, 2032);
+    }));
+
+    // 2048 bytes can't be added back with ADDI, so t0 must not be needed for it.
+    REQUIRE(emit(2040) == Assemble([](Assembler& as) {
+        as.ADDI(sp, sp, -16);
+        as.SD(ra, 8, sp);
+        as.ADDI(sp, sp, -2032);
+        as.ADDI(sp, sp, 2032);
+        as.LD(ra, 8, sp);
+        as.ADDI(sp, sp, 16);
+    }));
+}
+
+TEST_CASE("FPRs are 8-byte aligned on RV32", "[frame]") {
+    const auto code = Assemble(
+        [](Assembler& as) {
+            FrameBuilder frame{as, {RISCVExtension::C, RISCVExtension::D}};
+            frame.SaveRegister(ra);
+            frame.SaveRegister(fs0);
+            REQUIRE(frame.GetFrameSize() == 16);
+            frame.EmitPrologue();
+            frame.EmitEpilogue();
+        },
+        ArchFeature::RV32);
+
+    // ra is padded out to 8 bytes, so that fs0 is saved below it at an aligned offset.
+    REQUIRE(code == Assemble(
+                        [](Assembler& as) {
+                            as.C_ADDI16SP(-16);
+                            as.C_SWSP(ra, 12);
+                            as.C_FSDSP(fs0, 0);
+                            as.C_LWSP(ra, 12);
+                            as.C_FLDSP(fs0, 0);
+                            as.C_ADDI16SP(16);
+                            as.C_JR(ra);
+                        },
+                        ArchFeature::RV32));
+}
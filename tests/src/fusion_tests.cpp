@@ -0,0 +1,141 @@
+#include <catch/catch.hpp>
+
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/decoder.hpp>
+#include <biscuit/fusion.hpp>
+#include <biscuit/ir.hpp>
+
+using namespace biscuit;
+
+namespace {
+FusionProfile GetPair(const std::function<void(Assembler&)>& first,
+                      const std::function<void(Assembler&)>& second) {
+    return GetFusiblePair(MakeInstruction(ArchFeature::RV64, first),
+                          MakeInstruction(ArchFeature::RV64, second));
+}
+
+std::vector<uint8_t> Assemble(const std::function<void(Assembler&)>& emit,
+                              ArchFeature features = ArchFeature::RV64) {
+    std::vector<uint8_t> code(64);
+    Assembler as(code.data(), code.size(), features);
+    emit(as);
+    code.resize(static_cast<size_t>(as.GetCodeBuffer().GetSizeInBytes()));
+    return code;
+}
+} // Anonymous namespace
+
+TEST_CASE("Fusible pairs are recognized", "[fusion]") {
+    REQUIRE(GetPair([](Assembler& as) { as.LUI(a0, 0x12345); },
+                    [](Assembler& as) { as.ADDIW(a0, a0, 0x678); }) == FusionProfile::LuiAddi);
+    REQUIRE(GetPair([](Assembler& as) { as.AUIPC(a0, 1); },
+                    [](Assembler& as) { as.ADDI(a0, a0, -4); }) == FusionProfile::AuipcAddi);
+    REQUIRE(GetPair([](Assembler& as) { as.AUIPC(ra, 1); },
+                    [](Assembler& as) { as.JALR(ra, 16, ra); }) == FusionProfile::AuipcJalr);
+    REQUIRE(GetPair([](Assembler& as) { as.AUIPC(a0, 1); },
+                    [](Assembler& as) { as.LW(a0, 8, a0); }) == FusionProfile::AuipcLoad);
+    REQUIRE(GetPair([](Assembler& as) { as.SLLI(a0, a1, 32); },
+                    [](Assembler& as) { as.SRLI(a0, a0, 32); }) == FusionProfile::ZeroExtend);
+    REQUIRE(GetPair([](Assembler& as) { as.ADD(a0, a1, a2); },
+                    [](Assembler& as) { as.LBU(a0, 0, a0); }) == FusionProfile::IndexedLoad);
+
+    // Pairs that leave the result of the first instruction live aren't fused.
+    REQUIRE(GetPair([](Assembler& as) { as.LUI(a0, 0x12345); },
+                    [](Assembler& as) { as.ADDI(a1, a0, 0x678); }) == FusionProfile::None);
+    REQUIRE(GetPair([](Assembler& as) { as.AUIPC(t1, 1); },
+                    [](Assembler& as) { as.JALR(zero, 0, t1); }) == FusionProfile::None);
+
+    // Neither are shapes other than the canonical ones.
+    REQUIRE(GetPair([](Assembler& as) { as.SLLI(a0, a1, 32); },
+                    [](Assembler& as) { as.SRLI(a0, a0, 31); }) == FusionProfile::None);
+    REQUIRE(GetPair([](Assembler& as) { as.ADD(a0, a1, a2); },
+                    [](Assembler& as) { as.LD(a0, 8, a0); }) == FusionProfile::None);
+    REQUIRE(GetPair([](Assembler& as) { as.ADD(a0, a1, a2); },
+                    [](Assembler& as) { as.SD(a0, 0, a0); }) == FusionProfile::None);
+
+    const auto lui = MakeInstruction(ArchFeature::RV64, [](Assembler& as) { as.LUI(a0, 1); });
+    const auto addi = MakeInstruction(ArchFeature::RV64, [](Assembler& as) { as.ADDI(a0, a0, 1); });
+    REQUIRE(IsFusedPair(FusionProfile::All, lui, addi));
+    REQUIRE(IsFusedPair(FusionProfile::LuiAddi, lui, addi));
+    REQUIRE_FALSE(IsFusedPair(FusionProfile::AuipcAddi | FusionProfile::ZeroExtend, lui, addi));
+}
+
+TEST_CASE("Fusion helpers emit fusible pairs", "[fusion]") {
+    SECTION("LoadIndexed") {
+        REQUIRE(Assemble([](Assembler& as) { as.LoadIndexed(a0, a1, a2); }) == Assemble([](Assembler& as) {
+                    as.ADD(a0, a1, a2);
+                    as.LD(a0, 0, a0);
+                }));
+        REQUIRE(Assemble([](Assembler& as) { as.LoadIndexed(t0, t0, a2, LoadWidth::HalfUnsigned); }) ==
+                Assemble([](Assembler& as) {
+                    as.ADD(t0, t0, a2);
+                    as.LHU(t0, 0, t0);
+                }));
+    }
+
+    SECTION("ZeroExtend") {
+        REQUIRE(Assemble([](Assembler& as) { as.ZeroExtend(a0, a1, 8); }) ==
+                Assemble([](Assembler& as) { as.ANDI(a0, a1, 0xFF); }));
+        REQUIRE(Assemble([](Assembler& as) { as.ZeroExtend(a0, a1, 32); }) == Assemble([](Assembler& as) {
+                    as.SLLI(a0, a1, 32);
+                    as.SRLI(a0, a0, 32);
+                }));
+        REQUIRE(Assemble([](Assembler& as) { as.ZeroExtend(a0, a1, 16); }, ArchFeature::RV32) ==
+                Assemble(
+                    [](Assembler& as) {
+                        as.SLLI(a0, a1, 16);
+                        as.SRLI(a0, a0, 16);
+                    },
+                    ArchFeature::RV32));
+    }
+
+    SECTION("LoadAddress") {
+        REQUIRE(Assemble([](Assembler& as) { as.LoadAddress(a0, 0x12345678); }) == Assemble([](Assembler& as) {
+                    as.LUI(a0, 0x12345);
+                    as.ADDIW(a0, a0, 0x678);
+                }));
+
+        // Other addresses near the code are materialized relative to it.
+        std::vector<uint8_t> code(16);
+        const auto address = reinterpret_cast<uintptr_t>(code.data()) + 0x12800;
+        if (static_cast<uintptr_t>(static_cast<int32_t>(address)) == address) {
+            return;
+        }
+
+        Assembler as(code.data(), code.size());
+        as.LoadAddress(a0, address);
+        REQUIRE(as.GetCodeBuffer().GetSizeInBytes() == 8);
+
+        uint32_t auipc = 0;
+        uint32_t addi = 0;
+        std::memcpy(&auipc, code.data(), sizeof(auipc));
+        std::memcpy(&addi, code.data() + 4, sizeof(addi));
+        REQUIRE(auipc == 0x00013517); // auipc a0, 0x13
+        REQUIRE(addi == 0x80050513);  // addi a0, a0, -2048
+    }
+}
+
+TEST_CASE("Pairs in the fusion profile aren't compressed", "[fusion]") {
+    const auto emit = [](Assembler& as) {
+        as.EnableOptimization(Optimization::AutoCompress);
+        as.LI(a0, 0x12345010);
+        as.ZeroExtend(a1, a1, 32);
+    };
+
+    // LI's ADDIW and both shifts are compressible.
+    REQUIRE(Assemble(emit).size() == 10);
+
+    const auto code = Assemble([&](Assembler& as) {
+        as.SetFusionProfile(FusionProfile::LuiAddi | FusionProfile::ZeroExtend);
+        emit(as);
+    });
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.LUI(a0, 0x12345);
+        as.ADDIW(a0, a0, 0x10);
+        as.SLLI(a1, a1, 32);
+        as.SRLI(a1, a1, 32);
+    }));
+}
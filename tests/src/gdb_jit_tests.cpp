@@ -0,0 +1,169 @@
+#include <catch/catch.hpp>
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/gdb_jit.hpp>
+
+using namespace biscuit;
+
+// The interface as it's seen by a debugger.
+extern "C" {
+struct jit_code_entry {
+    jit_code_entry* next_entry;
+    jit_code_entry* prev_entry;
+    const char* symfile_addr;
+    uint64_t symfile_size;
+};
+
+struct jit_descriptor {
+    uint32_t version;
+    uint32_t action_flag;
+    jit_code_entry* relevant_entry;
+    jit_code_entry* first_entry;
+};
+
+extern jit_descriptor __jit_debug_descriptor;
+}
+
+namespace {
+size_t CountEntries() {
+    size_t count = 0;
+    for (auto* entry = __jit_debug_descriptor.first_entry; entry != nullptr; entry = entry->next_entry) {
+        count++;
+    }
+    return count;
+}
+
+template <typename T>
+T ReadAt(const jit_code_entry* entry, size_t offset) {
+    REQUIRE(offset + sizeof(T) <= entry->symfile_size);
+
+    T value{};
+    std::memcpy(&value, entry->symfile_addr + offset, sizeof(T));
+    return value;
+}
+
+struct SymbolInfo {
+    std::string_view name;
+    uint64_t value;
+    uint64_t address;
+    uint64_t size;
+};
+
+// Finds the first defined symbol within an image.
+SymbolInfo GetFirstSymbol(const jit_code_entry* entry) {
+    const auto shoff = ReadAt<uint64_t>(entry, 0x28);
+    const auto shnum = ReadAt<uint16_t>(entry, 0x3C);
+
+    for (uint16_t i = 0; i < shnum; i++) {
+        const auto header = shoff + i * 64U;
+        if (ReadAt<uint32_t>(entry, header + 4) != 2) { // SHT_SYMTAB
+            continue;
+        }
+
+        const auto symtab_offset = ReadAt<uint64_t>(entry, header + 0x18);
+        const auto strtab_index = ReadAt<uint32_t>(entry, header + 0x28);
+        const auto strtab_offset = ReadAt<uint64_t>(entry, shoff + strtab_index * 64U + 0x18);
+
+        // Skip the null symbol.
+        const auto symbol = symtab_offset + 24;
+        const auto name_offset = ReadAt<uint32_t>(entry, symbol);
+        const auto value = ReadAt<uint64_t>(entry, symbol + 8);
+
+        // Symbols of relocatable images are relative to the address of their section.
+        const auto section_index = ReadAt<uint16_t>(entry, symbol + 6);
+        const auto section_address = ReadAt<uint64_t>(entry, shoff + section_index * 64U + 0x10);
+
+        return {
+            .name = entry->symfile_addr + strtab_offset + name_offset,
+            .value = value,
+            .address = section_address + value,
+            .size = ReadAt<uint64_t>(entry, symbol + 16),
+        };
+    }
+
+    FAIL("No symbol table");
+    return {};
+}
+} // Anonymous namespace
+
+TEST_CASE("GdbJitRegistry registers finalized functions", "[gdb_jit]") {
+    std::array<uint8_t, 32> code{};
+    Assembler as(code.data(), code.size());
+
+    const auto initial_entries = CountEntries();
+
+    {
+        GdbJitRegistry registry;
+        as.AddCodeListener(&registry);
+
+        as.ADD(a0, a0, a1);
+        as.RET();
+        as.FinalizeFunction("add", 0);
+
+        const auto start = as.GetCodeBuffer().GetCursorOffset();
+        as.SUB(a0, a0, a1);
+        as.RET();
+        as.FinalizeFunction("sub", start);
+
+        as.RemoveCodeListener(&registry);
+
+        REQUIRE(registry.GetNumRegistered() == 2);
+        REQUIRE(CountEntries() == initial_entries + 2);
+        REQUIRE(__jit_debug_descriptor.version == 1);
+        REQUIRE(__jit_debug_descriptor.action_flag == 1);
+
+        // The most recently registered function is at the head of the list.
+        const auto* entry = __jit_debug_descriptor.first_entry;
+        REQUIRE(entry == __jit_debug_descriptor.relevant_entry);
+        REQUIRE(std::memcmp(entry->symfile_addr, "\x7F" "ELF", 4) == 0);
+        REQUIRE(ReadAt<uint8_t>(entry, 4) == 2);    // ELFCLASS64
+        REQUIRE(ReadAt<uint16_t>(entry, 18) == 243); // EM_RISCV
+
+        const auto sub = GetFirstSymbol(entry);
+        REQUIRE(sub.name == "sub");
+        REQUIRE(sub.value == 0);
+        REQUIRE(sub.address == reinterpret_cast<uintptr_t>(code.data() + 8));
+        REQUIRE(sub.size == 8);
+
+        const auto add = GetFirstSymbol(entry->next_entry);
+        REQUIRE(add.name == "add");
+        REQUIRE(add.value == 0);
+        REQUIRE(add.address == reinterpret_cast<uintptr_t>(code.data()));
+        REQUIRE(add.size == 8);
+        REQUIRE(entry->next_entry->prev_entry == entry);
+
+        // Unregistering removes entries from the middle of the list as well.
+        REQUIRE(registry.UnregisterFunction(code.data()));
+        REQUIRE(!registry.UnregisterFunction(code.data()));
+        REQUIRE(__jit_debug_descriptor.action_flag == 2);
+        REQUIRE(registry.GetNumRegistered() == 1);
+        REQUIRE(CountEntries() == initial_entries + 1);
+        REQUIRE(GetFirstSymbol(__jit_debug_descriptor.first_entry).name == "sub");
+    }
+
+    // Destroying the registry unregisters everything that's left.
+    REQUIRE(CountEntries() == initial_entries);
+}
+
+TEST_CASE("GdbJitRegistry registries share the descriptor", "[gdb_jit]") {
+    std::array<uint8_t, 8> code{};
+
+    const auto initial_entries = CountEntries();
+
+    GdbJitRegistry first;
+    GdbJitRegistry second;
+    first.RegisterFunction("first", code.data(), 4);
+    second.RegisterFunction("second", code.data() + 4, 4);
+    REQUIRE(CountEntries() == initial_entries + 2);
+
+    first.UnregisterAll();
+    REQUIRE(CountEntries() == initial_entries + 1);
+    REQUIRE(GetFirstSymbol(__jit_debug_descriptor.first_entry).name == "second");
+
+    second.UnregisterAll();
+    REQUIRE(CountEntries() == initial_entries);
+}
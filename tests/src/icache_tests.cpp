@@ -0,0 +1,57 @@
+#include <catch/catch.hpp>
+
+#include <array>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/icache.hpp>
+
+using namespace biscuit;
+
+TEST_CASE("CodePublisher batches modifications", "[icache]") {
+    std::array<uint8_t, 64> code{};
+    CodePublisher publisher;
+    REQUIRE(!publisher.HasPending());
+
+    // Empty ranges are ignored.
+    publisher.Add(code.data(), 0);
+    REQUIRE(!publisher.HasPending());
+
+    publisher.Add(code.data() + 32, 8);
+    publisher.Add(code.data(), 4);
+    REQUIRE(publisher.HasPending());
+
+    publisher.Publish();
+    REQUIRE(!publisher.HasPending());
+
+    // Publishing without modifications does nothing.
+    publisher.Publish();
+    REQUIRE(!publisher.HasPending());
+}
+
+TEST_CASE("CodePublisher detects a method once", "[icache]") {
+    const auto method = CodePublisher::GetMethod();
+    REQUIRE(CodePublisher::GetMethod() == method);
+
+#if defined(__linux__) && defined(__riscv)
+    REQUIRE(method != ICacheSyncMethod::ClearCache);
+#endif
+}
+
+TEST_CASE("PatchableJump defers publishing to a CodePublisher", "[icache]") {
+    Assembler as;
+    const auto first = as.EmitPatchableJump(as.GetCodeBuffer().GetCursorAddress());
+    const auto second = as.EmitPatchableJump(as.GetCodeBuffer().GetCursorAddress());
+
+    CodePublisher publisher;
+    first.Retarget(second.GetAddress(), publisher);
+    second.Retarget(first.GetAddress(), publisher);
+    REQUIRE(publisher.HasPending());
+    REQUIRE(first.GetTarget() == second.GetAddress());
+    REQUIRE(second.GetTarget() == first.GetAddress());
+
+    first.Unlink(publisher);
+    REQUIRE(!first.IsLinked());
+
+    publisher.Publish();
+    REQUIRE(!publisher.HasPending());
+}
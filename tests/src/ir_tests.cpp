@@ -0,0 +1,191 @@
+#include <catch/catch.hpp>
+
+#include <cstring>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/ir.hpp>
+
+using namespace biscuit;
+
+namespace {
+std::vector<uint8_t> GetCode(Assembler& as) {
+    const auto& buffer = as.GetCodeBuffer();
+    const auto* const begin = buffer.GetOffsetPointer(0);
+    return {begin, begin + buffer.GetSizeInBytes()};
+}
+
+uint32_t ReadWord(Assembler& as, ptrdiff_t offset) {
+    uint32_t word = 0;
+    std::memcpy(&word, as.GetCodeBuffer().GetOffsetPointer(offset), sizeof(word));
+    return word;
+}
+
+void RemoveNops(IRStream& stream) {
+    std::erase_if(stream.GetNodes(), [](const IRNode& node) {
+        return node.IsInstruction() && node.instruction.opcode == Opcode::ADDI &&
+               node.instruction.GetGPR(0) == zero && node.instruction.GetGPR(1) == zero &&
+               node.instruction.GetValue(2) == 0;
+    });
+}
+} // Anonymous namespace
+
+TEST_CASE("Emitting recorded code without passes is identical to emitting it directly", "[ir]") {
+    const auto emit = [](Assembler& as, bool record) {
+        Label loop;
+        Label done;
+        Label data;
+
+        as.Bind(&loop);
+        if (record) {
+            as.BeginRecording();
+        }
+
+        as.LILabel(a1, &data);
+        as.BEQZ(a0, &done);
+        as.ADDI(a0, a0, -1);
+        as.BNE(a0, a2, 8);
+        as.NOP();
+        as.J(&loop);
+        as.Bind(&done);
+        as.RET();
+        as.Bind(&data);
+        as.GetCodeBuffer().Emit32(0xFFFFFFFF);
+
+        if (record) {
+            as.EndRecording(IRPassPipeline{});
+        }
+    };
+
+    Assembler direct;
+    emit(direct, false);
+
+    Assembler recorded;
+    emit(recorded, true);
+
+    REQUIRE(!recorded.IsRecording());
+    REQUIRE(GetCode(recorded) == GetCode(direct));
+}
+
+TEST_CASE("Recorded streams refer to labels", "[ir]") {
+    Assembler as;
+    Label skip;
+
+    as.BeginRecording();
+    as.BEQZ(a0, &skip);
+    as.ADDI(a0, a0, 1);
+    as.Bind(&skip);
+    as.RET();
+    const auto stream = as.EndRecording();
+
+    // The recorded code is removed from the buffer, and the label is unbound again.
+    REQUIRE(as.GetCodeBuffer().GetSizeInBytes() == 0);
+    REQUIRE(!skip.IsBound());
+
+    const auto& nodes = stream.GetNodes();
+    REQUIRE(nodes.size() == 4);
+    REQUIRE(nodes[0].instruction.opcode == Opcode::BEQ);
+    REQUIRE(nodes[0].label == nodes[2].label);
+    REQUIRE(nodes[2].kind == IRNodeKind::Bind);
+    REQUIRE(stream.GetLabel(nodes[2].label) == &skip);
+
+    as.EmitIR(stream);
+    REQUIRE(skip.IsBound());
+    REQUIRE(*skip.GetLocation() == 8);
+    REQUIRE(ReadWord(as, 0) == 0x00050463); // BEQ a0, zero, 8
+}
+
+TEST_CASE("Passes removing instructions re-resolve branches", "[ir]") {
+    IRPassPipeline passes;
+    passes.Add(RemoveNops);
+    REQUIRE(passes.GetNumPasses() == 1);
+
+    SECTION("Branches within the recording") {
+        Assembler as;
+        Label skip;
+
+        as.BeginRecording();
+        as.BNE(a0, a1, &skip);
+        as.NOP();
+        as.NOP();
+        as.ADDI(a0, a0, 1);
+        as.BLT(a0, a1, -4); // Back to the ADDI, by offset
+        as.Bind(&skip);
+        as.RET();
+        as.EndRecording(passes);
+
+        REQUIRE(as.GetCodeBuffer().GetSizeInBytes() == 16);
+        REQUIRE(ReadWord(as, 0) == 0x00B51663); // BNE a0, a1, 12
+        REQUIRE(ReadWord(as, 8) == 0xFEB54EE3); // BLT a0, a1, -4
+        REQUIRE(*skip.GetLocation() == 12);
+    }
+
+    SECTION("Branches preceding the recording") {
+        Assembler as;
+        Label target;
+
+        as.J(&target);
+
+        as.BeginRecording();
+        as.NOP();
+        as.NOP();
+        as.Bind(&target);
+        as.RET();
+        as.EndRecording(passes);
+
+        REQUIRE(as.GetCodeBuffer().GetSizeInBytes() == 8);
+        REQUIRE(ReadWord(as, 0) == 0x0040006F); // J 4
+        REQUIRE(*target.GetLocation() == 4);
+    }
+}
+
+TEST_CASE("AutoCompress is suspended while recording", "[ir]") {
+    Assembler as;
+    as.EnableOptimization(Optimization::AutoCompress);
+
+    as.BeginRecording();
+    REQUIRE(as.IsRecording());
+    REQUIRE(!as.IsOptimizationEnabled(Optimization::AutoCompress));
+
+    as.ADDI(a0, a0, 1);
+    const auto stream = as.EndRecording();
+    REQUIRE(as.IsOptimizationEnabled(Optimization::AutoCompress));
+
+    REQUIRE(stream.GetNodes().size() == 1);
+    REQUIRE(stream.GetNodes()[0].instruction.opcode == Opcode::ADDI);
+
+    as.EmitIR(stream);
+    REQUIRE(as.GetCodeBuffer().GetSizeInBytes() == 2);
+}
+
+TEST_CASE("Zcmp and Zcmt instructions are recorded as themselves", "[ir]") {
+    Assembler as;
+
+    as.BeginRecording();
+    as.CM_PUSH({ra, {s0}}, -16);
+    as.CM_JALT(32);
+    as.CM_POPRET({ra, {s0}}, 16);
+    const auto stream = as.EndRecording();
+
+    // These share their encodings with C.FSDSP, which they must not be mistaken for.
+    const auto& nodes = stream.GetNodes();
+    REQUIRE(nodes.size() == 3);
+    REQUIRE(nodes[0].instruction.opcode == Opcode::CM_PUSH);
+    REQUIRE(nodes[1].instruction.opcode == Opcode::CM_JALT);
+    REQUIRE(nodes[2].instruction.opcode == Opcode::CM_POPRET);
+
+    // C.FSDSP is decoded as usual in later recordings.
+    as.BeginRecording();
+    as.C_FSDSP(fs0, 8);
+    const auto fsdsp_stream = as.EndRecording();
+    REQUIRE(fsdsp_stream.GetNodes()[0].instruction.opcode == Opcode::C_FSDSP);
+
+    as.EmitIR(stream);
+    const auto code = GetCode(as);
+
+    Assembler expected;
+    expected.CM_PUSH({ra, {s0}}, -16);
+    expected.CM_JALT(32);
+    expected.CM_POPRET({ra, {s0}}, 16);
+    REQUIRE(code == GetCode(expected));
+}
@@ -0,0 +1,114 @@
+#include <catch/catch.hpp>
+
+#include <cstring>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/island_manager.hpp>
+
+using namespace biscuit;
+
+namespace {
+// Nothing can be mapped within 1MiB of this.
+constexpr uint64_t far_address = 0x4000'0000'0000'0000;
+
+uint32_t ReadWord(Assembler& as, ptrdiff_t offset) {
+    uint32_t word = 0;
+    std::memcpy(&word, as.GetCodeBuffer().GetOffsetPointer(offset), sizeof(word));
+    return word;
+}
+
+// Retrieves the offset that the JAL at the given offset jumps to.
+ptrdiff_t GetJalTarget(Assembler& as, ptrdiff_t offset) {
+    const auto instruction = ReadWord(as, offset);
+    REQUIRE((instruction & 0x7F) == 0b1101111);
+
+    const auto imm = ((instruction >> 11) & 0x100000) | (instruction & 0xFF000) |
+                     ((instruction >> 9) & 0x800) | ((instruction >> 20) & 0x7FE);
+    return offset + (static_cast<int32_t>(imm << 11) >> 11);
+}
+
+// Retrieves the address loaded by the veneer at the given offset.
+uint64_t GetVeneerDestination(Assembler& as, ptrdiff_t offset) {
+    REQUIRE(ReadWord(as, offset) == 0x00000317);              // AUIPC t1, 0
+    REQUIRE((ReadWord(as, offset + 4) & 0xFFFFF) == 0x33303); // LD t1, slot(t1)
+    REQUIRE(ReadWord(as, offset + 8) == 0x00030067);          // JR t1
+
+    const auto slot = offset + (static_cast<int32_t>(ReadWord(as, offset + 4)) >> 20);
+    uint64_t destination = 0;
+    std::memcpy(&destination, as.GetCodeBuffer().GetOffsetPointer(slot), sizeof(destination));
+    return destination;
+}
+} // Anonymous namespace
+
+TEST_CASE("IslandManager reaches near destinations directly", "[island_manager]") {
+    Assembler as;
+    IslandManager islands{as};
+
+    const auto base = as.GetCodeBuffer().GetOffsetAddress(0);
+    islands.Call(base + 0x100);
+    islands.Jump(base - 0x100);
+
+    REQUIRE(as.GetCodeBuffer().GetSizeInBytes() == 8);
+    REQUIRE((ReadWord(as, 0) & 0xFFF) == 0x0EF); // JAL ra
+    REQUIRE((ReadWord(as, 4) & 0xFFF) == 0x06F); // JAL zero
+    REQUIRE(GetJalTarget(as, 0) == 0x100);
+    REQUIRE(GetJalTarget(as, 4) == -0x100);
+    REQUIRE(!islands.HasPendingSites());
+}
+
+TEST_CASE("IslandManager shares veneers between far destinations", "[island_manager]") {
+    Assembler as;
+    IslandManager islands{as};
+
+    islands.Call(far_address);
+    islands.Jump(far_address + 8);
+    islands.Call(far_address);
+    as.RET();
+    REQUIRE(islands.HasPendingSites());
+
+    islands.Place();
+    REQUIRE(!islands.HasPendingSites());
+    REQUIRE(islands.GetNumVeneers() == 2);
+
+    // Veneers are emitted in order of destination.
+    REQUIRE(GetJalTarget(as, 0) == 16);
+    REQUIRE(GetJalTarget(as, 8) == 16);
+    REQUIRE(GetJalTarget(as, 4) == 40);
+    REQUIRE(GetVeneerDestination(as, 16) == far_address);
+    REQUIRE(GetVeneerDestination(as, 40) == far_address + 8);
+
+    // Later sites within range reuse placed veneers.
+    const auto site = as.GetCodeBuffer().GetCursorOffset();
+    islands.Call(far_address);
+    REQUIRE(!islands.HasPendingSites());
+    REQUIRE(GetJalTarget(as, site) == 16);
+}
+
+TEST_CASE("IslandManager tracks the range of pending sites", "[island_manager]") {
+    Assembler as(3 << 20);
+    IslandManager islands{as};
+
+    islands.Call(far_address);
+    islands.Place();
+    REQUIRE(islands.GetNumVeneers() == 1);
+
+    // Move far enough away that the first veneer is out of range.
+    while (as.GetCodeBuffer().GetCursorOffset() < IslandManager::jal_range + 16) {
+        as.NOP();
+    }
+
+    const auto site = as.GetCodeBuffer().GetCursorOffset();
+    islands.Call(far_address);
+    REQUIRE(islands.HasPendingSites());
+    REQUIRE(!islands.NeedsIsland());
+    REQUIRE(!islands.NeedsIsland(IslandManager::jal_range / 2));
+    REQUIRE(islands.NeedsIsland(IslandManager::jal_range));
+
+    // Inline islands are jumped over.
+    const auto skip = as.GetCodeBuffer().GetCursorOffset();
+    islands.PlaceInline();
+    REQUIRE(islands.GetNumVeneers() == 2);
+    REQUIRE(GetJalTarget(as, skip) == as.GetCodeBuffer().GetCursorOffset());
+    REQUIRE(GetJalTarget(as, site) == skip + 4);
+    REQUIRE(GetVeneerDestination(as, skip + 4) == far_address);
+}
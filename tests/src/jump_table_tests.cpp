@@ -0,0 +1,124 @@
+#include <catch/catch.hpp>
+
+#include <cstring>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/jump_table.hpp>
+
+using namespace biscuit;
+
+namespace {
+// Nothing can be mapped within 2GiB of this.
+constexpr uint64_t far_address = 0x4000'0000'0000'0000;
+
+uint16_t ReadHalfword(Assembler& as, ptrdiff_t offset) {
+    uint16_t halfword = 0;
+    std::memcpy(&halfword, as.GetCodeBuffer().GetOffsetPointer(offset), sizeof(halfword));
+    return halfword;
+}
+
+uint32_t ReadWord(Assembler& as, ptrdiff_t offset) {
+    uint32_t word = 0;
+    std::memcpy(&word, as.GetCodeBuffer().GetOffsetPointer(offset), sizeof(word));
+    return word;
+}
+
+uint64_t ReadEntry(uint64_t table, uint32_t index) {
+    uint64_t entry = 0;
+    std::memcpy(&entry, reinterpret_cast<const void*>(table + index * 8), sizeof(entry));
+    return entry;
+}
+
+// Retrieves the address that an AUIPC and the I-type instruction after it compute.
+uint64_t GetPairTarget(Assembler& as, ptrdiff_t offset) {
+    const auto hi20 = static_cast<int32_t>(ReadWord(as, offset) & 0xFFFFF000);
+    const auto lo12 = static_cast<int32_t>(ReadWord(as, offset + 4)) >> 20;
+    return as.GetCodeBuffer().GetOffsetAddress(offset) + static_cast<uint64_t>(int64_t{hi20} + lo12);
+}
+} // Anonymous namespace
+
+TEST_CASE("JumpTable turns calls into CM.JALT", "[jump_table]") {
+    Assembler as;
+    JumpTable table{as};
+
+    const auto helper = as.GetCodeBuffer().GetOffsetAddress(0) + 0x1000;
+    REQUIRE(table.AddCall(helper) == 32U);
+    REQUIRE(table.AddCall(helper) == 32U);
+
+    table.EmitSetup(t0);
+    table.Call(helper);
+    table.Call(helper);
+    table.Call(far_address);
+    as.RET();
+
+    REQUIRE(ReadHalfword(as, 12) == 0xA082); // CM.JALT 32
+    REQUIRE(ReadHalfword(as, 14) == 0xA082); // CM.JALT 32
+    REQUIRE(ReadWord(as, 16) == 0x0010031B); // LI t1, far_address (ADDIW t1, zero, 1)
+    REQUIRE(!table.IsPlaced());
+
+    table.Place();
+    REQUIRE(table.IsPlaced());
+
+    // Without any jumps, only the call entries are emitted.
+    const auto address = *table.GetTableAddress();
+    const auto cursor = as.GetCodeBuffer().GetCursorAddress();
+    REQUIRE(address % JumpTable::alignment == 0);
+    REQUIRE(address + 33 * 8 == cursor);
+    REQUIRE(ReadEntry(address, 32) == helper);
+
+    // AUIPC t0 + ADDI t0 + CSRW jvt, t0
+    REQUIRE(GetPairTarget(as, 0) == address);
+    REQUIRE(ReadWord(as, 8) == 0x01729073);
+
+    // No more indices can be assigned after placement.
+    REQUIRE(!table.AddCall(helper + 4));
+}
+
+TEST_CASE("JumpTable assigns indices by frequency", "[jump_table]") {
+    Assembler as;
+    JumpTable table{as};
+
+    table.CountCall(0x1000, 3);
+    table.CountCall(0x2000, 10);
+    table.CountCall(0x3000);
+    table.CountCall(0x4000, 2);
+    table.CountJump(0x5000, 5);
+    table.AssignByFrequency();
+
+    REQUIRE(table.GetNumCalls() == 3);
+    REQUIRE(table.GetCallIndex(0x2000) == 32U);
+    REQUIRE(table.GetCallIndex(0x1000) == 33U);
+    REQUIRE(table.GetCallIndex(0x4000) == 34U);
+    REQUIRE(!table.GetCallIndex(0x3000));
+
+    REQUIRE(table.GetNumJumps() == 1);
+    REQUIRE(table.GetJumpIndex(0x5000) == 0U);
+}
+
+TEST_CASE("JumpTable places jump and call entries", "[jump_table]") {
+    Assembler as;
+    JumpTable table{as};
+
+    const auto base = as.GetCodeBuffer().GetOffsetAddress(0);
+    REQUIRE(table.AddJump(base + 0x100) == 0U);
+    REQUIRE(table.AddJump(base + 0x200) == 1U);
+    REQUIRE(table.AddCall(base + 0x300) == 32U);
+
+    table.Jump(base + 0x200);
+    REQUIRE(ReadHalfword(as, 0) == 0xA006); // CM.JT 1
+
+    table.Place();
+    table.EmitSetup(t0);
+
+    // Unused jump entries are kept, so that call entries start at index 32.
+    const auto address = *table.GetTableAddress();
+    REQUIRE(address % JumpTable::alignment == 0);
+    REQUIRE(address - base < 2 + JumpTable::alignment);
+    REQUIRE(ReadEntry(address, 0) == base + 0x100);
+    REQUIRE(ReadEntry(address, 1) == base + 0x200);
+    REQUIRE(ReadEntry(address, 2) == 0);
+    REQUIRE(ReadEntry(address, 32) == base + 0x300);
+
+    const auto setup = static_cast<ptrdiff_t>(address - base) + 33 * 8;
+    REQUIRE(GetPairTarget(as, setup) == address);
+}
@@ -0,0 +1,247 @@
+#include <catch/catch.hpp>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/object_writer.hpp>
+
+using namespace biscuit;
+
+namespace {
+// Minimal reader for the parts of ELF64 objects that the tests check.
+class ObjectReader {
+public:
+    struct SectionInfo {
+        std::string_view name;
+        uint32_t type;
+        uint64_t flags;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t link;
+        uint32_t info;
+    };
+
+    struct SymbolInfo {
+        std::string_view name;
+        uint8_t info;
+        uint16_t section;
+        uint64_t value;
+        uint64_t size;
+    };
+
+    struct RelocationInfo {
+        uint64_t offset;
+        uint32_t type;
+        std::string_view symbol;
+        int64_t addend;
+    };
+
+    explicit ObjectReader(const std::vector<uint8_t>& data) : m_data{data} {
+        const auto shoff = Read<uint64_t>(0x28);
+        const auto shnum = Read<uint16_t>(0x3C);
+        const auto shstrndx = Read<uint16_t>(0x3E);
+        const auto shstrtab = Read<uint64_t>(shoff + shstrndx * 64U + 0x18);
+
+        for (uint16_t i = 0; i < shnum; i++) {
+            const auto header = shoff + i * 64U;
+            m_sections.push_back({
+                .name = String(shstrtab + Read<uint32_t>(header)),
+                .type = Read<uint32_t>(header + 0x04),
+                .flags = Read<uint64_t>(header + 0x08),
+                .offset = Read<uint64_t>(header + 0x18),
+                .size = Read<uint64_t>(header + 0x20),
+                .link = Read<uint32_t>(header + 0x28),
+                .info = Read<uint32_t>(header + 0x2C),
+            });
+        }
+    }
+
+    template <typename T>
+    T Read(uint64_t offset) const {
+        REQUIRE(offset + sizeof(T) <= m_data.size());
+
+        T value{};
+        std::memcpy(&value, m_data.data() + offset, sizeof(T));
+        return value;
+    }
+
+    std::string_view String(uint64_t offset) const {
+        REQUIRE(offset < m_data.size());
+        return reinterpret_cast<const char*>(m_data.data() + offset);
+    }
+
+    const SectionInfo& FindSection(std::string_view name) const {
+        for (const auto& section : m_sections) {
+            if (section.name == name) {
+                return section;
+            }
+        }
+        FAIL("Missing section " << name);
+        return m_sections.front();
+    }
+
+    std::vector<SymbolInfo> GetSymbols() const {
+        const auto& symtab = FindSection(".symtab");
+        const auto& strtab = m_sections[symtab.link];
+
+        std::vector<SymbolInfo> symbols;
+        for (uint64_t offset = 0; offset < symtab.size; offset += 24) {
+            const auto entry = symtab.offset + offset;
+            symbols.push_back({
+                .name = String(strtab.offset + Read<uint32_t>(entry)),
+                .info = Read<uint8_t>(entry + 4),
+                .section = Read<uint16_t>(entry + 6),
+                .value = Read<uint64_t>(entry + 8),
+                .size = Read<uint64_t>(entry + 16),
+            });
+        }
+        return symbols;
+    }
+
+    std::vector<RelocationInfo> GetRelocations(std::string_view name) const {
+        const auto& rela = FindSection(name);
+        const auto symbols = GetSymbols();
+
+        std::vector<RelocationInfo> relocations;
+        for (uint64_t offset = 0; offset < rela.size; offset += 24) {
+            const auto entry = rela.offset + offset;
+            const auto info = Read<uint64_t>(entry + 8);
+            relocations.push_back({
+                .offset = Read<uint64_t>(entry),
+                .type = static_cast<uint32_t>(info),
+                .symbol = symbols.at(info >> 32).name,
+                .addend = Read<int64_t>(entry + 16),
+            });
+        }
+        return relocations;
+    }
+
+private:
+    const std::vector<uint8_t>& m_data;
+    std::vector<SectionInfo> m_sections;
+};
+} // Anonymous namespace
+
+TEST_CASE("ObjectWriter emits sections, symbols, and relocations", "[object_writer]") {
+    Assembler text;
+    Label entry;
+    Label local;
+    text.Bind(&entry);
+
+    // Call an external helper
+    text.AddRelocation(RelocationType::Call, "helper");
+    text.AUIPC(ra, 0);
+    text.JALR(ra, 0, ra);
+
+    // Load the address of a table defined in another section
+    const auto hi20_offset = text.GetCodeBuffer().GetCursorOffset();
+    text.AddRelocation(RelocationType::PCRelHi20, "table", 8);
+    text.AUIPC(a0, 0);
+    text.ADDI(a0, a0, 0);
+    text.AddRelocation({
+        .offset = hi20_offset + 4,
+        .type = RelocationType::PCRelLo12I,
+        .symbol = {},
+        .addend = 0,
+        .hi20_offset = hi20_offset,
+    });
+
+    // Branch to an external function
+    text.AddRelocation(RelocationType::Branch, "other");
+    text.BEQ(a0, zero, 0);
+    text.Bind(&local);
+    text.RET();
+    text.ExportLabel("kernel", &entry, text.GetCodeBuffer().GetSizeInBytes());
+    text.ExportLabel("kernel_tail", &local);
+
+    Assembler data;
+    Label table;
+    data.Bind(&table);
+    data.GetCodeBuffer().Emit(uint64_t{0});
+    data.AddRelocation({
+        .offset = 0,
+        .type = RelocationType::Absolute64,
+        .symbol = "kernel",
+        .addend = 4,
+        .hi20_offset = 0,
+    });
+    data.GetCodeBuffer().Emit(uint64_t{0});
+    data.ExportLabel("table", &table, 16, SymbolType::Object);
+
+    ObjectWriter writer{FloatABI::Double};
+    REQUIRE(writer.AddSection(".text", text) == 1);
+    REQUIRE(writer.AddSection(".data.rel.ro", data, SectionKind::ReadOnlyData, 8) == 2);
+
+    const auto object = writer.Write();
+    const ObjectReader reader{object};
+
+    // Header
+    REQUIRE(std::memcmp(object.data(), "\x7F" "ELF", 4) == 0);
+    REQUIRE(reader.Read<uint8_t>(4) == 2);        // ELFCLASS64
+    REQUIRE(reader.Read<uint16_t>(0x10) == 1);    // ET_REL
+    REQUIRE(reader.Read<uint16_t>(0x12) == 243);  // EM_RISCV
+    REQUIRE(reader.Read<uint32_t>(0x30) == 0x5);  // RVC | double-float ABI
+
+    // Sections
+    const auto& text_section = reader.FindSection(".text");
+    REQUIRE(text_section.flags == 0x6);
+    REQUIRE(text_section.size == text.GetCodeBuffer().GetSizeInBytes());
+    REQUIRE(std::memcmp(object.data() + text_section.offset, text.GetCodeBuffer().GetOffsetPointer(0),
+                        text_section.size) == 0);
+    REQUIRE(reader.FindSection(".data.rel.ro").flags == 0x2);
+
+    // Symbols
+    const auto symbols = reader.GetSymbols();
+    REQUIRE(symbols.size() == 7);
+    REQUIRE(symbols[1].name == ".Lpcrel_hi0");
+    REQUIRE(symbols[1].info == 0x00); // Local, no type
+    REQUIRE(symbols[1].section == 1);
+    REQUIRE(symbols[1].value == 8);
+    REQUIRE(reader.FindSection(".symtab").info == 2);
+
+    REQUIRE(symbols[2].name == "kernel");
+    REQUIRE(symbols[2].info == 0x12); // Global function
+    REQUIRE(symbols[2].section == 1);
+    REQUIRE(symbols[2].value == 0);
+    REQUIRE(symbols[2].size == 24);
+    REQUIRE(symbols[3].name == "kernel_tail");
+    REQUIRE(symbols[3].value == 20);
+    REQUIRE(symbols[4].name == "table");
+    REQUIRE(symbols[4].info == 0x11); // Global object
+    REQUIRE(symbols[4].section == 2);
+    REQUIRE(symbols[4].size == 16);
+
+    REQUIRE(symbols[5].name == "helper");
+    REQUIRE(symbols[5].info == 0x10); // Global, no type
+    REQUIRE(symbols[5].section == 0);
+    REQUIRE(symbols[6].name == "other");
+    REQUIRE(symbols[6].section == 0);
+
+    // Relocations
+    const auto text_relocations = reader.GetRelocations(".rela.text");
+    REQUIRE(text_relocations.size() == 4);
+    REQUIRE(text_relocations[0].offset == 0);
+    REQUIRE(text_relocations[0].type == 19); // R_RISCV_CALL_PLT
+    REQUIRE(text_relocations[0].symbol == "helper");
+    REQUIRE(text_relocations[1].offset == 8);
+    REQUIRE(text_relocations[1].type == 23); // R_RISCV_PCREL_HI20
+    REQUIRE(text_relocations[1].symbol == "table");
+    REQUIRE(text_relocations[1].addend == 8);
+    REQUIRE(text_relocations[2].offset == 12);
+    REQUIRE(text_relocations[2].type == 24); // R_RISCV_PCREL_LO12_I
+    REQUIRE(text_relocations[2].symbol == ".Lpcrel_hi0");
+    REQUIRE(text_relocations[3].offset == 16);
+    REQUIRE(text_relocations[3].type == 16); // R_RISCV_BRANCH
+    REQUIRE(text_relocations[3].symbol == "other");
+    REQUIRE(reader.FindSection(".rela.text").info == 1);
+
+    const auto data_relocations = reader.GetRelocations(".rela.data.rel.ro");
+    REQUIRE(data_relocations.size() == 1);
+    REQUIRE(data_relocations[0].type == 2); // R_RISCV_64
+    REQUIRE(data_relocations[0].symbol == "kernel");
+    REQUIRE(data_relocations[0].addend == 4);
+    REQUIRE(reader.FindSection(".rela.data.rel.ro").info == 2);
+}
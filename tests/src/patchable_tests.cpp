@@ -0,0 +1,121 @@
+#include <catch/catch.hpp>
+
+#include <cstring>
+
+#include <biscuit/assembler.hpp>
+
+using namespace biscuit;
+
+namespace {
+// Nothing can be mapped within 1MiB of this.
+constexpr uint64_t far_address = 0x4000'0000'0000'0000;
+
+uint32_t ReadWord(uintptr_t address) {
+    uint32_t word = 0;
+    std::memcpy(&word, reinterpret_cast<const void*>(address), sizeof(word));
+    return word;
+}
+
+uint64_t ReadDoubleword(uintptr_t address) {
+    uint64_t doubleword = 0;
+    std::memcpy(&doubleword, reinterpret_cast<const void*>(address), sizeof(doubleword));
+    return doubleword;
+}
+} // Anonymous namespace
+
+TEST_CASE("EmitPatchableJump emits aligned fixed-size slots", "[patchable]") {
+    Assembler as;
+    auto& buffer = as.GetCodeBuffer();
+    REQUIRE(buffer.GetCursorAddress() % PatchableJump::alignment == 0);
+
+    as.C_NOP();
+    const auto target = buffer.GetCursorAddress() + 0x100;
+    const auto jump = as.EmitPatchableJump(target);
+
+    // C.NOP + C.NOP + NOP of padding
+    REQUIRE(jump.GetAddress() == buffer.GetOffsetAddress(8));
+    REQUIRE(ReadWord(buffer.GetOffsetAddress(0)) == 0x00010001);
+    REQUIRE(ReadWord(buffer.GetOffsetAddress(4)) == 0x00000013);
+    REQUIRE(buffer.GetSizeInBytes() == 8 + PatchableJump::size);
+
+    REQUIRE(ReadWord(jump.GetAddress()) == 0x0FA0006F);      // J +0xFA
+    REQUIRE(ReadWord(jump.GetAddress() + 4) == 0x00000317);  // AUIPC t1, 0
+    REQUIRE(ReadWord(jump.GetAddress() + 8) == 0x00C33303);  // LD t1, 12(t1)
+    REQUIRE(ReadWord(jump.GetAddress() + 12) == 0x00030067); // JR t1
+    REQUIRE(jump.GetTarget() == target);
+    REQUIRE(!jump.IsLinked());
+}
+
+TEST_CASE("PatchableJump retargets near and far", "[patchable]") {
+    Assembler as;
+    auto& buffer = as.GetCodeBuffer();
+
+    const auto exit = buffer.GetCursorAddress() - 0x1000;
+    const auto jump = as.EmitPatchableJump(exit);
+
+    // Far destinations go through the literal.
+    jump.Retarget(far_address);
+    REQUIRE(jump.GetTarget() == far_address);
+    REQUIRE(jump.IsLinked());
+    REQUIRE(ReadWord(jump.GetAddress()) == 0x0040006F); // J +4
+    REQUIRE(ReadDoubleword(jump.GetAddress() + 16) == far_address);
+
+    // Near destinations only need the leading jump.
+    const auto near = jump.GetAddress() + 0x20000;
+    jump.Retarget(near);
+    REQUIRE(jump.GetTarget() == near);
+    REQUIRE(ReadWord(jump.GetAddress()) == 0x0000006F + (0x20 << 12)); // J +0x20000
+
+    jump.Unlink();
+    REQUIRE(jump.GetTarget() == exit);
+    REQUIRE(!jump.IsLinked());
+}
+
+TEST_CASE("EmitPatchableJump handles far initial destinations", "[patchable]") {
+    Assembler as;
+    const auto jump = as.EmitPatchableJump(far_address);
+
+    REQUIRE(jump.GetTarget() == far_address);
+    REQUIRE(jump.GetUnlinkedTarget() == far_address);
+    REQUIRE(ReadDoubleword(jump.GetAddress() + 16) == far_address);
+}
+
+TEST_CASE("EmitPatchableLI loads repatchable constants", "[patchable]") {
+    Assembler as;
+    auto& buffer = as.GetCodeBuffer();
+
+    // The literal after the 12 bytes of code has to be naturally aligned.
+    const auto constant = as.EmitPatchableLI(x10, 0x1234'5678'9ABC'DEF0);
+    REQUIRE(constant.GetAddress() == buffer.GetOffsetAddress(4));
+    REQUIRE(constant.GetLiteralAddress() % 8 == 0);
+    REQUIRE(buffer.GetSizeInBytes() == 4 + 20);
+
+    REQUIRE(ReadWord(constant.GetAddress()) == 0x00000517);     // AUIPC a0, 0
+    REQUIRE(ReadWord(constant.GetAddress() + 4) == 0x00C53503); // LD a0, 12(a0)
+    REQUIRE(ReadWord(constant.GetAddress() + 8) == 0x00C0006F); // J +12
+    REQUIRE(constant.GetValue() == 0x1234'5678'9ABC'DEF0);
+
+    Repatch(constant, 42);
+    REQUIRE(constant.GetValue() == 42);
+    REQUIRE(ReadDoubleword(constant.GetLiteralAddress()) == 42);
+}
+
+TEST_CASE("EmitPatchableCall calls repatchable destinations", "[patchable]") {
+    Assembler as;
+    auto& buffer = as.GetCodeBuffer();
+
+    const auto call = as.EmitPatchableCall(far_address);
+    REQUIRE(call.GetAddress() == buffer.GetOffsetAddress(0));
+    REQUIRE(buffer.GetSizeInBytes() == 24);
+
+    REQUIRE(ReadWord(call.GetAddress()) == 0x00000317);      // AUIPC t1, 0
+    REQUIRE(ReadWord(call.GetAddress() + 4) == 0x01033303);  // LD t1, 16(t1)
+    REQUIRE(ReadWord(call.GetAddress() + 8) == 0x000300E7);  // JALR ra, 0(t1)
+    REQUIRE(ReadWord(call.GetAddress() + 12) == 0x00C0006F); // J +12
+    REQUIRE(call.GetTarget() == far_address);
+
+    const auto target = buffer.GetCursorAddress();
+    Repatch(call, target);
+    REQUIRE(call.GetTarget() == target);
+    REQUIRE(ReadDoubleword(call.GetLiteralAddress()) == target);
+}
@@ -0,0 +1,145 @@
+#include <catch/catch.hpp>
+
+#include <functional>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/peephole.hpp>
+
+using namespace biscuit;
+
+namespace {
+std::vector<uint8_t> GetCode(Assembler& as) {
+    const auto& buffer = as.GetCodeBuffer();
+    const auto* const begin = buffer.GetOffsetPointer(0);
+    return {begin, begin + buffer.GetSizeInBytes()};
+}
+
+// Records code, runs a peephole pass over it, and retrieves the result.
+std::vector<uint8_t> Optimize(const Peephole& peephole, size_t expected_rewrites,
+                              const std::function<void(Assembler&)>& emit) {
+    Assembler as;
+    as.BeginRecording();
+    emit(as);
+
+    auto stream = as.EndRecording();
+    REQUIRE(peephole.Run(stream) == expected_rewrites);
+
+    as.EmitIR(stream);
+    return GetCode(as);
+}
+
+std::vector<uint8_t> Assemble(const std::function<void(Assembler&)>& emit) {
+    Assembler as;
+    emit(as);
+    return GetCode(as);
+}
+} // Anonymous namespace
+
+TEST_CASE("Peephole removes redundant moves", "[peephole]") {
+    const Peephole peephole;
+
+    const auto code = Optimize(peephole, 3, [](Assembler& as) {
+        as.MV(a0, a0);
+        as.ADDI(a1, a1, 0);
+        as.NOP();
+        as.ADD(a2, zero, a2);
+        as.ADD(a3, a3, a3);
+        as.RET();
+    });
+
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.NOP();
+        as.ADD(a3, a3, a3);
+        as.RET();
+    }));
+}
+
+TEST_CASE("Peephole folds immediates into additions", "[peephole]") {
+    const Peephole peephole;
+
+    SECTION("Temporary overwritten afterwards") {
+        const auto code = Optimize(peephole, 1, [](Assembler& as) {
+            as.LI(t0, 100);
+            as.ADD(a0, a1, t0);
+            as.LI(t0, 1);
+            as.RET();
+        });
+
+        REQUIRE(code == Assemble([](Assembler& as) {
+            as.ADDI(a0, a1, 100);
+            as.LI(t0, 1);
+            as.RET();
+        }));
+    }
+
+    SECTION("Temporary is the destination") {
+        const auto code = Optimize(peephole, 1, [](Assembler& as) {
+            as.LI(a0, -8);
+            as.ADD(a0, a0, a1);
+        });
+
+        REQUIRE(code == Assemble([](Assembler& as) {
+            as.ADDI(a0, a1, -8);
+        }));
+    }
+
+    SECTION("Temporary live afterwards") {
+        const auto source = [](Assembler& as) {
+            as.LI(t0, 100);
+            as.ADD(a0, a1, t0);
+            as.ADD(a2, a2, t0);
+        };
+        REQUIRE(Optimize(peephole, 0, source) == Assemble(source));
+    }
+}
+
+TEST_CASE("Peephole uses Zba", "[peephole]") {
+    const Peephole peephole{{RISCVExtension::Zba}};
+
+    const auto code = Optimize(peephole, 2, [](Assembler& as) {
+        as.SLLI(t0, a1, 3);
+        as.ADD(a0, a0, t0);
+        as.SLLI(a2, a3, 32);
+        as.SRLI(a2, a2, 32);
+        as.MV(t0, zero);
+    });
+
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.SH3ADD(a0, a1, a0);
+        as.ZEXTW(a2, a3);
+        as.MV(t0, zero);
+    }));
+
+    // Without Zba, nothing changes.
+    const auto source = [](Assembler& as) {
+        as.SLLI(t0, a1, 3);
+        as.ADD(a0, a0, t0);
+        as.MV(t0, zero);
+    };
+    REQUIRE(Optimize(Peephole{}, 0, source) == Assemble(source));
+}
+
+TEST_CASE("Peephole turns branches over zeroing moves into CZERO", "[peephole]") {
+    const Peephole peephole{{RISCVExtension::Zicond}};
+
+    // Labels have to outlive the recording.
+    Label skip1;
+    Label skip2;
+
+    const auto code = Optimize(peephole, 2, [&](Assembler& as) {
+        as.BNEZ(a1, &skip1);
+        as.LI(a0, 0);
+        as.Bind(&skip1);
+        as.BEQZ(a2, &skip2);
+        as.MV(a3, zero);
+        as.Bind(&skip2);
+        as.RET();
+    });
+
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.CZERO_EQZ(a0, a0, a1);
+        as.CZERO_NEZ(a3, a3, a2);
+        as.RET();
+    }));
+}
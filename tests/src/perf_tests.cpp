@@ -0,0 +1,173 @@
+#include <catch/catch.hpp>
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/perf.hpp>
+
+using namespace biscuit;
+
+namespace {
+class RecordingListener final : public CodeListener {
+public:
+    void OnFunctionFinalized(const FinalizedFunction& function) override {
+        names.emplace_back(function.name);
+        functions.push_back(function);
+    }
+
+    std::vector<std::string> names;
+    std::vector<FinalizedFunction> functions;
+};
+
+// Creates a fresh directory for a test to write files into,
+// which is removed when the test finishes.
+class ScopedDirectory {
+public:
+    explicit ScopedDirectory(std::string_view name)
+        : m_path{std::filesystem::temp_directory_path() / name} {
+        std::filesystem::remove_all(m_path);
+        std::filesystem::create_directories(m_path);
+    }
+
+    ~ScopedDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(m_path, ec);
+    }
+
+    [[nodiscard]] std::string GetPath() const {
+        return m_path.string();
+    }
+
+private:
+    std::filesystem::path m_path;
+};
+
+std::vector<uint8_t> ReadFile(const std::string& path) {
+    std::ifstream file{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+template <typename T>
+T ReadAt(const std::vector<uint8_t>& data, size_t offset) {
+    REQUIRE(offset + sizeof(T) <= data.size());
+
+    T value{};
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+} // Anonymous namespace
+
+TEST_CASE("FinalizeFunction notifies code listeners", "[perf]") {
+    std::array<uint8_t, 32> code{};
+    Assembler as(code.data(), code.size());
+
+    RecordingListener first;
+    RecordingListener second;
+    as.AddCodeListener(&first);
+    as.AddCodeListener(&second);
+
+    as.ADDI(a0, a0, 1);
+    const auto start = as.GetCodeBuffer().GetCursorOffset();
+    as.ADD(a0, a0, a1);
+    as.RET();
+    as.FinalizeFunction("add", start);
+
+    as.RemoveCodeListener(&second);
+    as.FinalizeFunction("empty", as.GetCodeBuffer().GetCursorOffset());
+
+    REQUIRE(first.names == std::vector<std::string>{"add", "empty"});
+    REQUIRE(first.functions[0].code == code.data() + 4);
+    REQUIRE(first.functions[0].size == 8);
+    REQUIRE(first.functions[1].code == code.data() + 12);
+    REQUIRE(first.functions[1].size == 0);
+
+    REQUIRE(second.names == std::vector<std::string>{"add"});
+}
+
+#if defined(__linux__)
+TEST_CASE("PerfSink writes perf maps", "[perf]") {
+    const ScopedDirectory directory{"biscuit_perf_map_test"};
+
+    std::array<uint8_t, 32> code{};
+    Assembler as(code.data(), code.size());
+
+    std::string path;
+    {
+        PerfSink sink{PerfFormat::PerfMap, directory.GetPath()};
+        REQUIRE(sink.IsEnabled(PerfFormat::PerfMap));
+        REQUIRE(!sink.IsEnabled(PerfFormat::JitDump));
+        path = sink.GetPerfMapPath();
+
+        as.AddCodeListener(&sink);
+        as.ADD(a0, a0, a1);
+        as.RET();
+        as.FinalizeFunction("add", 0);
+        as.RemoveCodeListener(&sink);
+
+        sink.RecordFunction("other", reinterpret_cast<const void*>(uintptr_t{0x1000}), 0x24);
+    }
+
+    REQUIRE(path.starts_with(directory.GetPath() + "/perf-"));
+    REQUIRE(path.ends_with(".map"));
+
+    const auto contents = ReadFile(path);
+    const std::string text(contents.begin(), contents.end());
+
+    char address[32]{};
+    std::snprintf(address, sizeof(address), "%jx", static_cast<uintmax_t>(reinterpret_cast<uintptr_t>(code.data())));
+    REQUIRE(text == std::string{address} + " 8 add\n1000 24 other\n");
+}
+
+TEST_CASE("PerfSink writes jitdump files", "[perf]") {
+    const ScopedDirectory directory{"biscuit_jitdump_test"};
+
+    std::array<uint8_t, 32> code{};
+    Assembler as(code.data(), code.size());
+
+    std::string path;
+    {
+        PerfSink sink{PerfFormat::JitDump, directory.GetPath()};
+        REQUIRE(sink.IsEnabled(PerfFormat::JitDump));
+        REQUIRE(!sink.IsEnabled(PerfFormat::PerfMap));
+        path = sink.GetJitDumpPath();
+
+        as.AddCodeListener(&sink);
+        as.ADD(a0, a0, a1);
+        as.RET();
+        as.FinalizeFunction("add", 0);
+        as.RemoveCodeListener(&sink);
+    }
+
+    const auto data = ReadFile(path);
+
+    // Header
+    REQUIRE(ReadAt<uint32_t>(data, 0) == 0x4A695444);
+    REQUIRE(ReadAt<uint32_t>(data, 4) == 1);
+    REQUIRE(ReadAt<uint32_t>(data, 8) == 40);
+    REQUIRE(ReadAt<uint32_t>(data, 12) == 243);
+
+    // Code load record
+    constexpr size_t record = 40;
+    const auto record_size = ReadAt<uint32_t>(data, record + 4);
+    REQUIRE(ReadAt<uint32_t>(data, record) == 0);
+    REQUIRE(record_size == 56 + 4 + 8);
+    REQUIRE(ReadAt<uint64_t>(data, record + 24) == reinterpret_cast<uintptr_t>(code.data()));
+    REQUIRE(ReadAt<uint64_t>(data, record + 40) == 8);
+    REQUIRE(ReadAt<uint64_t>(data, record + 48) == 0);
+    REQUIRE(std::memcmp(data.data() + record + 56, "add", 4) == 0);
+    REQUIRE(std::memcmp(data.data() + record + 60, code.data(), 8) == 0);
+
+    // Close record
+    const size_t close = record + record_size;
+    REQUIRE(ReadAt<uint32_t>(data, close) == 3);
+    REQUIRE(ReadAt<uint32_t>(data, close + 4) == 16);
+    REQUIRE(data.size() == close + 16);
+}
+#endif
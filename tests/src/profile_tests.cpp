@@ -0,0 +1,114 @@
+#include <catch/catch.hpp>
+
+#include <biscuit/profile.hpp>
+
+using namespace biscuit;
+
+TEST_CASE("Parse basic ISA strings", "[profile]") {
+    const auto profile = Profile::Parse("rv64imafdcv_zba_zbb_zbs_zicond");
+    REQUIRE(profile.has_value());
+    REQUIRE(profile->GetArchFeature() == ArchFeature::RV64);
+
+    for (const auto ext : {RISCVExtension::I, RISCVExtension::M, RISCVExtension::A,
+                           RISCVExtension::F, RISCVExtension::D, RISCVExtension::C,
+                           RISCVExtension::V, RISCVExtension::Zba, RISCVExtension::Zbb,
+                           RISCVExtension::Zbs, RISCVExtension::Zicond}) {
+        REQUIRE(profile->Has(ext));
+    }
+    REQUIRE(!profile->Has(RISCVExtension::Zfh));
+
+    const auto rv32 = Profile::Parse("RV32IMC");
+    REQUIRE(rv32.has_value());
+    REQUIRE(rv32->GetArchFeature() == ArchFeature::RV32);
+    REQUIRE(rv32->Has(RISCVExtension::C));
+    REQUIRE(!rv32->Has(RISCVExtension::A));
+}
+
+TEST_CASE("Parse expands shorthands and implied extensions", "[profile]") {
+    const auto profile = Profile::Parse("rv64gcv").value();
+
+    REQUIRE(profile.Has(RISCVExtension::Zaamo));
+    REQUIRE(profile.Has(RISCVExtension::Zalrsc));
+    REQUIRE(profile.Has(RISCVExtension::Zca));
+    REQUIRE(profile.Has(RISCVExtension::Zcd));
+    REQUIRE(!profile.Has(RISCVExtension::Zcf));
+    REQUIRE(profile.Has(RISCVExtension::Zve64d));
+    REQUIRE(profile.Has(RISCVExtension::Zve32x));
+
+    const auto bitmanip = Profile::Parse("rv64ib").value();
+    REQUIRE(bitmanip.Has(RISCVExtension::Zba));
+    REQUIRE(bitmanip.Has(RISCVExtension::Zbb));
+    REQUIRE(bitmanip.Has(RISCVExtension::Zbs));
+
+    const auto crypto = Profile::Parse("rv64i_zvkn").value();
+    REQUIRE(crypto.Has(RISCVExtension::Zvkned));
+    REQUIRE(crypto.Has(RISCVExtension::Zvknhb));
+    REQUIRE(crypto.Has(RISCVExtension::Zvkb));
+    REQUIRE(crypto.Has(RISCVExtension::Zvkt));
+}
+
+TEST_CASE("Parse ignores versions and untracked extensions", "[profile]") {
+    const auto versioned = Profile::Parse("rv64i2p1_m2p0_a2p1_zicsr2p0_zifencei2p0_zba1p0_zve32x1p0");
+    const auto unversioned = Profile::Parse("rv64ima_zba_zve32x");
+    REQUIRE(versioned.has_value());
+    REQUIRE(versioned == unversioned);
+
+    const auto untracked = Profile::Parse("rv64imac_zicsr_zifencei_zic64b_zvl256b_xtheadba");
+    REQUIRE(untracked == Profile::Parse("rv64imac"));
+
+    // Any vendor extension is accepted, whether or not it's known.
+    const auto vendor = Profile::Parse("rv64imac_xtheadcondmov_xfoo1p0_xventanacondops");
+    REQUIRE(vendor == Profile::Parse("rv64imac"));
+}
+
+TEST_CASE("Parse rejects malformed ISA strings", "[profile]") {
+    REQUIRE(!Profile::Parse("").has_value());
+    REQUIRE(!Profile::Parse("rv64").has_value());
+    REQUIRE(!Profile::Parse("rv16i").has_value());
+    REQUIRE(!Profile::Parse("rv64mafd").has_value());
+    REQUIRE(!Profile::Parse("rv64i_zfoo").has_value());
+    REQUIRE(!Profile::Parse("rv64i__zba").has_value());
+    REQUIRE(!Profile::Parse("rv64iy").has_value());
+}
+
+TEST_CASE("Canonical strings", "[profile]") {
+    REQUIRE(Profile::Parse("rv64gc")->ToString() ==
+            "rv64imafdc_zaamo_zalrsc_zca_zcd");
+    REQUIRE(Profile::Parse("rv64i_zbb_zicond_zba_zfh_supm")->ToString() ==
+            "rv64if_zicond_zfh_zfhmin_zba_zbb_supm");
+
+    // Equivalent spellings result in the same canonical string.
+    const auto lhs = Profile::Parse("rv64imafdc_zve64d");
+    const auto rhs = Profile::Parse("RV64IMFADC_ZVE64F_ZVE64D_ZCA");
+    REQUIRE(lhs == rhs);
+    REQUIRE(lhs->ToString() == rhs->ToString());
+
+    // Canonical strings round-trip.
+    const auto rva23 = Profile::RVA23U64();
+    REQUIRE(Profile::Parse(rva23.ToString()) == rva23);
+}
+
+TEST_CASE("Profile presets", "[profile]") {
+    const auto rva20 = Profile::RVA20U64();
+    const auto rva22 = Profile::RVA22U64();
+    const auto rva23 = Profile::RVA23U64();
+
+    REQUIRE(rva20.IsSupportedBy(rva22));
+    REQUIRE(rva22.IsSupportedBy(rva23));
+    REQUIRE(!rva23.IsSupportedBy(rva22));
+    REQUIRE(!rva22.IsSupportedBy(rva20));
+
+    REQUIRE(rva22.Has(RISCVExtension::Zba));
+    REQUIRE(rva23.Has(RISCVExtension::V));
+    REQUIRE(rva23.Has(RISCVExtension::Zicond));
+
+    REQUIRE(Profile::Parse("rva22u64") == rva22);
+    REQUIRE(Profile::Parse("RVA23U64") == rva23);
+
+    const auto host = Profile::Parse("rv64gcv_zba_zbb_zbs_zicboz_zicbom_zfhmin_zkt_zihintpause_zicntr_zihpm");
+    REQUIRE(rva22.IsSupportedBy(*host));
+    REQUIRE(!rva23.IsSupportedBy(*host));
+
+    // Differing base widths are never compatible.
+    REQUIRE(!Profile::Parse("rv32imac")->IsSupportedBy(*Profile::Parse("rv64imac")));
+}
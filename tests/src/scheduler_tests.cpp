@@ -0,0 +1,131 @@
+#include <catch/catch.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/scheduler.hpp>
+
+using namespace biscuit;
+
+namespace {
+IRStream Record(const std::function<void(Assembler&)>& emit) {
+    Assembler as;
+    as.BeginRecording();
+    emit(as);
+    return as.EndRecording();
+}
+
+std::vector<Opcode> GetOpcodes(const IRStream& stream) {
+    std::vector<Opcode> opcodes;
+    for (const auto& node : stream.GetNodes()) {
+        if (node.kind == IRNodeKind::Instruction) {
+            opcodes.push_back(node.instruction.opcode);
+        }
+    }
+    return opcodes;
+}
+} // Anonymous namespace
+
+TEST_CASE("Instructions are classified", "[scheduler]") {
+    const auto stream = Record([](Assembler& as) {
+        as.ADD(a0, a1, a2);
+        as.MUL(a0, a1, a2);
+        as.DIVU(a0, a1, a2);
+        as.LD(a0, 0, a1);
+        as.FSD(f0, 8, sp);
+        as.FMADD_D(f0, f1, f2, f3);
+        as.CSRRW(a0, CSR::FCSR, a1);
+    });
+
+    const auto& nodes = stream.GetNodes();
+    REQUIRE(GetInstructionClass(nodes[0].instruction) == InstructionClass::IntAlu);
+    REQUIRE(GetInstructionClass(nodes[1].instruction) == InstructionClass::IntMul);
+    REQUIRE(GetInstructionClass(nodes[2].instruction) == InstructionClass::IntDiv);
+    REQUIRE(GetInstructionClass(nodes[3].instruction) == InstructionClass::Load);
+    REQUIRE(GetInstructionClass(nodes[4].instruction) == InstructionClass::Store);
+    REQUIRE(GetInstructionClass(nodes[5].instruction) == InstructionClass::FpMul);
+    REQUIRE(GetInstructionClass(nodes[6].instruction) == InstructionClass::Other);
+}
+
+TEST_CASE("Scheduler hides load latency", "[scheduler]") {
+    const auto model = MachineModel::TheadC906();
+
+    auto stream = Record([](Assembler& as) {
+        as.LD(a0, 0, a1);
+        as.ADDI(a0, a0, 1);
+        as.LD(a2, 0, a3);
+        as.ADDI(a2, a2, 1);
+    });
+
+    const auto before = EstimateCycles(stream, model);
+    REQUIRE(before == 8);
+
+    REQUIRE(Scheduler{model}.Run(stream) == 1);
+    REQUIRE(GetOpcodes(stream) == std::vector{Opcode::LD, Opcode::LD, Opcode::ADDI, Opcode::ADDI});
+    REQUIRE(EstimateCycles(stream, model) == 5);
+
+    // Scheduling again doesn't change anything.
+    REQUIRE(Scheduler{model}.Run(stream) == 0);
+}
+
+TEST_CASE("Scheduler respects memory and block boundaries", "[scheduler]") {
+    const auto model = MachineModel::SiFiveU74();
+
+    SECTION("Loads stay after stores") {
+        auto stream = Record([](Assembler& as) {
+            as.ADDI(a0, a0, 1);
+            as.ADDI(a0, a0, 1);
+            as.ADDI(a0, a0, 1);
+            as.SD(a4, 0, a5);
+            as.LD(a2, 0, a3);
+            as.ADDI(a2, a2, 1);
+        });
+
+        static_cast<void>(Scheduler{model}.Run(stream));
+
+        const auto opcodes = GetOpcodes(stream);
+        const auto store = std::find(opcodes.begin(), opcodes.end(), Opcode::SD);
+        const auto load = std::find(opcodes.begin(), opcodes.end(), Opcode::LD);
+        REQUIRE(store < load);
+    }
+
+    SECTION("Instructions aren't moved across labels") {
+        Label label;
+
+        auto stream = Record([&](Assembler& as) {
+            as.LD(a0, 0, a1);
+            as.ADDI(a0, a0, 1);
+            as.Bind(&label);
+            as.LD(a2, 0, a3);
+            as.ADDI(a2, a2, 1);
+            as.J(&label);
+        });
+
+        REQUIRE(Scheduler{model}.Run(stream) == 0);
+        REQUIRE(GetOpcodes(stream) ==
+                std::vector{Opcode::LD, Opcode::ADDI, Opcode::LD, Opcode::ADDI, Opcode::JAL});
+    }
+}
+
+TEST_CASE("Scheduler keeps fused pairs together", "[scheduler]") {
+    auto model = MachineModel::SiFiveU74();
+    model.fusion = FusionProfile::LuiAddi;
+
+    auto stream = Record([](Assembler& as) {
+        as.LD(a0, 0, a1);
+        as.ADD(a0, a0, a2);
+        as.LUI(t0, 0x12345);
+        as.ADDI(t0, t0, 0x678);
+        as.LD(a3, 0, a4);
+        as.ADD(a3, a3, t0);
+    });
+
+    REQUIRE(Scheduler{model}.Run(stream) == 1);
+
+    const auto opcodes = GetOpcodes(stream);
+    const auto lui = std::find(opcodes.begin(), opcodes.end(), Opcode::LUI);
+    REQUIRE(lui != opcodes.end());
+    REQUIRE(*(lui + 1) == Opcode::ADDI);
+}
@@ -0,0 +1,108 @@
+#include <catch/catch.hpp>
+
+#include <functional>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/strip_mine.hpp>
+
+using namespace biscuit;
+
+namespace {
+std::vector<uint8_t> Assemble(const std::function<void(Assembler&)>& emit) {
+    std::vector<uint8_t> code(256);
+    Assembler as(code.data(), code.size());
+    emit(as);
+    code.resize(static_cast<size_t>(as.GetCodeBuffer().GetSizeInBytes()));
+    return code;
+}
+} // Anonymous namespace
+
+TEST_CASE("Strip-mined loops", "[strip_mine]") {
+    const auto code = Assemble([](Assembler& as) {
+        StripMineLoop loop{as, SEW::E32, LMUL::M4};
+        loop.AddPointer(a0);
+        loop.AddPointer(a1);
+        loop.AddPointer(a2, 1);
+        loop.Emit(a3, t0, t1, [](Assembler& as, const StripMineStrip& strip) {
+            REQUIRE(strip.unroll_index == 0);
+            REQUIRE(strip.GetGroup(0) == v4);
+            REQUIRE(strip.GetGroup(1) == v8);
+            as.VLE32(v4, a0);
+            as.VSE32(v4, a1);
+        });
+    });
+
+    // Pointers with the same element size share the shifted length.
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.BEQZ(a3, 40);
+        as.VSETVLI(t0, a3, SEW::E32, LMUL::M4, VTA::Yes, VMA::Yes);
+        as.VLE32(v4, a0);
+        as.VSE32(v4, a1);
+        as.SUB(a3, a3, t0);
+        as.SLLI(t1, t0, 2);
+        as.ADD(a0, a0, t1);
+        as.ADD(a1, a1, t1);
+        as.ADD(a2, a2, t0);
+        as.BNEZ(a3, -32);
+    }));
+}
+
+TEST_CASE("Strip-mined loops use Zba to advance pointers", "[strip_mine]") {
+    const auto code = Assemble([](Assembler& as) {
+        StripMineLoop loop{as, SEW::E16, LMUL::M1, {RISCVExtension::Zba}};
+        loop.SetPolicy(VTA::No, VMA::Yes);
+        loop.AddPointer(a0);
+        loop.AddPointer(a1, 8);
+        loop.AddPointer(a2, 16);
+        loop.Emit(a3, t0, t1, [](Assembler&, const StripMineStrip&) {});
+    });
+
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.BEQZ(a3, 32);
+        as.VSETVLI(t0, a3, SEW::E16, LMUL::M1, VTA::No, VMA::Yes);
+        as.SUB(a3, a3, t0);
+        as.SH1ADD(a0, t0, a0);
+        as.SH3ADD(a1, t0, a1);
+        as.SLLI(t1, t0, 4);
+        as.ADD(a2, a2, t1);
+        as.BNEZ(a3, -24);
+    }));
+}
+
+TEST_CASE("Unrolled strip-mined loops", "[strip_mine]") {
+    std::vector<Vec> groups;
+
+    const auto code = Assemble([&](Assembler& as) {
+        StripMineLoop loop{as, SEW::E8, LMUL::M2};
+        loop.SetUnroll(3, 2);
+        loop.AddPointer(a0);
+        loop.Emit(a1, t0, t1, [&](Assembler& as, const StripMineStrip& strip) {
+            groups.push_back(strip.GetGroup(0));
+            groups.push_back(strip.GetGroup(1));
+            as.VLE8(strip.GetGroup(0), a0);
+        });
+    });
+
+    // Each copy of the body gets its own groups, starting after v0.
+    REQUIRE(groups == std::vector<Vec>{v2, v4, v6, v8, v10, v12});
+
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.BEQZ(a1, 64);
+        as.VSETVLI(t0, a1, SEW::E8, LMUL::M2, VTA::Yes, VMA::Yes);
+        as.VLE8(v2, a0);
+        as.SUB(a1, a1, t0);
+        as.ADD(a0, a0, t0);
+        as.BEQZ(a1, 44);
+        as.VSETVLI(t0, a1, SEW::E8, LMUL::M2, VTA::Yes, VMA::Yes);
+        as.VLE8(v6, a0);
+        as.SUB(a1, a1, t0);
+        as.ADD(a0, a0, t0);
+        as.BEQZ(a1, 24);
+        as.VSETVLI(t0, a1, SEW::E8, LMUL::M2, VTA::Yes, VMA::Yes);
+        as.VLE8(v10, a0);
+        as.SUB(a1, a1, t0);
+        as.ADD(a0, a0, t0);
+        as.BNEZ(a1, -56);
+    }));
+}
@@ -0,0 +1,132 @@
+#include <catch/catch.hpp>
+
+#include <array>
+#include <cstring>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/switch.hpp>
+
+using namespace biscuit;
+
+namespace {
+int32_t ReadEntry(Assembler& as, ptrdiff_t offset) {
+    int32_t entry = 0;
+    std::memcpy(&entry, as.GetCodeBuffer().GetOffsetPointer(offset), sizeof(entry));
+    return entry;
+}
+
+bool ContainsWord(Assembler& as, uint32_t word, uint32_t mask = 0xFFFFFFFF) {
+    const auto size = static_cast<ptrdiff_t>(as.GetCodeBuffer().GetSizeInBytes());
+    for (ptrdiff_t offset = 0; offset + 4 <= size; offset += 2) {
+        uint32_t candidate = 0;
+        std::memcpy(&candidate, as.GetCodeBuffer().GetOffsetPointer(offset), sizeof(candidate));
+        if ((candidate & mask) == word) {
+            return true;
+        }
+    }
+    return false;
+}
+} // Anonymous namespace
+
+TEST_CASE("Switch lowers dense cases to a jump table", "[switch]") {
+    Assembler as;
+    Switch dispatch{as, {RISCVExtension::Zba}};
+
+    std::array<Label, 3> handlers;
+    Label fallback;
+
+    // 5 of the 6 values in [10, 15], with 13 missing.
+    dispatch.AddCase(10, &handlers[0]);
+    dispatch.AddCase(11, &handlers[1]);
+    dispatch.AddCase(12, &handlers[2]);
+    dispatch.AddCase(14, &handlers[0]);
+    dispatch.AddCase(15, &handlers[1]);
+    dispatch.Emit(a0, &fallback, t0, t1);
+
+    const auto& clusters = dispatch.GetClusters();
+    REQUIRE(clusters.size() == 1);
+    REQUIRE(clusters[0].kind == SwitchClusterKind::JumpTable);
+    REQUIRE(clusters[0].low == 10);
+    REQUIRE(clusters[0].high == 15);
+
+    REQUIRE(ContainsWord(as, 0x2062C2B3)); // SH2ADD t0, t0, t1
+    REQUIRE(dispatch.HasPendingEntries());
+
+    // The table is last, with an entry for every value in the range.
+    const auto table = static_cast<ptrdiff_t>(as.GetCodeBuffer().GetSizeInBytes()) - 6 * 4;
+
+    for (auto& handler : handlers) {
+        as.Bind(&handler);
+        as.NOP();
+    }
+    as.Bind(&fallback);
+    dispatch.Resolve();
+    REQUIRE(!dispatch.HasPendingEntries());
+
+    const auto entry = [&](ptrdiff_t index) {
+        return table + ReadEntry(as, table + index * 4);
+    };
+    REQUIRE(entry(0) == *handlers[0].GetLocation());
+    REQUIRE(entry(1) == *handlers[1].GetLocation());
+    REQUIRE(entry(2) == *handlers[2].GetLocation());
+    REQUIRE(entry(3) == *fallback.GetLocation());
+    REQUIRE(entry(4) == *handlers[0].GetLocation());
+    REQUIRE(entry(5) == *handlers[1].GetLocation());
+}
+
+TEST_CASE("Switch lowers small ranges with few destinations to bit tests", "[switch]") {
+    Assembler as;
+    Switch dispatch{as};
+
+    Label whitespace;
+    Label digit;
+    Label fallback;
+
+    // Too sparse for a jump table, but within 64 values.
+    for (const int64_t c : {' ', '\t', '\n', '\r'}) {
+        dispatch.AddCase(c, &whitespace);
+    }
+    dispatch.AddCase('0', &digit);
+    dispatch.AddCase('1', &digit);
+    dispatch.Emit(a0, &fallback, t0, t1);
+
+    const auto& clusters = dispatch.GetClusters();
+    REQUIRE(clusters.size() == 1);
+    REQUIRE(clusters[0].kind == SwitchClusterKind::BitTest);
+    REQUIRE(clusters[0].low == '\t');
+    REQUIRE(clusters[0].high == '1');
+    REQUIRE(!dispatch.HasPendingEntries());
+
+    as.Bind(&whitespace);
+    as.Bind(&digit);
+    as.Bind(&fallback);
+}
+
+TEST_CASE("Switch searches sparse cases with compares", "[switch]") {
+    Assembler as;
+    Switch dispatch{as};
+
+    std::array<Label, 6> handlers;
+    Label fallback;
+
+    const std::array<int64_t, 6> values{-1'000'000, -5, 0, 1000, 1'000'000, 1'000'000'000};
+    for (size_t i = 0; i < values.size(); i++) {
+        dispatch.AddCase(values[i], &handlers[i]);
+    }
+    dispatch.Emit(a0, &fallback, t0, t1);
+
+    const auto& clusters = dispatch.GetClusters();
+    REQUIRE(clusters.size() == values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        REQUIRE(clusters[i].kind == SwitchClusterKind::Compare);
+        REQUIRE(clusters[i].low == values[i]);
+    }
+
+    // The search tree starts by splitting at the middle cluster.
+    REQUIRE(ContainsWord(as, 0x00554063, 0x01FFF07F)); // BLT a0, t0, ...
+
+    for (auto& handler : handlers) {
+        as.Bind(&handler);
+    }
+    as.Bind(&fallback);
+}
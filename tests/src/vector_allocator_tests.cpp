@@ -0,0 +1,115 @@
+#include <catch/catch.hpp>
+
+#include <biscuit/vector_allocator.hpp>
+
+using namespace biscuit;
+
+TEST_CASE("Register groups are aligned", "[vector_allocator]") {
+    VectorRegisterAllocator allocator;
+
+    // v0 is skipped, so single registers start at v1 and groups at their own size.
+    REQUIRE(allocator.Allocate(LMUL::M1) == v1);
+    REQUIRE(allocator.Allocate(LMUL::MF2) == v2);
+    REQUIRE(allocator.Allocate(LMUL::M2) == v4);
+    REQUIRE(allocator.Allocate(LMUL::M4) == v8);
+    REQUIRE(allocator.Allocate(LMUL::M1) == v3);
+    REQUIRE(allocator.Allocate(LMUL::M8) == v16);
+    REQUIRE(allocator.Allocate(LMUL::M8) == v24);
+    REQUIRE_FALSE(allocator.TryAllocate(LMUL::M8).has_value());
+    REQUIRE(allocator.GetFreeCount() == 7);
+
+    REQUIRE(allocator.IsLive(v20));
+    allocator.Free(v16);
+    REQUIRE_FALSE(allocator.IsLive(v20));
+    REQUIRE(allocator.Allocate(LMUL::M4) == v12);
+    REQUIRE(allocator.Allocate(LMUL::M4) == v16);
+
+    // v0 is only handed out as a mask.
+    REQUIRE_FALSE(allocator.IsLive(v0));
+    REQUIRE(allocator.AllocateMask() == v0);
+    REQUIRE(allocator.IsLive(v0));
+}
+
+TEST_CASE("Scopes free their register groups", "[vector_allocator]") {
+    VectorRegisterAllocator allocator;
+    const auto outer = allocator.Allocate(LMUL::M2);
+
+    {
+        VectorRegisterAllocator::Scope scope{allocator};
+        REQUIRE(allocator.Allocate(LMUL::M8) == v8);
+
+        {
+            VectorRegisterAllocator::Scope inner_scope{allocator};
+            REQUIRE(allocator.Allocate(LMUL::M8) == v16);
+            const auto freed = allocator.Allocate(LMUL::M1);
+            allocator.Free(freed);
+        }
+
+        REQUIRE_FALSE(allocator.IsLive(v16));
+        REQUIRE(allocator.IsLive(v8));
+    }
+
+    REQUIRE_FALSE(allocator.IsLive(v8));
+    REQUIRE(allocator.IsLive(outer));
+    REQUIRE(allocator.GetFreeCount() == 30);
+}
+
+TEST_CASE("Vector operand legality", "[vector_allocator]") {
+    SECTION("Alignment") {
+        REQUIRE(AreVectorOperandsLegal(VectorShape::SingleWidth, LMUL::M4, v4, v8, v12));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::SingleWidth, LMUL::M4, v4, v8, v10));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::SingleWidth, LMUL::M2, v3, v4));
+        REQUIRE(AreVectorOperandsLegal(VectorShape::SingleWidth, LMUL::MF2, v3, v5, v7));
+
+        // Widening with LMUL=8 would need groups of 16 registers.
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::Widening, LMUL::M8, v0, v8, v16));
+    }
+
+    SECTION("Widening") {
+        REQUIRE(AreVectorOperandsLegal(VectorShape::Widening, LMUL::M1, v2, v4, v5));
+        REQUIRE(AreVectorOperandsLegal(VectorShape::Widening, LMUL::M1, v2, v3, v4));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::Widening, LMUL::M1, v2, v2, v4));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::Widening, LMUL::M1, v2, v4, v2));
+        REQUIRE(AreVectorOperandsLegal(VectorShape::Widening, LMUL::M4, v8, v12, v16));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::Widening, LMUL::M4, v8, v8, v16));
+
+        // Fractional sources can't overlap at all.
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::Widening, LMUL::MF2, v2, v2, v4));
+
+        REQUIRE(AreVectorOperandsLegal(VectorShape::WideningWide, LMUL::M2, v4, v4, v10));
+        REQUIRE(AreVectorOperandsLegal(VectorShape::WideningWide, LMUL::M2, v4, v8, v6));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::WideningWide, LMUL::M2, v4, v8, v4));
+
+        // A source can't be read with two different element widths.
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::WideningWide, LMUL::M2, v4, v8, v10));
+    }
+
+    SECTION("Narrowing") {
+        REQUIRE(AreVectorOperandsLegal(VectorShape::Narrowing, LMUL::M1, v2, v2));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::Narrowing, LMUL::M1, v3, v2));
+        REQUIRE(AreVectorOperandsLegal(VectorShape::Narrowing, LMUL::M4, v8, v16, v8));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::Narrowing, LMUL::M4, v12, v8));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::Narrowing, LMUL::M4, v4, v8, v12));
+    }
+
+    SECTION("Reductions") {
+        REQUIRE(AreVectorOperandsLegal(VectorShape::Reduction, LMUL::M8, v1, v8, v3));
+        REQUIRE(AreVectorOperandsLegal(VectorShape::Reduction, LMUL::M8, v8, v8, v9));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::Reduction, LMUL::M8, v1, v4, v3));
+
+        // The scalar source of widening reductions is read with a different element width.
+        REQUIRE(AreVectorOperandsLegal(VectorShape::Reduction, LMUL::M4, v1, v4, v5));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::WideningReduction, LMUL::M4, v1, v4, v5));
+        REQUIRE(AreVectorOperandsLegal(VectorShape::WideningReduction, LMUL::M4, v4, v4, v1));
+        REQUIRE(AreVectorOperandsLegal(VectorShape::WideningReduction, LMUL::M4, v0, v4, v1, VecMask::Yes));
+    }
+
+    SECTION("Masks") {
+        REQUIRE(AreVectorOperandsLegal(VectorShape::SingleWidth, LMUL::M1, v0, v1, v2));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::SingleWidth, LMUL::M1, v0, v1, v2, VecMask::Yes));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::SingleWidth, LMUL::M2, v2, v0, v4, VecMask::Yes));
+        REQUIRE(AreVectorOperandsLegal(VectorShape::SingleWidth, LMUL::M2, v2, v4, v6, VecMask::Yes));
+        REQUIRE(AreVectorOperandsLegal(VectorShape::Reduction, LMUL::M2, v0, v4, v1, VecMask::Yes));
+        REQUIRE_FALSE(AreVectorOperandsLegal(VectorShape::Reduction, LMUL::M2, v1, v4, v0, VecMask::Yes));
+    }
+}
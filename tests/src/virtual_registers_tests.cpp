@@ -0,0 +1,176 @@
+#include <catch/catch.hpp>
+
+#include <functional>
+#include <vector>
+
+#include <biscuit/assembler.hpp>
+#include <biscuit/virtual_registers.hpp>
+
+using namespace biscuit;
+
+namespace {
+std::vector<uint8_t> Assemble(const std::function<void(Assembler&)>& emit) {
+    std::vector<uint8_t> code(256);
+    Assembler as(code.data(), code.size());
+    emit(as);
+    code.resize(static_cast<size_t>(as.GetCodeBuffer().GetSizeInBytes()));
+    return code;
+}
+} // Anonymous namespace
+
+TEST_CASE("Virtual registers prefer caller-saved registers", "[virtual_registers]") {
+    VirtualCodeBuilder builder;
+    const auto sum = builder.NewGPR();
+    const auto value = builder.NewGPR();
+    const auto loop = builder.NewLabel();
+
+    builder.Reserve(a0);
+    builder.Reserve(a1);
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(sum), 0); });
+    builder.Bind(loop);
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LD(map.Def(value), 0, a0); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.ADD(map.Def(sum), map.Use(sum), map.Use(value)); });
+    builder.Add([](Assembler& as, RegisterMap&) { as.ADDI(a0, a0, 8); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.BNE(a0, a1, map.GetLabel(loop)); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.MV(a0, map.Use(sum)); });
+
+    const auto code = Assemble([&](Assembler& as) { builder.Emit(as); });
+
+    // The sum is referenced often enough to prefer a compressible register.
+    REQUIRE(builder.GetAssignment(sum) == a2);
+    REQUIRE(builder.GetAssignment(value) == t0);
+    REQUIRE(builder.GetSpillAreaSize() == 0);
+    REQUIRE(builder.GetUsedCalleeSavedGPRs().empty());
+
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.LI(a2, 0);
+        as.LD(t0, 0, a0);
+        as.ADD(a2, a2, t0);
+        as.ADDI(a0, a0, 8);
+        as.BNE(a0, a1, -12);
+        as.MV(a0, a2);
+    }));
+}
+
+TEST_CASE("Virtual registers stay live across loops", "[virtual_registers]") {
+    VirtualCodeBuilder builder;
+    const auto step = builder.NewGPR();
+    const auto temp = builder.NewGPR();
+    const auto loop = builder.NewLabel();
+
+    builder.Reserve(a0);
+    builder.Reserve(a1);
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(step), 7); });
+    builder.Bind(loop);
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.ADD(a0, a0, map.Use(step)); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(temp), 1); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.SUB(a1, a1, map.Use(temp)); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.BNEZ(a1, map.GetLabel(loop)); });
+    builder.Allocate();
+
+    // The step is read again on the next iteration, after temp is written.
+    REQUIRE(builder.GetAssignment(step) == t0);
+    REQUIRE(builder.GetAssignment(temp) == t1);
+}
+
+TEST_CASE("Virtual registers live across calls are callee-saved", "[virtual_registers]") {
+    VirtualCodeBuilder builder;
+    const auto kept = builder.NewGPR();
+    const auto result = builder.NewGPR();
+    const auto kept_fp = builder.NewFPR();
+
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(kept), 5); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.FMV_D_X(map.Def(kept_fp), map.Use(kept)); });
+    builder.AddCall([](Assembler& as, RegisterMap&) { as.ECALL(); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.ADDI(map.Def(result), map.Use(kept), 1); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.FMV_X_D(map.Def(result), map.Use(kept_fp)); });
+    builder.Allocate();
+
+    REQUIRE(builder.GetAssignment(kept) == s0);
+    REQUIRE(builder.GetAssignment(kept_fp) == fs2);
+    REQUIRE(builder.GetAssignment(result) == t0);
+    REQUIRE(builder.GetUsedCalleeSavedGPRs() == std::vector<GPR>{s0});
+    REQUIRE(builder.GetUsedCalleeSavedFPRs() == std::vector<FPR>{fs2});
+}
+
+TEST_CASE("Virtual registers are spilled", "[virtual_registers]") {
+    VirtualCodeBuilder builder;
+    const auto x = builder.NewGPR();
+    const auto y = builder.NewGPR();
+    const auto z = builder.NewGPR();
+
+    // Leave only a0 and a1 to allocate from.
+    for (const auto reg : {t0, t1, t2, t3, t4, a2, a3, a4, a5, a6, a7, s0, s1, s2, s3, s4, s5, s6, s7, s8, s9,
+                           s10, s11}) {
+        builder.Reserve(reg);
+    }
+    builder.SetSpillArea(sp, 16);
+
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(x), 1); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(y), 2); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(z), 3); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.ADD(map.Def(x), map.Use(x), map.Use(y)); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.ADD(map.Def(x), map.Use(x), map.Use(z)); });
+
+    const auto code = Assemble([&](Assembler& as) { builder.Emit(as); });
+
+    // x lives the longest, so it gives up its register to z.
+    REQUIRE_FALSE(builder.GetAssignment(x).has_value());
+    REQUIRE(builder.GetAssignment(y) == a1);
+    REQUIRE(builder.GetAssignment(z) == a0);
+    REQUIRE(builder.GetSpillAreaSize() == 8);
+
+    REQUIRE(code == Assemble([](Assembler& as) {
+        as.LI(t5, 1);
+        as.SD(t5, 16, sp);
+        as.LI(a1, 2);
+        as.LI(a0, 3);
+        as.LD(t5, 16, sp);
+        as.ADD(t5, t5, a1);
+        as.SD(t5, 16, sp);
+        as.LD(t5, 16, sp);
+        as.ADD(t5, t5, a0);
+        as.SD(t5, 16, sp);
+    }));
+}
+
+TEST_CASE("Virtual registers are spilled within the scratch register limit", "[virtual_registers]") {
+    VirtualCodeBuilder builder;
+    const auto x = builder.NewGPR();
+    const auto y = builder.NewGPR();
+    const auto z = builder.NewGPR();
+    const auto u = builder.NewGPR();
+    const auto w = builder.NewGPR();
+
+    // Leave only a0 and a1 to allocate from.
+    for (const auto reg : {t0, t1, t2, t3, t4, a2, a3, a4, a5, a6, a7, s0, s1, s2, s3, s4, s5, s6, s7, s8, s9,
+                           s10, s11}) {
+        builder.Reserve(reg);
+    }
+
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(x), 1); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(y), 2); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(z), 3); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(u), 4); });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.LI(map.Def(w), 5); });
+
+    // x, y, and z outlive u and w, but can't all be spilled, since this node reads all of them.
+    builder.Add([=](Assembler& as, RegisterMap& map) {
+        as.ADD(t0, map.Use(x), map.Use(y));
+        as.ADD(t0, t0, map.Use(z));
+    });
+    builder.Add([=](Assembler& as, RegisterMap& map) { as.ADD(t1, map.Use(u), map.Use(w)); });
+    builder.Add([=](Assembler& as, RegisterMap& map) {
+        as.ADD(t2, map.Use(x), map.Use(y));
+        as.ADD(t2, t2, map.Use(z));
+    });
+
+    const auto code = Assemble([&](Assembler& as) { builder.Emit(as); });
+
+    REQUIRE_FALSE(builder.GetAssignment(x).has_value());
+    REQUIRE(builder.GetAssignment(y) == a1);
+    REQUIRE_FALSE(builder.GetAssignment(z).has_value());
+    REQUIRE(builder.GetAssignment(u) == a0);
+    REQUIRE_FALSE(builder.GetAssignment(w).has_value());
+    REQUIRE(builder.GetSpillAreaSize() == 24);
+}